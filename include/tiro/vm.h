@@ -14,6 +14,127 @@
 extern "C" {
 #endif
 
+/**
+ * Defines the possible reasons for a garbage collection.
+ */
+typedef enum tiro_gc_reason {
+    /** Triggered automatically because the heap has grown since the last collection. */
+    TIRO_GC_AUTOMATIC = 0,
+    /** Forced collection, e.g. requested by the program. */
+    TIRO_GC_FORCED = 1,
+    /** Triggered by an allocation that could not be satisfied otherwise. */
+    TIRO_GC_ALLOC_FAILURE = 2,
+    /** Major collection that also evacuates sparsely populated heap pages. */
+    TIRO_GC_COMPACTION = 3,
+} tiro_gc_reason_t;
+
+/** The number of distinct garbage collection reasons. */
+#define TIRO_GC_REASONS 4
+
+/**
+ * Returns the string representation of the given garbage collection reason.
+ * The returned string is allocated in static storage and MUST NOT
+ * be freed.
+ */
+TIRO_API const char* tiro_gc_reason_str(tiro_gc_reason_t reason);
+
+/**
+ * Describes a completed garbage collection cycle. Durations are measured in milliseconds.
+ */
+typedef struct tiro_gc_event {
+    /** The reason that triggered the collection. */
+    tiro_gc_reason_t reason;
+
+    /** True if the entire heap was traced, false for collections of the young generation only. */
+    bool major;
+
+    /** True if the heap was marked incrementally (in multiple slices). */
+    bool incremental;
+
+    /** Time spent marking reachable objects. */
+    double mark_time;
+
+    /**
+     * Time spent sweeping during the collection. Pages are swept lazily afterwards,
+     * which is not included here.
+     */
+    double sweep_time;
+
+    /** Total time spent in the collection. */
+    double total_time;
+
+    /** Size (in bytes) of the allocated objects before the collection. */
+    size_t bytes_before;
+
+    /** Size (in bytes) of the allocated objects after the collection. */
+    size_t bytes_after;
+
+    /** Number of allocated objects before the collection. */
+    size_t objects_before;
+
+    /** Number of allocated objects after the collection. */
+    size_t objects_after;
+
+    /** Number of heap pages after the collection. */
+    size_t pages;
+
+    /** Number of large objects (which are allocated outside of pages) after the collection. */
+    size_t large_objects;
+} tiro_gc_event_t;
+
+/** The number of buckets in the pause histogram of `tiro_heap_stats_t`. */
+#define TIRO_GC_PAUSE_BUCKETS 16
+
+/**
+ * Heap and garbage collector statistics, see `tiro_vm_heap_stats`.
+ */
+typedef struct tiro_heap_stats {
+    /** Total memory (in bytes) allocated by the heap, including metadata. */
+    size_t total_bytes;
+
+    /** Memory (in bytes) occupied by allocated objects. */
+    size_t allocated_bytes;
+
+    /** Memory (in bytes) that is known to be free. */
+    size_t free_bytes;
+
+    /** Number of allocated objects. */
+    size_t allocated_objects;
+
+    /** Number of objects allocated since the virtual machine was created. */
+    size_t total_allocated_objects;
+
+    /** Number of heap pages. */
+    size_t pages;
+
+    /** Number of large objects (which are allocated outside of pages). */
+    size_t large_objects;
+
+    /** Number of empty heap pages that have been released since the virtual machine was created. */
+    size_t released_pages;
+
+    /** Number of completed garbage collections, indexed by `tiro_gc_reason_t`. */
+    size_t collections[TIRO_GC_REASONS];
+
+    /**
+     * Number of garbage collector pauses. Every slice of an incremental collection
+     * counts as a separate pause.
+     */
+    size_t pauses;
+
+    /** Sum of all pauses (in milliseconds). */
+    double pause_total;
+
+    /** Longest pause (in milliseconds). */
+    double pause_max;
+
+    /**
+     * Histogram of pause durations. Bucket `i` counts the pauses shorter than `0.064 * 2^i` milliseconds
+     * (that do not fit into a previous bucket). The last bucket counts all longer pauses.
+     */
+    size_t pause_histogram[TIRO_GC_PAUSE_BUCKETS];
+} tiro_heap_stats_t;
+
 /**
  * The tiro_vm_settings structure can be provided to `tiro_vm_new` as a
  * configuration parameter.
@@ -66,6 +187,68 @@ typedef struct tiro_vm_settings {
      * Defaults to `false`.
      */
     bool enable_panic_stack_trace;
+
+    /**
+     * The maximum time (in microseconds) a coroutine may run before it is preempted.
+     * A preempted coroutine is placed at the end of the ready queue, which allows other ready
+     * coroutines to make progress. Preemption only happens at function calls and loop iterations,
+     * the time slice is therefore not exact.
+     *
+     * Defaults to 0, which disables preemption of individual coroutines.
+     */
+    uint32_t coroutine_time_slice;
+
+    /**
+     * The maximum time (in microseconds) spent in a single call to `tiro_vm_run_ready()`.
+     * When the budget is exhausted, the running coroutine is preempted and `tiro_vm_run_ready()` returns.
+     * Coroutines that did not complete remain ready (see `tiro_vm_has_ready()`) and continue in the next call.
+     * The budget is not exact, see `coroutine_time_slice`.
+     *
+     * Defaults to 0, which means that `tiro_vm_run_ready()` runs until no coroutine is ready.
+     */
+    uint32_t run_ready_budget;
+
+    /**
+     * The minimum number of bytes allocated between two automatic garbage collections.
+     *
+     * The default value (0) will apply a sane default (1 MiB).
+     */
+    size_t gc_min_nursery_size;
+
+    /**
+     * The heap may grow by this fraction of the size of its live objects before the next
+     * automatic garbage collection is triggered. Must not be negative.
+     *
+     * Defaults to 0.25.
+     */
+    double gc_heap_growth;
+
+    /**
+     * Target fraction of time spent in the garbage collector. When collections take too long
+     * compared to the time spent running the program (given its allocation rate), the heap is allowed
+     * to grow further before the next automatic garbage collection. Must be in [0, 1].
+     *
+     * Defaults to 0.05. A value of 0 disables this rule.
+     */
+    double gc_time_ratio;
+
+    /**
+     * Fraction of the maximum heap size (see `max_heap_size`) that automatic garbage collections try
+     * to keep free. When the live objects approach the limit, collections happen more frequently
+     * instead of growing the heap. Must be in [0, 1).
+     *
+     * Defaults to 0.1. A value of 0 disables this rule.
+     */
+    double gc_heap_headroom;
+
+    /**
+     * This callback is invoked after every completed garbage collection cycle.
+     * The callback MUST NOT call into the virtual machine. Defaults to NULL.
+     *
+     * \param event Describes the collection. Only valid for the duration of the call.
+     * \param userdata The userdata pointer set in this settings instance.
+     */
+    void (*gc_callback)(const tiro_gc_event_t* event, void* userdata);
 } tiro_vm_settings_t;
 
 /**
@@ -144,7 +327,8 @@ TIRO_API void tiro_vm_get_export(tiro_vm_t vm, tiro_string_t module_name, tiro_s
     tiro_handle_t result, tiro_error_t* err);
 
 /**
- * Runs all ready coroutines. Returns (and does not block) when all coroutines are either waiting or done.
+ * Runs all ready coroutines. Returns (and does not block) when all coroutines are either waiting or done,
+ * or when the `run_ready_budget` configured in the vm's settings has been exhausted.
  */
 TIRO_API void tiro_vm_run_ready(tiro_vm_t vm, tiro_error_t* err);
 
@@ -153,6 +337,112 @@ TIRO_API void tiro_vm_run_ready(tiro_vm_t vm, tiro_error_t* err);
  */
 TIRO_API bool tiro_vm_has_ready(tiro_vm_t vm);
 
+/**
+ * Starts the sampling profiler. While the profiler is active, the call stack of the running coroutine
+ * is recorded roughly every `interval_us` microseconds. Use 0 to select the default interval (1 millisecond).
+ * Samples from earlier runs of the profiler are retained until `tiro_vm_profiler_reset` is called.
+ *
+ * Samples are only taken while tiro code is executing (at function calls and loop iterations).
+ */
+TIRO_API void tiro_vm_profiler_start(tiro_vm_t vm, uint32_t interval_us, tiro_error_t* err);
+
+/**
+ * Stops the sampling profiler. Samples collected so far remain available.
+ */
+TIRO_API void tiro_vm_profiler_stop(tiro_vm_t vm, tiro_error_t* err);
+
+/**
+ * Discards all samples collected by the profiler.
+ */
+TIRO_API void tiro_vm_profiler_reset(tiro_vm_t vm, tiro_error_t* err);
+
+/**
+ * Returns the samples collected by the profiler in the "folded stacks" format used by flamegraph tools.
+ * Every line contains a call stack (the coroutine name followed by "module.function:line" for every frame,
+ * separated by ";"), followed by a space and the number of samples for that stack.
+ *
+ * The string is returned via the `result` output parameter. The string must be passed to `free` to release memory.
+ */
+TIRO_API void tiro_vm_profiler_folded_stacks(tiro_vm_t vm, char** result, tiro_error_t* err);
+
+/**
+ * Starts the allocation profiler. While the profiler is active, the heap records a sample of the allocated
+ * objects: on average, one object is sampled every `interval_bytes` bytes. Use 0 to select the default
+ * interval (512 KiB). Every sample records the innermost frames of the running coroutine
+ * (including source lines, if available) and the type of the allocated object.
+ * Samples from earlier runs of the profiler are retained until `tiro_vm_alloc_profiler_reset` is called.
+ *
+ * While the profiler is stopped, its cost is a single comparison per allocation.
+ */
+TIRO_API void
+tiro_vm_alloc_profiler_start(tiro_vm_t vm, uint64_t interval_bytes, tiro_error_t* err);
+
+/**
+ * Stops the allocation profiler. Samples collected so far remain available.
+ */
+TIRO_API void tiro_vm_alloc_profiler_stop(tiro_vm_t vm, tiro_error_t* err);
+
+/**
+ * Discards all samples collected by the allocation profiler.
+ */
+TIRO_API void tiro_vm_alloc_profiler_reset(tiro_vm_t vm, tiro_error_t* err);
+
+/**
+ * Returns the samples collected by the allocation profiler in the "folded stacks" format used by flamegraph tools.
+ * Every line contains an allocation stack (the coroutine name, followed by "module.function:line" for every frame
+ * and the type of the allocated object, separated by ";"), followed by a space and the estimated number of bytes
+ * allocated by that stack.
+ *
+ * The string is returned via the `result` output parameter. The string must be passed to `free` to release memory.
+ */
+TIRO_API void tiro_vm_alloc_profiler_folded_stacks(tiro_vm_t vm, char** result, tiro_error_t* err);
+
+/**
+ * Returns the instruction statistics collected by the interpreter as a json document.
+ * The document contains the number of executions of every opcode, of every pair of consecutive opcodes
+ * and the number of executed instructions per function, all sorted by their counts.
+ *
+ * Statistics are only collected if tiro was built with the `TIRO_INSTRUMENT` option,
+ * `TIRO_ERROR_BAD_STATE` is returned otherwise.
+ *
+ * The string is returned via the `result` output parameter. The string must be passed to `free` to release memory.
+ */
+TIRO_API void tiro_vm_op_stats(tiro_vm_t vm, char** result, tiro_error_t* err);
+
+/**
+ * Discards the instruction statistics collected so far.
+ * Returns `TIRO_ERROR_BAD_STATE` if tiro was not built with the `TIRO_INSTRUMENT` option.
+ */
+TIRO_API void tiro_vm_op_stats_reset(tiro_vm_t vm, tiro_error_t* err);
+
+/**
+ * Retrieves the current heap and garbage collector statistics of the given virtual machine.
+ * The statistics are written to `stats`.
+ */
+TIRO_API void tiro_vm_heap_stats(tiro_vm_t vm, tiro_heap_stats_t* stats, tiro_error_t* err);
+
+/**
+ * Returns the live objects on the heap grouped by their (internal) type as a json document.
+ * The document is an array of entries with the fields "type", "objects" and "bytes", sorted by size.
+ * The numbers are computed by the last full garbage collection, objects that survived the following
+ * collections of the young generation are included as well.
+ *
+ * The string is returned via the `result` output parameter. The string must be passed to `free` to release memory.
+ */
+TIRO_API void tiro_vm_heap_live_types(tiro_vm_t vm, char** result, tiro_error_t* err);
+
+/**
+ * Returns a snapshot of all live objects on the heap as a json document, for offline analysis of memory usage
+ * (e.g. with the `tiro_heap_report` tool). The snapshot contains the type, the size and the outgoing references
+ * of every object, together with the (labelled) roots that keep the objects alive.
+ *
+ * A full garbage collection is performed before the snapshot is taken. The snapshot must not be taken
+ * while the vm is running.
+ *
+ * The string is returned via the `result` output parameter. The string must be passed to `free` to release memory.
+ */
+TIRO_API void tiro_vm_heap_snapshot(tiro_vm_t vm, char** result, tiro_error_t* err);
+
 /**
  * Allocates a new global handle. Global handles point to a single rooted object slot that can hold
  * an arbitrary value. Slots are always initialized to null.
@@ -11,10 +11,98 @@
 #include "tiro/vm.h"
 
 #include <any>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
 #include <optional>
+#include <string>
 
 namespace tiro {
 
+/// Defines the possible reasons for a garbage collection.
+enum class gc_reason : int {
+    automatic = TIRO_GC_AUTOMATIC,
+    forced = TIRO_GC_FORCED,
+    alloc_failure = TIRO_GC_ALLOC_FAILURE,
+    compaction = TIRO_GC_COMPACTION,
+};
+
+/// Returns the string representation of the given garbage collection reason.
+/// The returned string is allocated in static storage.
+inline const char* to_string(gc_reason r) {
+    return tiro_gc_reason_str(static_cast<tiro_gc_reason_t>(r));
+}
+
+/// Describes a completed garbage collection cycle. See `tiro_gc_event_t` for details.
+struct gc_event {
+    /// The reason that triggered the collection.
+    gc_reason reason = gc_reason::automatic;
+
+    /// True if the entire heap was traced, false for collections of the young generation only.
+    bool major = false;
+
+    /// True if the heap was marked incrementally.
+    bool incremental = false;
+
+    /// Time spent marking reachable objects, sweeping (excluding lazy sweeping) and in total.
+    std::chrono::duration<double, std::milli> mark_time{0};
+    std::chrono::duration<double, std::milli> sweep_time{0};
+    std::chrono::duration<double, std::milli> total_time{0};
+
+    /// Size (in bytes) and number of the allocated objects before and after the collection.
+    size_t bytes_before = 0;
+    size_t bytes_after = 0;
+    size_t objects_before = 0;
+    size_t objects_after = 0;
+
+    /// Number of heap pages and large objects after the collection.
+    size_t pages = 0;
+    size_t large_objects = 0;
+};
+
+/// Heap and garbage collector statistics. See `tiro_heap_stats_t` for details.
+struct heap_stats {
+    /// Total memory (in bytes) allocated by the heap, including metadata.
+    size_t total_bytes = 0;
+
+    /// Memory (in bytes) occupied by allocated objects.
+    size_t allocated_bytes = 0;
+
+    /// Memory (in bytes) that is known to be free.
+    size_t free_bytes = 0;
+
+    /// Number of allocated objects.
+    size_t allocated_objects = 0;
+
+    /// Number of objects allocated since the virtual machine was created.
+    size_t total_allocated_objects = 0;
+
+    /// Number of heap pages and large objects.
+    size_t pages = 0;
+    size_t large_objects = 0;
+
+    /// Number of empty heap pages that have been released since the virtual machine was created.
+    size_t released_pages = 0;
+
+    /// Number of completed garbage collections, indexed by `gc_reason`.
+    std::array<size_t, TIRO_GC_REASONS> collections{};
+
+    /// Number of garbage collector pauses, their total and their maximum duration.
+    size_t pauses = 0;
+    std::chrono::duration<double, std::milli> pause_total{0};
+    std::chrono::duration<double, std::milli> pause_max{0};
+
+    /// Histogram of pause durations. Bucket `i` counts the pauses shorter than `0.064 * 2^i` milliseconds
+    /// (that do not fit into a previous bucket). The last bucket counts all longer pauses.
+    std::array<size_t, TIRO_GC_PAUSE_BUCKETS> pause_histogram{};
+
+    /// Returns the number of completed garbage collections with the given reason.
+    size_t collections_by(gc_reason reason) const {
+        return collections[static_cast<size_t>(reason)];
+    }
+};
+
 /// Settings to control the construction of a virtual machine.
 struct vm_settings {
     /// The size (in bytes) of heap pages allocated by the virtual machine for the storage of most objects.
@@ -44,6 +132,39 @@ struct vm_settings {
     /// Capturing stack traces has a significant performance impact because many call frames on the
     /// call stack have to be visited.
     bool enable_panic_stack_traces = false;
+
+    /// The maximum time a coroutine may run before it is preempted and placed at the end of the ready queue.
+    /// Preemption only happens at function calls and loop iterations. Zero (the default) disables preemption.
+    /// Must not be negative and must fit into 32 bits when measured in microseconds
+    /// (about 71 minutes), otherwise constructing the vm throws an error.
+    std::chrono::microseconds coroutine_time_slice{0};
+
+    /// The maximum time spent in a single call to `vm::run_ready()`. Coroutines that did not complete
+    /// remain ready (see `vm::has_ready()`) and continue in the next call. Zero (the default) means unlimited.
+    /// Must not be negative and must fit into 32 bits when measured in microseconds
+    /// (about 71 minutes), otherwise constructing the vm throws an error.
+    std::chrono::microseconds run_ready_budget{0};
+
+    /// The minimum number of bytes allocated between two automatic garbage collections.
+    /// The default value (0) will apply a sane default.
+    size_t gc_min_nursery_size = 0;
+
+    /// The heap may grow by this fraction of the size of its live objects before the next
+    /// automatic garbage collection is triggered.
+    double gc_heap_growth = 0.25;
+
+    /// Target fraction of time spent in the garbage collector. The heap is allowed to grow further
+    /// when collections take too long compared to the time spent running the program.
+    /// Zero disables this rule.
+    double gc_time_ratio = 0.05;
+
+    /// Fraction of the maximum heap size that automatic garbage collections try to keep free.
+    /// Zero disables this rule.
+    double gc_heap_headroom = 0.1;
+
+    /// Invoked after every completed garbage collection cycle.
+    /// The callback must not call into the virtual machine.
+    std::function<void(const gc_event& event)> gc_callback;
 };
 
 class vm final {
@@ -86,6 +207,96 @@ public:
     /// Runs all ready coroutines. Returns (and does not block) when all coroutines are either waiting or done.
     void run_ready() { tiro_vm_run_ready(raw_vm_, error_adapter()); }
 
+    /// Returns the current heap and garbage collector statistics.
+    tiro::heap_stats heap_stats() const {
+        tiro_heap_stats_t raw_stats;
+        tiro_vm_heap_stats(raw_vm_, &raw_stats, error_adapter());
+
+        tiro::heap_stats stats;
+        stats.total_bytes = raw_stats.total_bytes;
+        stats.allocated_bytes = raw_stats.allocated_bytes;
+        stats.free_bytes = raw_stats.free_bytes;
+        stats.allocated_objects = raw_stats.allocated_objects;
+        stats.total_allocated_objects = raw_stats.total_allocated_objects;
+        stats.pages = raw_stats.pages;
+        stats.large_objects = raw_stats.large_objects;
+        stats.released_pages = raw_stats.released_pages;
+        for (size_t i = 0; i < stats.collections.size(); ++i)
+            stats.collections[i] = raw_stats.collections[i];
+        stats.pauses = raw_stats.pauses;
+        stats.pause_total = std::chrono::duration<double, std::milli>(raw_stats.pause_total);
+        stats.pause_max = std::chrono::duration<double, std::milli>(raw_stats.pause_max);
+        for (size_t i = 0; i < stats.pause_histogram.size(); ++i)
+            stats.pause_histogram[i] = raw_stats.pause_histogram[i];
+        return stats;
+    }
+
+    /// Returns the live objects on the heap grouped by type as a json document.
+    /// See `tiro_vm_heap_live_types` for details.
+    std::string heap_live_types() const {
+        detail::resource_holder<char*, std::free> result;
+        tiro_vm_heap_live_types(raw_vm_, result.out(), error_adapter());
+        return std::string(result.get());
+    }
+
+    /// Returns a snapshot of all live objects on the heap as a json document.
+    /// See `tiro_vm_heap_snapshot` for details.
+    std::string heap_snapshot() const {
+        detail::resource_holder<char*, std::free> result;
+        tiro_vm_heap_snapshot(raw_vm_, result.out(), error_adapter());
+        return std::string(result.get());
+    }
+
+    /// Starts the sampling profiler with the given interval (zero selects the default interval).
+    /// See `tiro_vm_profiler_start` for details.
+    void start_profiler(std::chrono::microseconds interval = std::chrono::microseconds(0)) {
+        tiro_vm_profiler_start(raw_vm_, static_cast<uint32_t>(interval.count()), error_adapter());
+    }
+
+    /// Stops the sampling profiler. Samples collected so far remain available.
+    void stop_profiler() { tiro_vm_profiler_stop(raw_vm_, error_adapter()); }
+
+    /// Discards all samples collected by the profiler.
+    void reset_profiler() { tiro_vm_profiler_reset(raw_vm_, error_adapter()); }
+
+    /// Returns the samples collected by the profiler in the folded stacks format used by flamegraph tools.
+    std::string profiler_folded_stacks() const {
+        detail::resource_holder<char*, std::free> result;
+        tiro_vm_profiler_folded_stacks(raw_vm_, result.out(), error_adapter());
+        return std::string(result.get());
+    }
+
+    /// Starts the allocation profiler with the given average sampling interval in bytes
+    /// (zero selects the default interval). See `tiro_vm_alloc_profiler_start` for details.
+    void start_alloc_profiler(uint64_t interval_bytes = 0) {
+        tiro_vm_alloc_profiler_start(raw_vm_, interval_bytes, error_adapter());
+    }
+
+    /// Stops the allocation profiler. Samples collected so far remain available.
+    void stop_alloc_profiler() { tiro_vm_alloc_profiler_stop(raw_vm_, error_adapter()); }
+
+    /// Discards all samples collected by the allocation profiler.
+    void reset_alloc_profiler() { tiro_vm_alloc_profiler_reset(raw_vm_, error_adapter()); }
+
+    /// Returns the samples collected by the allocation profiler in the folded stacks format,
+    /// weighted by the estimated number of allocated bytes.
+    std::string alloc_profiler_folded_stacks() const {
+        detail::resource_holder<char*, std::free> result;
+        tiro_vm_alloc_profiler_folded_stacks(raw_vm_, result.out(), error_adapter());
+        return std::string(result.get());
+    }
+
+    /// Returns the instruction statistics collected by the interpreter as a json document.
+    /// Requires a build with the `TIRO_INSTRUMENT` option. See `tiro_vm_op_stats` for details.
+    std::string op_stats() const {
+        detail::resource_holder<char*, std::free> result;
+        tiro_vm_op_stats(raw_vm_, result.out(), error_adapter());
+        return std::string(result.get());
+    }
+
+    /// Discards the instruction statistics collected so far.
+    void reset_op_stats() { tiro_vm_op_stats_reset(raw_vm_, error_adapter()); }
+
     /// Returns the raw virtual machine instance managed by this object.
     tiro_vm_t raw_vm() const { return raw_vm_; }
 
@@ -100,6 +311,16 @@ public:
     }
 
 private:
+    // Converts the duration to the number of microseconds expected by the c api.
+    // Throws instead of silently truncating durations that do not fit into 32 bits.
+    static uint32_t to_raw_duration(std::chrono::microseconds duration, const char* name) {
+        if (duration.count() < 0 || duration.count() > std::numeric_limits<uint32_t>::max()) {
+            throw generic_error(std::string(message(api_errc::bad_arg)) + ": " + name
+                                + " must be non-negative and fit into 32 bits (in microseconds)");
+        }
+        return static_cast<uint32_t>(duration.count());
+    }
+
     tiro_vm_t construct_vm() {
         tiro_vm_settings_t raw_settings;
         tiro_vm_settings_init(&raw_settings);
@@ -107,6 +328,14 @@ private:
         raw_settings.max_heap_size = settings_.max_heap_size;
         raw_settings.userdata = this;
         raw_settings.enable_panic_stack_trace = settings_.enable_panic_stack_traces;
+        raw_settings.coroutine_time_slice = to_raw_duration(
+            settings_.coroutine_time_slice, "coroutine_time_slice");
+        raw_settings.run_ready_budget = to_raw_duration(
+            settings_.run_ready_budget, "run_ready_budget");
+        raw_settings.gc_min_nursery_size = settings_.gc_min_nursery_size;
+        raw_settings.gc_heap_growth = settings_.gc_heap_growth;
+        raw_settings.gc_time_ratio = settings_.gc_time_ratio;
+        raw_settings.gc_heap_headroom = settings_.gc_heap_headroom;
 
         if (settings_.print_stdout) {
             raw_settings.print_stdout = [](tiro_string_t message, void* userdata) {
@@ -116,6 +345,27 @@ private:
             };
         }
 
+        if (settings_.gc_callback) {
+            raw_settings.gc_callback = [](const tiro_gc_event_t* raw_event, void* userdata) {
+                tiro::vm& self = *static_cast<tiro::vm*>(userdata);
+
+                gc_event event;
+                event.reason = static_cast<gc_reason>(raw_event->reason);
+                event.major = raw_event->major;
+                event.incremental = raw_event->incremental;
+                event.mark_time = std::chrono::duration<double, std::milli>(raw_event->mark_time);
+                event.sweep_time = std::chrono::duration<double, std::milli>(raw_event->sweep_time);
+                event.total_time = std::chrono::duration<double, std::milli>(raw_event->total_time);
+                event.bytes_before = raw_event->bytes_before;
+                event.bytes_after = raw_event->bytes_after;
+                event.objects_before = raw_event->objects_before;
+                event.objects_after = raw_event->objects_after;
+                event.pages = raw_event->pages;
+                event.large_objects = raw_event->large_objects;
+                self.settings_.gc_callback(event);
+            };
+        }
+
         tiro_vm_t raw_vm = tiro_vm_new(&raw_settings, error_adapter());
         TIRO_ASSERT(raw_vm);
         return raw_vm;
@@ -55,7 +55,8 @@ tiro_kind_t tiro_value_kind(tiro_vm_t vm, tiro_handle_t value) {
             TIRO_MAP(Boolean, BOOLEAN)
             TIRO_MAP(SmallInteger, INTEGER)
             TIRO_MAP(HeapInteger, INTEGER)
-            TIRO_MAP(Float, FLOAT)
+            TIRO_MAP(HeapFloat, FLOAT)
+            TIRO_MAP(SmallFloat, FLOAT)
             TIRO_MAP(String, STRING)
             TIRO_MAP(Buffer, BUFFER)
             TIRO_MAP(Tuple, TUPLE)
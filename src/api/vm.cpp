@@ -2,10 +2,13 @@
 
 #include "vm/builtins/modules.hpp"
 #include "vm/heap/chunks.hpp"
+#include "vm/heap/snapshot.hpp"
 #include "vm/modules/load.hpp"
 #include "vm/modules/registry.hpp"
 #include "vm/objects/all.hpp"
 
+#include <chrono>
+#include <limits>
 #include <new>
 
 using namespace tiro;
@@ -13,9 +16,42 @@ using namespace tiro::api;
 
 static constexpr tiro_vm_settings_t default_settings = []() {
     tiro_vm_settings_t settings{};
+    tiro::vm::GcPolicy policy;
+    settings.gc_heap_growth = policy.heap_growth;
+    settings.gc_time_ratio = policy.gc_time_ratio;
+    settings.gc_heap_headroom = policy.heap_headroom;
     return settings;
 }();
 
+static tiro_gc_reason_t to_external(vm::GcReason reason) {
+    switch (reason) {
+    case vm::GcReason::Automatic:
+        return TIRO_GC_AUTOMATIC;
+    case vm::GcReason::Forced:
+        return TIRO_GC_FORCED;
+    case vm::GcReason::AllocFailure:
+        return TIRO_GC_ALLOC_FAILURE;
+    case vm::GcReason::Compaction:
+        return TIRO_GC_COMPACTION;
+    }
+
+    TIRO_UNREACHABLE("invalid gc reason");
+}
+
+const char* tiro_gc_reason_str(tiro_gc_reason_t reason) {
+    switch (reason) {
+    case TIRO_GC_AUTOMATIC:
+        return "AUTOMATIC";
+    case TIRO_GC_FORCED:
+        return "FORCED";
+    case TIRO_GC_ALLOC_FAILURE:
+        return "ALLOC_FAILURE";
+    case TIRO_GC_COMPACTION:
+        return "COMPACTION";
+    }
+    return "<INVALID GC REASON>";
+}
+
 void tiro_vm_settings_init(tiro_vm_settings_t* settings) {
     if (!settings) {
         return;
@@ -25,8 +61,13 @@ void tiro_vm_settings_init(tiro_vm_settings_t* settings) {
 }
 
 tiro_vm_t tiro_vm_new(const tiro_vm_settings_t* settings, tiro_error_t* err) {
-    return entry_point(err, nullptr, [&] {
+    return entry_point(err, nullptr, [&]() -> tiro_vm_t {
         auto& raw_settings = settings ? *settings : default_settings;
+        if (!(raw_settings.gc_heap_growth >= 0)
+            || !(raw_settings.gc_time_ratio >= 0 && raw_settings.gc_time_ratio <= 1)
+            || !(raw_settings.gc_heap_headroom >= 0 && raw_settings.gc_heap_headroom < 1))
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG), nullptr;
+
         tiro::vm::ContextSettings internal_settings;
 
         if (auto page_size = raw_settings.page_size) // 0 -> leave at default value
@@ -44,6 +85,37 @@ tiro_vm_t tiro_vm_new(const tiro_vm_settings_t* settings, tiro_error_t* err) {
         }
 
         internal_settings.enable_panic_stack_traces = raw_settings.enable_panic_stack_trace;
+        internal_settings.coroutine_time_slice = std::chrono::microseconds(
+            raw_settings.coroutine_time_slice);
+        internal_settings.run_ready_budget = std::chrono::microseconds(raw_settings.run_ready_budget);
+
+        auto& policy = internal_settings.gc_policy;
+        if (auto min_nursery_size = raw_settings.gc_min_nursery_size) // 0 -> leave at default value
+            policy.min_nursery_bytes = min_nursery_size;
+        policy.heap_growth = raw_settings.gc_heap_growth;
+        policy.gc_time_ratio = raw_settings.gc_time_ratio;
+        policy.heap_headroom = raw_settings.gc_heap_headroom;
+
+        if (raw_settings.gc_callback) {
+            auto func = raw_settings.gc_callback;
+            auto userdata = raw_settings.userdata;
+            internal_settings.gc_callback = [func, userdata](const vm::GcEvent& event) {
+                tiro_gc_event_t raw_event{};
+                raw_event.reason = to_external(event.reason);
+                raw_event.major = event.major;
+                raw_event.incremental = event.incremental;
+                raw_event.mark_time = event.mark_duration;
+                raw_event.sweep_time = event.sweep_duration;
+                raw_event.total_time = event.duration;
+                raw_event.bytes_before = event.bytes_before;
+                raw_event.bytes_after = event.bytes_after;
+                raw_event.objects_before = event.objects_before;
+                raw_event.objects_after = event.objects_after;
+                raw_event.pages = event.pages;
+                raw_event.large_objects = event.large_objects;
+                func(&raw_event, userdata);
+            };
+        }
 
         return new tiro_vm(raw_settings.userdata, std::move(internal_settings));
     });
@@ -170,6 +242,160 @@ bool tiro_vm_has_ready(tiro_vm_t vm) {
     });
 }
 
+void tiro_vm_profiler_start(tiro_vm_t vm, uint32_t interval_us, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        auto interval = interval_us != 0 ? std::chrono::microseconds(interval_us)
+                                         : vm::Profiler::default_interval;
+        vm->ctx.profiler().start(interval);
+    });
+}
+
+void tiro_vm_profiler_stop(tiro_vm_t vm, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        vm->ctx.profiler().stop();
+    });
+}
+
+void tiro_vm_profiler_reset(tiro_vm_t vm, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        vm->ctx.profiler().reset();
+    });
+}
+
+void tiro_vm_profiler_folded_stacks(tiro_vm_t vm, char** result, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm || !result)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        *result = copy_to_cstr(vm->ctx.profiler().folded_stacks());
+    });
+}
+
+void tiro_vm_alloc_profiler_start(tiro_vm_t vm, uint64_t interval_bytes, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        size_t interval = vm::AllocationProfiler::default_interval;
+        if (interval_bytes != 0) {
+            if (interval_bytes > std::numeric_limits<size_t>::max())
+                return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+            interval = static_cast<size_t>(interval_bytes);
+        }
+        vm->ctx.allocation_profiler().start(interval);
+    });
+}
+
+void tiro_vm_alloc_profiler_stop(tiro_vm_t vm, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        vm->ctx.allocation_profiler().stop();
+    });
+}
+
+void tiro_vm_alloc_profiler_reset(tiro_vm_t vm, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        vm->ctx.allocation_profiler().reset();
+    });
+}
+
+void tiro_vm_alloc_profiler_folded_stacks(tiro_vm_t vm, char** result, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm || !result)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        *result = copy_to_cstr(vm->ctx.allocation_profiler().folded_stacks());
+    });
+}
+
+void tiro_vm_op_stats(tiro_vm_t vm, char** result, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm || !result)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+        if (!vm::OpStats::enabled())
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_STATE);
+
+        *result = copy_to_cstr(vm->ctx.op_stats().to_json());
+    });
+}
+
+void tiro_vm_op_stats_reset(tiro_vm_t vm, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+        if (!vm::OpStats::enabled())
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_STATE);
+
+        vm->ctx.op_stats().reset();
+    });
+}
+
+void tiro_vm_heap_stats(tiro_vm_t vm, tiro_heap_stats_t* stats, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm || !stats)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        vm::Heap& heap = vm->ctx.heap();
+        const vm::HeapStats& heap_stats = heap.stats();
+        const vm::GcStats& gc_stats = heap.collector().stats();
+
+        tiro_heap_stats_t result{};
+        result.total_bytes = heap_stats.total_bytes;
+        result.allocated_bytes = heap_stats.allocated_bytes;
+        result.free_bytes = heap_stats.free_bytes;
+        result.allocated_objects = heap_stats.allocated_objects;
+        result.total_allocated_objects = heap_stats.total_allocated_objects;
+        result.pages = heap.page_count();
+        result.large_objects = heap.large_object_count();
+        result.released_pages = heap_stats.released_pages;
+
+        static_assert(TIRO_GC_REASONS == vm::gc_reason_count);
+        for (size_t i = 0; i < vm::gc_reason_count; ++i)
+            result.collections[to_external(static_cast<vm::GcReason>(i))] = gc_stats.collections[i];
+
+        const vm::PauseHistogram& pauses = gc_stats.pauses;
+        static_assert(TIRO_GC_PAUSE_BUCKETS == vm::PauseHistogram::bucket_count);
+        result.pauses = pauses.count();
+        result.pause_total = pauses.total();
+        result.pause_max = pauses.max();
+        for (size_t i = 0; i < vm::PauseHistogram::bucket_count; ++i)
+            result.pause_histogram[i] = pauses.bucket(i);
+        *stats = result;
+    });
+}
+
+void tiro_vm_heap_live_types(tiro_vm_t vm, char** result, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm || !result)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        *result = copy_to_cstr(vm->ctx.heap().collector().stats().live_types_json());
+    });
+}
+
+void tiro_vm_heap_snapshot(tiro_vm_t vm, char** result, tiro_error_t* err) {
+    return entry_point(err, [&] {
+        if (!vm || !result)
+            return TIRO_REPORT(err, TIRO_ERROR_BAD_ARG);
+
+        *result = copy_to_cstr(vm::heap_snapshot(vm->ctx));
+    });
+}
+
 tiro_handle_t tiro_global_new(tiro_vm_t vm, tiro_error_t* err) {
     return entry_point(err, nullptr, [&]() -> tiro_handle_t {
         if (!vm)
@@ -105,6 +105,13 @@ void format_function(const BytecodeFunction& func, FormatStream& stream) {
                 dump(handler.target));
         }
     }
+
+    const auto& lines = func.lines();
+    if (!lines.empty()) {
+        stream.format("\nLines:\n");
+        for (const auto& entry : lines)
+            stream.format("  start: {}, line: {}\n", dump(entry.start), entry.line);
+    }
 }
 
 void format_module(const BytecodeModule& module, FormatStream& stream) {
@@ -499,6 +506,15 @@ void Disassembler::disassemble_instruction() {
             out_.format(" method {} count {}", dump(call_method.method), call_method.count);
         }
 
+        void visit_tail_call(const BytecodeInstr::TailCall& tail_call) {
+            out_.format(" function {} count {}", dump(tail_call.function), tail_call.count);
+        }
+
+        void visit_tail_call_method(const BytecodeInstr::TailCallMethod& tail_call_method) {
+            out_.format(
+                " method {} count {}", dump(tail_call_method.method), tail_call_method.count);
+        }
+
         void visit_return(const BytecodeInstr::Return& ret) {
             out_.format(" value {}", dump(ret.value));
         }
@@ -37,6 +37,22 @@ struct ExceptionHandler final {
         , target(target_) {}
 };
 
+// Represents an entry in the line table of a function. The entry applies to all
+// instructions starting at `start` up to the start of the next entry.
+struct LineEntry final {
+    // Start byte offset into the function's code.
+    BytecodeOffset start;
+
+    // Source line (1 based).
+    u32 line = 0;
+
+    LineEntry() = default;
+
+    LineEntry(BytecodeOffset start_, u32 line_)
+        : start(start_)
+        , line(line_) {}
+};
+
 // Represents a function that has been compiled to bytecode.
 class BytecodeFunction final {
 public:
@@ -65,6 +81,10 @@ public:
     std::vector<ExceptionHandler>& handlers() { return handlers_; }
     Span<const ExceptionHandler> handlers() const { return handlers_; }
 
+    // Line table, sorted by start offset. May be empty if no line information is available.
+    std::vector<LineEntry>& lines() { return lines_; }
+    Span<const LineEntry> lines() const { return lines_; }
+
 private:
     BytecodeMemberId name_;
     BytecodeFunctionType type_ = BytecodeFunctionType::Normal;
@@ -72,6 +92,7 @@ private:
     u32 locals_ = 0;
     std::vector<byte> code_;
     std::vector<ExceptionHandler> handlers_;
+    std::vector<LineEntry> lines_;
 };
 
 } // namespace tiro
@@ -309,6 +309,15 @@ BytecodeInstr BytecodeInstr::make_call_method(const BytecodeRegister& method, co
     return {CallMethod{method, count}};
 }
 
+BytecodeInstr BytecodeInstr::make_tail_call(const BytecodeRegister& function, const u32& count) {
+    return {TailCall{function, count}};
+}
+
+BytecodeInstr
+BytecodeInstr::make_tail_call_method(const BytecodeRegister& method, const u32& count) {
+    return {TailCallMethod{method, count}};
+}
+
 BytecodeInstr BytecodeInstr::make_return(const BytecodeRegister& value) {
     return {Return{value}};
 }
@@ -578,6 +587,14 @@ BytecodeInstr::BytecodeInstr(CallMethod call_method)
     : type_(BytecodeOp::CallMethod)
     , call_method_(std::move(call_method)) {}
 
+BytecodeInstr::BytecodeInstr(TailCall tail_call)
+    : type_(BytecodeOp::TailCall)
+    , tail_call_(std::move(tail_call)) {}
+
+BytecodeInstr::BytecodeInstr(TailCallMethod tail_call_method)
+    : type_(BytecodeOp::TailCallMethod)
+    , tail_call_method_(std::move(tail_call_method)) {}
+
 BytecodeInstr::BytecodeInstr(Return ret)
     : type_(BytecodeOp::Return)
     , return_(std::move(ret)) {}
@@ -944,6 +961,18 @@ const BytecodeInstr::CallMethod& BytecodeInstr::as_call_method() const {
     return call_method_;
 }
 
+const BytecodeInstr::TailCall& BytecodeInstr::as_tail_call() const {
+    TIRO_DEBUG_ASSERT(
+        type_ == BytecodeOp::TailCall, "Bad member access on BytecodeInstr: not a TailCall.");
+    return tail_call_;
+}
+
+const BytecodeInstr::TailCallMethod& BytecodeInstr::as_tail_call_method() const {
+    TIRO_DEBUG_ASSERT(type_ == BytecodeOp::TailCallMethod,
+        "Bad member access on BytecodeInstr: not a TailCallMethod.");
+    return tail_call_method_;
+}
+
 const BytecodeInstr::Return& BytecodeInstr::as_return() const {
     TIRO_DEBUG_ASSERT(
         type_ == BytecodeOp::Return, "Bad member access on BytecodeInstr: not a Return.");
@@ -1245,6 +1274,16 @@ void BytecodeInstr::format(FormatStream& stream) const {
                 "CallMethod(method: {}, count: {})", call_method.method, call_method.count);
         }
 
+        void visit_tail_call([[maybe_unused]] const TailCall& tail_call) {
+            stream.format(
+                "TailCall(function: {}, count: {})", tail_call.function, tail_call.count);
+        }
+
+        void visit_tail_call_method([[maybe_unused]] const TailCallMethod& tail_call_method) {
+            stream.format("TailCallMethod(method: {}, count: {})", tail_call_method.method,
+                tail_call_method.count);
+        }
+
         void visit_return([[maybe_unused]] const Return& ret) {
             stream.format("Return(value: {})", ret.value);
         }
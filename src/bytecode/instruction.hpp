@@ -665,6 +665,24 @@ public:
             , count(count_) {}
     };
 
+    struct TailCall final {
+        BytecodeRegister function;
+        u32 count;
+
+        TailCall(const BytecodeRegister& function_, const u32& count_)
+            : function(function_)
+            , count(count_) {}
+    };
+
+    struct TailCallMethod final {
+        BytecodeRegister method;
+        u32 count;
+
+        TailCallMethod(const BytecodeRegister& method_, const u32& count_)
+            : method(method_)
+            , count(count_) {}
+    };
+
     struct Return final {
         BytecodeRegister value;
 
@@ -788,6 +806,8 @@ public:
     static BytecodeInstr make_load_method(const BytecodeRegister& object,
         const BytecodeMemberId& name, const BytecodeRegister& thiz, const BytecodeRegister& method);
     static BytecodeInstr make_call_method(const BytecodeRegister& method, const u32& count);
+    static BytecodeInstr make_tail_call(const BytecodeRegister& function, const u32& count);
+    static BytecodeInstr make_tail_call_method(const BytecodeRegister& method, const u32& count);
     static BytecodeInstr make_return(const BytecodeRegister& value);
     static BytecodeInstr make_rethrow();
     static BytecodeInstr
@@ -857,6 +877,8 @@ public:
     BytecodeInstr(Call call);
     BytecodeInstr(LoadMethod load_method);
     BytecodeInstr(CallMethod call_method);
+    BytecodeInstr(TailCall tail_call);
+    BytecodeInstr(TailCallMethod tail_call_method);
     BytecodeInstr(Return ret);
     BytecodeInstr(Rethrow rethrow);
     BytecodeInstr(AssertFail assert_fail);
@@ -929,6 +951,8 @@ public:
     const Call& as_call() const;
     const LoadMethod& as_load_method() const;
     const CallMethod& as_call_method() const;
+    const TailCall& as_tail_call() const;
+    const TailCallMethod& as_tail_call_method() const;
     const Return& as_return() const;
     const Rethrow& as_rethrow() const;
     const AssertFail& as_assert_fail() const;
@@ -1014,6 +1038,8 @@ private:
         Call call_;
         LoadMethod load_method_;
         CallMethod call_method_;
+        TailCall tail_call_;
+        TailCallMethod tail_call_method_;
         Return return_;
         Rethrow rethrow_;
         AssertFail assert_fail_;
@@ -1157,6 +1183,10 @@ decltype(auto) BytecodeInstr::visit_impl(Self&& self, Visitor&& vis, Args&&... a
         return vis.visit_load_method(self.load_method_, std::forward<Args>(args)...);
     case BytecodeOp::CallMethod:
         return vis.visit_call_method(self.call_method_, std::forward<Args>(args)...);
+    case BytecodeOp::TailCall:
+        return vis.visit_tail_call(self.tail_call_, std::forward<Args>(args)...);
+    case BytecodeOp::TailCallMethod:
+        return vis.visit_tail_call_method(self.tail_call_method_, std::forward<Args>(args)...);
     case BytecodeOp::Return:
         return vis.visit_return(self.return_, std::forward<Args>(args)...);
     case BytecodeOp::Rethrow:
@@ -139,6 +139,10 @@ std::string_view to_string(BytecodeOp type) {
         return "LoadMethod";
     case BytecodeOp::CallMethod:
         return "CallMethod";
+    case BytecodeOp::TailCall:
+        return "TailCall";
+    case BytecodeOp::TailCallMethod:
+        return "TailCallMethod";
     case BytecodeOp::Return:
         return "Return";
     case BytecodeOp::Rethrow:
@@ -226,4 +230,332 @@ bool references_module(BytecodeOp op) {
     }
 }
 
+std::string_view to_string(BytecodeOperand operand) {
+#define TIRO_CASE(x)         \
+    case BytecodeOperand::x: \
+        return #x;
+
+    switch (operand) {
+        TIRO_CASE(Local)
+        TIRO_CASE(Param)
+        TIRO_CASE(Module)
+        TIRO_CASE(Offset)
+        TIRO_CASE(U32)
+        TIRO_CASE(I64)
+        TIRO_CASE(F64)
+    }
+
+#undef TIRO_CASE
+
+    TIRO_UNREACHABLE("invalid bytecode operand");
+}
+
+u32 operand_size(BytecodeOperand operand) {
+    switch (operand) {
+    case BytecodeOperand::Local:
+    case BytecodeOperand::Param:
+    case BytecodeOperand::Module:
+    case BytecodeOperand::Offset:
+    case BytecodeOperand::U32:
+        return 4;
+    case BytecodeOperand::I64:
+    case BytecodeOperand::F64:
+        return 8;
+    }
+    TIRO_UNREACHABLE("invalid bytecode operand");
+}
+
+Span<const BytecodeOperand> operands(BytecodeOp op) {
+    using T = BytecodeOperand;
+
+    switch (op) {
+    /* [[[cog
+        import cog
+        from codegen.bytecode import InstructionList
+
+        for ins in InstructionList:
+            if not ins.params:
+                continue
+
+            operands = ", ".join(f"T::{p.operand}" for p in ins.params)
+            cog.outl(f"case BytecodeOp::{ins.name}: {{")
+            cog.outl(f"    static constexpr T result[] = {{{operands}}};")
+            cog.outl(f"    return result;")
+            cog.outl(f"}}")
+    ]]] */
+    case BytecodeOp::LoadNull: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::LoadFalse: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::LoadTrue: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::LoadInt: {
+        static constexpr T result[] = {T::I64, T::Local};
+        return result;
+    }
+    case BytecodeOp::LoadFloat: {
+        static constexpr T result[] = {T::F64, T::Local};
+        return result;
+    }
+    case BytecodeOp::LoadParam: {
+        static constexpr T result[] = {T::Param, T::Local};
+        return result;
+    }
+    case BytecodeOp::StoreParam: {
+        static constexpr T result[] = {T::Local, T::Param};
+        return result;
+    }
+    case BytecodeOp::LoadModule: {
+        static constexpr T result[] = {T::Module, T::Local};
+        return result;
+    }
+    case BytecodeOp::StoreModule: {
+        static constexpr T result[] = {T::Local, T::Module};
+        return result;
+    }
+    case BytecodeOp::LoadMember: {
+        static constexpr T result[] = {T::Local, T::Module, T::Local};
+        return result;
+    }
+    case BytecodeOp::StoreMember: {
+        static constexpr T result[] = {T::Local, T::Local, T::Module};
+        return result;
+    }
+    case BytecodeOp::LoadTupleMember: {
+        static constexpr T result[] = {T::Local, T::U32, T::Local};
+        return result;
+    }
+    case BytecodeOp::StoreTupleMember: {
+        static constexpr T result[] = {T::Local, T::Local, T::U32};
+        return result;
+    }
+    case BytecodeOp::LoadIndex: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::StoreIndex: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::LoadClosure: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::LoadEnv: {
+        static constexpr T result[] = {T::Local, T::U32, T::U32, T::Local};
+        return result;
+    }
+    case BytecodeOp::StoreEnv: {
+        static constexpr T result[] = {T::Local, T::Local, T::U32, T::U32};
+        return result;
+    }
+    case BytecodeOp::Add: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Sub: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Mul: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Div: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Mod: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Pow: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::UAdd: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::UNeg: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::LSh: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::RSh: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::BAnd: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::BOr: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::BXor: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::BNot: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Gt: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Gte: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Lt: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Lte: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Eq: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::NEq: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::LNot: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Array: {
+        static constexpr T result[] = {T::U32, T::Local};
+        return result;
+    }
+    case BytecodeOp::Tuple: {
+        static constexpr T result[] = {T::U32, T::Local};
+        return result;
+    }
+    case BytecodeOp::Set: {
+        static constexpr T result[] = {T::U32, T::Local};
+        return result;
+    }
+    case BytecodeOp::Map: {
+        static constexpr T result[] = {T::U32, T::Local};
+        return result;
+    }
+    case BytecodeOp::Env: {
+        static constexpr T result[] = {T::Local, T::U32, T::Local};
+        return result;
+    }
+    case BytecodeOp::Closure: {
+        static constexpr T result[] = {T::Module, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Record: {
+        static constexpr T result[] = {T::Module, T::Local};
+        return result;
+    }
+    case BytecodeOp::Iterator: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::IteratorNext: {
+        static constexpr T result[] = {T::Local, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Formatter: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::AppendFormat: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::FormatResult: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Copy: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Swap: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::Push: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::PopTo: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::Jmp: {
+        static constexpr T result[] = {T::Offset};
+        return result;
+    }
+    case BytecodeOp::JmpTrue: {
+        static constexpr T result[] = {T::Local, T::Offset};
+        return result;
+    }
+    case BytecodeOp::JmpFalse: {
+        static constexpr T result[] = {T::Local, T::Offset};
+        return result;
+    }
+    case BytecodeOp::JmpNull: {
+        static constexpr T result[] = {T::Local, T::Offset};
+        return result;
+    }
+    case BytecodeOp::JmpNotNull: {
+        static constexpr T result[] = {T::Local, T::Offset};
+        return result;
+    }
+    case BytecodeOp::Call: {
+        static constexpr T result[] = {T::Local, T::U32};
+        return result;
+    }
+    case BytecodeOp::LoadMethod: {
+        static constexpr T result[] = {T::Local, T::Module, T::Local, T::Local};
+        return result;
+    }
+    case BytecodeOp::CallMethod: {
+        static constexpr T result[] = {T::Local, T::U32};
+        return result;
+    }
+    case BytecodeOp::TailCall: {
+        static constexpr T result[] = {T::Local, T::U32};
+        return result;
+    }
+    case BytecodeOp::TailCallMethod: {
+        static constexpr T result[] = {T::Local, T::U32};
+        return result;
+    }
+    case BytecodeOp::Return: {
+        static constexpr T result[] = {T::Local};
+        return result;
+    }
+    case BytecodeOp::AssertFail: {
+        static constexpr T result[] = {T::Local, T::Local};
+        return result;
+    }
+        /// [[[end]]]
+
+    default:
+        return {};
+    }
+}
+
 } // namespace tiro
@@ -2,6 +2,7 @@
 #define TIRO_BYTECODE_OP_HPP
 
 #include "bytecode/fwd.hpp"
+#include "common/adt/span.hpp"
 #include "common/defs.hpp"
 #include "common/format.hpp"
 
@@ -518,6 +519,27 @@ enum class BytecodeOp : u8 {
     ///   - count (constant, u32)
     CallMethod,
 
+    /// Call the given function with the topmost count arguments on the stack
+    /// and return its result from the current function (a call in tail position).
+    ///
+    /// The current function's frame may be replaced by the callee's frame, in which case
+    /// the instructions following this one are never executed. Otherwise, this instruction behaves
+    /// exactly like Call. It must therefore be followed by the same instructions as a Call in
+    /// tail position (i.e. PopTo and Return).
+    ///
+    /// Arguments:
+    ///   - function (local, u32)
+    ///   - count (constant, u32)
+    TailCall,
+
+    /// Like CallMethod, but for calls in tail position. The current function's frame may
+    /// be replaced by the callee's frame (see TailCall).
+    ///
+    /// Arguments:
+    ///   - method (local, u32)
+    ///   - count (constant, u32)
+    TailCallMethod,
+
     /// Returns the value to the calling function.
     ///
     /// Arguments:
@@ -550,8 +572,30 @@ bool references_offset(BytecodeOp op);
 /// Returns true if instructions with that opcode reference module members.
 bool references_module(BytecodeOp op);
 
+/// Describes the type and the encoding of a single instruction operand.
+/// All operands are encoded as big endian integers in the serialized bytecode.
+enum class BytecodeOperand : u8 {
+    Local,  ///< Index of a local variable (u32).
+    Param,  ///< Index of a function parameter (u32).
+    Module, ///< Index of a module member (u32).
+    Offset, ///< Byte offset of a jump target in the current function (u32).
+    U32,    ///< Unsigned integer constant (u32).
+    I64,    ///< Signed integer constant (i64).
+    F64,    ///< Floating point constant (f64).
+};
+
+std::string_view to_string(BytecodeOperand operand);
+
+/// Returns the size of the given operand in serialized bytecode, in bytes.
+u32 operand_size(BytecodeOperand operand);
+
+/// Returns the operands of instructions with the given opcode, in the order in which
+/// they appear in serialized bytecode.
+Span<const BytecodeOperand> operands(BytecodeOp op);
+
 } // namespace tiro
 
 TIRO_ENABLE_FREE_TO_STRING(tiro::BytecodeOp)
+TIRO_ENABLE_FREE_TO_STRING(tiro::BytecodeOperand)
 
 #endif // TIRO_BYTECODE_OP_HPP
@@ -529,6 +529,20 @@ std::variant<BytecodeInstr, BytecodeReaderError> BytecodeReader::read() {
             const auto p_count = u32(r_.read_u32());
             return BytecodeInstr::CallMethod{p_method, p_count};
         }
+        case BytecodeOp::TailCall: {
+            static constexpr auto operand_size = 8;
+            TIRO_CHECK_OPERAND_SIZE(operand_size);
+            const auto p_function = BytecodeRegister(r_.read_u32());
+            const auto p_count = u32(r_.read_u32());
+            return BytecodeInstr::TailCall{p_function, p_count};
+        }
+        case BytecodeOp::TailCallMethod: {
+            static constexpr auto operand_size = 8;
+            TIRO_CHECK_OPERAND_SIZE(operand_size);
+            const auto p_method = BytecodeRegister(r_.read_u32());
+            const auto p_count = u32(r_.read_u32());
+            return BytecodeInstr::TailCallMethod{p_method, p_count};
+        }
         case BytecodeOp::Return: {
             static constexpr auto operand_size = 4;
             TIRO_CHECK_OPERAND_SIZE(operand_size);
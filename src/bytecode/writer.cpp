@@ -27,6 +27,20 @@ void BytecodeWriter::start_handler(BytecodeLabel handler) {
     handler_start_ = pos();
 }
 
+void BytecodeWriter::line(u32 line) {
+    if (line == 0 || (!lines_.empty() && lines_.back().line == line))
+        return;
+
+    // Replace entries that do not cover any instructions.
+    const auto current_pos = pos();
+    if (!lines_.empty() && lines_.back().start.value() == current_pos) {
+        lines_.pop_back();
+        if (!lines_.empty() && lines_.back().line == line)
+            return;
+    }
+    lines_.emplace_back(BytecodeOffset(current_pos), line);
+}
+
 void BytecodeWriter::finish() {
     // Close current handler entry, if any.
     finish_handler();
@@ -47,6 +61,8 @@ void BytecodeWriter::finish() {
     }
 
     simplify_handlers(complete_handlers);
+
+    output_.lines() = std::move(lines_);
 }
 
 void BytecodeWriter::finish_handler() {
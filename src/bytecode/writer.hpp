@@ -36,6 +36,10 @@ public:
     /// \pre `handler_label` must be valid
     void start_handler(BytecodeLabel handler_label);
 
+    /// Marks the current byte offset as the start of instructions that originate from
+    /// the given source line. Zero (unknown) keeps the current line.
+    void line(u32 line);
+
     /// Complete bytecode construction. Call this after all instructions
     /// have been emitted. All required block labels must be defined
     /// when this function is called, because it will patch all label references.
@@ -280,6 +284,14 @@ public:
         write(BytecodeOp::CallMethod, method, count);
     }
 
+    void tail_call(BytecodeRegister function, u32 count) {
+        write(BytecodeOp::TailCall, function, count);
+    }
+
+    void tail_call_method(BytecodeRegister method, u32 count) {
+        write(BytecodeOp::TailCallMethod, method, count);
+    }
+
     void ret(BytecodeRegister value) { write(BytecodeOp::Return, value); }
 
     void rethrow() { write(BytecodeOp::Rethrow); }
@@ -334,6 +346,9 @@ private:
     // current exception handler state
     BytecodeLabel handler_;
     u32 handler_start_ = 0;
+
+    // line table entries, emitted when the source line changes
+    std::vector<LineEntry> lines_;
 };
 
 } // namespace tiro
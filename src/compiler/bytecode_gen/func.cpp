@@ -72,6 +72,11 @@ private:
     // Returns true if `id` is guaranteed to be null.
     bool is_constant_null(ir::InstId id);
 
+    // Returns the call instruction in tail position within the given block, or an invalid id.
+    // A call is in tail position if its result is returned immediately. Calls within the scope
+    // of an exception handler are never in tail position, because the handler must remain reachable.
+    ir::InstId find_tail_call(const ir::Block& block) const;
+
     ir::ModuleMemberId resolve_module_ref(ir::InstId inst_id);
 
 private:
@@ -84,6 +89,9 @@ private:
     BytecodeLocations locs_;
     std::vector<ir::BlockId> stack_;
     EntityStorage<bool, ir::BlockId> seen_;
+
+    // Call instruction in tail position within the current block (if any).
+    ir::InstId tail_call_;
 };
 
 } // namespace
@@ -107,8 +115,11 @@ void FunctionCompiler::run() {
         writer_.define_label(as_label(block_id));
         writer_.start_handler(as_label(block.handler()));
 
+        tail_call_ = find_tail_call(block);
         for (const auto& inst_id : block.insts()) {
-            compile_value(func_[inst_id].value(), inst_id);
+            const auto& inst = func_[inst_id];
+            writer_.line(inst.line());
+            compile_value(inst.value(), inst_id);
         }
 
         compile_phi_operands(block_id, block.terminator());
@@ -231,7 +242,11 @@ void FunctionCompiler::compile_value(const ir::Value& source, ir::InstId target)
             auto source_value = self.value(c.func);
             auto target_value = self.value(target);
             auto argc = push_args(c.args);
-            self.writer().call(source_value, argc);
+            if (target == self.tail_call_) {
+                self.writer().tail_call(source_value, argc);
+            } else {
+                self.writer().call(source_value, argc);
+            }
             self.writer().pop_to(target_value);
         }
 
@@ -277,7 +292,11 @@ void FunctionCompiler::compile_value(const ir::Value& source, ir::InstId target)
             self.writer().push(instance_value);
 
             auto argc = push_args(c.args);
-            self.writer().call_method(method_value, argc);
+            if (target == self.tail_call_) {
+                self.writer().tail_call_method(method_value, argc);
+            } else {
+                self.writer().call_method(method_value, argc);
+            }
             self.writer().pop_to(target_value);
         }
 
@@ -665,6 +684,24 @@ bool FunctionCompiler::is_constant_null(ir::InstId id) {
     }
 }
 
+ir::InstId FunctionCompiler::find_tail_call(const ir::Block& block) const {
+    const auto& term = block.terminator();
+    if (term.type() != ir::TerminatorType::Return || block.handler() || block.inst_count() == 0)
+        return {};
+
+    const auto last_id = block.inst(block.inst_count() - 1);
+    if (term.as_return().value != last_id)
+        return {};
+
+    switch (func_[last_id].value().type()) {
+    case ir::ValueType::Call:
+    case ir::ValueType::MethodCall:
+        return last_id;
+    default:
+        return {};
+    }
+}
+
 static InternedString
 exported_member_name(const ir::ModuleMember& member, const ir::Module& module) {
     struct NameVisitor {
@@ -16,8 +16,6 @@ namespace tiro::ir {
 /// actual value, which describes the operation to perform.
 class Inst final {
 public:
-    // TODO source ranges
-
     Inst(Value value);
 
     /// Only declared variables have a valid name.
@@ -29,11 +27,17 @@ public:
     Value& value() noexcept { return value_; }
     void value(Value&& value) { value_ = std::move(value); }
 
+    /// The source line (1 based) of the code that produced this instruction.
+    /// Zero if the instruction does not originate from a specific line.
+    u32 line() const noexcept { return line_; }
+    void line(u32 line) { line_ = line; }
+
     void format(FormatStream& stream) const;
 
 private:
     InternedString name_;
     Value value_;
+    u32 line_ = 0;
 };
 
 } // namespace tiro::ir
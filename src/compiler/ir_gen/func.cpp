@@ -11,6 +11,7 @@
 #include "compiler/ir_passes/dead_code_elimination.hpp"
 #include "compiler/semantics/symbol_table.hpp"
 #include "compiler/semantics/type_table.hpp"
+#include "compiler/source_db.hpp"
 
 #include "absl/container/inlined_vector.h"
 
@@ -24,10 +25,12 @@ void CurrentBlock::advance(InternedString label) {
 }
 
 InstResult CurrentBlock::compile_expr(NotNull<AstExpr*> expr, ExprOptions options) {
+    auto line = ctx_.enter_source(expr->range());
     return tiro::ir::compile_expr(expr, options, *this);
 }
 
 OkResult CurrentBlock::compile_stmt(NotNull<AstStmt*> stmt) {
+    auto line = ctx_.enter_source(stmt->range());
     return tiro::ir::compile_stmt(stmt, *this);
 }
 
@@ -137,6 +140,13 @@ EntityPtr<Region> FunctionIRGen::current_scope() {
     return region;
 }
 
+ResetValue<u32> FunctionIRGen::enter_source(const AbsoluteSourceRange& range) {
+    u32 line = current_line_;
+    if (range.valid())
+        line = sources().cursor_pos(range.id(), range.range().begin()).line();
+    return replace_value(current_line_, line);
+}
+
 FunctionIRGen::RegionGuard FunctionIRGen::enter_loop(BlockId jump_break, BlockId jump_continue) {
     auto id = active_regions_.push_back(Region::make_loop(jump_break, jump_continue));
     return RegionGuard(this, id, current_loop_);
@@ -434,6 +444,8 @@ InstId FunctionIRGen::define_new(Value&& value, BlockId block_id) {
 }
 
 InstId FunctionIRGen::define_new(Inst&& inst, BlockId block_id) {
+    if (!inst.line())
+        inst.line(current_line_);
     auto id = result_.make(std::move(inst));
     emit(id, block_id);
     return id;
@@ -264,6 +264,10 @@ public:
 
     ClosureEnvId current_env() const;
 
+    /// Marks the given source range as the origin of all instructions created until the
+    /// returned guard is destroyed. Invalid ranges keep the current source line.
+    ResetValue<u32> enter_source(const AbsoluteSourceRange& range);
+
     /// Returns the current exception handler. Blocks created through this object will
     /// inherit the current handler.
     BlockId current_handler() const;
@@ -397,6 +401,9 @@ private:
     // Active exception handler.
     BlockId current_handler_;
 
+    // Source line of the innermost expression or statement being compiled (0 if unknown).
+    u32 current_line_ = 0;
+
     // Tracks active closure environments. The last context represents the innermost environment.
     std::vector<EnvContext> local_env_stack_;
 
@@ -92,6 +92,7 @@ bool CSSABuilder::lift_phi(
     // This approach has the advantage that we do not have to update any usages that refer
     // to the original instruction.
     auto new_inst = func_.make(Inst(std::move(original_value)));
+    func_[new_inst].line(func_[original_inst].line());
     phi_def = new_inst;
     func_[original_inst].value(Value::make_alias(new_inst));
     new_stmts.push_back(original_inst);
@@ -0,0 +1,153 @@
+#include "heap_report/graph.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace tiro::heap_report {
+
+Graph load_graph(std::istream& input) {
+    auto json = nlohmann::json::parse(input);
+    if (json.at("version").get<int>() != 1)
+        throw std::runtime_error("unsupported snapshot version");
+
+    Graph graph;
+    graph.types = json.at("types").get<std::vector<std::string>>();
+
+    const auto& objects = json.at("objects");
+    graph.objects = objects.size();
+    for (const auto& object : objects) {
+        graph.type.push_back(object.at(0).get<uint32_t>());
+        graph.size.push_back(object.at(1).get<uint64_t>());
+        graph.edges.push_back(object.at(2).get<std::vector<uint32_t>>());
+        graph.name.push_back(object.size() > 3 ? object.at(3).get<std::string>() : std::string());
+    }
+
+    // Synthetic root node, followed by one node per root label.
+    graph.root = static_cast<uint32_t>(graph.objects);
+    graph.edges.emplace_back();
+    for (const auto& root : json.at("roots")) {
+        const auto label = root.at(0).get<std::string>();
+        const auto object = root.at(1).get<uint32_t>();
+        if (object >= graph.objects)
+            throw std::runtime_error("invalid root reference");
+
+        auto pos = std::find(graph.labels.begin(), graph.labels.end(), label);
+        if (pos == graph.labels.end()) {
+            graph.labels.push_back(label);
+            graph.edges.emplace_back();
+            graph.edges[graph.root].push_back(graph.label_node(graph.labels.size() - 1));
+            pos = graph.labels.end() - 1;
+        }
+        graph.edges[graph.label_node(pos - graph.labels.begin())].push_back(object);
+    }
+
+    for (size_t i = 0; i < graph.objects; ++i) {
+        for (auto target : graph.edges[i]) {
+            if (target >= graph.objects)
+                throw std::runtime_error("invalid object reference");
+        }
+    }
+    return graph;
+}
+
+// Computes the dominator tree with the iterative algorithm by Cooper, Harvey and Kennedy
+// ("A Simple, Fast Dominance Algorithm").
+Dominators compute_dominators(const Graph& graph) {
+    const size_t n = graph.size_nodes();
+
+    // Depth first search from the root to compute the post order.
+    std::vector<uint32_t> post_order;
+    std::vector<uint32_t> post_index(n, invalid_node);
+    {
+        std::vector<bool> visited(n, false);
+        std::vector<std::pair<uint32_t, size_t>> stack; // (node, next edge)
+        stack.emplace_back(graph.root, 0);
+        visited[graph.root] = true;
+        while (!stack.empty()) {
+            auto& [node, next] = stack.back();
+            if (next < graph.edges[node].size()) {
+                uint32_t target = graph.edges[node][next++];
+                if (!visited[target]) {
+                    visited[target] = true;
+                    stack.emplace_back(target, 0);
+                }
+                continue;
+            }
+
+            post_index[node] = static_cast<uint32_t>(post_order.size());
+            post_order.push_back(node);
+            stack.pop_back();
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> preds(n);
+    for (uint32_t node : post_order) {
+        for (uint32_t target : graph.edges[node])
+            preds[target].push_back(node);
+    }
+
+    Dominators dom;
+    dom.idom.assign(n, invalid_node);
+    dom.idom[graph.root] = graph.root;
+
+    const auto intersect = [&](uint32_t a, uint32_t b) {
+        while (a != b) {
+            while (post_index[a] < post_index[b])
+                a = dom.idom[a];
+            while (post_index[b] < post_index[a])
+                b = dom.idom[b];
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto pos = post_order.rbegin(), end = post_order.rend(); pos != end; ++pos) {
+            const uint32_t node = *pos;
+            if (node == graph.root)
+                continue;
+
+            uint32_t new_idom = invalid_node;
+            for (uint32_t pred : preds[node]) {
+                if (dom.idom[pred] == invalid_node)
+                    continue;
+                new_idom = new_idom == invalid_node ? pred : intersect(pred, new_idom);
+            }
+            if (new_idom != dom.idom[node]) {
+                dom.idom[node] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    // Dominated nodes always precede their dominators in post order.
+    dom.retained.assign(n, 0);
+    for (uint32_t node : post_order) {
+        if (node < graph.objects)
+            dom.retained[node] += graph.size[node];
+        if (node != graph.root)
+            dom.retained[dom.idom[node]] += dom.retained[node];
+    }
+
+    // Breadth first search for the shortest path from the root to every object.
+    dom.parent.assign(n, invalid_node);
+    {
+        std::vector<uint32_t> queue{graph.root};
+        dom.parent[graph.root] = graph.root;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            for (uint32_t target : graph.edges[queue[i]]) {
+                if (dom.parent[target] == invalid_node) {
+                    dom.parent[target] = queue[i];
+                    queue.push_back(target);
+                }
+            }
+        }
+    }
+    return dom;
+}
+
+} // namespace tiro::heap_report
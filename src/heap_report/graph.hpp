@@ -0,0 +1,52 @@
+#ifndef TIRO_HEAP_REPORT_GRAPH_HPP
+#define TIRO_HEAP_REPORT_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace tiro::heap_report {
+
+inline constexpr uint32_t invalid_node = uint32_t(-1);
+
+/// The object graph of a heap snapshot, extended by synthetic nodes for the root and the root labels.
+/// Nodes [0, objects) represent objects, followed by the root and then the labels.
+/// The root references one node for every root label (e.g. "modules" or "module main"),
+/// which in turn reference the labelled objects.
+struct Graph {
+    size_t objects = 0;
+    uint32_t root = invalid_node;
+    std::vector<std::string> types;
+    std::vector<std::string> labels;
+
+    std::vector<uint32_t> type;
+    std::vector<uint64_t> size;
+    std::vector<std::string> name;
+    std::vector<std::vector<uint32_t>> edges;
+
+    size_t size_nodes() const { return edges.size(); }
+    uint32_t label_node(size_t label) const { return root + 1 + static_cast<uint32_t>(label); }
+};
+
+/// The dominator tree of a graph, rooted in the graph's synthetic root node.
+///
+/// The retained size of an object is the size of all objects that would become unreachable
+/// if the object itself was removed, i.e. the size of its subtree in the dominator tree.
+struct Dominators {
+    std::vector<uint32_t> idom;     // Immediate dominator, invalid_node if unreachable
+    std::vector<uint64_t> retained; // Retained size
+    std::vector<uint32_t> parent;   // Parent on a shortest path from the root
+};
+
+/// Parses a heap snapshot in the format written by `tiro_vm_heap_snapshot` (see vm/heap/snapshot.hpp).
+/// Throws if the snapshot is malformed.
+Graph load_graph(std::istream& input);
+
+/// Computes the dominator tree of the given graph.
+Dominators compute_dominators(const Graph& graph);
+
+} // namespace tiro::heap_report
+
+#endif // TIRO_HEAP_REPORT_GRAPH_HPP
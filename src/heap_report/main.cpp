@@ -0,0 +1,220 @@
+#include "cxxopts.hpp"
+#include "fmt/format.h"
+
+#include "heap_report/graph.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Reads a heap snapshot (see `tiro_vm_heap_snapshot`) and prints the memory retained
+// by the heap's roots and by the largest individual objects (see heap_report/graph.hpp).
+
+using tiro::heap_report::Dominators;
+using tiro::heap_report::Graph;
+
+namespace {
+
+struct OptionsError {
+    std::string message;
+};
+
+struct ShowHelp {
+    std::string content;
+};
+
+struct Options {
+    std::string input_file;
+    size_t top = 20;
+};
+
+using OptionsResult = std::variant<Options, OptionsError, ShowHelp>;
+
+OptionsResult parse_options(int argc, char** argv);
+
+Graph read_graph(const std::string& path);
+void print_report(const Graph& graph, const Dominators& dom, const Options& options);
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        OptionsResult options_result = parse_options(argc, argv);
+        if (auto err = std::get_if<OptionsError>(&options_result)) {
+            fmt::print(stderr, "{}\n", err->message);
+            return 1;
+        }
+        if (auto help = std::get_if<ShowHelp>(&options_result)) {
+            fmt::print(stdout, "{}\n", help->content);
+            return 0;
+        }
+
+        const Options& options = std::get<Options>(options_result);
+        Graph graph;
+        try {
+            graph = read_graph(options.input_file);
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "Failed to read '{}': {}\n", options.input_file, e.what());
+            return 1;
+        }
+
+        Dominators dom = tiro::heap_report::compute_dominators(graph);
+        print_report(graph, dom, options);
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "Fatal error: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
+
+namespace {
+
+OptionsResult parse_options(int argc, char** argv) {
+    cxxopts::Options options(argv[0], "prints retained sizes and dominators of a tiro heap snapshot");
+
+    /* clang-format off */
+    options.add_options()
+        ("top", "number of objects to list (default: 20)", cxxopts::value<size_t>(), "<n>")
+        ("input", "heap snapshot file", cxxopts::value<std::string>(), "<file>")
+        ("h,help", "show this message", cxxopts::value<bool>());
+    /* clang-format on */
+    options.parse_positional("input");
+    options.positional_help("<snapshot file>");
+
+    auto result = options.parse(argc, argv);
+    if (result["help"].as<bool>())
+        return ShowHelp{options.help()};
+
+    if (!result.count("input"))
+        return OptionsError{"Error: no snapshot file specified"};
+
+    Options parsed_options;
+    parsed_options.input_file = result["input"].as<std::string>();
+    if (result.count("top"))
+        parsed_options.top = result["top"].as<size_t>();
+    return parsed_options;
+}
+
+Graph read_graph(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("failed to open the file");
+    return tiro::heap_report::load_graph(file);
+}
+
+std::string format_bytes(uint64_t bytes) {
+    if (bytes < 1024)
+        return fmt::format("{} B", bytes);
+    if (bytes < 1024 * 1024)
+        return fmt::format("{:.1f} KiB", double(bytes) / 1024);
+    return fmt::format("{:.1f} MiB", double(bytes) / (1024 * 1024));
+}
+
+std::string describe(const Graph& graph, uint32_t node) {
+    if (node == graph.root)
+        return "<root>";
+    if (node > graph.root)
+        return fmt::format("[{}]", graph.labels[node - graph.root - 1]);
+
+    const auto& type = graph.types.at(graph.type[node]);
+    const auto& name = graph.name[node];
+    if (name.empty())
+        return fmt::format("{}#{}", type, node);
+    return fmt::format("{}#{} \"{}\"", type, node, name);
+}
+
+std::string format_path(const Graph& graph, const Dominators& dom, uint32_t node) {
+    std::vector<uint32_t> path;
+    for (uint32_t current = node; current != graph.root; current = dom.parent[current])
+        path.push_back(current);
+
+    std::string result;
+    for (auto pos = path.rbegin(), end = path.rend(); pos != end; ++pos) {
+        if (!result.empty())
+            result += " -> ";
+        result += describe(graph, *pos);
+    }
+    return result;
+}
+
+void print_report(const Graph& graph, const Dominators& dom, const Options& options) {
+    uint64_t total_bytes = 0;
+    for (size_t i = 0; i < graph.objects; ++i)
+        total_bytes += graph.size[i];
+
+    fmt::print("Heap snapshot: {} objects, {}\n", graph.objects, format_bytes(total_bytes));
+
+    // Modules are also reachable through other roots (e.g. the module registry), so their
+    // "module <name>" labels never dominate anything. The retained sizes of the module objects
+    // are listed in a separate section instead.
+    const auto is_module_label = [&](size_t label) {
+        return graph.labels[label].rfind("module ", 0) == 0;
+    };
+
+    fmt::print("\nRetained by roots:\n");
+    std::vector<uint32_t> labels;
+    std::vector<uint32_t> modules;
+    for (size_t i = 0; i < graph.labels.size(); ++i) {
+        const uint32_t label = graph.label_node(i);
+        if (!is_module_label(i)) {
+            labels.push_back(label);
+            continue;
+        }
+        modules.insert(modules.end(), graph.edges[label].begin(), graph.edges[label].end());
+    }
+    std::sort(labels.begin(), labels.end(),
+        [&](uint32_t a, uint32_t b) { return dom.retained[a] > dom.retained[b]; });
+    for (uint32_t label : labels)
+        fmt::print("  {:>12}  {}\n", format_bytes(dom.retained[label]), describe(graph, label));
+    fmt::print("  {:>12}  (shared by multiple roots)\n",
+        format_bytes(dom.retained[graph.root]
+                     - std::accumulate(labels.begin(), labels.end(), uint64_t(0),
+                         [&](uint64_t sum, uint32_t label) { return sum + dom.retained[label]; })));
+
+    fmt::print("\nRetained by modules:\n");
+    std::sort(modules.begin(), modules.end(),
+        [&](uint32_t a, uint32_t b) { return dom.retained[a] > dom.retained[b]; });
+    for (uint32_t module : modules)
+        fmt::print("  {:>12}  {}\n", format_bytes(dom.retained[module]), describe(graph, module));
+
+    fmt::print("\nLargest objects by retained size:\n");
+    std::vector<uint32_t> objects;
+    for (uint32_t i = 0; i < graph.objects; ++i)
+        objects.push_back(i);
+    const size_t top = std::min(options.top, objects.size());
+    std::partial_sort(objects.begin(), objects.begin() + top, objects.end(),
+        [&](uint32_t a, uint32_t b) { return dom.retained[a] > dom.retained[b]; });
+    for (size_t i = 0; i < top; ++i) {
+        uint32_t object = objects[i];
+        fmt::print("  {:>12}  {} (self {})\n", format_bytes(dom.retained[object]),
+            describe(graph, object), format_bytes(graph.size[object]));
+        fmt::print("                path: {}\n", format_path(graph, dom, object));
+    }
+
+    fmt::print("\nObjects by type:\n");
+    std::vector<std::pair<uint64_t, uint64_t>> types(graph.types.size()); // (count, bytes)
+    for (size_t i = 0; i < graph.objects; ++i) {
+        types[graph.type[i]].first += 1;
+        types[graph.type[i]].second += graph.size[i];
+    }
+    std::vector<size_t> type_order;
+    for (size_t i = 0; i < types.size(); ++i)
+        type_order.push_back(i);
+    std::sort(type_order.begin(), type_order.end(),
+        [&](size_t a, size_t b) { return types[a].second > types[b].second; });
+    for (size_t type : type_order) {
+        fmt::print("  {:>12}  {:>10} objects  {}\n", format_bytes(types[type].second),
+            types[type].first, graph.types[type]);
+    }
+}
+
+} // namespace
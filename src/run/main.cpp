@@ -23,6 +23,10 @@ struct ShowHelp {
 struct Options {
     std::vector<std::string> input_files;
     std::optional<std::string> call;
+    std::optional<std::string> profile;
+    std::optional<std::string> alloc_profile;
+    std::optional<std::string> heap_snapshot;
+    std::optional<std::string> op_stats;
     bool dump_cst = false;
     bool dump_ast = false;
     bool dump_ir = false;
@@ -38,7 +42,8 @@ using OptionsResult = std::variant<Options, ShowHelp, OptionsError>;
 
 OptionsResult parse_options(int argc, char** argv);
 tiro::compiled_module compile(const std::vector<InputFile>& files, const Options& options);
-int run(const tiro::compiled_module& module, std::string_view function_name);
+int run(const tiro::compiled_module& module, const Options& options);
+void write_file_contents(const char* path, std::string_view content);
 std::string read_file_contents(const char* path);
 
 static const std::string_view test_module_name = "main";
@@ -80,7 +85,7 @@ int main(int argc, char* argv[]) {
         }
 
         if (options.call)
-            return run(*compiled, *options.call);
+            return run(*compiled, options);
     } catch (const std::exception& e) {
         fmt::print(stderr, "Fatal error: {}\n", e.what());
         return 1;
@@ -103,6 +108,10 @@ OptionsResult parse_options(int argc, char** argv) {
         ("dump-ir", "print the compiler's intermediate representation", cxxopts::value<bool>())
         ("dump-bytecode", "print the disassembled final bytecode", cxxopts::value<bool>())
         ("dump", "dump all intermediate datastructures", cxxopts::value<bool>())
+        ("profile", "sample the called function and write folded stacks (for flamegraphs) to the given file", cxxopts::value<std::string>(), "<file>")
+        ("alloc-profile", "sample allocations of the called function and write folded stacks (weighted by bytes) to the given file", cxxopts::value<std::string>(), "<file>")
+        ("heap-snapshot", "write a snapshot of the heap (json, see tiro_heap_report) to the given file after the called function returned", cxxopts::value<std::string>(), "<file>")
+        ("op-stats", "write instruction statistics (json) to the given file, requires a TIRO_INSTRUMENT build", cxxopts::value<std::string>(), "<file>")
         ("input", "input files", cxxopts::value<std::vector<std::string>>(), "<file>")
         ("h,help", "show this message", cxxopts::value<bool>());
     /* clang-format on */
@@ -142,6 +151,26 @@ OptionsResult parse_options(int argc, char** argv) {
         parsed_options.dump_bytecode = true;
     if (auto call = result["call"]; call.count())
         parsed_options.call = call.as<std::string>();
+    if (auto profile = result["profile"]; profile.count()) {
+        if (!parsed_options.call)
+            return OptionsError{"Error: --profile requires --call"};
+        parsed_options.profile = profile.as<std::string>();
+    }
+    if (auto alloc_profile = result["alloc-profile"]; alloc_profile.count()) {
+        if (!parsed_options.call)
+            return OptionsError{"Error: --alloc-profile requires --call"};
+        parsed_options.alloc_profile = alloc_profile.as<std::string>();
+    }
+    if (auto heap_snapshot = result["heap-snapshot"]; heap_snapshot.count()) {
+        if (!parsed_options.call)
+            return OptionsError{"Error: --heap-snapshot requires --call"};
+        parsed_options.heap_snapshot = heap_snapshot.as<std::string>();
+    }
+    if (auto op_stats = result["op-stats"]; op_stats.count()) {
+        if (!parsed_options.call)
+            return OptionsError{"Error: --op-stats requires --call"};
+        parsed_options.op_stats = op_stats.as<std::string>();
+    }
     return parsed_options;
 }
 
@@ -200,7 +229,13 @@ tiro::compiled_module compile(const std::vector<InputFile>& files, const Options
     return compiler.take_module();
 }
 
-int run(const tiro::compiled_module& module, std::string_view function_name) {
+int run(const tiro::compiled_module& module, const Options& options) {
+    const std::string_view function_name = *options.call;
+    const auto& profile = options.profile;
+    const auto& alloc_profile = options.alloc_profile;
+    const auto& heap_snapshot = options.heap_snapshot;
+    const auto& op_stats = options.op_stats;
+
     tiro::vm vm;
     vm.load_std();
     vm.load(module);
@@ -218,6 +253,21 @@ int run(const tiro::compiled_module& module, std::string_view function_name) {
         return 1;
     }
 
+    if (profile)
+        vm.start_profiler();
+    if (alloc_profile)
+        vm.start_alloc_profiler();
+    if (op_stats) {
+        try {
+            vm.reset_op_stats(); // Ignore module initialization
+        } catch (const tiro::error& e) {
+            fmt::print(stderr,
+                "Instruction statistics are not available (requires a TIRO_INSTRUMENT build): {}\n",
+                e.message());
+            return 1;
+        }
+    }
+
     std::optional<int> exit;
     tiro::run_async(vm, target->as<tiro::function>(), [&](tiro::vm&, const tiro::coroutine& coro) {
         tiro::result result = coro.result();
@@ -234,6 +284,47 @@ int run(const tiro::compiled_module& module, std::string_view function_name) {
         vm.run_ready();
     }
 
+    if (profile) {
+        vm.stop_profiler();
+        try {
+            write_file_contents(profile->c_str(), vm.profiler_folded_stacks());
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "Failed to write profile to '{}': {}\n", *profile, e.what());
+            return 1;
+        }
+    }
+
+    if (alloc_profile) {
+        vm.stop_alloc_profiler();
+        try {
+            write_file_contents(alloc_profile->c_str(), vm.alloc_profiler_folded_stacks());
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "Failed to write allocation profile to '{}': {}\n", *alloc_profile,
+                e.what());
+            return 1;
+        }
+    }
+
+    if (heap_snapshot) {
+        try {
+            write_file_contents(heap_snapshot->c_str(), vm.heap_snapshot());
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "Failed to write heap snapshot to '{}': {}\n", *heap_snapshot,
+                e.what());
+            return 1;
+        }
+    }
+
+    if (op_stats) {
+        try {
+            write_file_contents(op_stats->c_str(), vm.op_stats());
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "Failed to write instruction statistics to '{}': {}\n", *op_stats,
+                e.what());
+            return 1;
+        }
+    }
+
     if (!exit)
         throw std::logic_error("function did not return after main loop completed");
     return *exit;
@@ -281,4 +372,24 @@ std::string read_file_contents(const char* path) {
     return result;
 }
 
+void write_file_contents(const char* path, std::string_view content) {
+    struct file_handle {
+        FILE* fd = nullptr;
+
+        ~file_handle() {
+            if (fd)
+                std::fclose(fd);
+        }
+    } file;
+
+    file.fd = std::fopen(path, "wb");
+    if (!file.fd) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    if (std::fwrite(content.data(), 1, content.size(), file.fd) != content.size()) {
+        throw std::system_error(errno, std::system_category());
+    }
+}
+
 } // namespace
@@ -430,7 +430,8 @@ void DumpHelper::dump_value(Value value) {
     case ValueType::HeapInteger:
         stream_.format("{}", value.must_cast<HeapInteger>().value());
         break;
-    case ValueType::Float:
+    case ValueType::HeapFloat:
+    case ValueType::SmallFloat:
         stream_.format("{:#}", value.must_cast<Float>().value());
         break;
     case ValueType::String:
@@ -13,6 +13,7 @@
 #include "vm/objects/record.hpp"
 #include "vm/objects/result.hpp"
 #include "vm/objects/string.hpp"
+#include "vm/objects/weak_map.hpp"
 
 #include <cmath>
 #include <cstdio>
@@ -100,6 +101,11 @@ static void std_new_string_builder(SyncFrameContext& frame) {
     frame.return_value(StringBuilder::make(ctx));
 }
 
+static void std_new_weak_map(SyncFrameContext& frame) {
+    Context& ctx = frame.ctx();
+    frame.return_value(WeakMap::make(ctx));
+}
+
 static void std_new_buffer(SyncFrameContext& frame) {
     Context& ctx = frame.ctx();
 
@@ -306,6 +312,7 @@ static constexpr ExposedType types[] = {
     {"Symbol"sv, PublicType::Symbol},
     {"Tuple"sv, PublicType::Tuple},
     {"Type"sv, PublicType::Type},
+    {"WeakMap"sv, PublicType::WeakMap},
 };
 
 static constexpr MathConstant math_constants[] = {
@@ -358,6 +365,7 @@ static constexpr FunctionDesc functions[] = {
     // Constructor functions (TODO)
     FunctionDesc::plain("new_string_builder"sv, 0, std_new_string_builder),
     FunctionDesc::plain("new_buffer"sv, 1, std_new_buffer),
+    FunctionDesc::plain("new_weak_map"sv, 0, std_new_weak_map),
 };
 
 Module create_std_module(Context& ctx) {
@@ -39,6 +39,8 @@ static ContextSettings default_settings([[maybe_unused]] Context& ctx, ContextSe
             std::fflush(stdout);
         };
     }
+    if (settings.gc_mapped_memory)
+        settings.alloc = DefaultHeapAllocator(true);
     return settings;
 }
 
@@ -50,9 +52,20 @@ Context::Context()
 Context::Context(ContextSettings settings)
     : settings_(default_settings(*this, std::move(settings)))
     , heap_(settings_.page_size_bytes, settings_.alloc)
+    , allocation_profiler_(*this)
+#ifdef TIRO_JIT
+    , jit_(settings_.jit_threshold)
+#endif
     , startup_time_(timestamp()) {
     heap_.collector().roots(&roots_);
     heap_.max_size(settings_.max_heap_size_bytes);
+    heap_.collector().policy(settings_.gc_policy);
+    heap_.collector().on_collection(settings_.gc_callback);
+    heap_.collector().incremental(settings_.gc_slice_budget, settings_.gc_slice_allocation_bytes);
+    heap_.sweep_threads(settings_.gc_sweep_threads);
+    heap_.page_retention(settings_.gc_spare_pages, settings_.gc_page_release_cycles);
+    heap_.size_classes(settings_.gc_size_classes);
+    heap_.collector().evacuation(settings_.gc_evacuation_threshold);
     roots_.init(*this);
     roots_.get_externals().set_ctx(*this);
 }
@@ -93,6 +106,10 @@ void Context::start(Handle<Coroutine> coro) {
 }
 
 void Context::run_ready() {
+    run_ready_impl(true);
+}
+
+void Context::run_ready_impl(bool preemptible) {
     if (running_)
         TIRO_ERROR("already running, nested calls are not allowed");
 
@@ -103,6 +120,14 @@ void Context::run_ready() {
 
     loop_timestamp_ = timestamp() - startup_time_;
 
+    // Coroutines are preempted when their time slice or the budget of this call has been exhausted.
+    using Clock = Interpreter::Clock;
+    const auto slice = settings_.coroutine_time_slice;
+    const auto budget = settings_.run_ready_budget;
+    std::optional<Clock::time_point> run_deadline;
+    if (preemptible && budget.count() > 0)
+        run_deadline = Clock::now() + budget;
+
     Scope sc(*this);
     Local current = sc.local<Nullable<Coroutine>>();
     while (1) {
@@ -111,12 +136,30 @@ void Context::run_ready() {
             break;
         }
 
+        std::optional<Clock::time_point> deadline = run_deadline;
+        if (preemptible && slice.count() > 0) {
+            auto slice_deadline = Clock::now() + slice;
+            if (!deadline || slice_deadline < *deadline)
+                deadline = slice_deadline;
+        }
+
         Handle<Coroutine> coro = current.must_cast<Coroutine>();
-        interpreter.run(coro);
+        interpreter.run(coro, deadline);
         if (coro->state() == CoroutineState::Done) {
             coro->reset_token(); // ensure old token cannot be used
             execute_callbacks(coro);
         }
+
+        // Make progress with incremental marking (if any) between coroutines.
+        // Objects may only be moved here, because no native code holds unrooted values.
+        Collector& collector = heap_.collector();
+        collector.step();
+        if (preemptible && collector.compaction_due())
+            collector.collect(GcReason::Compaction);
+
+        // Remaining coroutines continue in the next call.
+        if (run_deadline && Clock::now() >= *run_deadline)
+            break;
     }
 }
 
@@ -128,7 +171,9 @@ Result Context::run_init(Handle<Value> func, MaybeHandle<Tuple> args) {
     Scope sc(*this);
     Local coro = sc.local(make_coroutine(func, args));
     start(coro);
-    run_ready();
+
+    // Module initializers must complete, they cannot be preempted.
+    run_ready_impl(false);
 
     const auto state = coro->state();
     if (state != CoroutineState::Done)
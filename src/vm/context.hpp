@@ -10,8 +10,15 @@
 #include "vm/heap/heap.hpp"
 #include "vm/interpreter.hpp"
 #include "vm/objects/primitives.hpp"
+#include "vm/op_stats.hpp"
+#include "vm/profiler.hpp"
 #include "vm/root_set.hpp"
 
+#ifdef TIRO_JIT
+#include "vm/jit/jit.hpp"
+#endif
+
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -52,6 +59,57 @@ struct ContextSettings {
 
     // Maximum size of the heap.
     size_t max_heap_size_bytes = default_heap_max_size_bytes;
+
+    // Maximum time a coroutine may run before it is preempted and placed at the end of the ready queue.
+    // Zero disables preemption of individual coroutines.
+    std::chrono::microseconds coroutine_time_slice{0};
+
+    // Maximum duration of a single call to `Context::run_ready()`. Coroutines are preempted when the budget
+    // has been exhausted and remain ready for the next call. Zero means unlimited.
+    std::chrono::microseconds run_ready_budget{0};
+
+    // Controls when automatic garbage collections are triggered (heap growth, gc time ratio, headroom).
+    GcPolicy gc_policy;
+
+    // Invoked after every completed garbage collection cycle. Must not allocate objects on the heap.
+    std::function<void(const GcEvent& event)> gc_callback;
+
+    // Maximum duration of a single incremental marking slice during a major garbage collection.
+    // Zero disables incremental marking, i.e. major collections stop the world until they are complete.
+    std::chrono::microseconds gc_slice_budget{0};
+
+    // Number of bytes that may be allocated between two incremental marking slices.
+    // Marking slices are also performed by `Context::run_ready()` between two coroutines.
+    size_t gc_slice_allocation_bytes = 256 * 1024;
+
+    // Number of helper threads that sweep heap pages in the background after a garbage collection.
+    // Zero means that pages are swept lazily by the vm's thread when it needs free space.
+    u32 gc_sweep_threads = 0;
+
+    // Number of empty heap pages that are always retained after a garbage collection.
+    u32 gc_spare_pages = 1;
+
+    // Additional empty pages are returned to the allocator once they have not been used
+    // during this many garbage collections.
+    u32 gc_page_release_cycles = 2;
+
+    // Allocate small objects from pages that only contain objects of the same size (see `Heap::size_classes()`).
+    bool gc_size_classes = false;
+
+    // Map heap pages and large objects directly from the operating system (see `DefaultHeapAllocator`).
+    // Large arrays can then grow without copying their elements, and pages of at least 2 MiB
+    // (see `page_size_bytes`) are backed by transparent huge pages. Ignored on unsupported platforms.
+    bool gc_mapped_memory = false;
+
+    // Heap pages whose live objects occupy less than this fraction of the page are evacuated (compacted)
+    // by `Context::run_ready()` between two coroutines, if a major collection found enough of them.
+    // Zero disables evacuation.
+    double gc_evacuation_threshold = 0;
+
+#ifdef TIRO_JIT
+    // Number of calls and loop iterations after which a function is compiled to machine code.
+    u32 jit_threshold = Jit::default_threshold;
+#endif
 };
 
 class Context final {
@@ -74,6 +132,13 @@ public:
     ExternalStorage& externals() { return roots_.get_externals(); }
     ModuleRegistry& modules() { return roots_.get_modules(); }
     TypeSystem& types() { return roots_.get_types(); }
+    Profiler& profiler() { return profiler_; }
+    AllocationProfiler& allocation_profiler() { return allocation_profiler_; }
+    OpStats& op_stats() { return op_stats_; }
+
+#ifdef TIRO_JIT
+    Jit& jit() { return jit_; }
+#endif
 
     Context(const Context&) = delete;
     Context& operator=(const Context&) = delete;
@@ -97,6 +162,9 @@ public:
     /// Runs all coroutines that have been scheduled for execution. Stops when all coroutines have either completed
     /// or yielded (waiting for async operations to complete). When a coroutine has completed its execution, its native
     /// callback will be executed (if one has been specified in `set_callback()`).
+    ///
+    /// If `ContextSettings::run_ready_budget` is set, this function also returns when the budget has been exhausted.
+    /// Coroutines that were interrupted remain ready (see `has_ready()`) and continue in the next call.
     void run_ready();
 
     /// Returns true if there is at least one coroutine ready for execution.
@@ -122,6 +190,7 @@ private:
     // -- Functions responsible for scheduling coroutines.
     friend Interpreter;
 
+    void run_ready_impl(bool preemptible);
     void schedule_coroutine(Handle<Coroutine> coro);
     Nullable<Coroutine> dequeue_coroutine();
     void execute_callbacks(Handle<Coroutine> coro);
@@ -169,6 +238,7 @@ public:
 
     /// Interns the given string, or returns an existing interned string that was previously interned.
     /// Interned strings can be compared using their addresses only.
+    /// The table of interned strings does not keep its strings (or their symbols) alive.
     String get_interned_string(Handle<String> str);
 
     /// Returns a string object with the given content.
@@ -189,6 +259,12 @@ public:
         roots_.trace(tracer);
     }
 
+    /// See `RootSet::trace_labelled()`.
+    template<typename Labeler, typename Tracer>
+    void trace_labelled(Labeler&& label, Tracer&& tracer) {
+        roots_.trace_labelled(label, tracer);
+    }
+
     void intern_impl(MutHandle<String> str, MaybeOutHandle<Symbol> assoc_symbol);
 
 private:
@@ -196,6 +272,12 @@ private:
     void* userdata_ = nullptr;
     RootSet roots_;
     Heap heap_;
+    Profiler profiler_;
+    AllocationProfiler allocation_profiler_;
+    OpStats op_stats_;
+#ifdef TIRO_JIT
+    Jit jit_;
+#endif
 
     // True if some thread is currently running.
     bool running_ = false;
@@ -6,14 +6,40 @@ namespace tiro::vm {
 
 HeapAllocator::~HeapAllocator() {}
 
+void* HeapAllocator::resize_aligned(
+    void* block, size_t old_size, size_t new_size, size_t align, bool may_move) {
+    (void) block;
+    (void) old_size;
+    (void) new_size;
+    (void) align;
+    (void) may_move;
+    return nullptr;
+}
+
+DefaultHeapAllocator::DefaultHeapAllocator() {}
+
+DefaultHeapAllocator::DefaultHeapAllocator(bool mapped)
+    : mapped_(mapped && memory_mapping_supported()) {}
+
 DefaultHeapAllocator::~DefaultHeapAllocator() {}
 
 void* DefaultHeapAllocator::allocate_aligned(size_t size, size_t align) {
+    if (mapped_)
+        return tiro::vm::map_aligned(size, align);
     return tiro::vm::allocate_aligned(size, align);
 }
 
 void DefaultHeapAllocator::free_aligned(void* block, size_t size, size_t align) {
+    if (mapped_)
+        return tiro::vm::unmap_aligned(block, size, align);
     return tiro::vm::deallocate_aligned(block, size, align);
 }
 
+void* DefaultHeapAllocator::resize_aligned(
+    void* block, size_t old_size, size_t new_size, size_t align, bool may_move) {
+    if (mapped_)
+        return tiro::vm::remap_aligned(block, old_size, new_size, align, may_move);
+    return nullptr;
+}
+
 } // namespace tiro::vm
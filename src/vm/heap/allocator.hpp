@@ -18,16 +18,40 @@ public:
     /// Frees a block of memory previously allocated via `allocate_aligned`.
     /// `size` and `align` are the exact arguments used when allocating the block.
     virtual void free_aligned(void* block, size_t size, size_t align) = 0;
+
+    /// Attempts to resize a block previously allocated via `allocate_aligned` (or resized by this function)
+    /// without copying its contents. `old_size` and `align` are the current size and the alignment of the block.
+    /// If `may_move` is true, the block may be moved to a new address with the same alignment.
+    /// Returns the (possibly new) address of the block on success. Returns nullptr if the block cannot be resized,
+    /// in which case it remains valid and unchanged.
+    ///
+    /// The default implementation does not support resizing and always returns nullptr.
+    virtual void* resize_aligned(
+        void* block, size_t old_size, size_t new_size, size_t align, bool may_move);
 };
 
 /// Default implementation of HeapAllocator that uses appropriate system
 /// allocation functions for the current platform.
+///
+/// In mapped mode, blocks are mapped directly from the operating system instead (where supported).
+/// Blocks of at least `huge_page_size` bytes are then backed by transparent huge pages if possible,
+/// and blocks can be resized (and moved) without copying their contents.
 class DefaultHeapAllocator final : public HeapAllocator {
 public:
+    DefaultHeapAllocator();
+    explicit DefaultHeapAllocator(bool mapped);
     ~DefaultHeapAllocator();
 
+    /// Returns true if blocks are mapped directly from the operating system.
+    bool mapped() const { return mapped_; }
+
     virtual void* allocate_aligned(size_t size, size_t align) override;
     virtual void free_aligned(void* block, size_t size, size_t align) override;
+    virtual void* resize_aligned(
+        void* block, size_t old_size, size_t new_size, size_t align, bool may_move) override;
+
+private:
+    bool mapped_ = false;
 };
 
 } // namespace tiro::vm
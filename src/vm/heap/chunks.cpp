@@ -1,10 +1,24 @@
 #include "vm/heap/chunks.hpp"
 
+#include "common/bitops.hpp"
 #include "vm/heap/heap.hpp"
 #include "vm/objects/value.hpp"
 
+#include <new>
+
 namespace tiro::vm {
 
+std::string_view to_string(Region region) {
+    switch (region) {
+    case Region::Generic:
+        return "Generic";
+    case Region::Data:
+        return "Data";
+    }
+
+    TIRO_UNREACHABLE("invalid region");
+}
+
 NotNull<Page*> Page::from_address(const void* address, Heap& heap) {
     return from_address(address, heap.layout());
 }
@@ -59,10 +73,10 @@ PageLayout Page::compute_layout(size_t page_size) {
     return layout;
 }
 
-NotNull<Page*> Page::allocate(Heap& heap) {
+NotNull<Page*> Page::allocate(Heap& heap, Region region, u32 slot_cells) {
     auto& layout = heap.layout();
     void* block = heap.allocate_raw(layout.page_size, layout.page_size);
-    return TIRO_NN(new (block) Page(heap));
+    return TIRO_NN(new (block) Page(heap, region, slot_cells));
 }
 
 void Page::destroy(NotNull<Page*> page) {
@@ -82,11 +96,9 @@ BitsetView<Page::BitsetItem> Page::mark_bitmap() {
     return BitsetView(storage, cells_count());
 }
 
-void Page::sweep(SweepStats& stats, FreeSpace& free_space) {
-    // Invoke all finalizers for objects that have not been marked.
-    // This is not very efficient (improvement: separate pages for objects with finalizers?)
-    // but it will do for now.
-    invoke_finalizers();
+u32 Page::sweep(std::vector<Span<Cell>>& free_blocks) {
+    if (slot_cells_ != 0)
+        return sweep_slots();
 
     // Optimized sweep that runs through the block & mark bitmaps using efficient block operations.
     //
@@ -101,7 +113,7 @@ void Page::sweep(SweepStats& stats, FreeSpace& free_space) {
     //
     // The needed transitions are:
     //   10 -> 01   (note: coalesce free blocks to 00 if the previous is also free)
-    //   11 -> 10
+    //   11 -> 10   (note: live blocks are marked again after the free list was rebuilt)
     //   00 -> 00
     //   01 -> 01   (note: coalesce free blocks to 00 if the previous is also free)
     // which can all be implemented using '&' and '^', see below.
@@ -111,12 +123,17 @@ void Page::sweep(SweepStats& stats, FreeSpace& free_space) {
         auto block = block_bitmap_storage();
         auto mark = mark_bitmap_storage();
         TIRO_DEBUG_ASSERT(block.size() == mark.size(), "bitmaps must have the same size");
+
+        // The page has been idle since the last sweep if it contains no (live or dead) blocks at all.
+        BitsetItem any_block = 0;
         for (size_t i = 0, n = block.size(); i < n; ++i) {
+            any_block |= block[i];
             auto new_block = block[i] & mark[i];
             auto new_mark = block[i] ^ mark[i];
             mark[i] = new_mark;
             block[i] = new_block;
         }
+        idle_cycles_ = any_block ? 0 : idle_cycles_ + 1;
     }
 
     // Rebuild the free list.
@@ -127,7 +144,7 @@ void Page::sweep(SweepStats& stats, FreeSpace& free_space) {
     //
     // This step could probably be merged into the last loop for even
     // better cache efficiency, with some additional smarts? Might not be worth it, however ..
-    size_t free_cells = 0;
+    u32 free_cells = 0;
     {
         auto block = block_bitmap();
         auto mark = mark_bitmap();
@@ -142,9 +159,9 @@ void Page::sweep(SweepStats& stats, FreeSpace& free_space) {
                                                              : total_cells - current_free;
             TIRO_DEBUG_ASSERT(free_size > 0, "empty free block");
 
-            // register the coalesced block with the free space.
-            free_space.insert_free(cells().subspan(current_free, free_size));
-            free_cells += free_size;
+            // the coalesced block is registered with the free space by the caller.
+            free_blocks.push_back(cells().subspan(current_free, free_size));
+            free_cells += static_cast<u32>(free_size);
 
             // clear the mark bit for free blocks that follow the initial free block.
             // this coalesces them with their predecessor as far as the bitmaps are concerned.
@@ -157,8 +174,84 @@ void Page::sweep(SweepStats& stats, FreeSpace& free_space) {
         }
     }
     TIRO_DEBUG_ASSERT(free_cells <= cells_count(), "free count is too large");
-    stats.free_cells = free_cells;
-    stats.allocated_cells = cells_count() - free_cells;
+
+    // Live blocks (10 after the transition above) become marked again (11), which
+    // promotes them to the old generation.
+    {
+        auto block = block_bitmap_storage();
+        auto mark = mark_bitmap_storage();
+        for (size_t i = 0, n = block.size(); i < n; ++i)
+            mark[i] |= block[i];
+    }
+
+    return free_cells;
+}
+
+u32 Page::sweep_slots() {
+    // Free slots are not coalesced, they simply remain "00" (like block extents).
+    // Dead objects (10) become free (00), live objects (11) are not touched.
+    u32 allocated = 0;
+    {
+        auto block = block_bitmap_storage();
+        auto mark = mark_bitmap_storage();
+
+        BitsetItem any_block = 0;
+        for (size_t i = 0, n = block.size(); i < n; ++i) {
+            any_block |= block[i];
+            block[i] &= mark[i];
+            allocated += popcount(block[i]);
+        }
+        idle_cycles_ = any_block ? 0 : idle_cycles_ + 1;
+    }
+    next_slot_ = 0;
+
+    TIRO_DEBUG_ASSERT(allocated * slot_cells_ <= slot_end_, "allocated count is too large");
+    return slot_end_ - allocated * slot_cells_;
+}
+
+Cell* Page::allocate_slot() {
+    TIRO_DEBUG_ASSERT(slot_cells_ != 0, "page is not divided into slots");
+
+    auto block = block_bitmap();
+    for (u32 index = next_slot_; index < slot_end_; index += slot_cells_) {
+        if (!block.test(index)) {
+            TIRO_DEBUG_ASSERT(!mark_bitmap().test(index), "free slots must not be marked");
+            block.set(index);
+            next_slot_ = index + slot_cells_;
+            return cell(index);
+        }
+    }
+    next_slot_ = slot_end_;
+    return nullptr;
+}
+
+void Page::clear_marks() {
+    // 11 -> 10 for marked blocks, free blocks (01) and extents (00) are not affected.
+    auto block = block_bitmap_storage();
+    auto mark = mark_bitmap_storage();
+    for (size_t i = 0, n = block.size(); i < n; ++i)
+        mark[i] &= ~block[i];
+    live_cells_ = 0;
+}
+
+void Page::reassign(Region region, u32 slot_cells) {
+    TIRO_DEBUG_ASSERT(block_bitmap().find_set() == BitsetView<BitsetItem>::npos,
+        "only empty pages can be reassigned");
+    TIRO_DEBUG_ASSERT(finalizers_.empty(), "empty pages must not have finalizers");
+
+    // Removes the free block metadata of pages without slots.
+    auto marks = mark_bitmap_storage();
+    std::fill(marks.begin(), marks.end(), 0);
+
+    set_region(region);
+    set_slot_cells(slot_cells);
+}
+
+void Page::set_slot_cells(u32 slot_cells) {
+    TIRO_DEBUG_ASSERT(slot_cells <= cells_count(), "slot size is too large");
+    slot_cells_ = slot_cells;
+    slot_end_ = slot_cells != 0 ? (cells_count() / slot_cells) * slot_cells : 0;
+    next_slot_ = 0;
 }
 
 void Page::invoke_finalizers() {
@@ -268,13 +361,15 @@ const PageLayout& Page::layout() const {
     return heap().layout();
 }
 
-Page::Page(Heap& heap)
-    : Chunk(ChunkType::Page, heap) {
+Page::Page(Heap& heap, Region region, u32 slot_cells)
+    : Chunk(ChunkType::Page, region, heap) {
     auto blocks = block_bitmap_storage();
     std::uninitialized_fill(blocks.begin(), blocks.end(), 0);
 
     auto marks = mark_bitmap_storage();
     std::uninitialized_fill(marks.begin(), marks.end(), 0);
+
+    set_slot_cells(slot_cells);
 }
 
 Page::~Page() {}
@@ -300,14 +395,14 @@ NotNull<LargeObject*> LargeObject::from_address(const void* address) {
     return TIRO_NN(const_cast<LargeObject*>(lob));
 }
 
-NotNull<LargeObject*> LargeObject::allocate(Heap& heap, u32 cells) {
+NotNull<LargeObject*> LargeObject::allocate(Heap& heap, u32 cells, Region region) {
     TIRO_DEBUG_ASSERT(cells > 0, "zero sized allocation");
 
     void* block = heap.allocate_raw(dynamic_size(cells), cell_align);
     if (!block)
         TIRO_ERROR("failed to allocate large object chunk");
 
-    return TIRO_NN(new (block) LargeObject(heap, cells));
+    return TIRO_NN(new (block) LargeObject(heap, cells, region));
 }
 
 size_t LargeObject::dynamic_size(u32 cells) {
@@ -321,6 +416,21 @@ void LargeObject::destroy(NotNull<LargeObject*> lob) {
         sizeof(LargeObject) + lob->cells_count() * sizeof(Cell), cell_align);
 }
 
+LargeObject* LargeObject::resize(NotNull<LargeObject*> lob, u32 cells, bool may_move) {
+    TIRO_DEBUG_ASSERT(cells > 0, "zero sized allocation");
+
+    auto& heap = lob->heap();
+    void* block = heap.resize_raw(static_cast<void*>(lob.get()), lob->dynamic_size(),
+        dynamic_size(cells), cell_align, may_move);
+    if (!block)
+        return nullptr;
+
+    // The chunk header has been moved (or kept) by the allocator.
+    auto resized = std::launder(static_cast<LargeObject*>(block));
+    resized->cells_count_ = cells;
+    return resized;
+}
+
 Span<Cell> LargeObject::cells() {
     return Span(cell(), cells_count_);
 }
@@ -11,6 +11,9 @@
 
 #include "absl/container/flat_hash_set.h"
 
+#include <string_view>
+#include <vector>
+
 namespace tiro::vm {
 
 /// Represents the type of a heap allocated chunk.
@@ -23,6 +26,23 @@ enum class ChunkType : u8 {
     LargeObject,
 };
 
+/// Objects are segregated into regions depending on the properties of their type.
+/// All objects within a chunk belong to the chunk's region. See `design/heap.md`.
+enum class Region : u8 {
+    /// Objects that may contain references to other objects or that have finalizers.
+    Generic,
+
+    /// Objects without references and without finalizers, e.g. strings or buffers.
+    /// The collector marks these objects but never traces them.
+    Data,
+};
+
+/// The number of distinct regions.
+inline constexpr size_t region_count = 2;
+
+/// Returns the name of the given region.
+std::string_view to_string(Region region);
+
 /// Common base class of page and large object chunk.
 class alignas(cell_size) Chunk {
 public:
@@ -32,16 +52,23 @@ public:
     /// Returns the type of this chunk.
     ChunkType type() const { return type_; }
 
+    /// Returns the region of the objects in this chunk.
+    Region region() const { return region_; }
+
     /// Returns the heap that this chunk belongs to.
     Heap& heap() const { return heap_; }
 
 protected:
-    explicit Chunk(ChunkType type, Heap& heap)
+    explicit Chunk(ChunkType type, Region region, Heap& heap)
         : type_(type)
+        , region_(region)
         , heap_(heap) {}
 
+    void set_region(Region region) { region_ = region; }
+
 private:
     ChunkType type_;
+    Region region_;
     Heap& heap_;
 };
 
@@ -86,6 +113,11 @@ struct PageLayout {
 
 /// Page are used to allocate most objects.
 ///
+/// Pages either provide free blocks of any size (registered with the heap's free space)
+/// or they are divided into slots of a fixed size (size class pages).
+/// A slot is free if the block bit of its first cell is not set; size class pages do not use
+/// free blocks, the block bitmap alone tracks their occupancy.
+///
 /// Internal page layout:
 /// - Header (the Page class itself), aligned to CellSize
 /// - Block bitmap (integer array), aligned to CellSize
@@ -109,7 +141,10 @@ public:
     static NotNull<Page*> from_address(const void* address, const PageLayout& layout);
 
     /// Allocates a page for the provided heap, using the heap's allocator and page layout.
-    static NotNull<Page*> allocate(Heap& heap);
+    /// All objects allocated from the page belong to the given region.
+    /// The page is divided into slots of `slot_cells` cells, unless `slot_cells` is zero.
+    static NotNull<Page*> allocate(
+        Heap& heap, Region region = Region::Generic, u32 slot_cells = 0);
 
     /// Destroys a page.
     static void destroy(NotNull<Page*> page);
@@ -120,22 +155,58 @@ public:
     /// Returns a view over this page's mark bitmap.
     BitsetView<BitsetItem> mark_bitmap();
 
-    struct SweepStats {
-        u32 allocated_cells = 0;
-        u32 free_cells = 0;
-    };
-
-    /// Sweeps this page after the heap was traced. Invoked by the garbage collector.
+    /// Sweeps this page after the heap was traced. Invoked by the heap's sweeper.
     ///
     /// Visits all unmarked (dead) blocks in this page, coalesces neighboring free blocks,
-    /// and then registers them with the free space.
-    /// Marked (live) blocks are not touched.
-    /// As a side effect, all blocks within this page are reset to `unmarked`.
-    void sweep(SweepStats& stats, FreeSpace& free_space);
+    /// and appends them to `free_blocks`. The caller must register them with the free space.
+    /// Size class pages only clear the block bits of dead objects, their free slots are found
+    /// by `allocate_slot()`.
+    /// Marked (live) blocks are not touched and remain marked: mark bits are "sticky"
+    /// and identify objects of the old generation until `clear_marks()` is called.
+    ///
+    /// Finalizers of dead objects must have been invoked already (see `invoke_finalizers()`).
+    /// This function only accesses the page's bitmaps, it may be called from a helper thread
+    /// as long as no other thread accesses the same page.
+    ///
+    /// Returns the total number of free cells in this page.
+    u32 sweep(std::vector<Span<Cell>>& free_blocks);
+
+    /// Moves this page into a different region and changes its slot size (zero for a page without slots).
+    /// All cells are left without any block metadata.
+    /// \pre the page must be completely empty (e.g. freshly swept without any live objects).
+    void reassign(Region region, u32 slot_cells);
+
+    /// Returns the size of the slots in this page (in cells), or zero if this page is not
+    /// divided into slots.
+    u32 slot_cells() const { return slot_cells_; }
+
+    /// Returns the number of cells that can be used for objects. This is less than `cells_count()`
+    /// for size class pages whose cells are not a multiple of the slot size.
+    u32 usable_cells() { return slot_cells_ != 0 ? slot_end_ : cells_count(); }
+
+    /// Allocates the next free slot in this page. Slots are handed out in address order, starting
+    /// after the slot allocated last. Returns nullptr if there are no free slots after that position.
+    /// The position is reset by `sweep()`.
+    /// \pre the page must be divided into slots.
+    Cell* allocate_slot();
+
+    /// Returns the number of consecutive sweeps that found this page completely empty, without
+    /// any allocations in between. Used by the heap to release unused pages.
+    u32 idle_cycles() const { return idle_cycles_; }
+
+    /// Resets all allocated blocks within this page to `unmarked`.
+    /// Called by the garbage collector before a major collection traces the entire heap.
+    void clear_marks();
+
+    /// Returns the number of cells occupied by objects marked since the last call to `clear_marks()`.
+    /// After a major collection, this is the number of cells used by live objects.
+    u32 live_cells() const { return live_cells_; }
+
+    /// Called by the collector when an object of the given size (in cells) has been marked.
+    void add_live_cells(u32 cells) { live_cells_ += cells; }
 
     /// Invoke the finalizers of unmarked objects.
-    /// This is usually called automatically from sweep(), but it is also called directly
-    /// when the heap is shutting down.
+    /// Called by the heap for all pages before they are swept, and when the heap is shutting down.
     void invoke_finalizers();
 
     /// Returns a span over this page's cell array.
@@ -203,15 +274,30 @@ public:
     const PageLayout& layout() const;
 
 private:
-    explicit Page(Heap& heap);
+    explicit Page(Heap& heap, Region region, u32 slot_cells);
     ~Page();
 
     Span<BitsetItem> block_bitmap_storage();
     Span<BitsetItem> mark_bitmap_storage();
 
+    void set_slot_cells(u32 slot_cells);
+    u32 sweep_slots();
+
 private:
     // Set of cell indices that contain objects that must be finalized.
     absl::flat_hash_set<u32> finalizers_;
+
+    // See idle_cycles().
+    u32 idle_cycles_ = 0;
+
+    // See live_cells().
+    u32 live_cells_ = 0;
+
+    // See slot_cells(). `slot_end_` is the first cell index after the last slot, `next_slot_` the
+    // index of the next slot inspected by allocate_slot().
+    u32 slot_cells_ = 0;
+    u32 slot_end_ = 0;
+    u32 next_slot_ = 0;
 };
 static_assert(alignof(Page) == cell_align);
 
@@ -224,7 +310,8 @@ public:
 
     /// Allocates a new large object chunk for the given heap.
     /// The chunk will have exactly `cells_count` cells available.
-    static NotNull<LargeObject*> allocate(Heap& heap, u32 cells_count);
+    static NotNull<LargeObject*> allocate(
+        Heap& heap, u32 cells_count, Region region = Region::Generic);
 
     /// Returns the number of bytes that must be allocated to accommodate the given amount of cells.
     static size_t dynamic_size(u32 cells);
@@ -232,6 +319,11 @@ public:
     /// Destroys a large object chunk.
     static void destroy(NotNull<LargeObject*> lob);
 
+    /// Attempts to resize a large object chunk to `cells_count` cells without copying its contents
+    /// (see `HeapAllocator::resize_aligned()`). The chunk may be moved to a new address if `may_move` is true.
+    /// Returns the resized chunk on success. Returns nullptr on failure, in which case `lob` remains unchanged.
+    static LargeObject* resize(NotNull<LargeObject*> lob, u32 cells_count, bool may_move);
+
     /// Returns a span over the object stored in this chunk.
     Span<Cell> cells();
 
@@ -261,8 +353,8 @@ public:
     void invoke_finalizer();
 
 private:
-    explicit LargeObject(Heap& heap, u32 cells)
-        : Chunk(ChunkType::LargeObject, heap)
+    explicit LargeObject(Heap& heap, u32 cells, Region region)
+        : Chunk(ChunkType::LargeObject, region, heap)
         , cells_count_(cells) {}
 
 private:
@@ -11,6 +11,13 @@
 
 #include "vm/root_set.ipp"
 
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
 #if 0
 #    define TIRO_TRACE_COLLECTOR(...) fmt::print("collector: " __VA_ARGS__);
 #else
@@ -19,7 +26,12 @@
 
 namespace tiro::vm {
 
-static size_t compute_next_threshold(size_t last_threshold, size_t current_heap_size);
+// Minimum number of sparsely populated pages that make a compaction worthwhile.
+static constexpr size_t min_sparse_pages = 2;
+
+// Maximum number of trailing slots (e.g. array elements) visited at once when tracing an object.
+// Larger objects are traced in multiple steps.
+static constexpr size_t mark_chunk_slots = 512;
 
 template<typename TimePoint>
 static double elapsed_ms(TimePoint start, TimePoint end);
@@ -32,43 +44,46 @@ std::string_view to_string(GcReason trigger) {
         return "Forced";
     case GcReason::AllocFailure:
         return "AllocFailure";
+    case GcReason::Compaction:
+        return "Compaction";
     }
 
     TIRO_UNREACHABLE("invalid gc reason");
 }
 
-Collector::Collector(Heap& heap)
-    : heap_(heap) {}
+double PauseHistogram::upper_bound(size_t index) {
+    TIRO_DEBUG_ASSERT(index < bucket_count, "bucket index out of bounds");
+    if (index == bucket_count - 1)
+        return std::numeric_limits<double>::infinity();
+    return std::ldexp(0.064, static_cast<int>(index));
+}
 
-Collector::~Collector() {}
+void PauseHistogram::record(double duration) {
+    size_t index = 0;
+    while (index < bucket_count - 1 && duration >= upper_bound(index))
+        ++index;
 
-void Collector::collect([[maybe_unused]] GcReason reason) {
-    TIRO_DEBUG_ASSERT(!running_, "collector is already running");
-    running_ = true;
-    ScopeExit reset_running = [&]() { running_ = false; };
-
-    [[maybe_unused]] const size_t size_before_collect = heap_.stats().allocated_bytes;
-    [[maybe_unused]] const size_t objects_before_collect = heap_.stats().allocated_objects;
-    TIRO_TRACE_COLLECTOR("Invoking collect() at heap size {} ({} objects). Reason: {}.\n",
-        size_before_collect, objects_before_collect, to_string(reason));
+    buckets_[index] += 1;
+    count_ += 1;
+    total_ += duration;
+    max_ = std::max(max_, duration);
+}
 
-    const auto start = std::chrono::steady_clock::now();
-    {
-        if (roots_)
-            trace(*roots_);
-        sweep(heap_);
+std::string GcStats::live_types_json() const {
+    std::vector<std::pair<ValueType, GcTypeStats>> types;
+    for (size_t i = 0; i < live_types.size(); ++i) {
+        if (live_types[i].objects > 0)
+            types.emplace_back(static_cast<ValueType>(i), live_types[i]);
     }
-    [[maybe_unused]] const auto duration = last_duration_ = elapsed_ms(
-        start, std::chrono::steady_clock::now());
-
-    [[maybe_unused]] const size_t size_after_collect = heap_.stats().allocated_bytes;
-    [[maybe_unused]] const size_t objects_after_collect = heap_.stats().allocated_objects;
-    next_threshold_ = compute_next_threshold(next_threshold_, size_after_collect);
+    std::stable_sort(types.begin(), types.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.second.bytes > rhs.second.bytes; });
 
-    TIRO_TRACE_COLLECTOR(
-        "Collection took {} ms. New heap size is {} ({} objects). Next "
-        "auto-collect at heap size {}.\n",
-        duration, size_after_collect, objects_after_collect, next_threshold_);
+    nlohmann::ordered_json result = nlohmann::ordered_json::array();
+    for (const auto& [type, stats] : types) {
+        result.push_back(
+            {{"type", to_string(type)}, {"objects", stats.objects}, {"bytes", stats.bytes}});
+    }
+    return result.dump();
 }
 
 class Collector::Tracer final {
@@ -79,8 +94,25 @@ public:
     Tracer(const Tracer&) = delete;
     Tracer& operator=(const Tracer&) = delete;
 
+    /// Called before the given object is traced. If `offset` is not zero, the object has already been
+    /// traced partially: only its trailing slots, starting from `offset`, are visited.
+    void enter(Header* object, size_t offset) {
+        object_ = object;
+        offset_ = offset;
+    }
+
+    /// Called after an object has been traced.
+    void leave() {
+        object_ = nullptr;
+        offset_ = 0;
+    }
+
     /// Public entry point 1: Single value.
-    void operator()(Value& value) { collector_.mark(value); }
+    void operator()(Value& value) {
+        // The static slots of partially traced objects have been visited already.
+        if (offset_ == 0)
+            collector_.mark(value);
+    }
 
     /// Public entry point 2: Special case for fat hash table entries.
     void operator()(HashTableEntry& value) {
@@ -90,39 +122,656 @@ public:
     /// Public entry point 3: Array support.
     template<typename T>
     void operator()(Span<T> values) {
-        // TODO: Could be optimized for large arrays by not pushing every item on the stack;
-        //       push an array visitor instead.
+        // Large arrays are visited in chunks. The rest of the array is pushed onto the mark stack
+        // before the current chunk, so the stack holds at most one item per partially traced object.
+        // Spans outside of objects (e.g. in the root set) are visited at once.
+        const size_t start = std::exchange(offset_, 0);
+        size_t end = values.size();
+        if (object_ && end > start && end - start > mark_chunk_slots) {
+            end = start + mark_chunk_slots;
+            collector_.push(object_, end);
+        }
+        for (size_t i = start; i < end; ++i) {
+            operator()(values[i]);
+        }
+    }
+
+private:
+    Collector& collector_;
+    Header* object_ = nullptr;
+    size_t offset_ = 0;
+};
+
+// Replaces references to evacuated objects with their new location.
+class Collector::ForwardingTracer final {
+public:
+    ForwardingTracer() = default;
+
+    ForwardingTracer(const ForwardingTracer&) = delete;
+    ForwardingTracer& operator=(const ForwardingTracer&) = delete;
+
+    void operator()(Value& value) {
+        if (value.is_null() || !value.is_heap_ptr())
+            return;
+
+        Header* header = static_cast<HeapValue>(value).heap_ptr();
+        if (header->forwarded()) {
+            value = HeapValue(header->forwarding_address());
+            ++updated_;
+        }
+    }
+
+    void operator()(HashTableEntry& value) { value.trace(*this); }
+
+    template<typename T>
+    void operator()(Span<T> values) {
         for (auto& v : values) {
             operator()(v);
         }
     }
 
+    // Number of updated references.
+    size_t updated() const { return updated_; }
+
 private:
-    Collector& collector_;
+    size_t updated_ = 0;
+};
+
+// Reports every visited reference to a callback.
+class Collector::ReferenceTracer final {
+public:
+    explicit ReferenceTracer(FunctionRef<void(Value&)> fn)
+        : fn_(fn) {}
+
+    ReferenceTracer(const ReferenceTracer&) = delete;
+    ReferenceTracer& operator=(const ReferenceTracer&) = delete;
+
+    void operator()(Value& value) { fn_(value); }
+
+    void operator()(HashTableEntry& value) { value.trace(*this); }
+
+    template<typename T>
+    void operator()(Span<T> values) {
+        for (auto& v : values) {
+            operator()(v);
+        }
+    }
+
+private:
+    FunctionRef<void(Value&)> fn_;
 };
 
-void Collector::trace(RootSet& roots) {
+Collector::Collector(Heap& heap)
+    : heap_(heap) {}
+
+Collector::~Collector() {
+    if (marking_)
+        marking_collectors_ -= 1;
+}
+
+void Collector::incremental(std::chrono::microseconds slice_budget, size_t slice_allocation) {
+    TIRO_CHECK(slice_budget.count() >= 0, "the slice budget must not be negative");
+    TIRO_CHECK(slice_allocation > 0, "the slice allocation must be positive");
+    slice_budget_ = slice_budget;
+    slice_allocation_ = slice_allocation;
+}
+
+void Collector::policy(const GcPolicy& policy) {
+    TIRO_CHECK(policy.min_nursery_bytes > 0, "the minimum nursery size must be positive");
+    TIRO_CHECK(policy.heap_growth >= 0, "the heap growth factor must not be negative");
+    TIRO_CHECK(policy.gc_time_ratio >= 0 && policy.gc_time_ratio <= 1,
+        "the gc time ratio must be in [0, 1]");
+    TIRO_CHECK(policy.heap_headroom >= 0 && policy.heap_headroom < 1,
+        "the heap headroom must be in [0, 1)");
+    policy_ = policy;
+}
+
+void Collector::evacuation(double threshold) {
+    TIRO_CHECK(threshold >= 0 && threshold <= 1, "the evacuation threshold must be in [0, 1]");
+    evacuation_threshold_ = threshold;
+}
+
+void Collector::collect(GcReason reason) {
+    TIRO_DEBUG_ASSERT(!running_, "collector is already running");
+
+    if (marking_) {
+        if (reason == GcReason::Automatic) {
+            step();
+            return;
+        }
+
+        // Other collections must complete immediately. The marking work done so far is discarded.
+        abort_marking();
+    }
+
+    // The mark bits of pages that have not been swept yet still belong to the previous cycle.
+    heap_.finish_sweep();
+
+    // Automatic collections only trace the young generation, unless the old generation
+    // has grown too much since the last major collection.
+    const bool major = reason != GcReason::Automatic || old_bytes_ >= major_threshold_;
+    if (major && reason == GcReason::Automatic && slice_budget_.count() > 0) {
+        start_marking();
+        return;
+    }
+
+    running_ = true;
+    ScopeExit reset_running = [&]() { running_ = false; };
+
+    [[maybe_unused]] const size_t size_before_collect = heap_.stats().allocated_bytes;
+    [[maybe_unused]] const size_t objects_before_collect = heap_.stats().allocated_objects;
+    TIRO_TRACE_COLLECTOR("Invoking {} collect() at heap size {} ({} objects). Reason: {}.\n",
+        major ? "major" : "minor", size_before_collect, objects_before_collect, to_string(reason));
+
+    begin_event(reason, major, false);
+    const auto start = std::chrono::steady_clock::now();
+    {
+        if (major)
+            heap_.clear_marks();
+
+        marked_ = 0;
+        marked_bytes_ = 0;
+        marked_types_ = {};
+        if (roots_)
+            trace(*roots_, major);
+        event_.mark_duration = elapsed_ms(start, std::chrono::steady_clock::now());
+
+        // Free blocks in the selected pages are not registered with the free space by the sweep,
+        // evacuated objects are moved to other pages instead.
+        const bool evacuating = reason == GcReason::Compaction && evacuation_threshold_ > 0
+                                && heap_.begin_evacuation(sparse_pages());
+        complete(major);
+        if (evacuating)
+            evacuate();
+    }
+    const auto duration = elapsed_ms(start, std::chrono::steady_clock::now());
+    stats_.pauses.record(duration);
+    update_thresholds(major, duration);
+    end_event(duration);
+
+    TIRO_TRACE_COLLECTOR("Collection took {} ms. Next auto-collect at heap size {}.\n", duration,
+        next_threshold_);
+}
+
+void Collector::step() {
+    TIRO_DEBUG_ASSERT(!running_, "collector is already running");
+    if (!marking_)
+        return;
+
+    mark_step(Clock::now());
+}
+
+void Collector::mark_step(Clock::time_point pause_start) {
+    running_ = true;
+    ScopeExit reset_running = [&]() { running_ = false; };
+
+    // Marking must keep up with the mutator: the remaining work is done without interruption if too
+    // much memory has been allocated since marking started.
+    const auto start = Clock::now();
+    const bool done = heap_.stats().allocated_bytes >= marking_limit_
+                          ? mark_slice(Clock::time_point::max())
+                          : mark_slice(start + slice_budget_);
+    TIRO_TRACE_COLLECTOR("Marking slice took {} ms ({} objects remaining).\n",
+        elapsed_ms(start, Clock::now()), mark_stack_.size());
+
+    if (done) {
+        finish_marking();
+        const auto end = Clock::now();
+        marking_duration_ += elapsed_ms(start, end);
+        event_.mark_duration = marking_duration_ - event_.sweep_duration;
+        stats_.pauses.record(elapsed_ms(pause_start, end));
+        update_thresholds(true, marking_duration_);
+        end_event(marking_duration_);
+    } else {
+        const auto end = Clock::now();
+        marking_duration_ += elapsed_ms(start, end);
+        stats_.pauses.record(elapsed_ms(pause_start, end));
+        next_threshold_ = heap_.stats().allocated_bytes + slice_allocation_;
+    }
+}
+
+void Collector::shade(Value value) {
+    TIRO_DEBUG_ASSERT(marking_, "must be marking");
+    mark(value);
+}
+
+void Collector::rescan(Header* object) {
+    TIRO_DEBUG_ASSERT(marking_, "must be marking");
+    if (is_marked(object))
+        push(object, 0);
+}
+
+void Collector::start_marking() {
+    TIRO_DEBUG_ASSERT(!marking_, "collector is already marking");
+    TIRO_DEBUG_ASSERT(mark_stack_.empty(), "mark stack must be empty");
+    TIRO_TRACE_COLLECTOR("Starting incremental marking at heap size {}.\n",
+        heap_.stats().allocated_bytes);
+
+    const auto start = Clock::now();
+    {
+        running_ = true;
+        ScopeExit reset_running = [&]() { running_ = false; };
+
+        begin_event(GcReason::Automatic, true, true);
+        const size_t size = heap_.stats().allocated_bytes;
+        marking_limit_ = limit_threshold(size + nursery_size(size), size);
+
+        heap_.clear_marks();
+        marked_ = 0;
+        marked_bytes_ = 0;
+        marked_types_ = {};
+        begin_weak_tables();
+        marking_ = true;
+        marking_collectors_ += 1;
+
+        // Roots are scanned again when marking completes, because they are modified without write barriers.
+        if (roots_) {
+            Tracer tracer{*this};
+            roots_->trace(tracer);
+        }
+        marking_duration_ = elapsed_ms(start, Clock::now());
+    }
+    mark_step(start);
+}
+
+bool Collector::mark_slice(Clock::time_point deadline) {
+    TIRO_DEBUG_ASSERT(marking_, "must be marking");
+
+    // Checking the clock after every object would be too expensive.
+    static constexpr size_t check_interval = 64;
+
+    Tracer tracer{*this};
+    size_t count = 0;
+    MarkItem item;
+    while (1) {
+        while (mark_stack_.pop(item)) {
+            trace_value(HeapValue(item.object), tracer, item.offset);
+
+            if (++count % check_interval == 0 && Clock::now() >= deadline)
+                return mark_stack_.empty() && !mark_stack_.overflowed();
+        }
+        if (!mark_stack_.overflowed())
+            return true;
+
+        rescan_marked(tracer);
+    }
+}
+
+void Collector::finish_marking() {
+    TIRO_DEBUG_ASSERT(marking_, "must be marking");
+    TIRO_DEBUG_ASSERT(running_, "must be running");
+
+    // Values stored in roots or coroutine stacks while marking was in progress have not been seen by
+    // the write barrier. All coroutine stacks marked so far are in the remembered set (see trace_value()).
+    Tracer tracer{*this};
+    if (roots_)
+        roots_->trace(tracer);
+    for (auto object : heap_.remembered_) {
+        TIRO_DEBUG_ASSERT(HeapValue(object).is<CoroutineStack>(),
+            "only coroutine stacks are remembered while marking");
+        trace_value(HeapValue(object), tracer);
+    }
+    trace_stack(tracer);
+    trace_ephemerons(tracer);
+
+    // Removing entries from weak tables writes to the tables, which must not trigger the incremental barrier.
+    marking_ = false;
+    marking_collectors_ -= 1;
+    clear_weak_tables();
+    ++incremental_cycles_;
+    complete(true);
+}
+
+void Collector::abort_marking() {
+    TIRO_DEBUG_ASSERT(marking_, "must be marking");
+    mark_stack_.clear();
+    weak_storages_.clear();
+    ephemerons_.clear();
+    marking_ = false;
+    marking_collectors_ -= 1;
+}
+
+void Collector::complete(bool major) {
+    // Segments allocated for a deep heap are not retained until the next cycle.
+    mark_stack_.trim();
+
+    const size_t allocated_bytes = heap_.stats().allocated_bytes;
+    allocated_since_ = allocated_bytes > old_bytes_ ? allocated_bytes - old_bytes_ : 0;
+
+    // All surviving objects have been promoted, the heap now consists of the old generation only.
+    old_objects_ = major ? marked_ : old_objects_ + marked_;
+    old_bytes_ = major ? marked_bytes_ : old_bytes_ + marked_bytes_;
+    heap_.update_allocated(old_objects_, old_bytes_);
+
+    if (major) {
+        stats_.live_types = marked_types_;
+    } else {
+        for (size_t i = 0; i < marked_types_.size(); ++i) {
+            stats_.live_types[i].objects += marked_types_[i].objects;
+            stats_.live_types[i].bytes += marked_types_[i].bytes;
+        }
+    }
+
+    const auto sweep_start = Clock::now();
+    sweep(heap_);
+    event_.sweep_duration = elapsed_ms(sweep_start, Clock::now());
+
+    if (major)
+        compaction_due_ = evacuation_threshold_ > 0 && sparse_pages().size() >= min_sparse_pages;
+    ++cycles_;
+    if (!major)
+        ++minor_cycles_;
+
+    TIRO_TRACE_COLLECTOR("New heap size is {} ({} objects).\n", old_bytes_,
+        heap_.stats().allocated_objects);
+}
+
+void Collector::begin_event(GcReason reason, bool major, bool incremental) {
+    event_ = GcEvent();
+    event_.reason = reason;
+    event_.major = major;
+    event_.incremental = incremental;
+    event_.bytes_before = heap_.stats().allocated_bytes;
+    event_.objects_before = heap_.stats().allocated_objects;
+}
+
+void Collector::end_event(double duration) {
+    event_.duration = duration;
+    event_.bytes_after = heap_.stats().allocated_bytes;
+    event_.objects_after = heap_.stats().allocated_objects;
+    event_.pages = heap_.page_count();
+    event_.large_objects = heap_.large_object_count();
+    stats_.collections[static_cast<size_t>(event_.reason)] += 1;
+
+    last_event_ = event_;
+    if (on_collection_)
+        on_collection_(last_event_);
+}
+
+void Collector::update_thresholds(bool major, double duration) {
+    const auto now = Clock::now();
+    const double mutator_duration = elapsed_ms(last_cycle_end_, now) - duration;
+    last_cycle_end_ = now;
+    last_duration_ = duration;
+
+    // Smooth the allocation rate over a few cycles, a single short interval is not very meaningful.
+    if (mutator_duration > 0) {
+        const double rate = static_cast<double>(allocated_since_) / mutator_duration;
+        allocation_rate_ = allocation_rate_ > 0 ? (allocation_rate_ + rate) / 2 : rate;
+    }
+
+    const size_t live_bytes = old_bytes_;
+    next_threshold_ = limit_threshold(live_bytes + nursery_size(live_bytes), live_bytes);
+    if (major) {
+        major_threshold_ = limit_threshold(
+            std::max(policy_.min_nursery_bytes, live_bytes * 2), live_bytes);
+    }
+}
+
+size_t Collector::nursery_size(size_t live_bytes) const {
+    const size_t max_size = heap_.max_size();
+    double nursery = std::max(static_cast<double>(policy_.min_nursery_bytes),
+        static_cast<double>(live_bytes) * policy_.heap_growth);
+
+    // The mutator must run for at least `duration * (1 - ratio) / ratio` between two collections
+    // for the collector to stay within its share of the total time.
+    const double ratio = policy_.gc_time_ratio;
+    if (ratio > 0 && ratio < 1) {
+        const double min_interval = last_duration_ * (1 - ratio) / ratio;
+        nursery = std::max(nursery, allocation_rate_ * min_interval);
+    }
+    return nursery >= static_cast<double>(max_size) ? max_size : static_cast<size_t>(nursery);
+}
+
+size_t Collector::limit_threshold(size_t threshold, size_t live_bytes) const {
+    const size_t max_size = heap_.max_size();
+    if (threshold < live_bytes)
+        threshold = max_size; // Overflow
+    if (policy_.heap_headroom <= 0)
+        return threshold;
+
+    // Leaves at least half of the remaining space for new allocations if the live objects exceed the limit.
+    const size_t limit = static_cast<size_t>(static_cast<double>(max_size) * (1 - policy_.heap_headroom));
+    const size_t remaining = live_bytes < max_size ? (max_size - live_bytes) / 2 : 0;
+    return std::min(threshold, std::max(limit, live_bytes + remaining));
+}
+
+std::vector<Page*> Collector::sparse_pages() {
+    std::vector<Page*> pages;
+    const double max_live_cells = evacuation_threshold_ * heap_.layout().cells_size;
+    for (auto page : heap_.pages_) {
+        if (page->live_cells() > 0 && page->live_cells() < max_live_cells)
+            pages.push_back(page);
+    }
+    return pages;
+}
+
+void Collector::evacuate() {
+    TIRO_DEBUG_ASSERT(running_, "must be running");
+    heap_.finish_sweep();
+
+    // Objects referenced from external handles are pinned, their addresses may be in use by native code.
+    absl::flat_hash_set<Header*> pinned;
+    if (roots_) {
+        roots_->get_externals().trace([&](Value& value) {
+            if (!value.is_null() && value.is_heap_ptr())
+                pinned.insert(static_cast<HeapValue>(value).heap_ptr());
+        });
+    }
+
+    size_t moved = 0;
+    for (auto page : heap_.evacuating_) {
+        bool heap_full = false;
+        Heap::for_each_marked_object(page, [&](Header* object) {
+            if (heap_full || !is_movable(object) || pinned.contains(object))
+                return;
+            if (!heap_.evacuate(object)) {
+                heap_full = true;
+                return;
+            }
+            ++moved;
+        });
+        if (heap_full)
+            break;
+    }
+
+    if (moved > 0) {
+        // Visit all references in the heap and replace forwarded objects with their new location.
+        ForwardingTracer tracer;
+        if (roots_)
+            roots_->trace(tracer);
+        heap_.for_each_marked_generic_object(
+            [&](Header* object) { trace_value(HeapValue(object), tracer); });
+
+#ifdef TIRO_DEBUG
+        ForwardingTracer verifier;
+        if (roots_)
+            roots_->trace(verifier);
+        heap_.for_each_marked_generic_object(
+            [&](Header* object) { trace_value(HeapValue(object), verifier); });
+        TIRO_DEBUG_ASSERT(verifier.updated() == 0, "all references must have been updated");
+#endif
+    }
+
+    heap_.end_evacuation();
+    evacuated_objects_ += moved;
+    compaction_due_ = false;
+    TIRO_TRACE_COLLECTOR("Evacuated {} objects.\n", moved);
+}
+
+bool Collector::is_movable(Header* header) {
+    // Only objects without identity (hashed by value) or objects that are referenced only
+    // by their owner are moved. Other objects may be hashed by their address or may be referenced
+    // by raw pointers (e.g. code from coroutine frames).
+    HeapValue value(header);
+    switch (value.type()) {
+    case ValueType::ArrayStorage:
+    case ValueType::HashTableStorage:
+    case ValueType::HeapFloat:
+    case ValueType::HeapInteger:
+    case ValueType::String:
+        return true;
+    case ValueType::Buffer:
+        return !Buffer(value).is_pinned();
+    default:
+        return false;
+    }
+}
+
+void Collector::trace(RootSet& roots, bool major) {
     TIRO_DEBUG_ASSERT(running_, "must be running");
-    TIRO_DEBUG_ASSERT(to_trace_.empty(), "trace stack must be empty");
+    TIRO_DEBUG_ASSERT(mark_stack_.empty(), "mark stack must be empty");
+
+    begin_weak_tables();
 
     // Visit all root objects.
     // The tracer will call `mark(value)` for every value it encounters.
     Tracer tracer{*this};
     roots.trace(tracer);
 
+    // Old objects are not visited by a minor collection, except for those that
+    // may contain references to young objects.
+    if (!major)
+        trace_remembered(tracer);
+
     // Visit all reachable objects
-    size_t count = 0;
-    while (!to_trace_.empty()) {
-        Value value = to_trace_.back();
-        to_trace_.pop_back();
+    trace_stack(tracer);
+    trace_ephemerons(tracer);
+    clear_weak_tables();
+}
+
+void Collector::trace_stack(Tracer& tracer) {
+    MarkItem item;
+    while (1) {
+        while (mark_stack_.pop(item))
+            trace_value(HeapValue(item.object), tracer, item.offset);
+        if (!mark_stack_.overflowed())
+            break;
+
+        rescan_marked(tracer);
+    }
+}
+
+void Collector::rescan_marked(Tracer& tracer) {
+    // Some marked objects were dropped from the mark stack. Their unmarked children are found by
+    // tracing all marked objects again. Minor collections retain more objects than necessary
+    // in this case, because the children of old objects are marked as well.
+    TIRO_TRACE_COLLECTOR("Mark stack overflow, rescanning the heap.\n");
+    ++mark_stack_overflows_;
+    mark_stack_.reset_overflow();
+    heap_.for_each_marked_generic_object(
+        [&](Header* object) { trace_value(HeapValue(object), tracer); });
+}
+
+void Collector::push(Header* object, size_t offset) {
+    // The overflow is handled by `rescan_marked()` once the stack is empty.
+    mark_stack_.push(MarkItem{object, offset});
+}
+
+void Collector::trace_remembered(Tracer& tracer) {
+    std::vector<Header*> remembered;
+    remembered.swap(heap_.remembered_);
+
+    for (auto object : remembered) {
+        HeapValue value(object);
+
+        // Coroutine stacks are modified by the interpreter without write barriers,
+        // they remain in the remembered set and are visited by every minor collection.
+        if (value.is<CoroutineStack>()) {
+            heap_.remembered_.push_back(object);
+        } else {
+            object->remembered(false);
+        }
         trace_value(value, tracer);
-        ++count;
     }
-    heap_.update_allocated_objects(count);
+}
+
+void Collector::register_weak_table(Header* table) {
+    TIRO_DEBUG_ASSERT(HeapValue(table).is<HashTable>() && HashTable(HeapValue(table)).weak_keys(),
+        "object must be a weak hash table");
+    weak_tables_.push_back(table);
+}
+
+void Collector::replace_weak_entries(Header* table, Header* entries) {
+    TIRO_DEBUG_ASSERT(HeapValue(table).is<HashTable>() && HashTable(HeapValue(table)).weak_keys(),
+        "object must be a weak hash table");
+    if (marking_)
+        weak_storages_.insert_or_assign(entries, table);
+}
+
+void Collector::begin_weak_tables() {
+    weak_storages_.clear();
+    ephemerons_.clear();
+
+    // Entries of old weak tables may be traced without their table, e.g. when they are in the
+    // remembered set or when they are rescanned by the write barrier.
+    for (auto header : weak_tables_) {
+        HashTable table{HeapValue(header)};
+        if (auto entries = table.get_entries(table.layout()); entries.has_value())
+            weak_storages_.emplace(entries.value().heap_ptr(), header);
+    }
+}
+
+void Collector::visit_weak_table(Header* header) {
+    HashTable table{HeapValue(header)};
+    if (auto entries = table.get_entries(table.layout()); entries.has_value())
+        weak_storages_.emplace(entries.value().heap_ptr(), header);
+    ephemerons_.push_back(header);
+}
+
+void Collector::trace_ephemerons(Tracer& tracer) {
+    // Marking a value may make the keys of other entries reachable, so the
+    // tables are visited again until no new objects have been marked.
+    while (1) {
+        std::sort(ephemerons_.begin(), ephemerons_.end());
+        ephemerons_.erase(std::unique(ephemerons_.begin(), ephemerons_.end()), ephemerons_.end());
+
+        for (auto header : ephemerons_) {
+            HashTable(HeapValue(header)).for_each_unsafe([&](Value key, Value value) {
+                if (is_live(key))
+                    mark(value);
+            });
+        }
+        if (mark_stack_.empty() && !mark_stack_.overflowed())
+            break;
+
+        trace_stack(tracer);
+    }
+}
+
+void Collector::clear_weak_tables() {
+    size_t cleared = 0;
+    for (auto header : ephemerons_) {
+        cleared += HashTable(HeapValue(header)).remove_if(
+            [&](Value key, [[maybe_unused]] Value value) { return !is_live(key); });
+    }
+    cleared_weak_entries_ = cleared;
+    weak_storages_.clear();
+    ephemerons_.clear();
+
+    // Old tables that were not visited by a minor collection are still marked.
+    weak_tables_.erase(std::remove_if(weak_tables_.begin(), weak_tables_.end(),
+                           [&](Header* table) { return !is_marked(table); }),
+        weak_tables_.end());
+    TIRO_TRACE_COLLECTOR("Removed {} entries from weak tables.\n", cleared);
+}
+
+bool Collector::is_live(Value value) {
+    if (value.is_null() || !value.is_heap_ptr())
+        return true;
+    return is_marked(static_cast<HeapValue>(value).heap_ptr());
+}
+
+bool Collector::is_marked(Header* header) {
+    if (header->large_object())
+        return LargeObject::from_address(header)->is_marked();
+
+    auto page = Page::from_address(header, heap_);
+    return page->is_cell_marked(page->cell_index(header));
 }
 
 void Collector::mark(Value value) {
-    TIRO_DEBUG_ASSERT(running_, "must be running");
+    TIRO_DEBUG_ASSERT(running_ || marking_, "must be running");
 
     if (value.is_null() || !value.is_heap_ptr())
         return;
@@ -130,12 +779,16 @@ void Collector::mark(Value value) {
     Header* header = static_cast<HeapValue>(value).heap_ptr();
     TIRO_DEBUG_ASSERT(header, "invalid heap pointer");
 
+    size_t bytes = 0;
+    Region region;
     if (header->large_object()) {
         auto lob = LargeObject::from_address(header);
         if (lob->is_marked())
             return;
 
         lob->set_marked(true);
+        region = lob->region();
+        bytes = lob->cells_count() * cell_size;
     } else {
         auto page = Page::from_address(header, heap_);
         auto index = page->cell_index(header);
@@ -143,13 +796,34 @@ void Collector::mark(Value value) {
             return;
 
         page->set_cell_marked(index, true);
+        region = page->region();
+
+        const u32 cells = ceil_div(object_size(header), cell_size);
+        page->add_live_cells(cells);
+        bytes = cells * cell_size;
     }
 
-    to_trace_.push_back(value);
+    auto& type_stats = marked_types_[static_cast<size_t>(value.type())];
+    type_stats.objects += 1;
+    type_stats.bytes += bytes;
+    marked_bytes_ += bytes;
+
+    // Marked objects survive the collection and are promoted to the old generation.
+    header->old(true);
+    ++marked_;
+
+    // Objects in the data region do not contain any references, there is nothing to trace.
+    if (region != Region::Data)
+        push(header, 0);
 }
 
-void Collector::trace_value(Value value, Tracer& tracer) {
-    const auto trace_impl = [this, &tracer](auto concrete_value) {
+template<typename TracerType>
+void Collector::trace_value(Value value, TracerType& tracer, size_t offset) {
+    // Marking tracers (as opposed to the tracer that updates references after evacuation)
+    // must also visit the type and record coroutine stacks.
+    static constexpr bool marking = std::is_same_v<TracerType, Tracer>;
+
+    const auto trace_impl = [this, &tracer, offset](auto concrete_value) {
         using ConcreteValueType = remove_cvref_t<decltype(concrete_value)>;
 
         // Layout code is only valid for actual heap types.
@@ -157,6 +831,21 @@ void Collector::trace_value(Value value, Tracer& tracer) {
             using Layout = typename ConcreteValueType::Layout;
             using Traits = LayoutTraits<Layout>;
 
+            // The entries of weak tables are processed after all other reachable objects have been marked.
+            if constexpr (marking && std::is_same_v<ConcreteValueType, HashTable>) {
+                if (concrete_value.weak_keys())
+                    visit_weak_table(concrete_value.heap_ptr());
+            }
+            if constexpr (marking && std::is_same_v<ConcreteValueType, HashTableStorage>) {
+                if (!weak_storages_.empty()) {
+                    if (auto pos = weak_storages_.find(concrete_value.heap_ptr());
+                        pos != weak_storages_.end()) {
+                        ephemerons_.push_back(pos->second);
+                        return;
+                    }
+                }
+            }
+
             if constexpr (Traits::may_contain_references) {
                 // Visit the type instance of the current value, which is important for user defined types.
                 // It is fine to skip this if `may_contain_references` is false, because
@@ -164,12 +853,29 @@ void Collector::trace_value(Value value, Tracer& tracer) {
                 // through `TypeSystem::trace()`.
                 // NOTE: This also means that builtin type instances that represent objects without references (e.g. String type)
                 //       may never move.
-                // TODO: Do 'may_contain_references' on a page level before visiting the object itself?
-                mark(HeapValue(concrete_value.heap_ptr()->type()));
+                // Objects without references are allocated in the data region and are never
+                // pushed onto the mark stack (see `mark()`), so they usually do not end up here.
+                if constexpr (marking) {
+                    if (offset == 0)
+                        mark(HeapValue(concrete_value.heap_ptr()->type()));
+                }
 
                 const auto layout = concrete_value.layout();
                 TIRO_DEBUG_ASSERT(layout != nullptr, "pointer to heap value must not be null");
-                Traits::trace(layout, tracer); // ends up invoking mark again for visited values
+                if constexpr (marking) {
+                    tracer.enter(concrete_value.heap_ptr(), offset);
+                    Traits::trace(layout, tracer); // ends up invoking mark again for visited values
+                    tracer.leave();
+                } else {
+                    (void) offset;
+                    Traits::trace(layout, tracer);
+                }
+
+                if constexpr (marking && std::is_same_v<ConcreteValueType, CoroutineStack>) {
+                    Header* header = concrete_value.heap_ptr();
+                    if (!header->remembered())
+                        heap_.remember(header);
+                }
             }
         } else {
             (void) concrete_value;
@@ -202,7 +908,6 @@ void Collector::trace_value(Value value, Tracer& tracer) {
         TIRO_CASE(CoroutineToken)
         TIRO_CASE(Environment)
         TIRO_CASE(Exception)
-        TIRO_CASE(Float)
         TIRO_CASE(HandlerTable)
         TIRO_CASE(HashTable)
         TIRO_CASE(HashTableIterator)
@@ -211,8 +916,10 @@ void Collector::trace_value(Value value, Tracer& tracer) {
         TIRO_CASE(HashTableStorage)
         TIRO_CASE(HashTableValueIterator)
         TIRO_CASE(HashTableValueView)
+        TIRO_CASE(HeapFloat)
         TIRO_CASE(HeapInteger)
         TIRO_CASE(InternalType)
+        TIRO_CASE(LineTable)
         TIRO_CASE(MagicFunction)
         TIRO_CASE(Method)
         TIRO_CASE(Module)
@@ -225,6 +932,7 @@ void Collector::trace_value(Value value, Tracer& tracer) {
         TIRO_CASE(Result)
         TIRO_CASE(Set)
         TIRO_CASE(SetIterator)
+        TIRO_CASE(SmallFloat)
         TIRO_CASE(SmallInteger)
         TIRO_CASE(String)
         TIRO_CASE(StringBuilder)
@@ -236,24 +944,25 @@ void Collector::trace_value(Value value, Tracer& tracer) {
         TIRO_CASE(Type)
         TIRO_CASE(Undefined)
         TIRO_CASE(UnresolvedImport)
+        TIRO_CASE(WeakMap)
         // [[[end]]]
 #undef TIRO_CASE
     }
 }
 
-void Collector::sweep(Heap& heap) {
-    heap.sweep();
-}
-
-static size_t compute_next_threshold(size_t last_threshold, size_t current_heap_size) {
-    if (current_heap_size <= (last_threshold / 3) * 2) {
-        return last_threshold;
+void Collector::visit_references(Header* object, FunctionRef<void(Value&)> fn) {
+    TIRO_DEBUG_ASSERT(object, "invalid object");
+    if (Header* type = object->type()) {
+        Value type_value = HeapValue(type);
+        fn(type_value);
     }
 
-    if (current_heap_size > max_pow2<size_t>()) {
-        return size_t(-1);
-    }
-    return ceil_pow2_fast<size_t>(current_heap_size);
+    ReferenceTracer tracer(fn);
+    trace_value(HeapValue(object), tracer);
+}
+
+void Collector::sweep(Heap& heap) {
+    heap.sweep();
 }
 
 template<typename TimePoint>
@@ -1,10 +1,21 @@
 #ifndef TIRO_VM_HEAP_NEW_COLLECTOR_HPP
 #define TIRO_VM_HEAP_NEW_COLLECTOR_HPP
 
+#include "common/adt/function_ref.hpp"
+#include "common/assert.hpp"
 #include "common/defs.hpp"
 #include "vm/fwd.hpp"
 #include "vm/heap/fwd.hpp"
+#include "vm/heap/mark_stack.hpp"
+#include "vm/objects/types.hpp"
 
+#include "absl/container/flat_hash_map.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
 #include <vector>
 
 namespace tiro::vm {
@@ -19,12 +30,146 @@ enum class GcReason {
 
     /// triggered by previous allocation failure
     AllocFailure,
+
+    /// major collection that also evacuates sparsely populated pages (see `Collector::evacuation()`).
+    /// Objects are moved, so no unrooted values may exist when the collection is triggered.
+    Compaction,
 };
 
+inline constexpr size_t gc_reason_count = 4;
+
 std::string_view to_string(GcReason reason);
 
+/// Describes a completed collection cycle (see `Collector::on_collection()`).
+/// Durations are measured in milliseconds.
+struct GcEvent {
+    /// The reason that triggered the collection.
+    GcReason reason = GcReason::Automatic;
+
+    /// True if the entire heap was traced, false for minor collections.
+    bool major = false;
+
+    /// True if the heap was marked incrementally.
+    bool incremental = false;
+
+    /// Time spent marking reachable objects. Includes all slices of incremental collections.
+    double mark_duration = 0;
+
+    /// Time spent sweeping during the collection (large objects and finalizers).
+    /// Pages are swept lazily after the collection, that time is not included.
+    double sweep_duration = 0;
+
+    /// Total time spent in the collection cycle, including evacuation.
+    double duration = 0;
+
+    /// Size and number of allocated objects before and after the collection.
+    size_t bytes_before = 0;
+    size_t bytes_after = 0;
+    size_t objects_before = 0;
+    size_t objects_after = 0;
+
+    /// Number of pages and large objects owned by the heap after the collection.
+    size_t pages = 0;
+    size_t large_objects = 0;
+
+    /// Returns the number of bytes freed by the collection.
+    size_t freed_bytes() const {
+        return bytes_before > bytes_after ? bytes_before - bytes_after : 0;
+    }
+};
+
+/// Counts the duration of collector pauses in buckets of exponentially growing size.
+/// Every slice of an incremental collection counts as a separate pause.
+class PauseHistogram final {
+public:
+    /// The number of buckets. The last bucket counts all pauses that exceed the previous buckets.
+    static constexpr size_t bucket_count = 16;
+
+    /// Returns the (exclusive) upper bound of the given bucket, in milliseconds.
+    /// Bucket `i` ends at `0.064 * 2^i` milliseconds. The last bucket is unbounded (infinity).
+    static double upper_bound(size_t index);
+
+    /// Records a pause with the given duration (in milliseconds).
+    void record(double duration);
+
+    /// Returns the number of pauses in the given bucket.
+    size_t bucket(size_t index) const {
+        TIRO_DEBUG_ASSERT(index < bucket_count, "bucket index out of bounds");
+        return buckets_[index];
+    }
+
+    /// Returns the total number of recorded pauses.
+    size_t count() const { return count_; }
+
+    /// Returns the sum of all recorded pauses (in milliseconds).
+    double total() const { return total_; }
+
+    /// Returns the longest recorded pause (in milliseconds).
+    double max() const { return max_; }
+
+private:
+    std::array<size_t, bucket_count> buckets_{};
+    size_t count_ = 0;
+    double total_ = 0;
+    double max_ = 0;
+};
+
+/// Number and size of the live objects of a single type.
+struct GcTypeStats {
+    size_t objects = 0;
+    size_t bytes = 0;
+};
+
+/// Statistics accumulated by a collector over its lifetime.
+struct GcStats {
+    /// Number of completed collections, indexed by their reason.
+    std::array<size_t, gc_reason_count> collections{};
+
+    /// Durations of all collector pauses.
+    PauseHistogram pauses;
+
+    /// Live objects by type, indexed by `ValueType`. Computed by the last major collection,
+    /// objects promoted by minor collections since then have been added to the counts.
+    std::array<GcTypeStats, max_value_type + 1> live_types{};
+
+    /// Formats the live objects by type as a json document (types sorted by size).
+    std::string live_types_json() const;
+};
+
+/// Controls when automatic garbage collections are triggered.
+///
+/// After every collection, the collector computes the size of the next young generation (the number of
+/// bytes that may be allocated until the next automatic collection) as the maximum of
+///
+///  - `min_nursery_bytes`,
+///  - `heap_growth` times the size of the surviving objects and
+///  - the number of bytes the mutator allocates (at its recent allocation rate) in the time it must run
+///    for the collector to use at most `gc_time_ratio` of the total time.
+///
+/// The resulting threshold is limited so that `heap_headroom` (a fraction of the maximum heap size)
+/// remains free. Once the live objects exceed that limit, collections happen more frequently instead,
+/// leaving half of the remaining space for new allocations.
+struct GcPolicy {
+    /// Minimum number of bytes allocated between two automatic collections.
+    size_t min_nursery_bytes = size_t(1) << 20;
+
+    /// The heap may grow by this fraction of its live size before the next automatic collection.
+    double heap_growth = 0.25;
+
+    /// Target fraction of time spent in the garbage collector. The young generation grows when collections
+    /// take too long relative to the time spent running the program.
+    /// Zero disables this rule.
+    double gc_time_ratio = 0.05;
+
+    /// Fraction of the maximum heap size that automatic collections try to keep free.
+    /// Zero disables this rule.
+    double heap_headroom = 0.1;
+};
+
 class Collector final {
 public:
+    using Clock = std::chrono::steady_clock;
+
     /// Constructs a new heap.
     /// Note: references point to partially constructed objects and must not be dereferenced in this constructor.
     Collector(Heap& heap);
@@ -41,30 +186,231 @@ public:
 
     /// Collects garbage.
     /// Traces the heap by following references in `roots`.
-    /// After tracing is complete, sweeps free space in `heap`.
+    /// After tracing is complete, sweeps free space in `heap` (pages are swept lazily, see `Sweeper`).
+    ///
+    /// Automatic collections are usually minor collections, which only trace the young generation
+    /// (objects allocated since the last collection) and the objects in the heap's remembered set.
+    /// All other collections are major collections that trace the entire heap.
+    ///
+    /// If incremental marking is enabled (see `incremental()`), automatic major collections
+    /// start an incremental marking phase instead and return immediately. While marking
+    /// is in progress, automatic collections perform a slice of marking work (see `step()`).
+    /// Other collections abort the marking phase and run a complete major collection.
     void collect(GcReason reason);
 
+    /// Configures incremental marking. A single marking slice runs for at most `slice_budget`
+    /// (roughly, the tracing of a single object cannot be interrupted). The mutator may allocate
+    /// `slice_allocation` bytes before the next slice starts.
+    /// A zero `slice_budget` disables incremental marking (the default).
+    void incremental(std::chrono::microseconds slice_budget, size_t slice_allocation);
+
+    /// Returns the policy that controls automatic collections.
+    const GcPolicy& policy() const noexcept { return policy_; }
+
+    /// Replaces the policy that controls automatic collections.
+    /// The new policy applies from the next collection onwards.
+    void policy(const GcPolicy& policy);
+
+    /// Configures the evacuation of sparsely populated pages by collections with reason `GcReason::Compaction`.
+    /// Pages whose live objects occupy less than `threshold` (a fraction of the page size) are evacuated:
+    /// movable objects are copied to other pages and all references to them are updated.
+    /// A zero `threshold` disables evacuation (the default).
+    void evacuation(double threshold);
+
+    /// Returns true if the last major collection found enough sparsely populated pages to make
+    /// a compaction worthwhile. The owner of the heap should then trigger a collection with reason
+    /// `GcReason::Compaction` at a point where no unrooted values exist (e.g. between coroutines).
+    bool compaction_due() const noexcept { return compaction_due_; }
+
+    /// Performs a slice of marking work if an incremental marking phase is in progress.
+    /// The collection is completed (i.e. the heap is swept) once all reachable objects have been marked.
+    void step();
+
+    /// Returns true if an incremental marking phase is in progress.
+    bool marking() const noexcept { return marking_; }
+
+    /// Returns true if any collector (of any heap) is currently marking. Used by the write barrier
+    /// to skip the check for incremental marking in the common case.
+    static bool any_marking() noexcept {
+        return marking_collectors_.load(std::memory_order_relaxed) != 0;
+    }
+
+    /// Write barrier for incremental marking: ensures that `value` will be marked because
+    /// it has been stored into an object that may have been traced already.
+    /// \pre `marking()` must be true.
+    void shade(Value value);
+
+    /// Write barrier for incremental marking: ensures that the object will be traced (again) if it
+    /// has already been marked. Used when the stored values are not known.
+    /// \pre `marking()` must be true.
+    void rescan(Header* object);
+
     /// Returns true if the collector is currently running.
     bool running() const noexcept { return running_; }
 
+    /// Returns the number of completed collection cycles.
+    size_t cycles() const noexcept { return cycles_; }
+
+    /// Returns the number of completed minor collection cycles (a subset of `cycles()`).
+    size_t minor_cycles() const noexcept { return minor_cycles_; }
+
+    /// Returns the number of completed major collection cycles that used incremental marking
+    /// (a subset of `cycles()`).
+    size_t incremental_cycles() const noexcept { return incremental_cycles_; }
+
+    /// Returns the statistics accumulated by this collector.
+    const GcStats& stats() const noexcept { return stats_; }
+
+    /// Returns a description of the last completed collection cycle.
+    const GcEvent& last_event() const noexcept { return last_event_; }
+
+    /// Sets a callback that is invoked after every completed collection cycle.
+    /// The callback must not allocate objects on the heap.
+    void on_collection(std::function<void(const GcEvent& event)> callback) {
+        on_collection_ = std::move(callback);
+    }
+
+    /// Returns the number of objects moved by compactions.
+    size_t evacuated_objects() const noexcept { return evacuated_objects_; }
+
     /// Heap size (in bytes) at which the garbage collector should be invoked again.
-    /// TODO: Introduce another automatic trigger (such as elapsed time since last gc).
-    /// TODO: This is pretty naive.
+    /// Leaves room for a young generation that is computed by the collector's policy (see `GcPolicy`).
     size_t next_threshold() const noexcept { return next_threshold_; }
 
+    /// Returns the duration of the last completed collection cycle (in milliseconds).
+    /// For incremental collections, this is the sum of all marking slices.
+    double last_duration() const noexcept { return last_duration_; }
+
+    /// Returns the mutator's recent allocation rate (in bytes per millisecond), as observed between collections.
+    double allocation_rate() const noexcept { return allocation_rate_; }
+
+    /// Registers a hash table with weak keys (see `HashTable::make_weak()`).
+    /// The table is forgotten automatically once it has been collected.
+    ///
+    /// Entries of weak tables are treated as ephemerons: a value is marked only if its key has been
+    /// marked through some other path. Entries whose keys remain unmarked are removed from the table
+    /// when marking is complete.
+    void register_weak_table(Header* table);
+
+    /// Called when a weak table receives a new entries storage. While marking is in progress,
+    /// the storage is registered so that it is never traced strongly, even if it is reached
+    /// without its table (e.g. through a root). Does nothing otherwise.
+    void replace_weak_entries(Header* table, Header* entries);
+
+    /// Limits the memory used by the mark stack to the given number of segments (see `MarkStack`).
+    /// When the stack is full, marking continues by tracing all marked objects again, which
+    /// is slow but does not require any additional memory. Zero means that there is no limit (the default).
+    void mark_stack_limit(size_t segments) { mark_stack_.max_segments(segments); }
+
+    /// Returns the number of times the mark stack overflowed since the collector was created.
+    size_t mark_stack_overflows() const noexcept { return mark_stack_overflows_; }
+
+    /// Returns the number of entries removed from weak tables by the last collection.
+    size_t cleared_weak_entries() const noexcept { return cleared_weak_entries_; }
+
+    /// Invokes `fn` for every reference stored in the given object, using the same code that
+    /// traces objects during a collection. The object's type instance is reported first.
+    /// Non-heap values (e.g. small integers) are reported as well.
+    void visit_references(Header* object, FunctionRef<void(Value&)> fn);
+
 private:
     class Tracer;
+    class ForwardingTracer;
+    class ReferenceTracer;
 
     /// Entry point called when tracing starts.
-    void trace(RootSet& roots);
+    /// Only young objects are visited unless `major` is true.
+    void trace(RootSet& roots, bool major);
+
+    /// Visits the objects in the heap's remembered set (for minor collections).
+    void trace_remembered(Tracer& tracer);
+
+    /// Visits all objects on the mark stack (and all objects reachable from them).
+    void trace_stack(Tracer& tracer);
+
+    /// Recovers from a mark stack overflow by tracing all marked objects again.
+    void rescan_marked(Tracer& tracer);
+
+    /// Pushes an object onto the mark stack. A non-zero `offset` continues the tracing of
+    /// a partially traced object at the given trailing slot.
+    void push(Header* object, size_t offset);
+
+    /// Resets the weak table state at the start of a new cycle.
+    void begin_weak_tables();
+
+    /// Called when a weak table (or its entries) would be traced. Its entries are processed
+    /// by `trace_ephemerons()` instead.
+    void visit_weak_table(Header* table);
+
+    /// Marks the values of weak table entries whose keys are reachable until no new objects
+    /// are found. Called when the mark stack is empty.
+    void trace_ephemerons(Tracer& tracer);
+
+    /// Removes the entries with unreachable keys from the weak tables visited by this cycle
+    /// and forgets weak tables that have not survived. Called after marking is complete.
+    void clear_weak_tables();
+
+    /// Returns true if the value will survive the current collection.
+    /// Values that are not heap objects are always live.
+    bool is_live(Value value);
+
+    /// Starts an incremental marking phase.
+    void start_marking();
+
+    /// Performs a slice of marking work. `pause_start` is the time at which the current pause started.
+    void mark_step(Clock::time_point pause_start);
+
+    /// Visits objects on the mark stack until the stack is empty or until the deadline has been reached.
+    /// Returns true if the stack is empty.
+    bool mark_slice(Clock::time_point deadline);
+
+    /// Completes the incremental marking phase and sweeps the heap.
+    void finish_marking();
+
+    /// Cancels the incremental marking phase.
+    void abort_marking();
+
+    /// Updates statistics after tracing and sweeps the heap.
+    void complete(bool major);
+
+    /// Prepares the event for a new collection cycle.
+    void begin_event(GcReason reason, bool major, bool incremental);
+
+    /// Completes the event of the current collection cycle, updates statistics and invokes the callback.
+    void end_event(double duration);
+
+    /// Computes the thresholds for the next collections, according to the collector's policy.
+    /// `duration` is the time spent in the completed collection cycle (in milliseconds).
+    void update_thresholds(bool major, double duration);
+
+    /// Returns the size of the next young generation, given the size of the live objects.
+    size_t nursery_size(size_t live_bytes) const;
+
+    /// Limits the given threshold so that the configured headroom remains free (if possible).
+    size_t limit_threshold(size_t threshold, size_t live_bytes) const;
+
+    /// Selects the sparsely populated pages after a major collection has traced the heap.
+    std::vector<Page*> sparse_pages();
+
+    /// Moves the movable objects out of the pages selected by `Heap::begin_evacuation()` and
+    /// updates all references to them. Called after the heap has been swept.
+    void evacuate();
+
+    /// Returns true if the object may be moved by the collector.
+    static bool is_movable(Header* header);
+
+    /// Returns true if the object has been marked.
+    bool is_marked(Header* header);
 
     /// Called for every object reference seen while tracing.
-    /// If the value has not been traced yet, it will be placed onto the trace stack.
+    /// If the value has not been traced yet, it will be placed onto the mark stack.
     void mark(Value value);
 
     /// Actually trace the value, visiting all directly reachable values.
-    /// Called at most once for every object.
-    void trace_value(Value value, Tracer& tracer);
+    /// Called at most once for every object (when marking), except for large objects which are traced in chunks.
+    /// Marking continues at the trailing slot `offset` if it is not zero.
+    template<typename TracerType>
+    void trace_value(Value value, TracerType& tracer, size_t offset = 0);
 
 private:
     void sweep(Heap& heap);
@@ -73,15 +419,83 @@ private:
     Heap& heap_;
     RootSet* roots_ = nullptr;
     bool running_ = false;
+    bool marking_ = false;
+
+    // Number of collectors with an incremental marking phase in progress.
+    static inline std::atomic<u32> marking_collectors_ = 0;
+
+    // Incremental marking settings.
+    std::chrono::microseconds slice_budget_{0};
+    size_t slice_allocation_ = size_t(1) << 18;
+
+    // Heap size at which an incremental marking phase is completed without interruption.
+    size_t marking_limit_ = 0;
+
+    // Time spent in the current incremental marking phase, in milliseconds.
+    double marking_duration_ = 0;
+
+    GcPolicy policy_;
 
-    // For marking. Should be replaced by some preallocated memory in the future.
-    std::vector<Value> to_trace_;
+    // Number of completed collection cycles.
+    size_t cycles_ = 0;
+    size_t minor_cycles_ = 0;
+    size_t incremental_cycles_ = 0;
+
+    // Evacuation settings and statistics.
+    double evacuation_threshold_ = 0;
+    bool compaction_due_ = false;
+    size_t evacuated_objects_ = 0;
+
+    // Number of objects (and their size in bytes) marked in the current cycle.
+    size_t marked_ = 0;
+    size_t marked_bytes_ = 0;
+    std::array<GcTypeStats, max_value_type + 1> marked_types_{};
+
+    // Telemetry.
+    GcStats stats_;
+    GcEvent event_;
+    GcEvent last_event_;
+    std::function<void(const GcEvent& event)> on_collection_;
+
+    // Number of objects and bytes in the old generation (i.e. the survivors of the last collection).
+    size_t old_objects_ = 0;
+    size_t old_bytes_ = 0;
+
+    // Objects that have been marked but not traced yet.
+    MarkStack mark_stack_;
+    size_t mark_stack_overflows_ = 0;
+
+    // All registered weak tables, including tables that may have died since the last collection.
+    std::vector<Header*> weak_tables_;
+
+    // Maps the entries storage of weak tables to their table. Storage objects are not traced
+    // when they are found in this map.
+    absl::flat_hash_map<Header*, Header*> weak_storages_;
+
+    // Weak tables visited in the current cycle. May contain duplicates.
+    std::vector<Header*> ephemerons_;
+
+    // Number of weak table entries removed by the last collection.
+    size_t cleared_weak_entries_ = 0;
 
     // Duration of last gc, in milliseconds.
     double last_duration_ = 0;
 
+    // End of the last collection cycle (or construction of the collector).
+    Clock::time_point last_cycle_end_ = Clock::now();
+
+    // Number of bytes allocated by the mutator since the last collection cycle.
+    size_t allocated_since_ = 0;
+
+    // Smoothed allocation rate of the mutator, in bytes per millisecond.
+    double allocation_rate_ = 0;
+
     // Next automatic gc call (byte threshold).
     size_t next_threshold_ = size_t(1) << 20;
+
+    // Size of the old generation (in bytes) at which automatic collections become major collections.
+    // Set to twice the size of the old generation after every major collection (within the heap's headroom).
+    size_t major_threshold_ = size_t(1) << 20;
 };
 
 } // namespace tiro::vm
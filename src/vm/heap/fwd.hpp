@@ -8,6 +8,7 @@ namespace tiro::vm {
 enum class ChunkType : u8;
 
 struct HeapStats;
+struct MarkItem;
 struct PageLayout;
 
 class Header;
@@ -18,6 +19,8 @@ class FreeSpace;
 class HeapAllocator;
 class Heap;
 class Collector;
+class MarkStack;
+class Sweeper;
 
 } // namespace tiro::vm
 
@@ -49,7 +49,6 @@ size_t object_size(Header* header) {
         TIRO_CASE(CoroutineToken)
         TIRO_CASE(Environment)
         TIRO_CASE(Exception)
-        TIRO_CASE(Float)
         TIRO_CASE(HandlerTable)
         TIRO_CASE(HashTable)
         TIRO_CASE(HashTableIterator)
@@ -58,8 +57,10 @@ size_t object_size(Header* header) {
         TIRO_CASE(HashTableStorage)
         TIRO_CASE(HashTableValueIterator)
         TIRO_CASE(HashTableValueView)
+        TIRO_CASE(HeapFloat)
         TIRO_CASE(HeapInteger)
         TIRO_CASE(InternalType)
+        TIRO_CASE(LineTable)
         TIRO_CASE(MagicFunction)
         TIRO_CASE(Method)
         TIRO_CASE(Module)
@@ -72,6 +73,7 @@ size_t object_size(Header* header) {
         TIRO_CASE(Result)
         TIRO_CASE(Set)
         TIRO_CASE(SetIterator)
+        TIRO_CASE(SmallFloat)
         TIRO_CASE(SmallInteger)
         TIRO_CASE(String)
         TIRO_CASE(StringBuilder)
@@ -83,6 +85,7 @@ size_t object_size(Header* header) {
         TIRO_CASE(Type)
         TIRO_CASE(Undefined)
         TIRO_CASE(UnresolvedImport)
+        TIRO_CASE(WeakMap)
         // [[[end]]]
 
 #undef TIRO_CASE
@@ -15,6 +15,14 @@ class Header {
 private:
     enum Flags : u32 {
         LargeObjectBit = 0,
+
+        // Set when the object was promoted to the old generation, i.e. when it survived a collection.
+        // Mirrors the (sticky) mark bit of the object for fast access in the write barrier.
+        OldBit = 1,
+
+        // Set while the object is in the heap's remembered set.
+        // Objects in the remembered set are always old, see `forwarded()` for the other combination.
+        RememberedBit = 2,
     };
 
     // Contains the type pointer under normal circumstances.
@@ -23,7 +31,26 @@ private:
     bool large_object() const { return type_field_.tag_bit<LargeObjectBit>(); }
     void large_object(bool large_object) { type_field_.tag_bit<LargeObjectBit>(large_object); }
 
+    bool old() const { return type_field_.tag_bit<OldBit>(); }
+    void old(bool old) { type_field_.tag_bit<OldBit>(old); }
+
+    bool remembered() const { return type_field_.tag_bit<RememberedBit>(); }
+    void remembered(bool remembered) { type_field_.tag_bit<RememberedBit>(remembered); }
+
+    // An object that has been moved by the collector is marked as remembered, but not old (which
+    // does not happen otherwise). The type field then points to the new location of the object.
+    bool forwarded() const { return remembered() && !old(); }
+
+    Header* forwarding_address() const { return static_cast<Header*>(type_field_.pointer()); }
+
+    void forward(Header* new_address) {
+        type_field_.pointer(new_address);
+        old(false);
+        remembered(true);
+    }
+
     friend Value;
+    friend HeapValue;
     friend Heap;
     friend Collector;
 
@@ -1,6 +1,9 @@
 #include "vm/heap/heap.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <new>
 
 #include "fmt/format.h"
@@ -180,14 +183,39 @@ Span<Cell> FreeSpace::pop(FreeList& list) {
     return Span(reinterpret_cast<Cell*>(entry), entry->cells);
 }
 
+void AllocationBuffer::reset(NotNull<Page*> page, Span<Cell> cells) {
+    TIRO_DEBUG_ASSERT(remaining() == 0, "allocation buffer must be empty");
+    TIRO_DEBUG_ASSERT(cells.empty() || Page::from_address(cells.data(), page->layout()) == page,
+        "cells must belong to the given page");
+    page_ = page.get();
+    top_ = cells.data();
+    end_ = cells.data() + cells.size();
+}
+
+Span<Cell> AllocationBuffer::take_remaining() {
+    Span<Cell> result(top_, remaining());
+    page_ = nullptr;
+    top_ = end_ = nullptr;
+    return result;
+}
+
+// The allocation buffer is kept (and the object is allocated from the free lists instead)
+// if at least this many cells remain in the buffer.
+static constexpr u32 buffer_retain_cells = 32;
+
+AllocationObserver::~AllocationObserver() = default;
+
 Heap::Heap(size_t page_size, HeapAllocator& alloc)
     : alloc_(alloc)
     , layout_(Page::compute_layout(page_size))
     , collector_(*this)
-    , free_(layout_) {}
+    , free_{FreeSpace(layout_), FreeSpace(layout_)} {}
 
 Heap::~Heap() {
+    finish_sweep();
     for (auto page : pages_) {
+        // Old objects are still marked, but all objects must be finalized now.
+        page->clear_marks();
         page->invoke_finalizers();
         Page::destroy(page);
     }
@@ -200,7 +228,7 @@ Heap::~Heap() {
     lobs_.clear();
 }
 
-std::tuple<void*, ChunkType> Heap::allocate(size_t bytes_request) {
+std::tuple<void*, ChunkType> Heap::allocate(size_t bytes_request, Region region) {
     TIRO_DEBUG_ASSERT(!collector_.running(), "collector must not be running");
     TIRO_DEBUG_ASSERT(bytes_request > 0, "zero sized allocation");
 
@@ -215,20 +243,28 @@ std::tuple<void*, ChunkType> Heap::allocate(size_t bytes_request) {
     // Objects of large size get an allocation of their own.
     const u32 cells_request = ceil_div(bytes_request, cell_size);
     if (cells_request >= layout_.large_object_cells) {
-        auto lob = add_lob(cells_request);
+        auto lob = add_lob(cells_request, region);
         stats_.allocated_objects += 1;
-        stats_.allocated_bytes += bytes_request;
+        stats_.total_allocated_objects += 1;
+        stats_.allocated_bytes += cells_request * cell_size;
         return std::tuple(lob->cells().data(), ChunkType::LargeObject);
     }
 
     // All other objects are allocated from some free storage on a page.
-    auto try_allocate = [&]() { return free_.allocate_exact(cells_request); };
+    const u32 slot_cells = this->slot_cells(cells_request);
+    auto try_allocate = [&]() {
+        return slot_cells != 0 ? allocate_slot(slot_cells, region)
+                               : allocate_cells(cells_request, region);
+    };
 
     // Initial allocation.
     void* result = try_allocate();
 
-    // Run collector if initial allocation fails.
-    if (!pages_.empty() && !result && !collector_ran) {
+    // Run collector if initial allocation fails and the heap cannot grow any further.
+    // Otherwise the heap simply grows until the next automatic collection is due, which also
+    // allows incremental marking phases to proceed.
+    if (!pages_.empty() && !result && !collector_ran && !collector_.marking()
+        && layout_.page_size > max_size_ - stats_.total_bytes) {
         collector_.collect(GcReason::AllocFailure);
         collector_ran = true;
         result = try_allocate();
@@ -236,18 +272,258 @@ std::tuple<void*, ChunkType> Heap::allocate(size_t bytes_request) {
 
     // Allocate a new page if still no success after gc.
     if (!result) {
-        add_page();
+        add_page(region, slot_cells);
         result = try_allocate();
         if (TIRO_UNLIKELY(!result))
             TIRO_ERROR("allocation request failed after new page was allocated");
     }
 
     stats_.allocated_objects += 1;
-    stats_.allocated_bytes += bytes_request;
-    stats_.free_bytes -= bytes_request;
+    stats_.total_allocated_objects += 1;
+    stats_.allocated_bytes += cells_request * cell_size;
+    stats_.free_bytes -= cells_request * cell_size;
     return std::tuple(result, ChunkType::Page);
 }
 
+Cell* Heap::allocate_cells(u32 cells_request, Region region) {
+    // Fast path: bump pointer allocation.
+    if (Cell* result = buffer(region).allocate(cells_request))
+        return result;
+
+    // Pages are swept on demand, until one of them provides enough free space.
+    // Empty pages are used last, partially used pages of the region are filled up first.
+    while (1) {
+        if (Cell* result = allocate_free(cells_request, region))
+            return result;
+        if (!sweep_next())
+            break;
+    }
+    if (reuse_empty_page(region, 0))
+        return allocate_free(cells_request, region);
+    return nullptr;
+}
+
+Cell* Heap::allocate_free(u32 cells_request, Region region) {
+    auto& free = free_space(region);
+    auto& buffer = this->buffer(region);
+
+    // Don't throw away a buffer with lots of remaining space because of a single larger object.
+    if (buffer.remaining() >= buffer_retain_cells)
+        return free.allocate_exact(cells_request);
+
+    // Refill the buffer with the largest free chunk available.
+    Span<Cell> unused = buffer.take_remaining();
+    if (!unused.empty())
+        free.insert_free_with_metadata(unused);
+
+    Span<Cell> chunk = free.allocate_chunk(cells_request);
+    if (chunk.empty())
+        return nullptr;
+
+    buffer.reset(Page::from_address(chunk.data(), layout_), chunk);
+    Cell* result = buffer.allocate(cells_request);
+    TIRO_DEBUG_ASSERT(result, "allocation from a fresh buffer must succeed");
+    return result;
+}
+
+Cell* Heap::allocate_slot(u32 slot_cells, Region region) {
+    auto& size_class = this->size_class(region, slot_cells);
+    while (1) {
+        if (size_class.current) {
+            if (Cell* result = size_class.current->allocate_slot())
+                return result;
+            size_class.current = nullptr;
+        }
+
+        // Like allocate_cells(): partially used pages first, then unswept pages, then empty pages.
+        if (!size_class.available.empty()) {
+            size_class.current = size_class.available.back();
+            size_class.available.pop_back();
+        } else if (!sweep_next() && !reuse_empty_page(region, slot_cells)) {
+            return nullptr;
+        }
+    }
+}
+
+bool Heap::sweep_next() {
+    const Sweeper::SweptPage* swept = sweeper_.next();
+    if (!swept)
+        return false;
+
+    // Evacuated pages are registered by end_evacuation().
+    auto page = TIRO_NN(swept->page);
+    if (evacuating_.contains(page.get()))
+        return true;
+
+    if (swept->free_cells == page->usable_cells()) {
+        if (retained_pages_ >= spare_pages_ && page->idle_cycles() >= page_release_cycles_) {
+            release_page(page);
+            return true;
+        }
+        ++retained_pages_;
+
+        // Empty pages are not bound to their previous region or size class, they are handed out
+        // to the first one that runs out of space.
+        empty_pages_.push_back(page);
+        stats_.free_bytes += page->cells_count() * cell_size;
+        return true;
+    }
+
+    register_swept(page, swept->free_cells, swept->free_blocks);
+    return true;
+}
+
+void Heap::register_swept(Page* page, u32 free_cells, const std::vector<Span<Cell>>& free_blocks) {
+    stats_.free_bytes += free_cells * cell_size;
+    if (const u32 slot_cells = page->slot_cells()) {
+        if (free_cells > 0)
+            size_class(page->region(), slot_cells).available.push_back(page);
+        return;
+    }
+
+    auto& free = free_space(page->region());
+    for (auto block : free_blocks)
+        free.insert_free(block);
+}
+
+bool Heap::reuse_empty_page(Region region, u32 slot_cells) {
+    if (empty_pages_.empty())
+        return false;
+
+    auto page = empty_pages_.back();
+    empty_pages_.pop_back();
+    page->reassign(region, slot_cells);
+    stats_.free_bytes -= (page->cells_count() - page->usable_cells()) * cell_size;
+    if (slot_cells != 0) {
+        size_class(region, slot_cells).available.push_back(page);
+    } else {
+        free_space(region).insert_free_with_metadata(page->cells());
+    }
+    return true;
+}
+
+void Heap::finish_sweep() {
+    while (sweep_next()) {
+        // Pages that have not been claimed by a helper thread are swept by this thread.
+    }
+    sweeper_.finish();
+}
+
+void Heap::sample_allocations(AllocationObserver* observer, size_t interval) {
+    sample_observer_ = observer;
+    if (!observer) {
+        sample_countdown_ = std::numeric_limits<size_t>::max();
+        sample_distance_ = 0;
+        return;
+    }
+
+    TIRO_CHECK(interval > 0, "the sampling interval must be positive");
+    sample_distribution_ = std::exponential_distribution<double>(
+        1.0 / static_cast<double>(interval));
+    sample_distance_ = sample_countdown_ = next_sample_distance();
+}
+
+void Heap::sample_allocation(Header* object, size_t bytes) {
+    TIRO_DEBUG_ASSERT(sample_observer_, "allocation sampling is not enabled");
+    const size_t weight = sample_distance_ - sample_countdown_ + bytes;
+    sample_distance_ = sample_countdown_ = next_sample_distance();
+    sample_observer_->allocation_sampled(object, weight);
+}
+
+size_t Heap::next_sample_distance() {
+    // At least one byte, otherwise the countdown would end before the next allocation.
+    constexpr double max_distance = double(u64(1) << 62);
+    const double distance = std::ceil(sample_distribution_(sample_random_));
+    return static_cast<size_t>(std::clamp(distance, 1.0, max_distance));
+}
+
+bool Heap::begin_evacuation(std::vector<Page*> pages) {
+    TIRO_DEBUG_ASSERT(evacuating_.empty(), "evacuation is already in progress");
+    TIRO_DEBUG_ASSERT(!sweeper_.active(), "the previous sweep must be complete");
+    evacuating_.insert(pages.begin(), pages.end());
+    return !evacuating_.empty();
+}
+
+Header* Heap::evacuate(Header* object) {
+    TIRO_DEBUG_ASSERT(!object->large_object(), "large objects cannot be moved");
+    TIRO_DEBUG_ASSERT(!sweeper_.active(), "all pages must have been swept");
+
+    // Objects stay within their region.
+    auto page = Page::from_address(object, layout_);
+    const Region region = page->region();
+    const u32 cells = ceil_div(object_size(object), cell_size);
+    const u32 slot_cells = this->slot_cells(cells);
+    auto try_allocate = [&]() {
+        if (slot_cells != 0)
+            return allocate_slot(slot_cells, region);
+
+        auto& free = free_space(region);
+        Cell* result = free.allocate_exact(cells);
+        if (!result && reuse_empty_page(region, 0))
+            result = free.allocate_exact(cells);
+        return result;
+    };
+
+    Cell* target = try_allocate();
+    if (!target) {
+        if (layout_.page_size > max_size_ - stats_.total_bytes)
+            return nullptr;
+
+        add_page(region, slot_cells);
+        target = try_allocate();
+        TIRO_CHECK(target, "allocation request failed after new page was allocated");
+    }
+    stats_.free_bytes -= cells * cell_size;
+
+    // The copy keeps all header bits, i.e. it is marked and old.
+    std::memcpy(static_cast<void*>(target), static_cast<void*>(object), cells * cell_size);
+    auto target_page = Page::from_address(target, layout_);
+    target_page->set_cell_marked(target_page->cell_index(target), true);
+    target_page->add_live_cells(cells);
+
+    // The object is dead at its old location.
+    page->set_cell_marked(page->cell_index(object), false);
+
+    Header* result = reinterpret_cast<Header*>(target);
+    object->forward(result);
+    return result;
+}
+
+void Heap::end_evacuation() {
+    TIRO_DEBUG_ASSERT(!sweeper_.active(), "all pages must have been swept");
+
+    // The pages are not retained if they are empty now, their objects have been moved elsewhere.
+    std::vector<Span<Cell>> free_blocks;
+    for (auto page : evacuating_) {
+        free_blocks.clear();
+        const u32 free_cells = page->sweep(free_blocks);
+        if (free_cells == page->usable_cells()) {
+            release_page(TIRO_NN(page));
+            continue;
+        }
+        register_swept(page, free_cells, free_blocks);
+    }
+    evacuating_.clear();
+}
+
+void Heap::page_retention(u32 spare_pages, u32 release_cycles) {
+    spare_pages_ = spare_pages;
+    page_release_cycles_ = release_cycles;
+}
+
+void Heap::sweep_threads(u32 count) {
+    finish_sweep();
+    sweeper_.threads(count);
+}
+
+void Heap::retire_buffers() {
+    for (size_t i = 0; i < region_count; ++i) {
+        Span<Cell> unused = buffers_[i].take_remaining();
+        if (!unused.empty())
+            free_[i].insert_free_with_metadata(unused);
+    }
+}
+
 void Heap::mark_finalizer(ChunkType type, void* address) {
     TIRO_DEBUG_ASSERT(address, "invalid address");
 
@@ -263,12 +539,92 @@ void Heap::mark_finalizer(ChunkType type, void* address) {
     }
 }
 
+Header* Heap::resize_large_object(Header* object, size_t bytes, bool may_move) {
+    TIRO_DEBUG_ASSERT(object, "invalid object");
+    TIRO_DEBUG_ASSERT(!collector_.running(), "collector must not be running");
+    if (!object->large_object() || bytes == 0)
+        return nullptr;
+
+    const size_t cells = ceil_div(bytes, cell_size);
+    if (cells > std::numeric_limits<u32>::max())
+        return nullptr;
+
+    auto lob = LargeObject::from_address(object);
+    const size_t old_cells = lob->cells_count();
+    if (cells == old_cells)
+        return object;
+
+    // Growth counts as an allocation. Fail if a collection is due, the caller then falls back
+    // to a regular allocation (which runs the collector).
+    if (cells > old_cells
+        && stats_.allocated_bytes + (cells - old_cells) * cell_size >= collector_.next_threshold())
+        return nullptr;
+
+    // References from the mark stack or the remembered set cannot be updated.
+    if (collector_.marking() || object->remembered())
+        may_move = false;
+
+    // Registering a moved chunk must not fail.
+    if (may_move)
+        lobs_.reserve(lobs_.size() + 1); // may throw
+
+    LargeObject* resized = LargeObject::resize(lob, static_cast<u32>(cells), may_move);
+    if (!resized)
+        return nullptr;
+
+    if (resized != lob.get()) {
+        lobs_.erase(lob);
+        lobs_.insert(TIRO_NN(resized));
+    }
+
+    if (cells > old_cells) {
+        stats_.allocated_bytes += (cells - old_cells) * cell_size;
+    } else {
+        const size_t freed = (old_cells - cells) * cell_size;
+        stats_.allocated_bytes -= std::min(freed, stats_.allocated_bytes);
+    }
+    return reinterpret_cast<Header*>(resized->cell());
+}
+
+void Heap::remember(Header* object) {
+    TIRO_DEBUG_ASSERT(object, "invalid object");
+    TIRO_DEBUG_ASSERT(object->old(), "only old objects need to be remembered");
+    TIRO_DEBUG_ASSERT(!object->remembered(), "object is already remembered");
+    object->remembered(true);
+    remembered_.push_back(object);
+}
+
+void Heap::clear_marks() {
+    for (auto object : remembered_)
+        object->remembered(false);
+    remembered_.clear();
+
+    for (auto lob : lobs_)
+        lob->set_marked(false);
+
+    for (auto page : pages_)
+        page->clear_marks();
+}
+
 void Heap::sweep() {
-    // Reset 'allocated' / 'free' counters and recompute them during the sweep.
-    // Note that the 'total' counter is not reset.
+    TIRO_DEBUG_ASSERT(!sweeper_.active(), "the previous sweep must be complete");
+
+    // Unused cells in the allocation buffers must be marked as free, otherwise they would
+    // be considered as part of the previous block by the sweep.
+    retire_buffers();
+
+    // All free blocks are registered again when their page is swept.
+    // The 'allocated' counter has been updated by the collector, the 'total' counter is not reset.
     stats_.free_bytes = 0;
-    stats_.allocated_bytes = 0;
-    free_.reset();
+    for (auto& free : free_)
+        free.reset();
+    for (auto& size_classes : size_classes_by_region_) {
+        for (auto& size_class : size_classes) {
+            size_class.current = nullptr;
+            size_class.available.clear();
+        }
+    }
+    empty_pages_.clear();
 
     // see absl flat_hash_set::erase for the erase_if idiom.
     for (auto it = lobs_.begin(), end = lobs_.end(); it != end;) {
@@ -278,20 +634,20 @@ void Heap::sweep() {
             lob->invoke_finalizer();
             lobs_.erase(erase);
             destroy_lob(lob);
-        } else {
-            lob->set_marked(false);
-            stats_.allocated_bytes += lob->cells_count() * cell_size;
         }
     }
 
-    for (auto it = pages_.begin(), end = pages_.end(); it != end; ++it) {
-        auto page = *it;
-
-        Page::SweepStats page_stats;
-        page->sweep(page_stats, free_);
-        stats_.allocated_bytes += page_stats.allocated_cells * cell_size;
-        stats_.free_bytes += page_stats.free_cells * cell_size;
+    // Finalizers run on this thread, before the pages are swept (possibly by helper threads).
+    // This is not very efficient (improvement: separate pages for objects with finalizers?)
+    // but it will do for now. Pages in the data region never contain objects with finalizers.
+    retained_pages_ = 0;
+    sweep_pages_.clear();
+    for (auto page : pages_) {
+        if (page->region() != Region::Data)
+            page->invoke_finalizers();
+        sweep_pages_.push_back(page);
     }
+    sweeper_.start(sweep_pages_);
 }
 
 void* Heap::allocate_raw(size_t size, size_t align) {
@@ -312,19 +668,47 @@ void Heap::free_raw(void* block, size_t size, size_t align) {
     alloc_.free_aligned(block, size, align);
 }
 
-NotNull<Page*> Heap::add_page() {
-    NotNull<Page*> page = Page::allocate(*this); // may throw
+void* Heap::resize_raw(void* block, size_t old_size, size_t new_size, size_t align, bool may_move) {
+    TIRO_DEBUG_ASSERT(old_size <= stats_.total_bytes, "invalid total bytes count");
+    if (new_size > old_size && new_size - old_size > max_size_ - stats_.total_bytes)
+        return nullptr;
+
+    void* result = alloc_.resize_aligned(block, old_size, new_size, align, may_move);
+    if (result)
+        stats_.total_bytes = stats_.total_bytes - old_size + new_size;
+    return result;
+}
+
+size_t Heap::page_count(Region region) const {
+    size_t count = 0;
+    for (auto page : pages_) {
+        if (page->region() == region)
+            ++count;
+    }
+    for (auto page : empty_pages_) {
+        if (page->region() == region)
+            --count;
+    }
+    return count;
+}
+
+NotNull<Page*> Heap::add_page(Region region, u32 slot_cells) {
+    NotNull<Page*> page = Page::allocate(*this, region, slot_cells); // may throw
     {
         ScopeFailure cleanup_on_error = [&]() { Page::destroy(page); };
         pages_.insert(page); // may throw
     }
-    free_.insert_free_with_metadata(page->cells());
-    stats_.free_bytes += layout_.cells_size * cell_size;
+    if (slot_cells != 0) {
+        size_class(region, slot_cells).available.push_back(page);
+    } else {
+        free_space(region).insert_free_with_metadata(page->cells());
+    }
+    stats_.free_bytes += page->usable_cells() * cell_size;
     return page;
 }
 
-NotNull<LargeObject*> Heap::add_lob(u32 cells) {
-    NotNull<LargeObject*> lob = LargeObject::allocate(*this, cells); // may throw
+NotNull<LargeObject*> Heap::add_lob(u32 cells, Region region) {
+    NotNull<LargeObject*> lob = LargeObject::allocate(*this, cells, region); // may throw
     TIRO_DEBUG_ASSERT(lob->cells_count() == cells, "large object has inconsistent number of cells");
 
     ScopeFailure cleanup_on_error = [&]() { LargeObject::destroy(lob); };
@@ -337,4 +721,11 @@ void Heap::destroy_lob(NotNull<LargeObject*> lob) {
     LargeObject::destroy(lob);
 }
 
+void Heap::release_page(NotNull<Page*> page) {
+    TIRO_DEBUG_ASSERT(pages_.contains(page), "page is not registered");
+    pages_.erase(page);
+    Page::destroy(page);
+    stats_.released_pages += 1;
+}
+
 } // namespace tiro::vm
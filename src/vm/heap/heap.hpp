@@ -11,10 +11,16 @@
 #include "vm/heap/fwd.hpp"
 #include "vm/heap/header.hpp"
 #include "vm/heap/memory.hpp"
+#include "vm/heap/sweeper.hpp"
 #include "vm/object_support/fwd.hpp"
 
 #include "absl/container/flat_hash_set.h"
 
+#include <array>
+#include <limits>
+#include <random>
+#include <vector>
+
 namespace tiro::vm {
 
 /// Node in the free list.
@@ -49,7 +55,7 @@ static_assert(alignof(FreeListEntry) <= alignof(Cell));
 /// - size class `i` contains all memory blocks with `block_size_in_cells >= size[i] && block_size_in_cells < size[i+1]`
 /// - the last size class contains all larger memory blocks
 ///
-/// NOTE: currently all pages share a global free space datastructure.
+/// NOTE: currently all pages of a region share a global free space datastructure.
 /// This reduces the per-page overhead but also makes handling individual pages impossible.
 ///
 /// NOTE: all cells must come from a page with the expected layout.
@@ -68,10 +74,11 @@ public:
 
     /// Attempts to allocate a chunk of at least `count` cells.
     /// May return significantly more cells to the caller.
-    /// This function is suited to obtain large buffers for sequential (bump pointer) allocations.
+    /// This function is suited to obtain large buffers for sequential (bump pointer) allocations,
+    /// see `AllocationBuffer`.
     ///
-    /// TODO: use this for bump pointer allocation
-    /// TODO: must not be marked as allocated block when used for bump pointer allocation
+    /// The chunk is marked as a single allocated block. Cells that are not used by the caller must
+    /// be returned via `insert_free_with_metadata()`.
     ///
     /// \pre `count > 0`.
     /// \param count the required number of cells
@@ -139,25 +146,96 @@ private:
     std::vector<FreeList> lists_;
 };
 
+/// A linear allocation buffer for bump pointer allocation.
+///
+/// The buffer owns a contiguous range of free cells within a single page (obtained
+/// via `FreeSpace::allocate_chunk`). Allocations simply advance the buffer's top pointer
+/// and mark the start of the new block in the page's block bitmap.
+///
+/// The unused cells in the buffer have no block metadata of their own: they appear as
+/// extents of the previously allocated block. The remaining cells must therefore be returned
+/// to the free space before the heap is swept (see `Heap::retire_buffer()`).
+class AllocationBuffer final {
+public:
+    AllocationBuffer() = default;
+
+    AllocationBuffer(const AllocationBuffer&) = delete;
+    AllocationBuffer& operator=(const AllocationBuffer&) = delete;
+
+    /// Allocates `count` cells from the buffer. Returns nullptr if the buffer does not
+    /// have enough space left.
+    /// \pre `count > 0`
+    Cell* allocate(u32 count) {
+        TIRO_DEBUG_ASSERT(count > 0, "zero sized allocation");
+        if (TIRO_UNLIKELY(count > remaining()))
+            return nullptr;
+
+        Cell* cell = top_;
+        top_ += count;
+        page_->set_allocated(page_->cell_index(cell), count);
+        return cell;
+    }
+
+    /// Replaces the buffer's contents with the given span of cells. All cells must belong to `page`.
+    /// \pre the buffer must be empty (see `take_remaining()`).
+    void reset(NotNull<Page*> page, Span<Cell> cells);
+
+    /// Removes the remaining (unused) cells from the buffer and returns them.
+    /// The buffer is empty afterwards.
+    Span<Cell> take_remaining();
+
+    /// Returns the number of unused cells in the buffer.
+    u32 remaining() const { return static_cast<u32>(end_ - top_); }
+
+private:
+    Page* page_ = nullptr;
+    Cell* top_ = nullptr;
+    Cell* end_ = nullptr;
+};
+
 struct HeapStats {
     /// Total raw memory allocated by the heap, includes overhead for metadata.
     size_t total_bytes = 0;
 
-    /// Memory handed out to the mutator for object storage.
+    /// Memory handed out to the mutator for object storage (rounded up to whole cells).
+    /// After a collection, this is the size of all surviving objects.
     size_t allocated_bytes = 0;
 
     /// Total free memory (e.g. on free lists).
+    /// Free memory in pages that have not been swept yet is not included.
     size_t free_bytes = 0;
 
     /// Total number of allocated objects.
     /// Some of these objects may already be unreachable and will be removed
     /// from the count when the garbage collector runs again.
     size_t allocated_objects = 0;
+
+    /// Total number of objects allocated since the heap was created.
+    /// Unlike `allocated_objects`, this counter is never decremented.
+    size_t total_allocated_objects = 0;
+
+    /// Total number of empty pages that have been returned to the allocator.
+    size_t released_pages = 0;
+};
+
+/// Receives samples of the objects allocated by a heap, see `Heap::sample_allocations()`.
+class AllocationObserver {
+public:
+    virtual ~AllocationObserver();
+
+    /// Called for a sampled allocation, immediately after the object has been constructed.
+    /// `weight` is the number of bytes allocated since the previous sample (including the object itself).
+    /// The observer must not allocate on the heap.
+    virtual void allocation_sampled(Header* object, size_t weight) = 0;
 };
 
 /// The heap manages all memory dynamically allocated by the vm.
 class Heap final {
 public:
+    /// Objects up to this size (in cells) are allocated from size class pages when enabled,
+    /// see `size_classes()`.
+    static constexpr u32 max_slot_cells = 8;
+
     explicit Heap(size_t page_size, HeapAllocator& alloc);
     ~Heap();
 
@@ -187,7 +265,7 @@ public:
         TIRO_DEBUG_ASSERT(bytes >= sizeof(Layout),
             "allocation size is too small for instances of the given type");
 
-        auto [storage, chunk_type] = allocate(bytes);
+        auto [storage, chunk_type] = allocate(bytes, region_of<Layout>());
 
         Layout* result = new (storage) Layout(std::forward<Args>(args)...);
         if (chunk_type == ChunkType::LargeObject)
@@ -197,22 +275,174 @@ public:
 
         TIRO_DEBUG_ASSERT((void*) result == (void*) static_cast<Header*>(result),
             "invalid location of header in struct");
+
+        // The countdown is never reached while sampling is disabled.
+        if (TIRO_UNLIKELY(bytes >= sample_countdown_))
+            sample_allocation(result, bytes);
+        else
+            sample_countdown_ -= bytes;
         return result;
     }
 
+    /// Attempts to resize the large object `object` to `bytes` without copying it. This is only possible
+    /// if the heap's allocator supports resizing blocks (see `HeapAllocator::resize_aligned()`).
+    ///
+    /// If `may_move` is true, the object may be moved to a new address and the caller must update all
+    /// references to it. Objects are never moved while the collector is marking or when they are in the
+    /// remembered set. Never triggers a garbage collection: growth fails instead if a collection is due.
+    ///
+    /// Returns the (possibly new) address of the object on success. Returns nullptr if the object is
+    /// not a large object or if it cannot be resized, in which case it has not been modified.
+    /// The caller is responsible for updating the size information stored in the object itself.
+    Header* resize_large_object(Header* object, size_t bytes, bool may_move);
+
     /// The maximum heap size. Defaults to 'unconstrained' (max size_t).
     size_t max_size() const { return max_size_; }
 
     /// Set the maximum heap size.
     void max_size(size_t max_size) { max_size_ = max_size; }
 
+    /// Adds an object of the old generation to the remembered set.
+    /// Called by the write barrier (see `HeapValue::write_barrier()`) when a reference to a young
+    /// object is stored into `object`.
+    /// \pre `object` must be old and not yet remembered.
+    void remember(Header* object);
+
+    /// Returns the number of objects in the remembered set.
+    size_t remembered_count() const { return remembered_.size(); }
+
+    /// Returns the number of pages currently owned by the heap.
+    size_t page_count() const { return pages_.size(); }
+
+    /// Returns the number of pages that currently belong to the given region.
+    /// Empty pages retained by the last sweep do not belong to any region until they are reused.
+    size_t page_count(Region region) const;
+
+    /// Returns the number of large objects (objects allocated outside of pages) currently owned by the heap.
+    size_t large_object_count() const { return lobs_.size(); }
+
+    /// Returns the region for instances of the given layout. Objects that can neither reference other
+    /// objects nor require finalization are allocated in the data region, which is never traced.
+    template<typename Layout>
+    static constexpr Region region_of() {
+        using Traits = LayoutTraits<Layout>;
+        return Traits::may_contain_references || Traits::has_finalizer ? Region::Generic
+                                                                         : Region::Data;
+    }
+
+    /// Returns the number of helper threads used for sweeping.
+    u32 sweep_threads() const { return sweeper_.threads(); }
+
+    /// Sets the number of helper threads used for sweeping. With zero threads (the default),
+    /// pages are swept lazily by the thread that allocates from the heap.
+    void sweep_threads(u32 count);
+
+    /// Returns true if some pages have not been swept since the last collection.
+    bool sweeping() const { return sweeper_.active(); }
+
+    /// Returns true if small objects are allocated from size class pages.
+    bool size_classes() const { return size_classes_; }
+
+    /// Enables or disables size class pages. When enabled, every object of up to `max_slot_cells`
+    /// cells is allocated from a page that only contains objects of the same size. These pages
+    /// are divided into slots, allocation takes the next free slot from the page's block bitmap
+    /// instead of searching the free lists. All other objects are allocated from the free space.
+    ///
+    /// Disabled by default: every size class needs a page of its own (per region), which
+    /// increases the minimum heap size. Existing pages are not affected by this setting.
+    void size_classes(bool enabled) { size_classes_ = enabled; }
+
+    /// Configures when completely empty pages are returned to the heap's allocator, which allows
+    /// the heap to shrink after a spike in memory usage.
+    ///
+    /// An empty page is released when it is found by the sweep and it has not been used for allocations
+    /// during the last `release_cycles` collections. The first `spare_pages` empty pages
+    /// found by every sweep are always retained.
+    void page_retention(u32 spare_pages, u32 release_cycles);
+
+    /// Sweeps all pages that have not been swept since the last collection.
+    /// Must be called before the objects on the heap's pages are inspected.
+    void finish_sweep();
+
+    /// Invokes `fn(Header*)` for every marked object in the heap.
+    /// After a major collection, these are all live objects.
+    /// \pre all pages must have been swept.
+    template<typename Function>
+    void for_each_marked_object(Function&& fn) {
+        TIRO_DEBUG_ASSERT(!sweeper_.active(), "all pages must have been swept");
+        for (auto page : pages_)
+            for_each_marked_object(page, fn);
+        for (auto lob : lobs_) {
+            if (lob->is_marked())
+                fn(reinterpret_cast<Header*>(lob->cell()));
+        }
+    }
+
+    /// Reports a sample of the allocated objects to the given observer: on average, one object
+    /// is sampled every `interval` bytes. The distance between two samples is randomized to avoid bias
+    /// towards allocation patterns that repeat with the same period.
+    /// Passing a null observer disables sampling.
+    /// \pre `interval > 0` if `observer` is not null.
+    void sample_allocations(AllocationObserver* observer, size_t interval);
+
 private:
     friend Collector;
 
-    /// Called by the collector with the number of traced (live) objects.
-    void update_allocated_objects(size_t count) { stats_.allocated_objects = count; }
+    /// Called by the collector with the number and the size of the traced (live) objects.
+    void update_allocated(size_t objects, size_t bytes) {
+        stats_.allocated_objects = objects;
+        stats_.allocated_bytes = bytes;
+    }
+
+    /// Called by the collector before a major collection. Resets the mark bits of all objects
+    /// (which moves them back into the young generation until they are traced again)
+    /// and clears the remembered set.
+    void clear_marks();
+
+    /// Called by the collector after tracing the heap with the pages that should be evacuated.
+    /// Free blocks in these pages are not registered with the free space until `end_evacuation()` is called.
+    /// Returns false if `pages` is empty.
+    bool begin_evacuation(std::vector<Page*> pages);
+
+    /// Moves the object to another page and leaves a forwarding pointer at its old location.
+    /// Returns the new address of the object, or nullptr if the heap cannot grow any further.
+    /// \pre the object must be marked, all pages must have been swept.
+    Header* evacuate(Header* object);
+
+    /// Sweeps the evacuated pages again (all moved objects are dead at their old location)
+    /// and registers their free blocks with the free space.
+    void end_evacuation();
+
+    /// Invokes `fn(Header*)` for every marked object that may contain references, i.e. for all
+    /// marked objects outside of the data region.
+    /// \pre all pages must have been swept.
+    template<typename Function>
+    void for_each_marked_generic_object(Function&& fn) {
+        TIRO_DEBUG_ASSERT(!sweeper_.active(), "all pages must have been swept");
+        for (auto page : pages_) {
+            if (page->region() != Region::Data)
+                for_each_marked_object(page, fn);
+        }
+        for (auto lob : lobs_) {
+            if (lob->region() != Region::Data && lob->is_marked())
+                fn(reinterpret_cast<Header*>(lob->cell()));
+        }
+    }
+
+    /// Invokes `fn(Header*)` for every marked object in the given page.
+    template<typename Function>
+    static void for_each_marked_object(Page* page, Function&& fn) {
+        auto block = page->block_bitmap();
+        auto mark = page->mark_bitmap();
+        for (size_t index = block.find_set(); index != block.npos; index = block.find_set(index + 1)) {
+            if (mark.test(index))
+                fn(reinterpret_cast<Header*>(page->cell(index)));
+        }
+    }
 
     /// Called by the collector after tracing the heap.
+    /// Frees unmarked large objects and invokes finalizers of unmarked objects immediately,
+    /// but the pages themselves are swept lazily (see `Sweeper`).
     void sweep();
 
 private:
@@ -225,36 +455,127 @@ private:
     /// Throws a `tiro::Error` with code `TIRO_ERROR_ALLOC` on error.
     ///
     /// \pre `bytes > 0`
-    std::tuple<void*, ChunkType> allocate(size_t bytes);
+    std::tuple<void*, ChunkType> allocate(size_t bytes, Region region);
 
     /// Marks an object has having a finalizer.
     /// Must be called after allocate (when the object has been constructed) or not at all.
     /// \pre `address` points to a valid object.
     void mark_finalizer(ChunkType chunk, void* address);
 
+    // Reports an allocation to the sampling observer and starts the next countdown.
+    void sample_allocation(Header* object, size_t bytes);
+
+    // Draws the distance (in bytes) to the next sampled allocation.
+    size_t next_sample_distance();
+
+    // Allocates `count` cells from a page of the given region, using the region's allocation buffer
+    // if possible. Returns nullptr if there is not enough free space.
+    Cell* allocate_cells(u32 count, Region region);
+
+    // Allocates `count` cells from the region's free space, using the allocation buffer if possible.
+    // Returns nullptr if the free space does not contain a large enough block.
+    Cell* allocate_free(u32 count, Region region);
+
+    // Allocates a slot of `count` cells from a size class page of the given region.
+    // Returns nullptr if no page of that size class has a free slot.
+    // \pre `count > 0 && count <= max_slot_cells`.
+    Cell* allocate_slot(u32 count, Region region);
+
+    // Returns the slot size for objects of the given size, or zero if the object is allocated
+    // from the free space.
+    u32 slot_cells(u32 count) const {
+        return size_classes_ && count <= max_slot_cells ? count : 0;
+    }
+
+    // Sweeps the next page and registers its free blocks with the free space of the page's region
+    // (or with its size class). Empty pages are retained for any region or released instead
+    // (see page_retention()). Returns false if all pages have been swept already.
+    bool sweep_next();
+
+    // Registers the free cells of a swept page that contains live objects.
+    void register_swept(Page* page, u32 free_cells, const std::vector<Span<Cell>>& free_blocks);
+
+    // Moves an empty page retained by the sweep into the given region, with the given
+    // slot size (zero for a page without slots). Returns false if there are no empty pages.
+    bool reuse_empty_page(Region region, u32 slot_cells);
+
+    // Returns the unused cells of the allocation buffers to the free space.
+    void retire_buffers();
+
+    // Allocation state of a size class in a region.
+    struct SizeClass {
+        // Page that is used for allocations, may be null.
+        Page* current = nullptr;
+
+        // Swept pages with free slots.
+        std::vector<Page*> available;
+    };
+
+    FreeSpace& free_space(Region region) { return free_[static_cast<size_t>(region)]; }
+    AllocationBuffer& buffer(Region region) { return buffers_[static_cast<size_t>(region)]; }
+    SizeClass& size_class(Region region, u32 slot_cells) {
+        TIRO_DEBUG_ASSERT(slot_cells > 0 && slot_cells <= max_slot_cells, "invalid slot size");
+        return size_classes_by_region_[static_cast<size_t>(region)][slot_cells - 1];
+    }
+
     // Allocates and registers.
-    NotNull<Page*> add_page();
-    NotNull<LargeObject*> add_lob(u32 cells);
+    NotNull<Page*> add_page(Region region, u32 slot_cells);
+    NotNull<LargeObject*> add_lob(u32 cells, Region region);
 
     // Must already be unregistered.
     void destroy_lob(NotNull<LargeObject*> lob);
 
+    // Unregisters and destroys an empty page. The page must not be referenced by the free space.
+    void release_page(NotNull<Page*> page);
+
 private:
     friend LargeObject;
     friend Page;
 
     void* allocate_raw(size_t size, size_t align);
     void free_raw(void* block, size_t size, size_t align);
+    void* resize_raw(void* block, size_t old_size, size_t new_size, size_t align, bool may_move);
 
 private:
     HeapAllocator& alloc_;
     const PageLayout layout_;
     Collector collector_;
-    FreeSpace free_;
+    std::array<FreeSpace, region_count> free_;
+    std::array<AllocationBuffer, region_count> buffers_;
+    std::array<std::array<SizeClass, max_slot_cells>, region_count> size_classes_by_region_;
+    bool size_classes_ = false;
+    Sweeper sweeper_;
+    std::vector<Page*> sweep_pages_; // Reused buffer for Sweeper::start()
     absl::flat_hash_set<NotNull<Page*>> pages_;
     absl::flat_hash_set<NotNull<LargeObject*>> lobs_;
+
+    // Old objects that may contain references to young objects.
+    std::vector<Header*> remembered_;
+
     HeapStats stats_;
     size_t max_size_ = size_t(-1);
+
+    // Page retention policy, see page_retention().
+    u32 spare_pages_ = 1;
+    u32 page_release_cycles_ = 2;
+
+    // Number of empty pages retained by the current sweep.
+    u32 retained_pages_ = 0;
+
+    // Empty pages retained by the current sweep that have not been reused yet.
+    // Their cells are counted as free but they are not registered with any free space.
+    std::vector<Page*> empty_pages_;
+
+    // Pages selected for evacuation by the collector.
+    absl::flat_hash_set<Page*> evacuating_;
+
+    // Allocation sampling, see sample_allocations(). `sample_countdown_` is the number of bytes until
+    // the next sample and `sample_distance_` the initial value of the current countdown.
+    AllocationObserver* sample_observer_ = nullptr;
+    size_t sample_countdown_ = std::numeric_limits<size_t>::max();
+    size_t sample_distance_ = 0;
+    std::exponential_distribution<double> sample_distribution_;
+    std::minstd_rand sample_random_;
 };
 
 } // namespace tiro::vm
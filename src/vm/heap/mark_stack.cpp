@@ -0,0 +1,73 @@
+#include "vm/heap/mark_stack.hpp"
+
+#include "common/assert.hpp"
+
+#include <new>
+
+namespace tiro::vm {
+
+MarkStack::MarkStack() {
+    for (size_t i = 0; i < reserved_segments; ++i) {
+        auto segment = new Segment();
+        segment->next = free_;
+        free_ = segment;
+        ++segments_;
+    }
+}
+
+MarkStack::~MarkStack() {
+    clear();
+    while (free_) {
+        auto segment = free_;
+        free_ = segment->next;
+        delete segment;
+    }
+}
+
+void MarkStack::clear() {
+    while (top_) {
+        top_->size = 0;
+        shrink();
+    }
+    size_ = 0;
+    overflowed_ = false;
+}
+
+void MarkStack::trim() {
+    while (free_ && segments_ > reserved_segments) {
+        auto segment = free_;
+        free_ = segment->next;
+        delete segment;
+        --segments_;
+    }
+}
+
+bool MarkStack::grow() {
+    Segment* segment = free_;
+    if (segment) {
+        free_ = segment->next;
+    } else {
+        if (max_segments_ != 0 && segments_ >= max_segments_)
+            return false;
+
+        segment = new (std::nothrow) Segment();
+        if (!segment)
+            return false;
+        ++segments_;
+    }
+
+    segment->next = top_;
+    segment->size = 0;
+    top_ = segment;
+    return true;
+}
+
+void MarkStack::shrink() {
+    TIRO_DEBUG_ASSERT(top_ && top_->size == 0, "top segment must be empty");
+    auto segment = top_;
+    top_ = segment->next;
+    segment->next = free_;
+    free_ = segment;
+}
+
+} // namespace tiro::vm
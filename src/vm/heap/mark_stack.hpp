@@ -0,0 +1,119 @@
+#ifndef TIRO_VM_HEAP_MARK_STACK_HPP
+#define TIRO_VM_HEAP_MARK_STACK_HPP
+
+#include "common/defs.hpp"
+#include "vm/heap/fwd.hpp"
+
+namespace tiro::vm {
+
+/// An object that has been marked but not traced yet.
+/// Large objects are traced in several steps: `offset` is the index of the first
+/// trailing slot (e.g. array element) that has not been visited yet.
+struct MarkItem {
+    Header* object = nullptr;
+    size_t offset = 0;
+};
+
+/// The stack of objects that must be traced by the collector.
+///
+/// The stack consists of segments of fixed size that are cached between collections, so
+/// marking usually does not allocate any memory. A number of segments is allocated in advance
+/// and is never released. Additional segments are allocated on demand (up to the configured limit).
+///
+/// Pushing never fails: if no segment can be obtained, the item is dropped and the stack is
+/// marked as overflowed. The collector must then recover by tracing all marked objects again
+/// (see `Collector::rescan_marked()`).
+class MarkStack final {
+public:
+    /// Number of items in a single segment.
+    static constexpr size_t segment_size = 1022;
+
+    /// Number of segments allocated in advance.
+    static constexpr size_t reserved_segments = 4;
+
+    MarkStack();
+    ~MarkStack();
+
+    MarkStack(const MarkStack&) = delete;
+    MarkStack& operator=(const MarkStack&) = delete;
+
+    /// Returns true if the stack is empty.
+    bool empty() const { return top_ == nullptr; }
+
+    /// Returns the number of items on the stack.
+    size_t size() const { return size_; }
+
+    /// Pushes an item onto the stack. Returns false (and sets the overflow flag) if the item
+    /// has been dropped because no memory was available.
+    bool push(const MarkItem& item) {
+        if (TIRO_UNLIKELY(!top_ || top_->size == segment_size)) {
+            if (!grow()) {
+                overflowed_ = true;
+                return false;
+            }
+        }
+        top_->items[top_->size++] = item;
+        ++size_;
+        return true;
+    }
+
+    /// Removes the topmost item from the stack and stores it in `item`.
+    /// Returns false if the stack is empty.
+    bool pop(MarkItem& item) {
+        if (!top_)
+            return false;
+
+        item = top_->items[--top_->size];
+        --size_;
+        if (top_->size == 0)
+            shrink();
+        return true;
+    }
+
+    /// Removes all items from the stack and resets the overflow flag.
+    void clear();
+
+    /// Returns true if an item has been dropped since the flag was last reset.
+    bool overflowed() const { return overflowed_; }
+
+    /// Resets the overflow flag.
+    void reset_overflow() { overflowed_ = false; }
+
+    /// Returns the maximum number of segments (including the reserved segments).
+    size_t max_segments() const { return max_segments_; }
+
+    /// Limits the number of segments. Zero means that there is no limit (the default).
+    /// The reserved segments are always available.
+    void max_segments(size_t limit) { max_segments_ = limit; }
+
+    /// Returns the number of allocated segments (in use or cached).
+    size_t segments() const { return segments_; }
+
+    /// Releases cached segments beyond the reserved segments.
+    void trim();
+
+private:
+    struct Segment {
+        Segment* next = nullptr;
+        size_t size = 0;
+        MarkItem items[segment_size];
+    };
+
+    // Makes room for at least one item by pushing a new segment. Returns false on failure.
+    bool grow();
+
+    // Removes the (empty) top segment and caches it.
+    void shrink();
+
+private:
+    Segment* top_ = nullptr;  // Current segment (linked to the segments below)
+    Segment* free_ = nullptr; // Cached free segments
+    size_t size_ = 0;
+    size_t segments_ = 0;
+    size_t max_segments_ = 0;
+    bool overflowed_ = false;
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_HEAP_MARK_STACK_HPP
@@ -1,7 +1,13 @@
 #include "vm/heap/memory.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 
+#if defined(__linux__)
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
 namespace tiro::vm {
 
 #if defined(__APPLE__)
@@ -59,6 +65,118 @@ static void deallocate_aligned_impl(void* block, size_t size, size_t alignment)
 
 #endif
 
+#if defined(__linux__)
+
+// Linux implementation of memory mapping based on mmap and mremap.
+
+static size_t os_page_size() {
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// Rounds up to a multiple of the os page size. Throws if the result is not representable.
+static size_t round_to_os_pages(size_t size) {
+    const size_t page_size = os_page_size();
+    if (!checked_add(size, page_size - 1))
+        throw std::bad_alloc();
+    return size & ~(page_size - 1);
+}
+
+static void advise_huge_pages([[maybe_unused]] void* block, [[maybe_unused]] size_t size) {
+#    ifdef MADV_HUGEPAGE
+    // Only a hint: fails if transparent huge pages are not available, which is fine.
+    if (size >= huge_page_size)
+        ::madvise(block, size, MADV_HUGEPAGE);
+#    endif
+}
+
+static bool memory_mapping_supported_impl() {
+    return true;
+}
+
+static void* map_aligned_impl(size_t size, size_t alignment) {
+    size = round_to_os_pages(size);
+    alignment = std::max(alignment, os_page_size());
+    if (size >= huge_page_size)
+        alignment = std::max(alignment, huge_page_size);
+
+    // Map enough memory to contain an aligned block of the requested size, then unmap the excess.
+    size_t mapped_size = size;
+    if (!checked_add(mapped_size, alignment - os_page_size()))
+        throw std::bad_alloc();
+
+    void* mapped = ::mmap(
+        nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED)
+        throw std::bad_alloc();
+
+    const uintptr_t mapped_begin = reinterpret_cast<uintptr_t>(mapped);
+    const uintptr_t mapped_end = mapped_begin + mapped_size;
+    const uintptr_t begin = (mapped_begin + alignment - 1) & aligned_container_mask(alignment);
+    const uintptr_t end = begin + size;
+    if (begin != mapped_begin)
+        ::munmap(mapped, begin - mapped_begin);
+    if (end != mapped_end)
+        ::munmap(reinterpret_cast<void*>(end), mapped_end - end);
+
+    void* block = reinterpret_cast<void*>(begin);
+    advise_huge_pages(block, size);
+    return block;
+}
+
+static void unmap_aligned_impl(void* block, size_t size, size_t alignment) {
+    (void) alignment;
+    [[maybe_unused]] int result = ::munmap(block, round_to_os_pages(size));
+    TIRO_DEBUG_ASSERT(result == 0, "Failed to unmap memory.");
+}
+
+static void*
+remap_aligned_impl(void* block, size_t old_size, size_t new_size, size_t alignment, bool may_move) {
+    // The operating system only guarantees page alignment for moved blocks.
+    if (alignment > os_page_size())
+        may_move = false;
+
+    old_size = round_to_os_pages(old_size);
+    new_size = round_to_os_pages(new_size);
+    if (old_size == new_size)
+        return block;
+
+    void* result = ::mremap(block, old_size, new_size, may_move ? MREMAP_MAYMOVE : 0);
+    if (result == MAP_FAILED)
+        return nullptr;
+
+    advise_huge_pages(result, new_size);
+    return result;
+}
+
+#else
+
+// Platforms without support for memory mapping fall back to the system heap.
+
+static bool memory_mapping_supported_impl() {
+    return false;
+}
+
+static void* map_aligned_impl(size_t size, size_t alignment) {
+    return allocate_aligned_impl(size, alignment);
+}
+
+static void unmap_aligned_impl(void* block, size_t size, size_t alignment) {
+    deallocate_aligned_impl(block, size, alignment);
+}
+
+static void*
+remap_aligned_impl(void* block, size_t old_size, size_t new_size, size_t alignment, bool may_move) {
+    (void) block;
+    (void) old_size;
+    (void) new_size;
+    (void) alignment;
+    (void) may_move;
+    return nullptr;
+}
+
+#endif
+
 void* allocate_aligned(size_t size, size_t alignment) {
     TIRO_DEBUG_ASSERT(is_pow2(alignment), "The alignment must be a power of two.");
     TIRO_DEBUG_ASSERT(size >= alignment, "The size must be >= the alignment.");
@@ -69,4 +187,23 @@ void deallocate_aligned(void* block, size_t size, size_t alignment) {
     deallocate_aligned_impl(block, size, alignment);
 }
 
+bool memory_mapping_supported() {
+    return memory_mapping_supported_impl();
+}
+
+void* map_aligned(size_t size, size_t alignment) {
+    TIRO_DEBUG_ASSERT(is_pow2(alignment), "The alignment must be a power of two.");
+    TIRO_DEBUG_ASSERT(size > 0, "The size must not be zero.");
+    return map_aligned_impl(size, alignment);
+}
+
+void unmap_aligned(void* block, size_t size, size_t alignment) {
+    unmap_aligned_impl(block, size, alignment);
+}
+
+void* remap_aligned(void* block, size_t old_size, size_t new_size, size_t alignment, bool may_move) {
+    TIRO_DEBUG_ASSERT(new_size > 0, "The size must not be zero.");
+    return remap_aligned_impl(block, old_size, new_size, alignment, may_move);
+}
+
 } // namespace tiro::vm
@@ -33,6 +33,33 @@ void* allocate_aligned(size_t size, size_t alignment);
 /// Size and alignment must be the same as the arguments used during the initial allocation.
 void deallocate_aligned(void* block, size_t size, size_t alignment);
 
+/// Size of a (transparent) huge page on platforms that support them.
+inline constexpr size_t huge_page_size = size_t(1) << 21;
+
+/// Returns true if blocks can be mapped directly from the operating system on this platform,
+/// see `map_aligned()`.
+bool memory_mapping_supported();
+
+/// Maps `size` bytes of zeroed memory directly from the operating system.
+/// The returned address will be aligned correctly w.r.t. `alignment`, which must be a power of two.
+/// Blocks of at least `huge_page_size` bytes are aligned to huge pages and the operating system
+/// is advised to back them with transparent huge pages.
+///
+/// \pre `memory_mapping_supported()`.
+void* map_aligned(size_t size, size_t alignment);
+
+/// Unmaps a block of memory previously mapped through `map_aligned()` or `remap_aligned()`.
+/// Size and alignment must be the same as the arguments used when mapping the block.
+void unmap_aligned(void* block, size_t size, size_t alignment);
+
+/// Attempts to resize a block of memory previously mapped through `map_aligned()` or `remap_aligned()`
+/// without copying its contents. The block is resized in place if possible. Otherwise, if `may_move` is true,
+/// its pages may be moved to a new address by the operating system (only if `alignment` does not exceed the
+/// operating system's page size).
+/// Returns the (possibly new) address of the block on success. Returns nullptr on failure, in which case the
+/// original block remains valid. Always fails if `memory_mapping_supported()` is false.
+void* remap_aligned(void* block, size_t old_size, size_t new_size, size_t alignment, bool may_move);
+
 } // namespace tiro::vm
 
 #endif // TIRO_VM_HEAP_MEMORY_HPP
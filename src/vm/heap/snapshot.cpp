@@ -0,0 +1,236 @@
+#include "vm/heap/snapshot.hpp"
+
+#include "vm/context.hpp"
+#include "vm/heap/heap.hpp"
+#include "vm/objects/all.hpp"
+#include "vm/root_set.ipp"
+
+#include "absl/container/flat_hash_map.h"
+#include "fmt/format.h"
+
+#include <nlohmann/json.hpp>
+
+#include <iterator>
+#include <vector>
+
+namespace tiro::vm {
+
+namespace {
+
+// Maximum number of bytes of a string's content that are included in the snapshot.
+constexpr size_t max_string_preview = 64;
+
+class SnapshotWriter final {
+public:
+    explicit SnapshotWriter(Context& ctx)
+        : ctx_(ctx)
+        , heap_(ctx.heap()) {}
+
+    std::string run();
+
+private:
+    class RootTracer;
+
+    void collect_objects();
+    void collect_roots();
+    void write_objects();
+    void write_roots();
+
+    u32 type_index(ValueType type);
+    std::string object_name(Header* object);
+
+    // Returns the index of the referenced object, or -1 if the value is not a heap object.
+    i64 object_index(Value value) const;
+
+    void write_string(std::string_view str);
+
+private:
+    Context& ctx_;
+    Heap& heap_;
+    std::string out_;
+
+    std::vector<Header*> objects_;
+    absl::flat_hash_map<Header*, u32> indices_;
+
+    std::vector<ValueType> types_;
+    absl::flat_hash_map<ValueType, u32> type_indices_;
+
+    std::vector<std::string> root_labels_;
+    std::vector<std::pair<u32, u32>> roots_; // (label index, object index)
+
+    std::vector<u32> references_; // Reused buffer
+};
+
+} // namespace
+
+class SnapshotWriter::RootTracer final {
+public:
+    explicit RootTracer(SnapshotWriter& writer)
+        : writer_(writer) {}
+
+    RootTracer(const RootTracer&) = delete;
+    RootTracer& operator=(const RootTracer&) = delete;
+
+    void operator()(Value& value) {
+        TIRO_DEBUG_ASSERT(!writer_.root_labels_.empty(), "roots must be labelled");
+        if (auto index = writer_.object_index(value); index >= 0) {
+            const u32 label = static_cast<u32>(writer_.root_labels_.size() - 1);
+            writer_.roots_.emplace_back(label, static_cast<u32>(index));
+        }
+    }
+
+    void operator()(HashTableEntry& value) { value.trace(*this); }
+
+    template<typename T>
+    void operator()(Span<T> values) {
+        for (auto& v : values) {
+            operator()(v);
+        }
+    }
+
+private:
+    SnapshotWriter& writer_;
+};
+
+std::string SnapshotWriter::run() {
+    // Only reachable objects remain marked after a major collection.
+    heap_.collector().collect(GcReason::Forced);
+    heap_.finish_sweep();
+
+    collect_objects();
+    collect_roots();
+
+    out_ += "{\"version\":1,\"objects\":[";
+    write_objects();
+    out_ += "],\"roots\":[";
+    write_roots();
+    out_ += "],\"types\":[";
+    for (size_t i = 0; i < types_.size(); ++i) {
+        if (i > 0)
+            out_ += ',';
+        write_string(to_string(types_[i]));
+    }
+    out_ += "]}";
+    return std::move(out_);
+}
+
+void SnapshotWriter::collect_objects() {
+    heap_.for_each_marked_object([&](Header* object) {
+        indices_.emplace(object, static_cast<u32>(objects_.size()));
+        objects_.push_back(object);
+    });
+}
+
+void SnapshotWriter::collect_roots() {
+    RootTracer tracer(*this);
+    ctx_.trace_labelled([&](std::string_view label) { root_labels_.emplace_back(label); }, tracer);
+
+    for (u32 i = 0, n = static_cast<u32>(objects_.size()); i < n; ++i) {
+        auto value = HeapValue(objects_[i]);
+        if (value.type() != ValueType::Module)
+            continue;
+
+        root_labels_.push_back(fmt::format("module {}", Module(value).name().view()));
+        roots_.emplace_back(static_cast<u32>(root_labels_.size() - 1), i);
+    }
+}
+
+void SnapshotWriter::write_objects() {
+    auto& collector = heap_.collector();
+    for (size_t i = 0, n = objects_.size(); i < n; ++i) {
+        Header* object = objects_[i];
+        auto value = HeapValue(object);
+
+        references_.clear();
+        collector.visit_references(object, [&](Value& ref) {
+            if (auto index = object_index(ref); index >= 0)
+                references_.push_back(static_cast<u32>(index));
+        });
+
+        if (i > 0)
+            out_ += ',';
+        fmt::format_to(std::back_inserter(out_), "[{},{},[", type_index(value.type()),
+            object_size(value));
+        for (size_t j = 0; j < references_.size(); ++j) {
+            if (j > 0)
+                out_ += ',';
+            fmt::format_to(std::back_inserter(out_), "{}", references_[j]);
+        }
+        out_ += ']';
+
+        if (auto name = object_name(object); !name.empty()) {
+            out_ += ',';
+            write_string(name);
+        }
+        out_ += ']';
+    }
+}
+
+void SnapshotWriter::write_roots() {
+    for (size_t i = 0, n = roots_.size(); i < n; ++i) {
+        const auto& [label, object] = roots_[i];
+        if (i > 0)
+            out_ += ',';
+        out_ += '[';
+        write_string(root_labels_[label]);
+        fmt::format_to(std::back_inserter(out_), ",{}]", object);
+    }
+}
+
+u32 SnapshotWriter::type_index(ValueType type) {
+    auto [pos, inserted] = type_indices_.emplace(type, static_cast<u32>(types_.size()));
+    if (inserted)
+        types_.push_back(type);
+    return pos->second;
+}
+
+std::string SnapshotWriter::object_name(Header* object) {
+    auto value = HeapValue(object);
+    switch (value.type()) {
+    case ValueType::Module:
+        return std::string(Module(value).name().view());
+    case ValueType::String: {
+        auto str = String(value).view();
+        return std::string(str.substr(0, max_string_preview));
+    }
+    case ValueType::Symbol:
+        return std::string(Symbol(value).name().view());
+    case ValueType::Type:
+        return std::string(Type(value).name().view());
+    case ValueType::CodeFunctionTemplate: {
+        auto tmpl = CodeFunctionTemplate(value);
+        return fmt::format("{}.{}", tmpl.module().name().view(), tmpl.name().view());
+    }
+    case ValueType::CodeFunction: {
+        auto tmpl = CodeFunction(value).tmpl();
+        return fmt::format("{}.{}", tmpl.module().name().view(), tmpl.name().view());
+    }
+    case ValueType::NativeFunction:
+        return std::string(NativeFunction(value).name().view());
+    case ValueType::Coroutine:
+        return std::string(Coroutine(value).name().view());
+    default:
+        return {};
+    }
+}
+
+i64 SnapshotWriter::object_index(Value value) const {
+    if (value.is_null() || !value.is_heap_ptr())
+        return -1;
+
+    auto pos = indices_.find(HeapValue(value).heap_ptr());
+    TIRO_DEBUG_ASSERT(pos != indices_.end(), "referenced objects must be live");
+    return pos != indices_.end() ? static_cast<i64>(pos->second) : -1;
+}
+
+void SnapshotWriter::write_string(std::string_view str) {
+    // Strings are not required to be valid utf8, invalid sequences are replaced.
+    out_ += nlohmann::json(str).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+std::string heap_snapshot(Context& ctx) {
+    SnapshotWriter writer(ctx);
+    return writer.run();
+}
+
+} // namespace tiro::vm
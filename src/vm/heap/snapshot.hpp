@@ -0,0 +1,37 @@
+#ifndef TIRO_VM_HEAP_SNAPSHOT_HPP
+#define TIRO_VM_HEAP_SNAPSHOT_HPP
+
+#include "vm/fwd.hpp"
+
+#include <string>
+
+namespace tiro::vm {
+
+/// Returns a snapshot of all live objects in the context's heap as a json document.
+///
+/// A major collection is performed first, so the snapshot contains exactly the reachable objects.
+/// The document has the following structure:
+///
+///     {
+///         "version": 1,
+///         "objects": [[<type>, <size>, [<reference>, ...], <name>], ...],
+///         "roots": [[<label>, <object>], ...],
+///         "types": ["Array", "String", ...]
+///     }
+///
+/// Objects are identified by their index in "objects". `type` is an index into "types", `size`
+/// is the size of the object in bytes and the references are the indices of all objects referenced
+/// by the object (including its type instance), as seen by the garbage collector.
+/// The name is optional and only present for objects with a natural description, e.g. modules,
+/// functions, types or (the start of) strings.
+///
+/// Roots are labelled by the group of roots that references them (e.g. "modules", "externals" or
+/// "interpreter"). In addition, every module is listed as a root labelled "module <name>", which
+/// makes the memory retained by individual modules visible in dominator reports.
+///
+/// Snapshots are meant for offline analysis, e.g. with the `tiro_heap_report` tool.
+std::string heap_snapshot(Context& ctx);
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_HEAP_SNAPSHOT_HPP
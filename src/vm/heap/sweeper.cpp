@@ -0,0 +1,124 @@
+#include "vm/heap/sweeper.hpp"
+
+#include "common/assert.hpp"
+#include "vm/heap/chunks.hpp"
+
+namespace tiro::vm {
+
+Sweeper::Sweeper() {}
+
+Sweeper::~Sweeper() {
+    TIRO_DEBUG_ASSERT(!active(), "sweeper must not be active when it is destroyed");
+    stop_threads();
+}
+
+void Sweeper::threads(u32 count) {
+    TIRO_DEBUG_ASSERT(!active(), "sweeper must not be active");
+    finish();
+    stop_threads();
+
+    threads_.reserve(count);
+    for (u32 i = 0; i < count; ++i)
+        threads_.emplace_back([this]() { worker(); });
+}
+
+void Sweeper::start(const std::vector<Page*>& pages) {
+    TIRO_DEBUG_ASSERT(!active(), "sweeper is already active");
+    finish();
+
+    std::unique_lock lock(mutex_);
+    entries_ = std::make_unique<Entry[]>(pages.size());
+    for (size_t i = 0, n = pages.size(); i < n; ++i)
+        entries_[i].result.page = pages[i];
+    count_ = pages.size();
+    next_ = 0;
+    claim_.store(0, std::memory_order_relaxed);
+
+    if (!threads_.empty() && count_ > 0) {
+        sweeping_ = true;
+        cycle_ += 1;
+        wake_helpers_.notify_all();
+    }
+}
+
+const Sweeper::SweptPage* Sweeper::next() {
+    if (next_ >= count_)
+        return nullptr;
+
+    Entry& entry = entries_[next_++];
+    u8 expected = Unswept;
+    if (entry.state.compare_exchange_strong(expected, Sweeping, std::memory_order_acquire)) {
+        sweep(entry);
+        entry.state.store(Swept, std::memory_order_relaxed);
+    } else {
+        // The page is being swept by a helper thread, which usually takes only a few microseconds.
+        while (entry.state.load(std::memory_order_acquire) != Swept)
+            std::this_thread::yield();
+    }
+    return &entry.result;
+}
+
+void Sweeper::finish() {
+    TIRO_DEBUG_ASSERT(!active(), "all pages must have been consumed");
+
+    std::unique_lock lock(mutex_);
+    helpers_idle_.wait(lock, [&]() { return busy_ == 0; });
+    sweeping_ = false;
+}
+
+void Sweeper::sweep(Entry& entry) {
+    SweptPage& result = entry.result;
+    result.free_cells = result.page->sweep(result.free_blocks);
+}
+
+void Sweeper::help(Entry* entries, size_t count) {
+    while (1) {
+        const size_t index = claim_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count)
+            return;
+
+        Entry& entry = entries[index];
+        u8 expected = Unswept;
+        if (entry.state.compare_exchange_strong(expected, Sweeping, std::memory_order_acquire)) {
+            sweep(entry);
+            entry.state.store(Swept, std::memory_order_release);
+        }
+    }
+}
+
+void Sweeper::worker() {
+    std::unique_lock lock(mutex_);
+    u64 seen_cycle = 0;
+    while (1) {
+        wake_helpers_.wait(lock, [&]() { return stop_ || (sweeping_ && cycle_ != seen_cycle); });
+        if (stop_)
+            return;
+
+        seen_cycle = cycle_;
+        Entry* entries = entries_.get();
+        const size_t count = count_;
+        busy_ += 1;
+        lock.unlock();
+
+        help(entries, count);
+
+        lock.lock();
+        busy_ -= 1;
+        if (busy_ == 0)
+            helpers_idle_.notify_all();
+    }
+}
+
+void Sweeper::stop_threads() {
+    {
+        std::unique_lock lock(mutex_);
+        stop_ = true;
+        wake_helpers_.notify_all();
+    }
+    for (auto& thread : threads_)
+        thread.join();
+    threads_.clear();
+    stop_ = false;
+}
+
+} // namespace tiro::vm
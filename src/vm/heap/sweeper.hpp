@@ -0,0 +1,111 @@
+#ifndef TIRO_VM_HEAP_SWEEPER_HPP
+#define TIRO_VM_HEAP_SWEEPER_HPP
+
+#include "common/adt/span.hpp"
+#include "common/defs.hpp"
+#include "vm/heap/common.hpp"
+#include "vm/heap/fwd.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tiro::vm {
+
+/// Sweeps the pages of a heap after the collector has traced it.
+///
+/// Sweeping is lazy: `start()` only records the pages that must be swept. The heap requests
+/// pages one at a time (see `next()`) when it runs out of free space, and all remaining pages
+/// are swept by `finish()` before the next collection starts.
+///
+/// Optionally, a number of helper threads sweep pages in the background. A page is claimed
+/// by exactly one thread (either a helper or the heap's own thread) and only its bitmaps
+/// are modified during the sweep. The resulting free blocks are always registered with the
+/// free space by the heap's thread, so the free space itself does not need synchronization.
+class Sweeper final {
+public:
+    /// The result of sweeping a single page.
+    struct SweptPage {
+        Page* page = nullptr;
+
+        /// Coalesced free blocks in this page.
+        std::vector<Span<Cell>> free_blocks;
+
+        /// Total number of free cells in this page.
+        u32 free_cells = 0;
+    };
+
+    Sweeper();
+    ~Sweeper();
+
+    Sweeper(const Sweeper&) = delete;
+    Sweeper& operator=(const Sweeper&) = delete;
+
+    /// Returns the number of helper threads.
+    u32 threads() const { return static_cast<u32>(threads_.size()); }
+
+    /// Sets the number of helper threads. Zero means that all pages are swept lazily by the heap's thread.
+    /// \pre `!active()`.
+    void threads(u32 count);
+
+    /// Returns true if there are pages that have not been returned by `next()`.
+    bool active() const { return next_ < count_; }
+
+    /// Starts sweeping the given pages. The finalizers of dead objects within the pages
+    /// must have been invoked already.
+    /// \pre `!active()`.
+    void start(const std::vector<Page*>& pages);
+
+    /// Returns the next swept page, sweeping it on the calling thread if it has not been claimed
+    /// by a helper thread. Waits for the helper thread otherwise.
+    /// Returns nullptr if all pages have been returned already.
+    ///
+    /// The returned pointer remains valid until the next call to `next()` or `finish()`.
+    const SweptPage* next();
+
+    /// Waits until all helper threads have stopped accessing the current set of pages.
+    /// \pre `!active()`, i.e. all pages have been returned by `next()`.
+    void finish();
+
+private:
+    enum State : u8 { Unswept, Sweeping, Swept };
+
+    struct Entry {
+        std::atomic<u8> state = Unswept;
+        SweptPage result;
+    };
+
+    static void sweep(Entry& entry);
+
+    // Sweeps pages claimed by a helper thread.
+    void help(Entry* entries, size_t count);
+
+    void worker();
+    void stop_threads();
+
+private:
+    // Pages of the current cycle, in the order in which they are returned by `next()`.
+    std::unique_ptr<Entry[]> entries_;
+    size_t count_ = 0;
+    size_t next_ = 0;
+
+    // Index of the next page that may be claimed by a helper thread.
+    std::atomic<size_t> claim_ = 0;
+
+    // Protects the fields below (and the assignment of entries_ / count_ while helpers are running).
+    std::mutex mutex_;
+    std::condition_variable wake_helpers_;
+    std::condition_variable helpers_idle_;
+    std::vector<std::thread> threads_;
+    bool stop_ = false;
+    bool sweeping_ = false;
+    u64 cycle_ = 0;
+    u32 busy_ = 0;
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_HEAP_SWEEPER_HPP
@@ -0,0 +1,122 @@
+#include "vm/inline_cache.hpp"
+
+#include "vm/objects/all.hpp"
+
+namespace tiro::vm {
+
+Tuple InlineCache::make(Context& ctx, u32 sites) {
+    return Tuple::make(ctx, static_cast<size_t>(sites) * site_size);
+}
+
+std::optional<Value> InlineCache::load(Tuple cache, u32 site, Value object) {
+    auto entry = find_entry(cache, site, key_of(object));
+    if (!entry)
+        return {};
+
+    switch (object.type()) {
+    case ValueType::Module: {
+        auto members = object.must_cast<Module>().members();
+        auto index = static_cast<size_t>(entry->must_cast<SmallInteger>().value());
+        TIRO_DEBUG_ASSERT(index < members.size(), "cached member index out of bounds");
+        return members.unchecked_get(index);
+    }
+    case ValueType::Record: {
+        auto index = static_cast<size_t>(entry->must_cast<SmallInteger>().value());
+        return object.must_cast<Record>().get_slot(index);
+    }
+    default:
+        return *entry;
+    }
+}
+
+bool InlineCache::store(Tuple cache, u32 site, Value object, Value value) {
+    if (object.type() != ValueType::Record)
+        return false;
+
+    auto record = object.must_cast<Record>();
+    auto entry = find_entry(cache, site, record.schema());
+    if (!entry)
+        return false;
+
+    auto index = static_cast<size_t>(entry->must_cast<SmallInteger>().value());
+    record.set_slot(index, value);
+    return true;
+}
+
+void InlineCache::update_member(Tuple cache, u32 site, Value object, Symbol member, Value result) {
+    switch (object.type()) {
+    case ValueType::Module: {
+        auto index = object.must_cast<Module>().find_exported_index(member);
+        TIRO_DEBUG_ASSERT(index, "member must have been exported");
+        insert_entry(cache, site, object, SmallInteger::make(static_cast<i64>(*index)));
+        return;
+    }
+    case ValueType::Record: {
+        auto schema = object.must_cast<Record>().schema();
+        auto index = schema.index_of(member);
+        TIRO_DEBUG_ASSERT(index, "member must be part of the record");
+        insert_entry(cache, site, schema, SmallInteger::make(static_cast<i64>(*index)));
+        return;
+    }
+    case ValueType::Type:
+        insert_entry(cache, site, object, result);
+        return;
+    default:
+        // Instance members are bound to their object, there is nothing worth caching.
+        return;
+    }
+}
+
+void InlineCache::update_method(Tuple cache, u32 site, Value object, Symbol member, Value result) {
+    switch (object.type()) {
+    case ValueType::Module:
+    case ValueType::Record:
+    case ValueType::Type:
+        return update_member(cache, site, object, member, result);
+    default:
+        insert_entry(cache, site, key_of(object), result);
+        return;
+    }
+}
+
+Value InlineCache::key_of(Value object) {
+    switch (object.type()) {
+    case ValueType::Module:
+    case ValueType::Type:
+        return object;
+    case ValueType::Record:
+        return object.must_cast<Record>().schema();
+    default:
+        return SmallInteger::make(static_cast<i64>(object.type()));
+    }
+}
+
+std::optional<Value> InlineCache::find_entry(Tuple cache, u32 site, Value key) {
+    const size_t start = static_cast<size_t>(site) * site_size;
+    TIRO_DEBUG_ASSERT(start + site_size <= cache.size(), "cache site out of bounds");
+
+    for (size_t i = start, end = start + site_size; i < end; i += entry_size) {
+        Value entry_key = cache.unchecked_get(i);
+        if (entry_key.same(key))
+            return cache.unchecked_get(i + 1);
+        if (entry_key.is_null())
+            break;
+    }
+    return {};
+}
+
+void InlineCache::insert_entry(Tuple cache, u32 site, Value key, Value entry) {
+    const size_t start = static_cast<size_t>(site) * site_size;
+    TIRO_DEBUG_ASSERT(start + site_size <= cache.size(), "cache site out of bounds");
+
+    // Entries are kept in insertion order: shift older entries to the back (evicting the oldest
+    // entry if the site is full) and insert the new entry at the front.
+    for (size_t i = start + site_size - entry_size; i > start; i -= entry_size) {
+        cache.unchecked_set(i, cache.unchecked_get(i - entry_size));
+        cache.unchecked_set(i + 1, cache.unchecked_get(i - entry_size + 1));
+    }
+    cache.unchecked_set(start, key);
+    cache.unchecked_set(start + 1, entry);
+}
+
+} // namespace tiro::vm
@@ -0,0 +1,65 @@
+#ifndef TIRO_VM_INLINE_CACHE_HPP
+#define TIRO_VM_INLINE_CACHE_HPP
+
+#include "vm/fwd.hpp"
+#include "vm/objects/tuple.hpp"
+#include "vm/objects/value.hpp"
+
+#include <optional>
+
+namespace tiro::vm {
+
+/// Implements polymorphic inline caches for the member access instructions
+/// `LoadMember`, `StoreMember` and `LoadMethod`.
+///
+/// Every cached instruction (a "site") owns a fixed number of cache entries (`ways`).
+/// An entry maps the identity of the receiver's shape to the result of an earlier lookup:
+///
+///  - Modules are keyed by their own identity. The entry contains the index of the exported member.
+///  - Records are keyed by their schema. The entry contains the index of the property.
+///  - Types (i.e. static member access) are keyed by their own identity. The entry contains the member value.
+///  - All other values are keyed by their builtin value type. The entry contains the member of their
+///    public type. These entries are only created for `LoadMethod`, because `LoadMember` must allocate
+///    a bound method anyway.
+///
+/// A cache hit therefore only costs a few identity comparisons and a slot load.
+/// Caching is safe because the key sets of module exports, record schemas and types never change after
+/// construction, and because the members of types are constant.
+///
+/// The entries of all sites within a function are stored in a single tuple owned by the function's template.
+/// Empty entries are null. When all entries of a site are occupied, the oldest entry is evicted.
+class InlineCache final {
+public:
+    /// The number of cache entries for every site.
+    static constexpr u32 ways = 4;
+
+    /// Creates the storage for the given number of cache sites.
+    static Tuple make(Context& ctx, u32 sites);
+
+    /// Returns the cached value of `object.member` (for `LoadMember` or `LoadMethod`).
+    /// Returns an empty optional if the lookup was not cached. Never allocates.
+    static std::optional<Value> load(Tuple cache, u32 site, Value object);
+
+    /// Stores `value` as `object.member` if the property slot was cached.
+    /// Returns false (and does nothing) if the lookup was not cached. Never allocates.
+    static bool store(Tuple cache, u32 site, Value object, Value value);
+
+    /// Remembers the result of a successful, uncached `load_member` or `store_member`
+    /// operation. Never allocates.
+    static void update_member(Tuple cache, u32 site, Value object, Symbol member, Value result);
+
+    /// Remembers the result of a successful, uncached `load_method` operation. Never allocates.
+    static void update_method(Tuple cache, u32 site, Value object, Symbol member, Value result);
+
+private:
+    static constexpr u32 entry_size = 2;
+    static constexpr u32 site_size = ways * entry_size;
+
+    static Value key_of(Value object);
+    static std::optional<Value> find_entry(Tuple cache, u32 site, Value key);
+    static void insert_entry(Tuple cache, u32 site, Value key, Value entry);
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_INLINE_CACHE_HPP
@@ -2,12 +2,16 @@
 
 #include "bytecode/op.hpp"
 #include "common/adt/function_ref.hpp"
-#include "common/memory/byte_order.hpp"
 #include "common/scope_guards.hpp"
 #include "vm/context.hpp"
+#include "vm/inline_cache.hpp"
 #include "vm/math.hpp"
 #include "vm/objects/all.hpp"
 
+#ifdef TIRO_JIT
+#include "vm/jit/jit.hpp"
+#endif
+
 #include <cstring>
 
 // #define TIRO_TRACE_CALLS
@@ -128,15 +132,6 @@ static u32 push_function_args(Context& ctx, Handle<Coroutine> coro, Handle<Nulla
     return argc;
 }
 
-template<typename T>
-static T read_big_endian(const byte*& ptr) {
-    T value;
-    std::memcpy(&value, ptr, sizeof(T));
-    value = be_to_host(value);
-    ptr += sizeof(T);
-    return value;
-}
-
 [[maybe_unused]] static void
 trace_call(Context& ctx, Handle<Coroutine> coro, Handle<Value> function, u32 argc) {
     Scope sc(ctx);
@@ -175,21 +170,104 @@ BytecodeInterpreter::BytecodeInterpreter(
     , regs_(regs)
     , coro_(coro)
     , stack_(coro.stack().value())
-    , frame_(frame) {
+    , frame_(frame)
+    , members_(frame->tmpl.module().members()) {
     TIRO_DEBUG_ASSERT(frame == stack_.top_frame(), "frame must be on top of the stack");
     TIRO_DEBUG_ASSERT(frame->type == FrameType::Code, "unexpected frame type");
+    load_frame();
 }
 
-#define TIRO_BINOP(op)                         \
-    do {                                       \
-        auto lhs = read_local();               \
-        auto rhs = read_local();               \
-        auto target = read_local();            \
-        auto result = op(ctx_, lhs, rhs);      \
-        if (result.has_exception())            \
-            return unwind(result.exception()); \
-                                               \
-        target.set(result.value());            \
+// Evaluates a comparison like the generic comparison instructions do (see `compare()`).
+// Note that the three-way comparison is significant for NaN values.
+template<QuickOp Op, typename T>
+static bool quick_compare(T a, T b) {
+    const int cmp = a > b ? 1 : (a < b ? -1 : 0);
+    if constexpr (Op == QuickOp::GtSmallInt || Op == QuickOp::GtFloat) {
+        return cmp > 0;
+    } else if constexpr (Op == QuickOp::GteSmallInt || Op == QuickOp::GteFloat) {
+        return cmp >= 0;
+    } else if constexpr (Op == QuickOp::LtSmallInt || Op == QuickOp::LtFloat) {
+        return cmp < 0;
+    } else if constexpr (Op == QuickOp::LteSmallInt || Op == QuickOp::LteFloat) {
+        return cmp <= 0;
+    } else if constexpr (Op == QuickOp::EqSmallInt) {
+        return cmp == 0;
+    } else if constexpr (Op == QuickOp::NEqSmallInt) {
+        return cmp != 0;
+    } else {
+        static_assert(Op != Op, "not a comparison");
+    }
+}
+
+// Fast path for quickened instructions with small integer operands.
+// Returns false if the generic instruction must be executed instead, i.e. if the operands are not
+// small integers or if the result cannot be represented as a small integer.
+template<QuickOp Op>
+static bool quick_small_int_op(Context& ctx, Value lhs, Value rhs, MutHandle<Value> target) {
+    if (TIRO_UNLIKELY(!lhs.is_embedded_integer() || !rhs.is_embedded_integer()))
+        return false;
+
+    // Small integers have less than 64 bits, addition and subtraction cannot overflow.
+    const i64 a = SmallInteger(lhs).value();
+    const i64 b = SmallInteger(rhs).value();
+    i64 result = 0;
+    if constexpr (Op == QuickOp::AddSmallInt) {
+        result = a + b;
+    } else if constexpr (Op == QuickOp::SubSmallInt) {
+        result = a - b;
+    } else if constexpr (Op == QuickOp::MulSmallInt) {
+        if (TIRO_UNLIKELY(!checked_mul(a, b, result)))
+            return false;
+    } else if constexpr (Op == QuickOp::ModSmallInt) {
+        if (TIRO_UNLIKELY(b == 0))
+            return false;
+        result = a % b;
+    } else {
+        target.set(ctx.get_boolean(quick_compare<Op>(a, b)));
+        return true;
+    }
+
+    if (TIRO_UNLIKELY(!SmallInteger::fits(result)))
+        return false;
+    target.set(SmallInteger::make(result));
+    return true;
+}
+
+// Fast path for quickened instructions with float operands.
+// Returns false if the generic instruction must be executed instead.
+template<QuickOp Op>
+static bool quick_float_op(Context& ctx, Value lhs, Value rhs, MutHandle<Value> target) {
+    if (TIRO_UNLIKELY(!lhs.is<Float>() || !rhs.is<Float>()))
+        return false;
+
+    const f64 a = Float(lhs).value();
+    const f64 b = Float(rhs).value();
+    if constexpr (Op == QuickOp::AddFloat) {
+        target.set(Float::make(ctx, a + b));
+    } else if constexpr (Op == QuickOp::SubFloat) {
+        target.set(Float::make(ctx, a - b));
+    } else if constexpr (Op == QuickOp::MulFloat) {
+        target.set(Float::make(ctx, a * b));
+    } else if constexpr (Op == QuickOp::DivFloat) {
+        target.set(Float::make(ctx, a / b));
+    } else {
+        target.set(ctx.get_boolean(quick_compare<Op>(a, b)));
+    }
+    return true;
+}
+
+#define TIRO_BINOP(op)                            \
+    do {                                          \
+        const CodeWord* op_word = frame_->pc - 1; \
+        auto lhs = read_local();                  \
+        auto rhs = read_local();                  \
+        auto target = read_local();               \
+        quicken(op_word, *lhs, *rhs);             \
+        auto result = op(ctx_, lhs, rhs);         \
+        if (result.has_exception())               \
+            return unwind(result.exception());    \
+                                                  \
+        target.set(result.value());               \
     } while (0)
 
 #define TIRO_UNOP(op)                          \
@@ -203,598 +281,927 @@ BytecodeInterpreter::BytecodeInterpreter(
         target.set(result.value());            \
     } while (0)
 
-#define TIRO_CMP(expr)                         \
-    do {                                       \
-        auto lhs = read_local();               \
-        auto rhs = read_local();               \
-        auto target = read_local();            \
-        auto result = compare(ctx_, lhs, rhs); \
-        if (result.has_exception())            \
-            return unwind(result.exception()); \
-                                               \
-        auto cmp = result.value();             \
-        target.set(ctx_.get_boolean((expr)));  \
+#define TIRO_CMP(expr)                            \
+    do {                                          \
+        const CodeWord* op_word = frame_->pc - 1; \
+        auto lhs = read_local();                  \
+        auto rhs = read_local();                  \
+        auto target = read_local();               \
+        quicken(op_word, *lhs, *rhs);             \
+        auto result = compare(ctx_, lhs, rhs);    \
+        if (result.has_exception())               \
+            return unwind(result.exception());    \
+                                                  \
+        auto cmp = result.value();                \
+        target.set(ctx_.get_boolean((expr)));     \
     } while (0)
 
-void BytecodeInterpreter::run() {
-    while (1) {
-        TIRO_DEBUG_ASSERT(
-            readable_bytes() > 0, "end of function reached without return from function");
+// Executes a quickened instruction through the given fast path implementation.
+// If the fast path fails, the instruction is rewritten to its generic version and dispatched again.
+#define TIRO_QUICK(name, impl)                                             \
+    do {                                                                   \
+        const CodeWord* op_word = frame_->pc - 1;                          \
+        auto lhs = read_local();                                           \
+        auto rhs = read_local();                                           \
+        auto target = read_local();                                        \
+        if (TIRO_UNLIKELY(!impl<QuickOp::name>(ctx_, *lhs, *rhs, target))) \
+            deoptimize(op_word, QuickOp::name);                            \
+    } while (0)
 
-        const BytecodeOp op = read_op();
-        // fmt::print("Running op {}\n", to_string(op));
+// Instruction dispatch uses computed goto ("threaded code") when the compiler supports it.
+// Every instruction handler jumps directly to the handler of the next instruction, which
+// gives the branch predictor one indirect jump per handler instead of a single shared one.
+// The portable fallback is a plain switch statement.
+// Define TIRO_NO_COMPUTED_GOTO to force the fallback.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(TIRO_NO_COMPUTED_GOTO)
+#    define TIRO_COMPUTED_GOTO 1
+#endif
 
-        ScopeExit reset_registers = [&] { regs_.reset(); };
-        switch (op) {
-        case BytecodeOp::LoadNull: {
-            auto target = read_local();
-            target.set(Value::null());
-            break;
-        }
-        case BytecodeOp::LoadFalse: {
-            auto target = read_local();
-            target.set(ctx_.get_boolean(false));
-            break;
-        }
-        case BytecodeOp::LoadTrue: {
-            auto target = read_local();
-            target.set(ctx_.get_boolean(true));
-            break;
-        }
-        case BytecodeOp::LoadInt: {
-            const i64 value = read_i64();
-            auto target = read_local();
-            target.set(ctx_.get_integer(value));
-            break;
-        }
-        case BytecodeOp::LoadFloat: {
-            const f64 value = read_f64();
-            auto target = read_local();
-            target.set(Float::make(ctx_, value));
-            break;
-        }
-        case BytecodeOp::LoadParam: {
-            const u32 source = read_u32();
-            auto target = read_local();
-            TIRO_DEBUG_ASSERT(source < frame_->argc, "parameter index out of bounds");
+#ifdef TIRO_COMPUTED_GOTO
+#    define TIRO_OP(name)                             \
+        case static_cast<CodeWord>(BytecodeOp::name): \
+            op_##name
+#    define TIRO_QOP(name)                         \
+        case static_cast<CodeWord>(QuickOp::name): \
+            op_##name
+#    define TIRO_NEXT() goto* dispatch_table[read_op()]
+#else
+#    define TIRO_OP(name) case static_cast<CodeWord>(BytecodeOp::name)
+#    define TIRO_QOP(name) case static_cast<CodeWord>(QuickOp::name)
+#    define TIRO_NEXT() goto dispatch
+#endif
 
-            target.set(*CoroutineStack::arg(frame_, source));
-            break;
-        }
-        case BytecodeOp::StoreParam: {
-            auto source = read_local();
-            const u32 target = read_u32();
-            TIRO_DEBUG_ASSERT(target < frame_->argc, "parameter index out of bounds");
+// Dispatches the next instruction after passing a safepoint. Leaves the interpreter loop
+// if the coroutine was preempted.
+#define TIRO_SAFEPOINT_NEXT()              \
+    do {                                   \
+        if (TIRO_UNLIKELY(!safepoint()))   \
+            return;                        \
+        TIRO_NEXT();                       \
+    } while (0)
 
-            *CoroutineStack::arg(frame_, target) = *source;
-            break;
-        }
-        case BytecodeOp::LoadModule: {
-            const u32 source = read_u32();
-            auto target = read_local();
-            target.set(get_member(source));
-            break;
-        }
-        case BytecodeOp::StoreModule: {
-            auto source = read_local();
-            const u32 index = read_u32();
-            set_member(index, *source);
-            break;
-        }
-        case BytecodeOp::LoadMember: {
-            auto object = read_local();
-            const u32 name = read_u32();
-            auto target = read_local();
+// Jumps to `target` and dispatches the next instruction. `pc` must point into the current
+// (jump) instruction. Backward jumps (i.e. loop iterations) are safepoints.
+#define TIRO_JUMP_NEXT(pc, target)      \
+    do {                                \
+        set_pc(target);                 \
+        if (frame_->pc < (pc))          \
+            TIRO_SAFEPOINT_NEXT();      \
+        TIRO_NEXT();                    \
+    } while (0)
 
-            auto name_symbol = reg(get_member(name)).must_cast<Symbol>();
-            auto res = ctx_.types().load_member(ctx_, object, name_symbol);
-            if (TIRO_UNLIKELY(res.has_exception()))
-                return unwind(res.exception());
+void BytecodeInterpreter::run() {
+#ifdef TIRO_COMPUTED_GOTO
+    // Indexed by opcode value.
+    static const void* const dispatch_table[] = {
+        &&invalid_op, // Opcodes start at 1
+        /* [[[cog
+            import cog
+            from codegen.bytecode import InstructionList
+
+            for ins in InstructionList:
+                cog.outl(f"&&op_{ins.name},")
+        ]]] */
+        &&op_LoadNull,
+        &&op_LoadFalse,
+        &&op_LoadTrue,
+        &&op_LoadInt,
+        &&op_LoadFloat,
+        &&op_LoadParam,
+        &&op_StoreParam,
+        &&op_LoadModule,
+        &&op_StoreModule,
+        &&op_LoadMember,
+        &&op_StoreMember,
+        &&op_LoadTupleMember,
+        &&op_StoreTupleMember,
+        &&op_LoadIndex,
+        &&op_StoreIndex,
+        &&op_LoadClosure,
+        &&op_LoadEnv,
+        &&op_StoreEnv,
+        &&op_Add,
+        &&op_Sub,
+        &&op_Mul,
+        &&op_Div,
+        &&op_Mod,
+        &&op_Pow,
+        &&op_UAdd,
+        &&op_UNeg,
+        &&op_LSh,
+        &&op_RSh,
+        &&op_BAnd,
+        &&op_BOr,
+        &&op_BXor,
+        &&op_BNot,
+        &&op_Gt,
+        &&op_Gte,
+        &&op_Lt,
+        &&op_Lte,
+        &&op_Eq,
+        &&op_NEq,
+        &&op_LNot,
+        &&op_Array,
+        &&op_Tuple,
+        &&op_Set,
+        &&op_Map,
+        &&op_Env,
+        &&op_Closure,
+        &&op_Record,
+        &&op_Iterator,
+        &&op_IteratorNext,
+        &&op_Formatter,
+        &&op_AppendFormat,
+        &&op_FormatResult,
+        &&op_Copy,
+        &&op_Swap,
+        &&op_Push,
+        &&op_Pop,
+        &&op_PopTo,
+        &&op_Jmp,
+        &&op_JmpTrue,
+        &&op_JmpFalse,
+        &&op_JmpNull,
+        &&op_JmpNotNull,
+        &&op_Call,
+        &&op_LoadMethod,
+        &&op_CallMethod,
+        &&op_TailCall,
+        &&op_TailCallMethod,
+        &&op_Return,
+        &&op_Rethrow,
+        &&op_AssertFail,
+        /// [[[end]]]
+
+        // Quickened instructions, in the order of their declaration in `QuickOp`.
+        &&op_AddSmallInt,
+        &&op_SubSmallInt,
+        &&op_MulSmallInt,
+        &&op_ModSmallInt,
+        &&op_GtSmallInt,
+        &&op_GteSmallInt,
+        &&op_LtSmallInt,
+        &&op_LteSmallInt,
+        &&op_EqSmallInt,
+        &&op_NEqSmallInt,
+        &&op_AddFloat,
+        &&op_SubFloat,
+        &&op_MulFloat,
+        &&op_DivFloat,
+        &&op_GtFloat,
+        &&op_GteFloat,
+        &&op_LtFloat,
+        &&op_LteFloat,
+    };
+#endif
 
-            target.set(res.value());
-            break;
-        }
-        case BytecodeOp::StoreMember: {
-            auto source = read_local();
-            auto object = read_local();
-            const u32 name = read_u32();
+    // Registers are released when the interpreter loop exits. Instructions that allocate
+    // registers release them before dispatching to the next instruction.
+    ScopeExit reset_registers = [&] { regs_.reset(); };
 
-            auto name_symbol = reg(get_member(name)).must_cast<Symbol>();
-            auto res = ctx_.types().store_member(ctx_, object, name_symbol, source);
-            if (TIRO_UNLIKELY(res.has_exception()))
-                return unwind(res.exception());
+    if (!safepoint())
+        return;
 
-            break;
-        }
-        case BytecodeOp::LoadTupleMember: {
-            auto object = read_local();
-            const u32 index = read_u32();
-            auto target = read_local();
-
-            auto maybe_tuple = object.try_cast<Tuple>();
-            if (TIRO_UNLIKELY(!maybe_tuple)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "expected object of type tuple, but got '{}'", object->type()));
-            }
-
-            auto tuple = maybe_tuple.handle();
-            if (TIRO_UNLIKELY(index >= tuple->size())) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "invalid index {} into tuple of size {}", index, tuple->size()));
-            }
-            target.set(tuple->unchecked_get(index));
-            break;
-        }
-        case BytecodeOp::StoreTupleMember: {
-            auto source = read_local();
-            auto object = read_local();
-            const u32 index = read_u32();
-
-            auto maybe_tuple = object.try_cast<Tuple>();
-            if (TIRO_UNLIKELY(!maybe_tuple)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "expected object of type tuple but got '{}'.", object->type()));
-            }
-
-            auto tuple = maybe_tuple.handle();
-            if (TIRO_UNLIKELY(index >= tuple->size())) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "invalid index {} into tuple of size {}", index, tuple->size()));
-            }
-            tuple->unchecked_set(index, *source);
-            break;
-        }
-        case BytecodeOp::LoadIndex: {
-            auto array = read_local();
-            auto index = read_local();
-            auto target = read_local();
+#ifndef TIRO_COMPUTED_GOTO
+dispatch:
+#endif
+    switch (read_op()) {
+    TIRO_OP(LoadNull): {
+        auto target = read_local();
+        target.set(Value::null());
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadFalse): {
+        auto target = read_local();
+        target.set(ctx_.get_boolean(false));
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadTrue): {
+        auto target = read_local();
+        target.set(ctx_.get_boolean(true));
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadInt): {
+        const i64 value = read_i64();
+        auto target = read_local();
+        target.set(ctx_.get_integer(value));
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadFloat): {
+        const f64 value = read_f64();
+        auto target = read_local();
+        target.set(Float::make(ctx_, value));
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadParam): {
+        const u32 source = read_u32();
+        auto target = read_local();
+        TIRO_DEBUG_ASSERT(source < frame_->argc, "parameter index out of bounds");
 
-            auto res = ctx_.types().load_index(ctx_, array, index);
-            if (TIRO_UNLIKELY(res.has_exception()))
-                return unwind(res.exception());
+        target.set(*CoroutineStack::arg(frame_, source));
+        TIRO_NEXT();
+    }
+    TIRO_OP(StoreParam): {
+        auto source = read_local();
+        const u32 target = read_u32();
+        TIRO_DEBUG_ASSERT(target < frame_->argc, "parameter index out of bounds");
 
-            target.set(res.value());
-            break;
+        *CoroutineStack::arg(frame_, target) = *source;
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadModule): {
+        const u32 source = read_u32();
+        auto target = read_local();
+        target.set(get_member(source));
+        TIRO_NEXT();
+    }
+    TIRO_OP(StoreModule): {
+        auto source = read_local();
+        const u32 index = read_u32();
+        set_member(index, *source);
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadMember): {
+        auto object = read_local();
+        const u32 name = read_u32();
+        auto target = read_local();
+        const u32 site = read_u32();
+
+        if (auto cached = InlineCache::load(inline_cache(), site, *object)) {
+            target.set(*cached);
+            TIRO_NEXT();
         }
-        case BytecodeOp::StoreIndex: {
-            auto source = read_local();
-            auto array = read_local();
-            auto index = read_local();
 
-            auto res = ctx_.types().store_index(ctx_, array, index, source);
-            if (TIRO_UNLIKELY(res.has_exception()))
-                return unwind(res.exception());
+        auto name_symbol = reg(get_member(name)).must_cast<Symbol>();
+        auto res = ctx_.types().load_member(ctx_, object, name_symbol);
+        if (TIRO_UNLIKELY(res.has_exception()))
+            return unwind(res.exception());
 
-            break;
-        }
-        case BytecodeOp::LoadClosure: {
-            auto target = read_local();
+        InlineCache::update_member(inline_cache(), site, *object, *name_symbol, res.value());
+        target.set(res.value());
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(StoreMember): {
+        auto source = read_local();
+        auto object = read_local();
+        const u32 name = read_u32();
+        const u32 site = read_u32();
 
-            TIRO_DEBUG_ASSERT(!frame_->closure.is_null(), "Function does not have a closure.");
-            target.set(frame_->closure);
-            break;
-        }
-        case BytecodeOp::LoadEnv: {
-            auto env_arg = read_local();
-            const u32 level = read_u32();
-            const u32 index = read_u32();
-            auto target = read_local();
-
-            auto maybe_env = env_arg.try_cast<Environment>();
-            if (TIRO_UNLIKELY(!maybe_env)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "expected object of type environment, but got '{}'", env_arg->type()));
-            }
-
-            auto current_env = reg<Nullable<Environment>>(*maybe_env.handle());
-            if (level != 0)
-                current_env.set(current_env->value().parent(level));
-
-            if (TIRO_UNLIKELY(current_env->is_null())) { // Codegen error
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "too many levels requested from closure environment: {}", level));
-            }
-
-            if (TIRO_UNLIKELY(index >= current_env->value().size())) { // Codegen error
-                return unwind(TIRO_FORMAT_EXCEPTION(ctx_,
-                    "environment index {} is too large for environment of size {}", index,
-                    current_env->value().size()));
-            }
-
-            auto value = current_env->value().get(index);
-            if (TIRO_UNLIKELY(ctx_.get_undefined().same(value))) { // Codegen error
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "closure environment variable at index {} is undefined", index));
-            }
-
-            target.set(value);
-            break;
-        }
-        case BytecodeOp::StoreEnv: {
-            auto source = read_local();
-            auto env_arg = read_local();
-            const u32 level = read_u32();
-            const u32 index = read_u32();
-
-            auto maybe_env = env_arg.try_cast<Environment>();
-            if (TIRO_UNLIKELY(!maybe_env)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "expected object of type environment, but got '{}'", env_arg->type()));
-            }
-
-            auto current_env = reg<Nullable<Environment>>(*maybe_env.handle());
-            if (level != 0)
-                current_env.set(current_env->value().parent(level));
-
-            if (TIRO_UNLIKELY(index >= current_env->value().size())) { // Codegen error
-                return unwind(TIRO_FORMAT_EXCEPTION(ctx_,
-                    "environment index {} is too large for environment of size {}", index,
-                    current_env->value().size()));
-            }
-
-            if (TIRO_UNLIKELY(current_env->is_null())) { // Codegen error
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "too many levels requested from closure environment: {}", level));
-            }
-
-            current_env->value().set(index, *source);
-            break;
-        }
-        case BytecodeOp::Add:
-            TIRO_BINOP(add);
-            break;
-        case BytecodeOp::Sub:
-            TIRO_BINOP(sub);
-            break;
-        case BytecodeOp::Mul:
-            TIRO_BINOP(mul);
-            break;
-        case BytecodeOp::Div:
-            TIRO_BINOP(div);
-            break;
-        case BytecodeOp::Mod:
-            TIRO_BINOP(mod);
-            break;
-        case BytecodeOp::Pow:
-            TIRO_BINOP(pow);
-            break;
-        case BytecodeOp::UAdd:
-            TIRO_UNOP(unary_plus);
-            break;
-        case BytecodeOp::UNeg:
-            TIRO_UNOP(unary_minus);
-            break;
+        if (InlineCache::store(inline_cache(), site, *object, *source))
+            TIRO_NEXT();
 
-        // TODO
-        case BytecodeOp::LSh:
-        case BytecodeOp::RSh:
-        case BytecodeOp::BAnd:
-        case BytecodeOp::BOr:
-        case BytecodeOp::BXor:
-            TIRO_ERROR("instruction not implemented yet: {}", op);
+        auto name_symbol = reg(get_member(name)).must_cast<Symbol>();
+        auto res = ctx_.types().store_member(ctx_, object, name_symbol, source);
+        if (TIRO_UNLIKELY(res.has_exception()))
+            return unwind(res.exception());
 
-        case BytecodeOp::BNot:
-            TIRO_UNOP(bitwise_not);
-            break;
-        case BytecodeOp::Gt:
-            TIRO_CMP((cmp > 0));
-            break;
-        case BytecodeOp::Gte:
-            TIRO_CMP((cmp >= 0));
-            break;
-        case BytecodeOp::Lt:
-            TIRO_CMP((cmp < 0));
-            break;
-        case BytecodeOp::Lte:
-            TIRO_CMP((cmp <= 0));
-            break;
-        case BytecodeOp::Eq: {
-            auto lhs = read_local();
-            auto rhs = read_local();
-            auto target = read_local();
-            target.set(ctx_.get_boolean(equal(*lhs, *rhs)));
-            break;
+        InlineCache::update_member(inline_cache(), site, *object, *name_symbol, *source);
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadTupleMember): {
+        auto object = read_local();
+        const u32 index = read_u32();
+        auto target = read_local();
+
+        auto maybe_tuple = object.try_cast<Tuple>();
+        if (TIRO_UNLIKELY(!maybe_tuple)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "expected object of type tuple, but got '{}'", object->type()));
         }
-        case BytecodeOp::NEq: {
-            auto lhs = read_local();
-            auto rhs = read_local();
-            auto target = read_local();
-            target.set(ctx_.get_boolean(!equal(*lhs, *rhs)));
-            break;
+
+        auto tuple = maybe_tuple.handle();
+        if (TIRO_UNLIKELY(index >= tuple->size())) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "invalid index {} into tuple of size {}", index, tuple->size()));
         }
-        case BytecodeOp::LNot: {
-            auto value = read_local();
-            auto target = read_local();
-            target.set(ctx_.get_boolean(!ctx_.is_truthy(value)));
-            break;
+        target.set(tuple->unchecked_get(index));
+        TIRO_NEXT();
+    }
+    TIRO_OP(StoreTupleMember): {
+        auto source = read_local();
+        auto object = read_local();
+        const u32 index = read_u32();
+
+        auto maybe_tuple = object.try_cast<Tuple>();
+        if (TIRO_UNLIKELY(!maybe_tuple)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "expected object of type tuple but got '{}'.", object->type()));
         }
-        case BytecodeOp::Array: {
-            const u32 count = read_u32();
-            auto target = read_local();
 
-            target.set(Array::make(ctx_, HandleSpan<Value>(stack_.top_values(count))));
-            stack_.pop_values(count);
-            break;
+        auto tuple = maybe_tuple.handle();
+        if (TIRO_UNLIKELY(index >= tuple->size())) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "invalid index {} into tuple of size {}", index, tuple->size()));
         }
-        case BytecodeOp::Tuple: {
-            const u32 count = read_u32();
-            auto target = read_local();
+        tuple->unchecked_set(index, *source);
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadIndex): {
+        auto array = read_local();
+        auto index = read_local();
+        auto target = read_local();
 
-            target.set(Tuple::make(ctx_, HandleSpan<Value>(stack_.top_values(count))));
-            stack_.pop_values(count);
-            break;
-        }
-        case BytecodeOp::Set: {
-            const u32 count = read_u32();
-            auto target = read_local();
+        auto res = ctx_.types().load_index(ctx_, array, index);
+        if (TIRO_UNLIKELY(res.has_exception()))
+            return unwind(res.exception());
 
-            auto set_result = Set::make(ctx_, HandleSpan<Value>(stack_.top_values(count)));
-            if (TIRO_UNLIKELY(set_result.has_exception()))
-                return unwind(set_result.exception());
+        target.set(res.value());
+        TIRO_NEXT();
+    }
+    TIRO_OP(StoreIndex): {
+        auto source = read_local();
+        auto array = read_local();
+        auto index = read_local();
 
-            target.set(set_result.value());
-            stack_.pop_values(count);
-            break;
-        }
-        case BytecodeOp::Map: {
-            const u32 count = read_u32();
-            auto target = read_local();
-
-            const Span<Value> pairs = stack_.top_values(count);
-            auto map_result = HashTable::make(ctx_, count);
-            if (TIRO_UNLIKELY(map_result.has_exception()))
-                return unwind(map_result.exception());
-
-            auto map = reg(map_result.value());
-            for (u32 i = 0; i < count; i += 2) {
-                auto key = Handle<Value>(pairs.data() + i);
-                auto value = Handle<Value>(pairs.data() + i + 1);
-                map->set(ctx_, key, value)
-                    .must("failed to insert map entry"); // size is preallocated
-            }
-
-            target.set(map);
-            stack_.pop_values(count);
-            break;
+        auto res = ctx_.types().store_index(ctx_, array, index, source);
+        if (TIRO_UNLIKELY(res.has_exception()))
+            return unwind(res.exception());
+
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadClosure): {
+        auto target = read_local();
+
+        TIRO_DEBUG_ASSERT(!frame_->closure.is_null(), "Function does not have a closure.");
+        target.set(frame_->closure);
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadEnv): {
+        auto env_arg = read_local();
+        const u32 level = read_u32();
+        const u32 index = read_u32();
+        auto target = read_local();
+
+        auto maybe_env = env_arg.try_cast<Environment>();
+        if (TIRO_UNLIKELY(!maybe_env)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "expected object of type environment, but got '{}'", env_arg->type()));
         }
-        case BytecodeOp::Env: {
-            auto parent = read_local().try_cast<Nullable<Environment>>();
-            const u32 size = read_u32();
-            auto target = read_local();
 
-            if (TIRO_UNLIKELY(!parent)) {
-                return unwind(
-                    TIRO_FORMAT_EXCEPTION(ctx_, "parent must be null or another environment"));
-            }
+        auto current_env = reg<Nullable<Environment>>(*maybe_env.handle());
+        if (level != 0)
+            current_env.set(current_env->value().parent(level));
 
-            target.set(Environment::make(ctx_, size, maybe_null(parent.handle())));
-            break;
+        if (TIRO_UNLIKELY(current_env->is_null())) { // Codegen error
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "too many levels requested from closure environment: {}", level));
         }
-        case BytecodeOp::Closure: {
-            const u32 tmpl_index = read_u32();
-            auto env_arg = read_local();
-            auto target = read_local();
-
-            auto tmpl = reg(get_member(tmpl_index)).must_cast<CodeFunctionTemplate>();
-            auto maybe_env = env_arg.try_cast<Nullable<Environment>>();
-            if (TIRO_UNLIKELY(!maybe_env)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "expected an environment or null, but got '{}'", env_arg->type()));
-            }
-
-            target.set(CodeFunction::make(ctx_, tmpl, maybe_null(maybe_env.handle())));
-            break;
+
+        if (TIRO_UNLIKELY(index >= current_env->value().size())) { // Codegen error
+            return unwind(TIRO_FORMAT_EXCEPTION(ctx_,
+                "environment index {} is too large for environment of size {}", index,
+                current_env->value().size()));
         }
-        case BytecodeOp::Record: {
-            const u32 tmpl_index = read_u32();
-            auto target = read_local();
 
-            auto tmpl = reg(get_member(tmpl_index)).must_cast<RecordSchema>();
-            target.set(Record::make(ctx_, tmpl));
-            break;
+        auto value = current_env->value().get(index);
+        if (TIRO_UNLIKELY(ctx_.get_undefined().same(value))) { // Codegen error
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "closure environment variable at index {} is undefined", index));
         }
-        case BytecodeOp::Iterator: {
-            auto container = read_local();
-            auto target = read_local();
-            auto res = ctx_.types().iterator(ctx_, container);
-            if (TIRO_UNLIKELY(res.has_exception()))
-                return unwind(res.exception());
 
-            target.set(res.value());
-            break;
+        target.set(value);
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(StoreEnv): {
+        auto source = read_local();
+        auto env_arg = read_local();
+        const u32 level = read_u32();
+        const u32 index = read_u32();
+
+        auto maybe_env = env_arg.try_cast<Environment>();
+        if (TIRO_UNLIKELY(!maybe_env)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "expected object of type environment, but got '{}'", env_arg->type()));
         }
-        case BytecodeOp::IteratorNext: {
-            auto iterator = read_local();
-            auto valid = read_local();
-            auto value = read_local();
 
-            auto res = ctx_.types().iterator_next(ctx_, iterator);
-            if (TIRO_UNLIKELY(res.has_exception()))
-                return unwind(res.exception());
+        auto current_env = reg<Nullable<Environment>>(*maybe_env.handle());
+        if (level != 0)
+            current_env.set(current_env->value().parent(level));
 
-            auto& next = res.value();
-            valid.set(ctx_.get_boolean(next.has_value()));
-            value.set(next ? *next : Value::null());
-            break;
+        if (TIRO_UNLIKELY(index >= current_env->value().size())) { // Codegen error
+            return unwind(TIRO_FORMAT_EXCEPTION(ctx_,
+                "environment index {} is too large for environment of size {}", index,
+                current_env->value().size()));
         }
-        case BytecodeOp::Formatter: {
-            // Initial capacity would improve performance!
-            auto target = read_local();
-            target.set(StringBuilder::make(ctx_));
-            break;
-        }
-        case BytecodeOp::AppendFormat: {
-            auto value = read_local();
-            auto formatter_arg = read_local();
-
-            auto maybe_formatter = formatter_arg.try_cast<StringBuilder>();
-            if (TIRO_UNLIKELY(!maybe_formatter)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "expected a string builder, but got '{}'", formatter_arg->type()));
-            }
-            to_string(ctx_, maybe_formatter.handle(), value);
-            break;
-        }
-        case BytecodeOp::FormatResult: {
-            auto formatter_arg = read_local();
-            auto target = read_local();
-
-            auto maybe_formatter = formatter_arg.try_cast<StringBuilder>();
-            if (TIRO_UNLIKELY(!maybe_formatter)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "expected a string builder, but got '{}'", formatter_arg->type()));
-            }
-            target.set(maybe_formatter.handle()->to_string(ctx_));
-            break;
-        }
-        case BytecodeOp::Copy: {
-            auto source = read_local();
-            auto target = read_local();
-            target.set(source);
-            break;
-        }
-        case BytecodeOp::Swap: {
-            auto a = read_local();
-            auto b = read_local();
-            auto t = a.get();
-            a.set(b);
-            b.set(t);
-            break;
-        };
-        case BytecodeOp::Push: {
-            reserve_stack(1);
 
-            auto value = read_local();
-            push_stack(*value);
-            break;
+        if (TIRO_UNLIKELY(current_env->is_null())) { // Codegen error
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "too many levels requested from closure environment: {}", level));
         }
-        case BytecodeOp::Pop: {
-            if (TIRO_UNLIKELY(stack_.top_value_count() == 0)) {
-                return unwind(
-                    TIRO_FORMAT_EXCEPTION(ctx_, "cannot pop any more values from the stack"));
-            }
 
-            stack_.pop_value();
-            break;
-        }
-        case BytecodeOp::PopTo: {
-            if (TIRO_UNLIKELY(stack_.top_value_count() == 0)) {
-                return unwind(
-                    TIRO_FORMAT_EXCEPTION(ctx_, "cannot pop any more values from the stack"));
-            }
-
-            auto target = read_local();
-            target.set(*stack_.top_value());
-            stack_.pop_value();
-            break;
+        current_env->value().set(index, *source);
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(Add):
+        TIRO_BINOP(add);
+        TIRO_NEXT();
+    TIRO_OP(Sub):
+        TIRO_BINOP(sub);
+        TIRO_NEXT();
+    TIRO_OP(Mul):
+        TIRO_BINOP(mul);
+        TIRO_NEXT();
+    TIRO_OP(Div):
+        TIRO_BINOP(div);
+        TIRO_NEXT();
+    TIRO_OP(Mod):
+        TIRO_BINOP(mod);
+        TIRO_NEXT();
+    TIRO_OP(Pow):
+        TIRO_BINOP(pow);
+        TIRO_NEXT();
+    TIRO_OP(UAdd):
+        TIRO_UNOP(unary_plus);
+        TIRO_NEXT();
+    TIRO_OP(UNeg):
+        TIRO_UNOP(unary_minus);
+        TIRO_NEXT();
+
+    // TODO
+    TIRO_OP(LSh):
+        TIRO_ERROR("instruction not implemented yet: {}", BytecodeOp::LSh);
+    TIRO_OP(RSh):
+        TIRO_ERROR("instruction not implemented yet: {}", BytecodeOp::RSh);
+    TIRO_OP(BAnd):
+        TIRO_ERROR("instruction not implemented yet: {}", BytecodeOp::BAnd);
+    TIRO_OP(BOr):
+        TIRO_ERROR("instruction not implemented yet: {}", BytecodeOp::BOr);
+    TIRO_OP(BXor):
+        TIRO_ERROR("instruction not implemented yet: {}", BytecodeOp::BXor);
+
+    TIRO_OP(BNot):
+        TIRO_UNOP(bitwise_not);
+        TIRO_NEXT();
+    TIRO_OP(Gt):
+        TIRO_CMP((cmp > 0));
+        TIRO_NEXT();
+    TIRO_OP(Gte):
+        TIRO_CMP((cmp >= 0));
+        TIRO_NEXT();
+    TIRO_OP(Lt):
+        TIRO_CMP((cmp < 0));
+        TIRO_NEXT();
+    TIRO_OP(Lte):
+        TIRO_CMP((cmp <= 0));
+        TIRO_NEXT();
+    TIRO_OP(Eq): {
+        const CodeWord* op_word = frame_->pc - 1;
+        auto lhs = read_local();
+        auto rhs = read_local();
+        auto target = read_local();
+        quicken(op_word, *lhs, *rhs);
+        target.set(ctx_.get_boolean(equal(*lhs, *rhs)));
+        TIRO_NEXT();
+    }
+    TIRO_OP(NEq): {
+        const CodeWord* op_word = frame_->pc - 1;
+        auto lhs = read_local();
+        auto rhs = read_local();
+        auto target = read_local();
+        quicken(op_word, *lhs, *rhs);
+        target.set(ctx_.get_boolean(!equal(*lhs, *rhs)));
+        TIRO_NEXT();
+    }
+    TIRO_OP(LNot): {
+        auto value = read_local();
+        auto target = read_local();
+        target.set(ctx_.get_boolean(!ctx_.is_truthy(value)));
+        TIRO_NEXT();
+    }
+    TIRO_OP(Array): {
+        const u32 count = read_u32();
+        auto target = read_local();
+
+        target.set(Array::make(ctx_, HandleSpan<Value>(stack_.top_values(count))));
+        stack_.pop_values(count);
+        TIRO_NEXT();
+    }
+    TIRO_OP(Tuple): {
+        const u32 count = read_u32();
+        auto target = read_local();
+
+        target.set(Tuple::make(ctx_, HandleSpan<Value>(stack_.top_values(count))));
+        stack_.pop_values(count);
+        TIRO_NEXT();
+    }
+    TIRO_OP(Set): {
+        const u32 count = read_u32();
+        auto target = read_local();
+
+        auto set_result = Set::make(ctx_, HandleSpan<Value>(stack_.top_values(count)));
+        if (TIRO_UNLIKELY(set_result.has_exception()))
+            return unwind(set_result.exception());
+
+        target.set(set_result.value());
+        stack_.pop_values(count);
+        TIRO_NEXT();
+    }
+    TIRO_OP(Map): {
+        const u32 count = read_u32();
+        auto target = read_local();
+
+        const Span<Value> pairs = stack_.top_values(count);
+        auto map_result = HashTable::make(ctx_, count);
+        if (TIRO_UNLIKELY(map_result.has_exception()))
+            return unwind(map_result.exception());
+
+        auto map = reg(map_result.value());
+        for (u32 i = 0; i < count; i += 2) {
+            auto key = Handle<Value>(pairs.data() + i);
+            auto value = Handle<Value>(pairs.data() + i + 1);
+            map->set(ctx_, key, value)
+                .must("failed to insert map entry"); // size is preallocated
         }
-        case BytecodeOp::Jmp: {
-            const u32 target = read_u32();
-            set_pc(target);
-            break;
+
+        target.set(map);
+        stack_.pop_values(count);
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(Env): {
+        auto parent = read_local().try_cast<Nullable<Environment>>();
+        const u32 size = read_u32();
+        auto target = read_local();
+
+        if (TIRO_UNLIKELY(!parent)) {
+            return unwind(
+                TIRO_FORMAT_EXCEPTION(ctx_, "parent must be null or another environment"));
         }
-        case BytecodeOp::JmpTrue: {
-            auto value = read_local();
-            const u32 target = read_u32();
-            if (ctx_.is_truthy(value)) {
-                set_pc(target);
-            }
-            break;
+
+        target.set(Environment::make(ctx_, size, maybe_null(parent.handle())));
+        TIRO_NEXT();
+    }
+    TIRO_OP(Closure): {
+        const u32 tmpl_index = read_u32();
+        auto env_arg = read_local();
+        auto target = read_local();
+
+        auto tmpl = reg(get_member(tmpl_index)).must_cast<CodeFunctionTemplate>();
+        auto maybe_env = env_arg.try_cast<Nullable<Environment>>();
+        if (TIRO_UNLIKELY(!maybe_env)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "expected an environment or null, but got '{}'", env_arg->type()));
         }
-        case BytecodeOp::JmpFalse: {
-            auto value = read_local();
-            const u32 target = read_u32();
-            if (!ctx_.is_truthy(value)) {
-                set_pc(target);
-            }
-            break;
+
+        target.set(CodeFunction::make(ctx_, tmpl, maybe_null(maybe_env.handle())));
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(Record): {
+        const u32 tmpl_index = read_u32();
+        auto target = read_local();
+
+        auto tmpl = reg(get_member(tmpl_index)).must_cast<RecordSchema>();
+        target.set(Record::make(ctx_, tmpl));
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(Iterator): {
+        auto container = read_local();
+        auto target = read_local();
+        auto res = ctx_.types().iterator(ctx_, container);
+        if (TIRO_UNLIKELY(res.has_exception()))
+            return unwind(res.exception());
+
+        target.set(res.value());
+        TIRO_NEXT();
+    }
+    TIRO_OP(IteratorNext): {
+        auto iterator = read_local();
+        auto valid = read_local();
+        auto value = read_local();
+
+        auto res = ctx_.types().iterator_next(ctx_, iterator);
+        if (TIRO_UNLIKELY(res.has_exception()))
+            return unwind(res.exception());
+
+        auto& next = res.value();
+        valid.set(ctx_.get_boolean(next.has_value()));
+        value.set(next ? *next : Value::null());
+        TIRO_NEXT();
+    }
+    TIRO_OP(Formatter): {
+        // Initial capacity would improve performance!
+        auto target = read_local();
+        target.set(StringBuilder::make(ctx_));
+        TIRO_NEXT();
+    }
+    TIRO_OP(AppendFormat): {
+        auto value = read_local();
+        auto formatter_arg = read_local();
+
+        auto maybe_formatter = formatter_arg.try_cast<StringBuilder>();
+        if (TIRO_UNLIKELY(!maybe_formatter)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "expected a string builder, but got '{}'", formatter_arg->type()));
         }
-        case BytecodeOp::JmpNull: {
-            auto value = read_local();
-            const u32 target = read_u32();
-            if (value->is_null()) {
-                set_pc(target);
-            }
-            break;
+        to_string(ctx_, maybe_formatter.handle(), value);
+        TIRO_NEXT();
+    }
+    TIRO_OP(FormatResult): {
+        auto formatter_arg = read_local();
+        auto target = read_local();
+
+        auto maybe_formatter = formatter_arg.try_cast<StringBuilder>();
+        if (TIRO_UNLIKELY(!maybe_formatter)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "expected a string builder, but got '{}'", formatter_arg->type()));
         }
-        case BytecodeOp::JmpNotNull: {
-            auto value = read_local();
-            const u32 target = read_u32();
-            if (!value->is_null()) {
-                set_pc(target);
-            }
-            break;
+        target.set(maybe_formatter.handle()->to_string(ctx_));
+        TIRO_NEXT();
+    }
+    TIRO_OP(Copy): {
+        auto source = read_local();
+        auto target = read_local();
+        target.set(source);
+        TIRO_NEXT();
+    }
+    TIRO_OP(Swap): {
+        auto a = read_local();
+        auto b = read_local();
+        auto t = a.get();
+        a.set(b);
+        b.set(t);
+        TIRO_NEXT();
+    };
+    TIRO_OP(Push): {
+        reserve_stack(1);
+
+        auto value = read_local();
+        push_stack(*value);
+        TIRO_NEXT();
+    }
+    TIRO_OP(Pop): {
+        if (TIRO_UNLIKELY(stack_.top_value_count() == 0)) {
+            return unwind(
+                TIRO_FORMAT_EXCEPTION(ctx_, "cannot pop any more values from the stack"));
         }
-        case BytecodeOp::Call: {
-            auto func = read_local();
-            const u32 count = read_u32();
-            return parent_.call_function(Handle<Coroutine>(&coro_), func, count);
+
+        stack_.pop_value();
+        TIRO_NEXT();
+    }
+    TIRO_OP(PopTo): {
+        if (TIRO_UNLIKELY(stack_.top_value_count() == 0)) {
+            return unwind(
+                TIRO_FORMAT_EXCEPTION(ctx_, "cannot pop any more values from the stack"));
         }
-        case BytecodeOp::LoadMethod: {
-            auto object = read_local();
-            const u32 name = read_u32();
-            auto this_ = read_local();
-            auto method = read_local();
 
+        auto target = read_local();
+        target.set(*stack_.top_value());
+        stack_.pop_value();
+        TIRO_NEXT();
+    }
+    TIRO_OP(Jmp): {
+        const CodeWord* pc = frame_->pc;
+        const u32 target = read_u32();
+        TIRO_JUMP_NEXT(pc, target);
+    }
+    TIRO_OP(JmpTrue): {
+        const CodeWord* pc = frame_->pc;
+        auto value = read_local();
+        const u32 target = read_u32();
+        if (ctx_.is_truthy(value))
+            TIRO_JUMP_NEXT(pc, target);
+        TIRO_NEXT();
+    }
+    TIRO_OP(JmpFalse): {
+        const CodeWord* pc = frame_->pc;
+        auto value = read_local();
+        const u32 target = read_u32();
+        if (!ctx_.is_truthy(value))
+            TIRO_JUMP_NEXT(pc, target);
+        TIRO_NEXT();
+    }
+    TIRO_OP(JmpNull): {
+        const CodeWord* pc = frame_->pc;
+        auto value = read_local();
+        const u32 target = read_u32();
+        if (value->is_null())
+            TIRO_JUMP_NEXT(pc, target);
+        TIRO_NEXT();
+    }
+    TIRO_OP(JmpNotNull): {
+        const CodeWord* pc = frame_->pc;
+        auto value = read_local();
+        const u32 target = read_u32();
+        if (!value->is_null())
+            TIRO_JUMP_NEXT(pc, target);
+        TIRO_NEXT();
+    }
+    TIRO_OP(Call): {
+        auto func = read_local();
+        const u32 count = read_u32();
+        if (TIRO_LIKELY(push_code_frame(*func, count, false)))
+            TIRO_SAFEPOINT_NEXT();
+
+        parent_.call_function(Handle<Coroutine>(&coro_), func, count);
+        if (!enter_top_frame())
+            return;
+
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(LoadMethod): {
+        auto object = read_local();
+        const u32 name = read_u32();
+        auto this_ = read_local();
+        auto method = read_local();
+        const u32 site = read_u32();
+
+        Value func;
+        if (auto cached = InlineCache::load(inline_cache(), site, *object)) {
+            func = *cached;
+        } else {
             auto name_symbol = reg(get_member(name)).must_cast<Symbol>();
             auto res = ctx_.types().load_method(ctx_, object, name_symbol);
             if (TIRO_UNLIKELY(res.has_exception()))
                 return unwind(res.exception());
 
-            auto func = res.value();
-            if (func.is<Method>()) {
-                this_.set(object);
-                method.set(func.must_cast<Method>().function());
-            } else {
-                this_.set(Value::null());
-                method.set(func);
-            }
-            break;
+            func = res.value();
+            InlineCache::update_method(inline_cache(), site, *object, *name_symbol, func);
         }
-        case BytecodeOp::CallMethod: {
-            auto method = read_local();
-            const u32 count = read_u32();
-            return parent_.call_method(Handle<Coroutine>(&coro_), method, count);
+
+        if (func.is<Method>()) {
+            this_.set(object);
+            method.set(func.must_cast<Method>().function());
+        } else {
+            this_.set(Value::null());
+            method.set(func);
         }
-        case BytecodeOp::Return: {
-            auto value = read_local();
-            return return_function(*value);
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(CallMethod): {
+        auto method = read_local();
+        const u32 count = read_u32();
+        {
+            TIRO_DEBUG_ASSERT(stack_.top_value_count() >= count + 1,
+                "the value stack must contain the all arguments, including `this`");
+            const bool is_method = !stack_.top_value(count)->is_null();
+            if (TIRO_LIKELY(push_code_frame(*method, count + (is_method ? 1 : 0), !is_method)))
+                TIRO_SAFEPOINT_NEXT();
         }
-        case BytecodeOp::Rethrow: {
-            // TODO: Static verify usage of rethrow in bytecode
-            TIRO_DEBUG_ASSERT(frame_->flags & FRAME_UNWINDING,
-                "function must be unwinding when using the rethrow instruction");
-            TIRO_DEBUG_ASSERT(
-                frame_->current_exception.has_value(), "current exception must be present");
-            return unwind(frame_->current_exception.value());
+
+        parent_.call_method(Handle<Coroutine>(&coro_), method, count);
+        if (!enter_top_frame())
+            return;
+
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(TailCall): {
+        auto func = read_local();
+        const u32 count = read_u32();
+        if (TIRO_LIKELY(replace_code_frame(*func, count, false)))
+            TIRO_SAFEPOINT_NEXT();
+
+        // Not possible, continue like a normal call. The following instructions return the result.
+        if (TIRO_LIKELY(push_code_frame(*func, count, false)))
+            TIRO_SAFEPOINT_NEXT();
+
+        parent_.call_function(Handle<Coroutine>(&coro_), func, count);
+        if (!enter_top_frame())
+            return;
+
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(TailCallMethod): {
+        auto method = read_local();
+        const u32 count = read_u32();
+        {
+            TIRO_DEBUG_ASSERT(stack_.top_value_count() >= count + 1,
+                "the value stack must contain the all arguments, including `this`");
+            const bool is_method = !stack_.top_value(count)->is_null();
+            const u32 argc = count + (is_method ? 1 : 0);
+            if (TIRO_LIKELY(replace_code_frame(*method, argc, !is_method)))
+                TIRO_SAFEPOINT_NEXT();
+            if (TIRO_LIKELY(push_code_frame(*method, argc, !is_method)))
+                TIRO_SAFEPOINT_NEXT();
         }
-        case BytecodeOp::AssertFail: {
-            auto expr_arg = read_local();
-            auto message_arg = read_local();
-
-            auto maybe_expr = expr_arg.try_cast<String>();
-            if (TIRO_UNLIKELY(!maybe_expr)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(
-                    ctx_, "assertion expression must be a string, but got '{}'", expr_arg->type()));
-            }
-
-            auto maybe_message = message_arg.try_cast<Nullable<String>>();
-            if (TIRO_UNLIKELY(!maybe_message)) {
-                return unwind(TIRO_FORMAT_EXCEPTION(ctx_,
-                    "assertion error message must be a string or null, but got '{}'",
-                    message_arg->type()));
-            }
-
-            return unwind(assertion_failed_exception(
-                ctx_, maybe_expr.handle(), maybe_null(maybe_message.handle())));
+
+        parent_.call_method(Handle<Coroutine>(&coro_), method, count);
+        if (!enter_top_frame())
+            return;
+
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(Return): {
+        auto value = read_local();
+        if (TIRO_LIKELY(pop_code_frame(*value)))
+            TIRO_NEXT();
+
+        return_function(*value);
+        if (!enter_top_frame())
+            return;
+
+        regs_.reset();
+        TIRO_NEXT();
+    }
+    TIRO_OP(Rethrow): {
+        // TODO: Static verify usage of rethrow in bytecode
+        TIRO_DEBUG_ASSERT(frame_->flags & FRAME_UNWINDING,
+            "function must be unwinding when using the rethrow instruction");
+        TIRO_DEBUG_ASSERT(
+            frame_->current_exception.has_value(), "current exception must be present");
+        return unwind(frame_->current_exception.value());
+    }
+    TIRO_OP(AssertFail): {
+        auto expr_arg = read_local();
+        auto message_arg = read_local();
+
+        auto maybe_expr = expr_arg.try_cast<String>();
+        if (TIRO_UNLIKELY(!maybe_expr)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(
+                ctx_, "assertion expression must be a string, but got '{}'", expr_arg->type()));
         }
+
+        auto maybe_message = message_arg.try_cast<Nullable<String>>();
+        if (TIRO_UNLIKELY(!maybe_message)) {
+            return unwind(TIRO_FORMAT_EXCEPTION(ctx_,
+                "assertion error message must be a string or null, but got '{}'",
+                message_arg->type()));
         }
+
+        return unwind(assertion_failed_exception(
+            ctx_, maybe_expr.handle(), maybe_null(maybe_message.handle())));
     }
+    TIRO_QOP(AddSmallInt):
+        TIRO_QUICK(AddSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(SubSmallInt):
+        TIRO_QUICK(SubSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(MulSmallInt):
+        TIRO_QUICK(MulSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(ModSmallInt):
+        TIRO_QUICK(ModSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(GtSmallInt):
+        TIRO_QUICK(GtSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(GteSmallInt):
+        TIRO_QUICK(GteSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(LtSmallInt):
+        TIRO_QUICK(LtSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(LteSmallInt):
+        TIRO_QUICK(LteSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(EqSmallInt):
+        TIRO_QUICK(EqSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(NEqSmallInt):
+        TIRO_QUICK(NEqSmallInt, quick_small_int_op);
+        TIRO_NEXT();
+    TIRO_QOP(AddFloat):
+        TIRO_QUICK(AddFloat, quick_float_op);
+        TIRO_NEXT();
+    TIRO_QOP(SubFloat):
+        TIRO_QUICK(SubFloat, quick_float_op);
+        TIRO_NEXT();
+    TIRO_QOP(MulFloat):
+        TIRO_QUICK(MulFloat, quick_float_op);
+        TIRO_NEXT();
+    TIRO_QOP(DivFloat):
+        TIRO_QUICK(DivFloat, quick_float_op);
+        TIRO_NEXT();
+    TIRO_QOP(GtFloat):
+        TIRO_QUICK(GtFloat, quick_float_op);
+        TIRO_NEXT();
+    TIRO_QOP(GteFloat):
+        TIRO_QUICK(GteFloat, quick_float_op);
+        TIRO_NEXT();
+    TIRO_QOP(LtFloat):
+        TIRO_QUICK(LtFloat, quick_float_op);
+        TIRO_NEXT();
+    TIRO_QOP(LteFloat):
+        TIRO_QUICK(LteFloat, quick_float_op);
+        TIRO_NEXT();
+    }
+
+#ifdef TIRO_COMPUTED_GOTO
+invalid_op:
+#endif
+    TIRO_UNREACHABLE("invalid opcode");
 }
 
 #undef TIRO_BINOP
 #undef TIRO_UNOP
 #undef TIRO_CMP
+#undef TIRO_QUICK
+#undef TIRO_OP
+#undef TIRO_QOP
+#undef TIRO_NEXT
+#undef TIRO_SAFEPOINT_NEXT
+#undef TIRO_JUMP_NEXT
 
 bool BytecodeInterpreter::handle_exception(
     Context& ctx, CodeFrame* frame, MutHandle<Exception> ex) {
@@ -832,16 +1239,148 @@ void BytecodeInterpreter::return_function(/* UNROOTED */ Value return_value) {
     return parent_.return_function(Handle<Coroutine>(&coro_), return_value);
 }
 
+bool BytecodeInterpreter::push_code_frame(Value function, u32 argc, bool pop_one_more) {
+#ifdef TIRO_TRACE_CALLS
+    // Calls are traced by the generic implementation.
+    return false;
+#endif
+
+    if (function.type() != ValueType::CodeFunction)
+        return false;
+
+    auto func = CodeFunction(function);
+    auto tmpl = func.tmpl();
+    if (TIRO_UNLIKELY(tmpl.params() != argc))
+        return false;
+
+    const u8 flags = pop_one_more ? FRAME_POP_ONE_MORE : 0;
+    if (TIRO_UNLIKELY(!stack_.push_user_frame(tmpl, func.closure(), flags)))
+        return false;
+
+    frame_ = TIRO_NN(static_cast<CodeFrame*>(stack_.top_frame()));
+    load_frame();
+    return true;
+}
+
+bool BytecodeInterpreter::replace_code_frame(Value function, u32 argc, bool pop_one_more) {
+#ifdef TIRO_TRACE_CALLS
+    // Calls are traced by the generic implementation.
+    return false;
+#endif
+
+    if (function.type() != ValueType::CodeFunction)
+        return false;
+
+    // The in-flight exception would be lost.
+    if (TIRO_UNLIKELY(frame_->flags & FRAME_UNWINDING))
+        return false;
+
+    auto func = CodeFunction(function);
+    auto tmpl = func.tmpl();
+    if (TIRO_UNLIKELY(tmpl.params() != argc))
+        return false;
+
+    const u8 flags = pop_one_more ? FRAME_POP_ONE_MORE : 0;
+    if (TIRO_UNLIKELY(!stack_.replace_user_frame(tmpl, func.closure(), flags)))
+        return false;
+
+    frame_ = TIRO_NN(static_cast<CodeFrame*>(stack_.top_frame()));
+    load_frame();
+    return true;
+}
+
+bool BytecodeInterpreter::pop_code_frame(/* UNROOTED */ Value return_value) {
+    CoroutineFrame* caller = frame_->caller();
+    if (!caller || caller->type != FrameType::Code)
+        return false;
+
+    // Same as Interpreter::return_function(), but the caller is known to be a bytecode frame.
+    u32 pop_args = frame_->argc;
+    if (frame_->flags & FRAME_POP_ONE_MORE)
+        ++pop_args;
+
+    stack_.pop_frame();
+    stack_.pop_values(pop_args);
+    TIRO_DEBUG_ASSERT(stack_.top_frame() == caller, "caller must be the new topmost frame");
+    TIRO_DEBUG_ASSERT(stack_.value_capacity_remaining() > 0,
+        "popping the frame must make at least one value slot available");
+    must_push_value(stack_, return_value);
+
+    frame_ = TIRO_NN(static_cast<CodeFrame*>(caller));
+    load_frame();
+    return true;
+}
+
+bool BytecodeInterpreter::enter_top_frame() {
+    if (coro_.state() != CoroutineState::Running)
+        return false;
+
+    // The stack may have been replaced (e.g. when a new frame did not fit into the old stack).
+    CoroutineStack stack = current_stack(coro_);
+    CoroutineFrame* frame = stack.top_frame();
+    if (!frame || frame->type != FrameType::Code)
+        return false;
+
+    stack_ = stack;
+    frame_ = TIRO_NN(static_cast<CodeFrame*>(frame));
+    load_frame();
+    return true;
+}
+
+bool BytecodeInterpreter::safepoint() {
+    Profiler& profiler = ctx_.profiler();
+    if (TIRO_UNLIKELY(profiler.sample_due()))
+        profiler.sample(coro_, stack_);
+
+    if (TIRO_UNLIKELY(parent_.should_preempt())) {
+        parent_.preempt(Handle<Coroutine>(&coro_));
+        return false;
+    }
+
+#ifdef TIRO_JIT
+    enter_jit();
+#endif
+    return true;
+}
+
+#ifdef TIRO_JIT
+void BytecodeInterpreter::enter_jit() {
+    auto tmpl = frame_->tmpl;
+    JitFunction* func = tmpl.jit();
+    if (!func) {
+        Jit& jit = ctx_.jit();
+        if (TIRO_LIKELY(tmpl.add_hotness(1) < jit.threshold()))
+            return;
+        func = jit.compile(tmpl);
+    }
+
+    const CodeWord* code = tmpl.code().data();
+    const u32 pc = static_cast<u32>(frame_->pc - code);
+    if (!func->has_entry(pc))
+        return;
+
+    const u32 exit_pc = ctx_.jit().run(ctx_, *func, frame_, pc);
+    TIRO_DEBUG_ASSERT(pc_in_bounds(exit_pc), "invalid exit from machine code");
+    frame_->pc = code + exit_pc;
+}
+#endif
+
+void BytecodeInterpreter::load_frame() {
+    members_ = frame_->tmpl.module().members();
+    cache_ = frame_->tmpl.inline_cache();
+#ifdef TIRO_INSTRUMENT
+    ctx_.op_stats().enter_function(frame_->tmpl);
+#endif
+}
+
 void BytecodeInterpreter::unwind(/* UNROOTED */ Exception ex) {
     return parent_.unwind(Handle<Coroutine>(&coro_), ex);
 }
 
 Value BytecodeInterpreter::get_member(u32 index) {
-    Module mod = frame_->tmpl.module();
-    Tuple members = mod.members();
-    TIRO_DEBUG_ASSERT(index < members.size(), "module member index out of bounds");
+    TIRO_DEBUG_ASSERT(index < members_.size(), "module member index out of bounds");
 
-    Value member = members.unchecked_get(index);
+    Value member = members_.unchecked_get(index);
 
     // TODO It would be great to have static verification for this.
     // Reading from an undefined variable is only possible when the codegen is buggy.
@@ -849,11 +1388,14 @@ Value BytecodeInterpreter::get_member(u32 index) {
     return member;
 }
 
+Tuple BytecodeInterpreter::inline_cache() {
+    TIRO_DEBUG_ASSERT(cache_.has_value(), "function must have an inline cache");
+    return cache_.value();
+}
+
 void BytecodeInterpreter::set_member(u32 index, Value value) {
-    Module mod = frame_->tmpl.module();
-    Tuple members = mod.members();
-    TIRO_DEBUG_ASSERT(index < members.size(), "module member index out of bounds");
-    members.unchecked_set(index, value);
+    TIRO_DEBUG_ASSERT(index < members_.size(), "module member index out of bounds");
+    members_.unchecked_set(index, value);
 }
 
 void BytecodeInterpreter::reserve_stack(u32 n) {
@@ -873,32 +1415,41 @@ void BytecodeInterpreter::push_stack(Value v) {
     must_push_value(stack_, v);
 }
 
-BytecodeOp BytecodeInterpreter::read_op() {
-    TIRO_DEBUG_ASSERT(readable_bytes() >= 1, "not enough available bytes");
+CodeWord BytecodeInterpreter::read_op() {
+    TIRO_DEBUG_ASSERT(
+        readable_words() >= 1, "end of function reached without return from function");
+
+    CodeWord opcode = *frame_->pc++;
+    TIRO_DEBUG_ASSERT((opcode <= 0xFF && valid_opcode(opcode)) || valid_quick_op(opcode),
+        "invalid opcode");
+#ifdef TIRO_INSTRUMENT
+    ctx_.op_stats().record(opcode);
+#endif
+    return opcode;
+}
+
+template<typename T>
+T BytecodeInterpreter::read_native() {
+    static_assert(sizeof(T) == 2 * sizeof(CodeWord));
+    TIRO_DEBUG_ASSERT(readable_words() >= 2, "not enough available code words");
 
-    u8 opcode = *frame_->pc++;
-    TIRO_DEBUG_ASSERT(valid_opcode(opcode), "invalid opcode");
-    return static_cast<BytecodeOp>(opcode);
+    T value;
+    std::memcpy(&value, frame_->pc, sizeof(T));
+    frame_->pc += 2;
+    return value;
 }
 
 i64 BytecodeInterpreter::read_i64() {
-    TIRO_DEBUG_ASSERT(readable_bytes() >= 8, "not enough available bytes");
-    return static_cast<i64>(read_big_endian<u64>(frame_->pc));
+    return static_cast<i64>(read_native<u64>());
 }
 
 f64 BytecodeInterpreter::read_f64() {
-    TIRO_DEBUG_ASSERT(readable_bytes() >= 8, "not enough available bytes");
-    // FIXME float serialization in some helper function, see also compiler/binary.hpp
-    static_assert(sizeof(f64) == sizeof(u64));
-    u64 as_u64 = read_big_endian<u64>(frame_->pc);
-    f64 d;
-    std::memcpy(&d, &as_u64, sizeof(f64));
-    return d;
+    return read_native<f64>();
 }
 
 u32 BytecodeInterpreter::read_u32() {
-    TIRO_DEBUG_ASSERT(readable_bytes() >= 4, "not enough available bytes");
-    return read_big_endian<u32>(frame_->pc);
+    TIRO_DEBUG_ASSERT(readable_words() >= 1, "not enough available code words");
+    return *frame_->pc++;
 }
 
 MutHandle<Value> BytecodeInterpreter::read_local() {
@@ -906,7 +1457,7 @@ MutHandle<Value> BytecodeInterpreter::read_local() {
     return MutHandle<Value>(CoroutineStack::local(frame_, local));
 }
 
-[[maybe_unused]] size_t BytecodeInterpreter::readable_bytes() const {
+[[maybe_unused]] size_t BytecodeInterpreter::readable_words() const {
     return static_cast<size_t>(frame_->tmpl.code().view().end() - frame_->pc);
 }
 
@@ -914,6 +1465,24 @@ MutHandle<Value> BytecodeInterpreter::read_local() {
     return offset < frame_->tmpl.code().size();
 }
 
+void BytecodeInterpreter::quicken(const CodeWord* op_word, Value lhs, Value rhs) {
+    const auto op = static_cast<BytecodeOp>(*op_word);
+    if (auto quick = select_quick_op(op, lhs, rhs))
+        rewrite_op(op_word, static_cast<CodeWord>(*quick));
+}
+
+void BytecodeInterpreter::deoptimize(const CodeWord* op_word, QuickOp op) {
+    rewrite_op(op_word, static_cast<CodeWord>(generic_op(op)));
+    frame_->pc = op_word;
+}
+
+void BytecodeInterpreter::rewrite_op(const CodeWord* op_word, CodeWord op) {
+    auto code = frame_->tmpl.code();
+    TIRO_DEBUG_ASSERT(op_word >= code.data() && op_word < code.data() + code.size(),
+        "opcode must be part of the current function");
+    code.rewrite(static_cast<size_t>(op_word - code.data()), op);
+}
+
 void BytecodeInterpreter::set_pc(u32 offset) {
     TIRO_DEBUG_ASSERT(pc_in_bounds(offset), "jump destination is out of bounds");
     frame_->pc = frame_->tmpl.code().data() + offset;
@@ -930,14 +1499,17 @@ Coroutine Interpreter::make_coroutine(Handle<Value> func, MaybeHandle<Tuple> arg
     return Coroutine::make(ctx(), name, func, arguments, stack);
 }
 
-void Interpreter::run(Handle<Coroutine> coro) {
+void Interpreter::run(Handle<Coroutine> coro, std::optional<Clock::time_point> deadline) {
     TIRO_DEBUG_ASSERT(!running_, "the interpreter is already running");
 
     running_ = true;
     current_ = *coro;
+    deadline_ = deadline;
+    preempt_countdown_ = preempt_check_interval;
     ScopeExit reset_running = [&] {
         running_ = false;
         current_ = Null();
+        deadline_.reset();
         regs_.reset();
     };
 
@@ -961,6 +1533,14 @@ Nullable<Coroutine> Interpreter::current_coroutine() {
     return current_;
 }
 
+void Interpreter::preempt(Handle<Coroutine> coro) {
+    TIRO_DEBUG_ASSERT(coro->state() == CoroutineState::Running, "only running coroutines can be preempted");
+
+    // Unlike Context::resume_coroutine(), the coroutine's token remains valid: the coroutine did not yield.
+    coro->state(CoroutineState::Ready);
+    ctx().schedule_coroutine(coro);
+}
+
 void Interpreter::run_until_block(Handle<Coroutine> coro) {
     TIRO_DEBUG_ASSERT(is_runnable(coro->state()), "coroutine must be in a runnable state");
 
@@ -7,8 +7,11 @@
 #include "vm/objects/coroutine.hpp"
 #include "vm/objects/nullable.hpp"
 #include "vm/objects/value.hpp"
+#include "vm/quicken.hpp"
 
 #include <array>
+#include <chrono>
+#include <optional>
 
 namespace tiro::vm {
 
@@ -61,10 +64,13 @@ public:
 
     // Runs the bytecode of the current function frame and returns on the first suspension point.
     //
+    // Calls to other bytecode functions and returns into bytecode functions are handled
+    // without leaving the interpreter loop: the interpreter simply switches to the new topmost frame.
     // Possible suspension points are:
-    // - A call to another function (including asynchronous ones)
+    // - A call to a native or magic function
+    // - A return into a frame that is not a bytecode frame (or from the outermost function)
     // - A thrown exception
-    // - Normal return from the function
+    // - Preemption at a safepoint (see Interpreter::run())
     //
     // In any event, after `run` has finished executing, the topmost frame on the stack will have to be
     // reexamined.
@@ -81,6 +87,8 @@ public:
         // Note: regs not owned by us, visited in parent
         tracer(coro_);
         tracer(stack_);
+        tracer(members_);
+        tracer(cache_);
     }
 
 private:
@@ -93,6 +101,44 @@ private:
     // Pops the current frame from the stack and applies the next state of the coroutine.
     void return_function(Value return_value);
 
+    // Fast path for calls to bytecode functions. Pushes a new frame for `function` onto the current
+    // stack and switches to that frame. Returns false (without side effects) if the generic call
+    // implementation must be used instead, e.g. if `function` is not a bytecode function or if
+    // the stack must grow first.
+    // The stack must contain the function's arguments (see Interpreter::enter_function()).
+    bool push_code_frame(Value function, u32 argc, bool pop_one_more);
+
+    // Fast path for tail calls to bytecode functions. Replaces the current frame with a new frame
+    // for `function` and switches to that frame. Returns false (without side effects) if the
+    // call must be executed like a normal call instead.
+    bool replace_code_frame(Value function, u32 argc, bool pop_one_more);
+
+    // Fast path for returns into bytecode functions. Pops the current frame, pushes the return value
+    // and switches to the caller's frame. Returns false (without side effects) if the caller is not a
+    // bytecode frame.
+    bool pop_code_frame(Value return_value);
+
+    // Called after a call or a return instruction has changed the topmost frame of the coroutine.
+    // Returns true if execution can continue within the interpreter loop, i.e. if the coroutine is still
+    // running and the new topmost frame is a bytecode frame. The interpreter state is updated
+    // to refer to that frame.
+    bool enter_top_frame();
+
+    // Caches frequently used values of the current function. Must be called after `frame_` changed.
+    void load_frame();
+
+    // Called on function entry and on loop iterations. Takes samples for the profiler,
+    // preempts the coroutine when its time slice has expired and enters compiled code (if enabled).
+    // Returns false if the coroutine was preempted, in which case the interpreter loop must return.
+    bool safepoint();
+
+#ifdef TIRO_JIT
+    // Called from safepoint(). Executes the current function's machine code
+    // (compiling it first, if the function just became hot), starting with the instruction at the current pc.
+    // Afterwards, the pc points to the next instruction that must be executed by the interpreter.
+    void enter_jit();
+#endif
+
     // Exits the current control flow by throwing an exception. The appropriate handler will be invoked,
     // which may involve popping the current function's frame.
     //
@@ -106,6 +152,10 @@ private:
     // Sets the module member with the given index (in the current function's module) to the specified value.
     void set_member(u32 index, Value v);
 
+    // Returns the inline cache storage of the current function.
+    // Must only be called by instructions that use an inline cache.
+    Tuple inline_cache();
+
     // Reserves enough space for `n` additional values on the stack. The stack might grow
     // (and therefore change) as a result.
     void reserve_stack(u32 n);
@@ -114,15 +164,32 @@ private:
     // on the stack before calling this function. Use `reserve_stack` when appropriate.
     void push_stack(Value v);
 
+    // Rewrites the instruction at `op_word` into a quickened instruction if there is
+    // a specialized version for the given operand types. Must be called before the instruction's
+    // generic implementation can trigger a garbage collection.
+    void quicken(const CodeWord* op_word, Value lhs, Value rhs);
+
+    // Rewrites the quickened instruction at `op_word` back to its generic version
+    // and resets the program counter, so that the generic instruction is dispatched next.
+    void deoptimize(const CodeWord* op_word, QuickOp op);
+
+    // Replaces the opcode of the instruction at `op_word` within the current function.
+    void rewrite_op(const CodeWord* op_word, CodeWord op);
+
     // Reads a variable of the given type from the instruction stream.
-    BytecodeOp read_op();
+    // Opcodes are either bytecode opcodes or quickened opcodes (see `QuickOp`).
+    CodeWord read_op();
     i64 read_i64();
     f64 read_f64();
     u32 read_u32();
     MutHandle<Value> read_local();
 
-    // Returns the number of readable bytes in the instruction streams (starting from the current pc).
-    size_t readable_bytes() const;
+    // Reads a 64 bit operand, which occupies two consecutive code words.
+    template<typename T>
+    T read_native();
+
+    // Returns the number of readable words in the instruction streams (starting from the current pc).
+    size_t readable_words() const;
 
     // Returns true if `offset` is a valid pc value for the current frame.
     bool pc_in_bounds(u32 offset) const;
@@ -137,6 +204,8 @@ private:
     Coroutine coro_;            // Currently executing coroutine.
     CoroutineStack stack_;      // The coroutine's stack (changes on growth).
     NotNull<CodeFrame*> frame_; // Current frame (points into the stack, adjusted on stack growth).
+    Tuple members_;             // Members of the current function's module.
+    Nullable<Tuple> cache_;     // Inline cache of the current function.
 };
 
 /// The interpreter is responsible for the creation and the execution
@@ -144,6 +213,8 @@ private:
 /// when a call to a bytecode function is made. Native function calls are evaluated directly.
 class Interpreter final {
 public:
+    using Clock = std::chrono::steady_clock;
+
     Interpreter() = default;
 
     void init(Context& ctx);
@@ -156,7 +227,12 @@ public:
     /// Executes the given coroutine until it either completes or yields.
     /// The coroutine must be in a runnable state.
     /// If the coroutine completed, the result can be obtained by calling coro->result().
-    void run(Handle<Coroutine> coro);
+    ///
+    /// If a `deadline` is specified, the coroutine is preempted at the first safepoint (function call
+    /// or loop iteration) after the deadline has passed: it is placed at the end of the ready queue
+    /// in the `Ready` state and `run()` returns. The clock is only consulted every `preempt_check_interval`
+    /// safepoints, so a coroutine always makes some progress, even if the deadline has already passed.
+    void run(Handle<Coroutine> coro, std::optional<Clock::time_point> deadline = {});
 
     /// Returns the currently running coroutine (or null).
     Nullable<Coroutine> current_coroutine();
@@ -170,8 +246,22 @@ public:
 private:
     friend BytecodeInterpreter;
 
+    // Number of safepoints between two clock reads when a deadline is active.
+    static constexpr u32 preempt_check_interval = 128;
+
     void run_until_block(Handle<Coroutine> coro);
 
+    // Returns true if the running coroutine should be preempted at the current safepoint.
+    bool should_preempt() {
+        if (!deadline_ || --preempt_countdown_ != 0)
+            return false;
+        preempt_countdown_ = preempt_check_interval;
+        return Clock::now() >= *deadline_;
+    }
+
+    // Moves the running coroutine to the end of the ready queue.
+    void preempt(Handle<Coroutine> coro);
+
     // Run the topmost frame of the coroutine's stack.
     // Note: frame points into the coroutine's current stack and will be invalidated
     // by stack growth during the the interpretation of the function frame.
@@ -267,6 +357,10 @@ private:
     // References the coroutine that is currently running, or null.
     Nullable<Coroutine> current_;
 
+    // Preemption state of the current run, see run().
+    std::optional<Clock::time_point> deadline_;
+    u32 preempt_countdown_ = 0;
+
     // Lifeline for the garbage collector.
     BytecodeInterpreter* child_ = nullptr;
 
@@ -0,0 +1,229 @@
+#include "vm/jit/assembler.hpp"
+
+#include <cstring>
+
+namespace tiro::vm {
+
+static u8 reg_code(X64Reg reg) {
+    return static_cast<u8>(reg);
+}
+
+static u8 cond_code(X64Cond cond) {
+    return static_cast<u8>(cond);
+}
+
+static bool fits_i8(i32 value) {
+    return value >= -128 && value <= 127;
+}
+
+static i32 rel32(u32 from, u32 to) {
+    return static_cast<i32>(static_cast<i64>(to) - static_cast<i64>(from));
+}
+
+void X64Assembler::bind(X64Label& label) {
+    TIRO_DEBUG_ASSERT(!label.bound(), "label was already bound");
+    label.pos_ = pos();
+    for (u32 fixup : label.fixups_) {
+        const i32 rel = rel32(fixup + 4, label.pos_);
+        std::memcpy(code_.data() + fixup, &rel, sizeof(rel));
+    }
+    label.fixups_.clear();
+}
+
+void X64Assembler::mov(X64Reg dst, X64Reg src) {
+    rex_w(reg_code(src), reg_code(dst));
+    emit(0x89);
+    modrm_reg(reg_code(src), reg_code(dst));
+}
+
+void X64Assembler::mov(X64Reg dst, X64Mem src) {
+    rex_w(reg_code(dst), reg_code(src.base));
+    emit(0x8B);
+    modrm_mem(reg_code(dst), src);
+}
+
+void X64Assembler::mov(X64Mem dst, X64Reg src) {
+    rex_w(reg_code(src), reg_code(dst.base));
+    emit(0x89);
+    modrm_mem(reg_code(src), dst);
+}
+
+void X64Assembler::mov(X64Mem dst, i32 imm) {
+    rex_w(0, reg_code(dst.base));
+    emit(0xC7);
+    modrm_mem(0, dst);
+    emit_u32(static_cast<u32>(imm));
+}
+
+void X64Assembler::mov(X64Reg dst, u64 imm) {
+    rex_w(0, reg_code(dst));
+    emit(0xB8 + (reg_code(dst) & 7));
+    emit_u64(imm);
+}
+
+void X64Assembler::mov_eax(u32 imm) {
+    emit(0xB8);
+    emit_u32(imm);
+}
+
+void X64Assembler::add(X64Reg dst, X64Reg src) {
+    rex_w(reg_code(src), reg_code(dst));
+    emit(0x01);
+    modrm_reg(reg_code(src), reg_code(dst));
+}
+
+void X64Assembler::sub(X64Reg dst, X64Reg src) {
+    rex_w(reg_code(src), reg_code(dst));
+    emit(0x29);
+    modrm_reg(reg_code(src), reg_code(dst));
+}
+
+void X64Assembler::sub(X64Reg dst, i8 imm) {
+    rex_w(0, reg_code(dst));
+    emit(0x83);
+    modrm_reg(5, reg_code(dst));
+    emit(static_cast<byte>(imm));
+}
+
+void X64Assembler::sub(X64Mem dst, i8 imm) {
+    rex_w(0, reg_code(dst.base));
+    emit(0x83);
+    modrm_mem(5, dst);
+    emit(static_cast<byte>(imm));
+}
+
+void X64Assembler::or_(X64Reg dst, i8 imm) {
+    rex_w(0, reg_code(dst));
+    emit(0x83);
+    modrm_reg(1, reg_code(dst));
+    emit(static_cast<byte>(imm));
+}
+
+void X64Assembler::imul(X64Reg dst, X64Reg src) {
+    rex_w(reg_code(dst), reg_code(src));
+    emit(0x0F);
+    emit(0xAF);
+    modrm_reg(reg_code(dst), reg_code(src));
+}
+
+void X64Assembler::sar1(X64Reg dst) {
+    rex_w(0, reg_code(dst));
+    emit(0xD1);
+    modrm_reg(7, reg_code(dst));
+}
+
+void X64Assembler::cmp(X64Reg lhs, X64Reg rhs) {
+    rex_w(reg_code(rhs), reg_code(lhs));
+    emit(0x39);
+    modrm_reg(reg_code(rhs), reg_code(lhs));
+}
+
+void X64Assembler::cmp(X64Reg lhs, X64Mem rhs) {
+    rex_w(reg_code(lhs), reg_code(rhs.base));
+    emit(0x3B);
+    modrm_mem(reg_code(lhs), rhs);
+}
+
+void X64Assembler::test(X64Reg lhs, X64Reg rhs) {
+    rex_w(reg_code(rhs), reg_code(lhs));
+    emit(0x85);
+    modrm_reg(reg_code(rhs), reg_code(lhs));
+}
+
+void X64Assembler::test8(X64Reg reg, u8 imm) {
+    // Without a REX prefix, the codes 4-7 would refer to ah, ch, dh and bh.
+    const u8 code = reg_code(reg);
+    if (code >= 4)
+        emit(0x40 | ((code >> 3) & 1));
+    emit(0xF6);
+    modrm_reg(0, code);
+    emit(imm);
+}
+
+void X64Assembler::cmov(X64Cond cond, X64Reg dst, X64Mem src) {
+    rex_w(reg_code(dst), reg_code(src.base));
+    emit(0x0F);
+    emit(0x40 + cond_code(cond));
+    modrm_mem(reg_code(dst), src);
+}
+
+void X64Assembler::jmp(X64Label& label) {
+    emit(0xE9);
+    emit_rel32(label);
+}
+
+void X64Assembler::jmp(X64Reg target) {
+    const u8 code = reg_code(target);
+    if (code >= 8)
+        emit(0x41);
+    emit(0xFF);
+    modrm_reg(4, code);
+}
+
+void X64Assembler::jcc(X64Cond cond, X64Label& label) {
+    emit(0x0F);
+    emit(0x80 + cond_code(cond));
+    emit_rel32(label);
+}
+
+void X64Assembler::ret() {
+    emit(0xC3);
+}
+
+void X64Assembler::emit_u32(u32 value) {
+    byte bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    code_.insert(code_.end(), std::begin(bytes), std::end(bytes));
+}
+
+void X64Assembler::emit_u64(u64 value) {
+    byte bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    code_.insert(code_.end(), std::begin(bytes), std::end(bytes));
+}
+
+void X64Assembler::rex_w(u8 reg, u8 rm) {
+    emit(0x48 | (((reg >> 3) & 1) << 2) | ((rm >> 3) & 1));
+}
+
+void X64Assembler::modrm_reg(u8 reg, u8 rm) {
+    emit(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+void X64Assembler::modrm_mem(u8 reg, X64Mem mem) {
+    const u8 base = reg_code(mem.base) & 7;
+
+    // rbp and r13 cannot be used as a base without displacement (the encoding means rip relative).
+    u8 mod;
+    if (mem.disp == 0 && base != 5) {
+        mod = 0;
+    } else if (fits_i8(mem.disp)) {
+        mod = 1;
+    } else {
+        mod = 2;
+    }
+
+    emit((mod << 6) | ((reg & 7) << 3) | base);
+
+    // rsp and r12 as a base require a SIB byte.
+    if (base == 4)
+        emit(0x24);
+
+    if (mod == 1) {
+        emit(static_cast<byte>(static_cast<i8>(mem.disp)));
+    } else if (mod == 2) {
+        emit_u32(static_cast<u32>(mem.disp));
+    }
+}
+
+void X64Assembler::emit_rel32(X64Label& label) {
+    if (label.bound()) {
+        emit_u32(static_cast<u32>(rel32(pos() + 4, label.pos_)));
+        return;
+    }
+
+    label.fixups_.push_back(pos());
+    emit_u32(0);
+}
+
+} // namespace tiro::vm
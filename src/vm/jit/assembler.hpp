@@ -0,0 +1,177 @@
+#ifndef TIRO_VM_JIT_ASSEMBLER_HPP
+#define TIRO_VM_JIT_ASSEMBLER_HPP
+
+#include "common/adt/span.hpp"
+#include "common/defs.hpp"
+
+#include <vector>
+
+namespace tiro::vm {
+
+/// General purpose registers of the x86-64 architecture.
+enum class X64Reg : u8 {
+    RAX = 0,
+    RCX,
+    RDX,
+    RBX,
+    RSP,
+    RBP,
+    RSI,
+    RDI,
+    R8,
+    R9,
+    R10,
+    R11,
+    R12,
+    R13,
+    R14,
+    R15,
+};
+
+/// Condition codes for conditional jumps and moves.
+enum class X64Cond : u8 {
+    Overflow = 0x0,
+    NoOverflow = 0x1,
+    Below = 0x2,
+    AboveEqual = 0x3,
+    Equal = 0x4,
+    NotEqual = 0x5,
+    BelowEqual = 0x6,
+    Above = 0x7,
+    Sign = 0x8,
+    NoSign = 0x9,
+    Less = 0xC,
+    GreaterEqual = 0xD,
+    LessEqual = 0xE,
+    Greater = 0xF,
+};
+
+/// A memory operand of the form `[base + disp]`.
+struct X64Mem {
+    X64Reg base;
+    i32 disp = 0;
+};
+
+/// References a position in the generated code. Labels can be used as jump destinations
+/// before they are bound, the jump instructions are patched when the label is bound.
+class X64Label final {
+public:
+    X64Label() = default;
+
+    bool bound() const { return pos_ != unbound; }
+
+private:
+    friend class X64Assembler;
+
+    static constexpr u32 unbound = u32(-1);
+
+    u32 pos_ = unbound;
+    std::vector<u32> fixups_; // Positions of rel32 displacements that refer to this label.
+};
+
+/// A minimal assembler for the subset of x86-64 instructions used by the JIT.
+/// Only 64 bit operand sizes are supported (unless noted otherwise).
+class X64Assembler final {
+public:
+    X64Assembler() = default;
+
+    /// The current size of the generated code, in bytes.
+    u32 pos() const { return static_cast<u32>(code_.size()); }
+
+    /// The generated code. All labels that are used as jump destinations must be bound.
+    Span<const byte> code() const { return code_; }
+
+    /// Binds the label to the current position.
+    void bind(X64Label& label);
+
+    /// `mov dst, src`
+    void mov(X64Reg dst, X64Reg src);
+
+    /// `mov dst, [mem]`
+    void mov(X64Reg dst, X64Mem src);
+
+    /// `mov [mem], src`
+    void mov(X64Mem dst, X64Reg src);
+
+    /// `mov qword [mem], imm` (the immediate is sign extended).
+    void mov(X64Mem dst, i32 imm);
+
+    /// `mov dst, imm` with a full 64 bit immediate.
+    void mov(X64Reg dst, u64 imm);
+
+    /// `mov eax, imm` (32 bit, zero extends into rax).
+    void mov_eax(u32 imm);
+
+    /// `add dst, src`
+    void add(X64Reg dst, X64Reg src);
+
+    /// `sub dst, src`
+    void sub(X64Reg dst, X64Reg src);
+
+    /// `sub dst, imm`
+    void sub(X64Reg dst, i8 imm);
+
+    /// `sub qword [dst], imm`
+    void sub(X64Mem dst, i8 imm);
+
+    /// `or dst, imm`
+    void or_(X64Reg dst, i8 imm);
+
+    /// `imul dst, src`
+    void imul(X64Reg dst, X64Reg src);
+
+    /// `sar dst, 1`
+    void sar1(X64Reg dst);
+
+    /// `cmp lhs, rhs`
+    void cmp(X64Reg lhs, X64Reg rhs);
+
+    /// `cmp lhs, [rhs]`
+    void cmp(X64Reg lhs, X64Mem rhs);
+
+    /// `test lhs, rhs`
+    void test(X64Reg lhs, X64Reg rhs);
+
+    /// `test reg8, imm` (tests the lowest byte of `reg`).
+    void test8(X64Reg reg, u8 imm);
+
+    /// `cmovcc dst, [src]`
+    void cmov(X64Cond cond, X64Reg dst, X64Mem src);
+
+    /// `jmp label` (rel32)
+    void jmp(X64Label& label);
+
+    /// `jmp reg`
+    void jmp(X64Reg target);
+
+    /// `jcc label` (rel32)
+    void jcc(X64Cond cond, X64Label& label);
+
+    /// `ret`
+    void ret();
+
+private:
+    void emit(byte b) { code_.push_back(b); }
+    void emit_u32(u32 value);
+    void emit_u64(u64 value);
+
+    // Emits a REX prefix for 64 bit operands. `reg` is the register in the ModRM reg field
+    // (or an opcode extension), `rm` is the register in the ModRM rm field.
+    void rex_w(u8 reg, u8 rm);
+
+    // Emits a ModRM byte that addresses a register.
+    void modrm_reg(u8 reg, u8 rm);
+
+    // Emits ModRM (and SIB) bytes and the displacement that address memory.
+    void modrm_mem(u8 reg, X64Mem mem);
+
+    // Emits a rel32 displacement to the given label.
+    void emit_rel32(X64Label& label);
+
+private:
+    std::vector<byte> code_;
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_JIT_ASSEMBLER_HPP
@@ -0,0 +1,66 @@
+#include "vm/jit/code_memory.hpp"
+
+#include "common/math.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+namespace tiro::vm {
+
+CodeMemory CodeMemory::make(Span<const byte> code) {
+    TIRO_DEBUG_ASSERT(code.size() > 0, "code must not be empty");
+
+    const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t mapped_size = ceil(code.size(), page_size);
+
+    void* mem = ::mmap(
+        nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        TIRO_ERROR("failed to map memory for machine code: {}", std::strerror(errno));
+
+    std::memcpy(mem, code.data(), code.size());
+    if (::mprotect(mem, mapped_size, PROT_READ | PROT_EXEC) != 0) {
+        const int error = errno;
+        ::munmap(mem, mapped_size);
+        TIRO_ERROR("failed to make machine code executable: {}", std::strerror(error));
+    }
+    return CodeMemory(static_cast<byte*>(mem), code.size(), mapped_size);
+}
+
+CodeMemory::CodeMemory(byte* data, size_t size, size_t mapped_size)
+    : data_(data)
+    , size_(size)
+    , mapped_size_(mapped_size) {}
+
+CodeMemory::~CodeMemory() {
+    reset();
+}
+
+CodeMemory::CodeMemory(CodeMemory&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_size_(std::exchange(other.mapped_size_, 0)) {}
+
+CodeMemory& CodeMemory::operator=(CodeMemory&& other) noexcept {
+    if (this != &other) {
+        reset();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_size_ = std::exchange(other.mapped_size_, 0);
+    }
+    return *this;
+}
+
+void CodeMemory::reset() {
+    if (data_)
+        ::munmap(data_, mapped_size_);
+    data_ = nullptr;
+    size_ = 0;
+    mapped_size_ = 0;
+}
+
+} // namespace tiro::vm
@@ -0,0 +1,44 @@
+#ifndef TIRO_VM_JIT_CODE_MEMORY_HPP
+#define TIRO_VM_JIT_CODE_MEMORY_HPP
+
+#include "common/adt/span.hpp"
+#include "common/defs.hpp"
+
+namespace tiro::vm {
+
+/// Owns a block of executable memory that contains generated machine code.
+///
+/// Memory is never writable and executable at the same time (W^X): the code is copied
+/// into a fresh writable mapping, which is then remapped as read-only and executable.
+class CodeMemory final {
+public:
+    /// Maps a new block of executable memory that contains a copy of `code`.
+    /// Throws if the memory cannot be mapped.
+    static CodeMemory make(Span<const byte> code);
+
+    CodeMemory() = default;
+    ~CodeMemory();
+
+    CodeMemory(CodeMemory&& other) noexcept;
+    CodeMemory& operator=(CodeMemory&& other) noexcept;
+
+    /// Start of the executable code.
+    const byte* data() const { return data_; }
+
+    /// Size of the executable code, in bytes.
+    size_t size() const { return size_; }
+
+private:
+    CodeMemory(byte* data, size_t size, size_t mapped_size);
+
+    void reset();
+
+private:
+    byte* data_ = nullptr;
+    size_t size_ = 0;
+    size_t mapped_size_ = 0;
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_JIT_CODE_MEMORY_HPP
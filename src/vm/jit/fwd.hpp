@@ -0,0 +1,14 @@
+#ifndef TIRO_VM_JIT_FWD_HPP
+#define TIRO_VM_JIT_FWD_HPP
+
+namespace tiro::vm {
+
+class CodeMemory;
+class Jit;
+class JitFunction;
+struct JitState;
+class X64Assembler;
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_JIT_FWD_HPP
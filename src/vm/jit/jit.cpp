@@ -0,0 +1,431 @@
+#include "vm/jit/jit.hpp"
+
+#include "bytecode/op.hpp"
+#include "vm/context.hpp"
+#include "vm/jit/assembler.hpp"
+#include "vm/modules/translate.hpp"
+#include "vm/objects/all.hpp"
+#include "vm/quicken.hpp"
+
+#include "fmt/format.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace tiro::vm {
+
+// Register assignment of the generated code. The first four registers contain the arguments
+// of JitFunction::Entry. All other registers used by the generated code are scratch registers.
+static constexpr X64Reg locals_reg = X64Reg::RDI;
+static constexpr X64Reg args_reg = X64Reg::RSI;
+static constexpr X64Reg state_reg = X64Reg::RDX;
+static constexpr X64Reg target_reg = X64Reg::RCX;
+
+namespace {
+
+class FunctionJitCompiler final {
+public:
+    explicit FunctionJitCompiler(Span<const CodeWord> code)
+        : code_(code)
+        , labels_(code.size())
+        , exits_(code.size())
+        , entries_(code.size(), JitFunction::no_entry) {}
+
+    std::unique_ptr<JitFunction> compile();
+
+private:
+    // Emits machine code for the instruction at `pc`. Returns false if the instruction
+    // is not supported, in which case no code has been emitted.
+    bool compile_instruction(BytecodeOp op, u32 pc);
+
+    // Guards that `lhs` and `rhs` are small integers (jumps to the exit of `pc` otherwise).
+    void guard_small_ints(X64Reg lhs, X64Reg rhs, u32 pc);
+
+    // Stores the boolean for the given condition (evaluated from the current flags) into `target`.
+    void store_condition(X64Cond cond, u32 target);
+
+    // Jumps to `label` if `value` is truthy (or falsy, if `truthy` is false).
+    void jump_if(X64Reg value, bool truthy, X64Label& label);
+
+    // Unconditionally jumps from the instruction at `pc` to `target`.
+    // Backward jumps return to the interpreter when the iteration budget is exhausted.
+    // The interpreter executes the jump instead, which is a safepoint.
+    void jump(u32 pc, u32 target);
+
+    // Returns a label that exits the machine code and continues with the interpreter at `pc`.
+    X64Label& exit(u32 pc);
+
+    // Returns from the machine code, the interpreter continues at `pc`.
+    void emit_exit(u32 pc);
+
+    u32 operand(u32 pc, u32 index) const;
+    i64 operand_i64(u32 pc, u32 index) const;
+    X64Label& label(u32 target);
+
+    static X64Mem local(u32 index);
+    static X64Mem param(u32 index);
+    static X64Mem false_value();
+    static X64Mem true_value();
+    static X64Mem backedges();
+
+private:
+    Span<const CodeWord> code_;
+    X64Assembler as_;
+    std::vector<X64Label> labels_; // Labels for every instruction start
+    std::vector<X64Label> exits_;  // Exit labels (if used)
+    std::vector<u32> exit_pcs_;    // Instructions with used exit labels
+    std::vector<u32> entries_;
+};
+
+} // namespace
+
+static BytecodeOp instruction_op(CodeWord op) {
+    if (valid_quick_op(op))
+        return generic_op(static_cast<QuickOp>(op));
+    return static_cast<BytecodeOp>(op);
+}
+
+static u32 instruction_words(BytecodeOp op) {
+    u32 words = 1;
+    for (auto operand : operands(op))
+        words += operand_size(operand) / sizeof(CodeWord);
+    if (has_inline_cache(op))
+        words += 1;
+    return words;
+}
+
+std::unique_ptr<JitFunction> FunctionJitCompiler::compile() {
+    // Machine code is entered by jumping to the requested instruction.
+    as_.jmp(target_reg);
+
+    for (u32 pc = 0, size = code_.size(); pc < size;) {
+        const BytecodeOp op = instruction_op(code_[pc]);
+        as_.bind(labels_[pc]);
+
+        const u32 start = as_.pos();
+        if (compile_instruction(op, pc)) {
+            entries_[pc] = start;
+        } else {
+            emit_exit(pc);
+        }
+        pc += instruction_words(op);
+    }
+
+    // Slow paths of the compiled instructions.
+    for (u32 pc : exit_pcs_) {
+        as_.bind(exits_[pc]);
+        emit_exit(pc);
+    }
+
+    auto memory = CodeMemory::make(as_.code());
+    return std::make_unique<JitFunction>(std::move(memory), std::move(entries_));
+}
+
+bool FunctionJitCompiler::compile_instruction(BytecodeOp op, u32 pc) {
+    constexpr X64Reg rax = X64Reg::RAX;
+    constexpr X64Reg r8 = X64Reg::R8;
+    constexpr X64Reg r9 = X64Reg::R9;
+
+    switch (op) {
+    case BytecodeOp::LoadNull:
+        as_.mov(local(operand(pc, 0)), 0);
+        return true;
+    case BytecodeOp::LoadFalse:
+    case BytecodeOp::LoadTrue:
+        as_.mov(rax, op == BytecodeOp::LoadTrue ? true_value() : false_value());
+        as_.mov(local(operand(pc, 0)), rax);
+        return true;
+    case BytecodeOp::LoadInt: {
+        // Large integers must be allocated on the heap.
+        const i64 value = operand_i64(pc, 0);
+        if (!SmallInteger::fits(value))
+            return false;
+
+        as_.mov(rax, static_cast<u64>(SmallInteger::make(value).raw()));
+        as_.mov(local(operand(pc, 2)), rax);
+        return true;
+    }
+    case BytecodeOp::LoadParam:
+        as_.mov(rax, param(operand(pc, 0)));
+        as_.mov(local(operand(pc, 1)), rax);
+        return true;
+    case BytecodeOp::StoreParam:
+        as_.mov(rax, local(operand(pc, 0)));
+        as_.mov(param(operand(pc, 1)), rax);
+        return true;
+    case BytecodeOp::Copy:
+        as_.mov(rax, local(operand(pc, 0)));
+        as_.mov(local(operand(pc, 1)), rax);
+        return true;
+    case BytecodeOp::Swap:
+        as_.mov(rax, local(operand(pc, 0)));
+        as_.mov(r8, local(operand(pc, 1)));
+        as_.mov(local(operand(pc, 0)), r8);
+        as_.mov(local(operand(pc, 1)), rax);
+        return true;
+
+    // Small integers are encoded as `2 * v + 1`. The generated code works directly on the encoded
+    // values, overflow of the encoded result is equivalent to overflow of the small integer range.
+    case BytecodeOp::Add:
+    case BytecodeOp::Sub:
+    case BytecodeOp::Mul: {
+        as_.mov(rax, local(operand(pc, 0)));
+        as_.mov(r8, local(operand(pc, 1)));
+        guard_small_ints(rax, r8, pc);
+        switch (op) {
+        case BytecodeOp::Add:
+            as_.sub(rax, 1);
+            as_.add(rax, r8);
+            as_.jcc(X64Cond::Overflow, exit(pc));
+            break;
+        case BytecodeOp::Sub:
+            as_.sub(rax, r8);
+            as_.jcc(X64Cond::Overflow, exit(pc));
+            as_.or_(rax, 1);
+            break;
+        case BytecodeOp::Mul:
+            as_.sar1(r8);
+            as_.sub(rax, 1);
+            as_.imul(rax, r8);
+            as_.jcc(X64Cond::Overflow, exit(pc));
+            as_.or_(rax, 1);
+            break;
+        default:
+            TIRO_UNREACHABLE("unexpected arithmetic instruction");
+        }
+        as_.mov(local(operand(pc, 2)), rax);
+        return true;
+    }
+
+    // The encoding of small integers preserves their order.
+    case BytecodeOp::Gt:
+    case BytecodeOp::Gte:
+    case BytecodeOp::Lt:
+    case BytecodeOp::Lte:
+    case BytecodeOp::Eq:
+    case BytecodeOp::NEq: {
+        X64Cond cond;
+        switch (op) {
+        case BytecodeOp::Gt:
+            cond = X64Cond::Greater;
+            break;
+        case BytecodeOp::Gte:
+            cond = X64Cond::GreaterEqual;
+            break;
+        case BytecodeOp::Lt:
+            cond = X64Cond::Less;
+            break;
+        case BytecodeOp::Lte:
+            cond = X64Cond::LessEqual;
+            break;
+        case BytecodeOp::Eq:
+            cond = X64Cond::Equal;
+            break;
+        case BytecodeOp::NEq:
+            cond = X64Cond::NotEqual;
+            break;
+        default:
+            TIRO_UNREACHABLE("unexpected comparison instruction");
+        }
+
+        as_.mov(rax, local(operand(pc, 0)));
+        as_.mov(r8, local(operand(pc, 1)));
+        guard_small_ints(rax, r8, pc);
+        as_.cmp(rax, r8);
+        store_condition(cond, operand(pc, 2));
+        return true;
+    }
+    case BytecodeOp::LNot: {
+        X64Label done;
+        as_.mov(r9, true_value());
+        as_.mov(rax, local(operand(pc, 0)));
+        jump_if(rax, false, done);
+        as_.mov(r9, false_value());
+        as_.bind(done);
+        as_.mov(local(operand(pc, 1)), r9);
+        return true;
+    }
+    case BytecodeOp::Jmp:
+        jump(pc, operand(pc, 0));
+        return true;
+    case BytecodeOp::JmpTrue:
+    case BytecodeOp::JmpFalse:
+    case BytecodeOp::JmpNull:
+    case BytecodeOp::JmpNotNull: {
+        const u32 target = operand(pc, 1);
+
+        // Backward jumps must pass through jump() when they are taken, forward jumps
+        // branch to their target directly.
+        X64Label backedge;
+        X64Label& taken = target <= pc ? backedge : label(target);
+
+        as_.mov(rax, local(operand(pc, 0)));
+        if (op == BytecodeOp::JmpTrue || op == BytecodeOp::JmpFalse) {
+            jump_if(rax, op == BytecodeOp::JmpTrue, taken);
+        } else {
+            as_.test(rax, rax);
+            as_.jcc(op == BytecodeOp::JmpNull ? X64Cond::Equal : X64Cond::NotEqual, taken);
+        }
+
+        if (target <= pc) {
+            X64Label done;
+            as_.jmp(done);
+            as_.bind(backedge);
+            jump(pc, target);
+            as_.bind(done);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void FunctionJitCompiler::guard_small_ints(X64Reg lhs, X64Reg rhs, u32 pc) {
+    as_.test8(lhs, static_cast<u8>(Value::embedded_integer_flag));
+    as_.jcc(X64Cond::Equal, exit(pc));
+    as_.test8(rhs, static_cast<u8>(Value::embedded_integer_flag));
+    as_.jcc(X64Cond::Equal, exit(pc));
+}
+
+void FunctionJitCompiler::store_condition(X64Cond cond, u32 target) {
+    // Moves do not modify the flags.
+    as_.mov(X64Reg::R9, false_value());
+    as_.cmov(cond, X64Reg::R9, true_value());
+    as_.mov(local(target), X64Reg::R9);
+}
+
+void FunctionJitCompiler::jump_if(X64Reg value, bool truthy, X64Label& target) {
+    // Only null and false are falsy.
+    as_.test(value, value);
+    if (truthy) {
+        X64Label falsy;
+        as_.jcc(X64Cond::Equal, falsy);
+        as_.cmp(value, false_value());
+        as_.jcc(X64Cond::NotEqual, target);
+        as_.bind(falsy);
+    } else {
+        as_.jcc(X64Cond::Equal, target);
+        as_.cmp(value, false_value());
+        as_.jcc(X64Cond::Equal, target);
+    }
+}
+
+void FunctionJitCompiler::jump(u32 pc, u32 target) {
+    if (target <= pc) {
+        as_.sub(backedges(), 1);
+        as_.jcc(X64Cond::Equal, exit(pc));
+    }
+    as_.jmp(label(target));
+}
+
+X64Label& FunctionJitCompiler::exit(u32 pc) {
+    TIRO_DEBUG_ASSERT(pc < exits_.size(), "instruction offset out of bounds");
+    X64Label& label = exits_[pc];
+    if (exit_pcs_.empty() || exit_pcs_.back() != pc)
+        exit_pcs_.push_back(pc);
+    return label;
+}
+
+void FunctionJitCompiler::emit_exit(u32 pc) {
+    as_.mov_eax(pc);
+    as_.ret();
+}
+
+u32 FunctionJitCompiler::operand(u32 pc, u32 index) const {
+    TIRO_DEBUG_ASSERT(pc + 1 + index < code_.size(), "operand out of bounds");
+    return code_[pc + 1 + index];
+}
+
+i64 FunctionJitCompiler::operand_i64(u32 pc, u32 index) const {
+    // 64 bit operands occupy two consecutive words in native byte order.
+    CodeWord words[2] = {operand(pc, index), operand(pc, index + 1)};
+    i64 value;
+    std::memcpy(&value, words, sizeof(value));
+    return value;
+}
+
+X64Label& FunctionJitCompiler::label(u32 target) {
+    TIRO_CHECK(target < labels_.size(), "jump destination out of bounds");
+    return labels_[target];
+}
+
+X64Mem FunctionJitCompiler::local(u32 index) {
+    TIRO_CHECK(index < (u32(1) << 24), "local index out of range");
+    return X64Mem{locals_reg, static_cast<i32>(index * sizeof(Value))};
+}
+
+X64Mem FunctionJitCompiler::param(u32 index) {
+    TIRO_CHECK(index < (u32(1) << 24), "parameter index out of range");
+    return X64Mem{args_reg, static_cast<i32>(index * sizeof(Value))};
+}
+
+X64Mem FunctionJitCompiler::false_value() {
+    return X64Mem{state_reg, static_cast<i32>(offsetof(JitState, false_value))};
+}
+
+X64Mem FunctionJitCompiler::true_value() {
+    return X64Mem{state_reg, static_cast<i32>(offsetof(JitState, true_value))};
+}
+
+X64Mem FunctionJitCompiler::backedges() {
+    return X64Mem{state_reg, static_cast<i32>(offsetof(JitState, backedges))};
+}
+
+JitFunction::JitFunction(CodeMemory code, std::vector<u32> entries)
+    : code_(std::move(code))
+    , entries_(std::move(entries)) {}
+
+u32 JitFunction::run(Value* locals, Value* args, JitState* state, u32 pc) const {
+    TIRO_DEBUG_ASSERT(has_entry(pc), "invalid entry point");
+    auto entry = reinterpret_cast<Entry>(reinterpret_cast<uintptr_t>(code_.data()));
+    return entry(locals, args, state, code_.data() + entries_[pc]);
+}
+
+Jit::Jit(u32 threshold)
+    : threshold_(threshold) {
+    if (std::getenv("TIRO_PERF_MAP")) {
+        auto path = fmt::format("/tmp/perf-{}.map", ::getpid());
+        perf_map_ = std::fopen(path.c_str(), "a");
+    }
+}
+
+Jit::~Jit() {
+    if (perf_map_)
+        std::fclose(perf_map_);
+}
+
+JitFunction* Jit::compile(CodeFunctionTemplate tmpl) {
+    TIRO_DEBUG_ASSERT(!tmpl.jit(), "function was already compiled");
+
+    FunctionJitCompiler compiler(tmpl.code().view());
+    auto func = compiler.compile();
+    if (perf_map_)
+        write_perf_map(tmpl, *func);
+
+    JitFunction* result = func.get();
+    tmpl.jit(std::move(func));
+    return result;
+}
+
+u32 Jit::run(Context& ctx, const JitFunction& func, CodeFrame* frame, u32 pc) {
+    // Refreshed on every entry because the machine code must not embed heap addresses.
+    state_.false_value = ctx.get_boolean(false);
+    state_.true_value = ctx.get_boolean(true);
+    state_.backedges = loop_iterations;
+
+    auto locals = CoroutineStack::locals(TIRO_NN(frame)).data();
+    auto args = CoroutineStack::args(TIRO_NN(frame)).data();
+    return func.run(locals, args, &state_, pc);
+}
+
+void Jit::write_perf_map(CodeFunctionTemplate tmpl, const JitFunction& func) {
+    const auto& code = func.code();
+    fmt::print(perf_map_, "{:x} {:x} tiro:{}.{}\n", reinterpret_cast<uintptr_t>(code.data()),
+        code.size(), tmpl.module().name().view(), tmpl.name().view());
+    std::fflush(perf_map_);
+}
+
+} // namespace tiro::vm
@@ -0,0 +1,119 @@
+#ifndef TIRO_VM_JIT_JIT_HPP
+#define TIRO_VM_JIT_JIT_HPP
+
+#include "common/defs.hpp"
+#include "vm/fwd.hpp"
+#include "vm/jit/code_memory.hpp"
+#include "vm/jit/fwd.hpp"
+#include "vm/objects/function.hpp"
+#include "vm/objects/value.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace tiro::vm {
+
+/// Runtime data passed to the machine code (see `JitFunction::Entry`).
+struct JitState {
+    // Heap values cannot be embedded into the machine code, they are updated before entering compiled code.
+    Value false_value;
+    Value true_value;
+
+    // Remaining number of backward jumps before the machine code returns to the interpreter.
+    // Returning regularly allows the interpreter to run its safepoints (e.g. for preemption) during long loops.
+    u64 backedges = 0;
+};
+
+/// Machine code generated for a single function template (see `Jit`).
+class JitFunction final {
+public:
+    /// Signature of the generated code. Execution starts at `target`, which must be one of the
+    /// function's entry points. Returns the offset of the first instruction that must be executed
+    /// by the interpreter.
+    using Entry = u32 (*)(Value* locals, Value* args, JitState* state, const void* target);
+
+    JitFunction(CodeMemory code, std::vector<u32> entries);
+
+    /// Returns true if the machine code can be entered at the instruction with the given offset.
+    bool has_entry(u32 pc) const { return pc < entries_.size() && entries_[pc] != no_entry; }
+
+    /// Executes the machine code, starting with the instruction at `pc`. Returns the offset
+    /// of the first instruction that must be executed by the interpreter.
+    /// `locals` and `args` point to the current frame's locals and arguments.
+    ///
+    /// \pre `has_entry(pc)`.
+    u32 run(Value* locals, Value* args, JitState* state, u32 pc) const;
+
+    /// The generated machine code.
+    const CodeMemory& code() const { return code_; }
+
+    static constexpr u32 no_entry = u32(-1);
+
+private:
+    CodeMemory code_;
+
+    // Maps instruction offsets to offsets in the machine code (or no_entry).
+    std::vector<u32> entries_;
+};
+
+/// A baseline JIT compiler for bytecode functions (x86-64 only, enabled with `TIRO_JIT`).
+///
+/// The interpreter counts calls and loop iterations of every function template (see
+/// `CodeFunctionTemplate::add_hotness()`). When a function becomes hot, the JIT translates its
+/// instructions into machine code, one template per instruction.
+///
+/// Only simple instructions are translated: constants, copies, parameter access, jumps and
+/// arithmetic or comparisons on small integers. All other instructions (and the slow paths of
+/// the translated instructions, e.g. operands of unexpected types or integer overflow) exit
+/// the machine code and resume execution in the interpreter at the current instruction.
+/// The interpreter enters the machine code again on the next call or loop iteration.
+///
+/// Because the generated code never allocates, calls, suspends or throws, all interactions with
+/// the rest of the runtime (exceptions, coroutines, garbage collection) are still handled by the interpreter.
+/// The machine code only reads and writes the values of the current frame, which live in the coroutine stack.
+/// Loops in compiled code return to the interpreter after a fixed number of iterations (`loop_iterations`),
+/// so that the interpreter's safepoints still run regularly.
+///
+/// Set the environment variable `TIRO_PERF_MAP` to write `/tmp/perf-<pid>.map`,
+/// which allows `perf` to symbolize generated functions.
+class Jit final {
+public:
+    /// The number of calls and loop iterations after which a function is compiled.
+    static constexpr u32 default_threshold = 1000;
+
+    /// The number of backward jumps executed by the machine code before it returns to the interpreter.
+    static constexpr u64 loop_iterations = 128;
+
+    explicit Jit(u32 threshold);
+    ~Jit();
+
+    Jit(const Jit&) = delete;
+    Jit& operator=(const Jit&) = delete;
+
+    /// The hotness value after which a function is compiled.
+    u32 threshold() const { return threshold_; }
+
+    /// Compiles the given function template and attaches the result to it.
+    /// Returns the new machine code, which is owned by the template (see `CodeFunctionTemplate::jit()`).
+    JitFunction* compile(CodeFunctionTemplate tmpl);
+
+    /// Executes the machine code for the given frame (see JitFunction::run).
+    u32 run(Context& ctx, const JitFunction& func, CodeFrame* frame, u32 pc);
+
+private:
+    void write_perf_map(CodeFunctionTemplate tmpl, const JitFunction& func);
+
+private:
+    u32 threshold_;
+
+    // Passed to the machine code, updated before entering compiled code.
+    JitState state_;
+
+    // Output file for perf symbols, or null.
+    std::FILE* perf_map_ = nullptr;
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_JIT_JIT_HPP
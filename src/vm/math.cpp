@@ -205,8 +205,10 @@ static void unwrap_number(Value v, Callback&& cb) {
         return cb(v.must_cast<SmallInteger>().value());
     case ValueType::HeapInteger:
         return cb(v.must_cast<HeapInteger>().value());
-    case ValueType::Float:
-        return cb(v.must_cast<Float>().value());
+    case ValueType::HeapFloat:
+        return cb(v.must_cast<HeapFloat>().value());
+    case ValueType::SmallFloat:
+        return cb(v.must_cast<SmallFloat>().value());
     default:
         break;
     }
@@ -4,6 +4,7 @@
 #include "vm/context.hpp"
 #include "vm/handles/scope.hpp"
 #include "vm/math.hpp"
+#include "vm/modules/translate.hpp"
 #include "vm/modules/verify.hpp"
 #include "vm/objects/all.hpp"
 
@@ -139,14 +140,10 @@ Value ModuleLoader::visit_function(const BytecodeMember::Function& f) {
         name = ctx_.get_interned_string("<UNNAMED>");
     }
 
-    absl::InlinedVector<HandlerTable::Entry, 8> handlers;
-    handlers.reserve(func.handlers().size());
-    for (const auto& handler : func.handlers()) {
-        handlers.push_back({handler.from.value(), handler.to.value(), handler.target.value()});
-    }
-
-    Local tmpl = sc.local(CodeFunctionTemplate::make(
-        ctx_, name, module_, func.params(), func.locals(), handlers, func.code()));
+    auto translated = translate_function(func);
+    Local tmpl = sc.local(CodeFunctionTemplate::make(ctx_, name, module_, func.params(),
+        func.locals(), translated.handlers, translated.lines, translated.code,
+        translated.cache_sites));
 
     switch (func.type()) {
     case BytecodeFunctionType::Normal:
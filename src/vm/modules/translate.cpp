@@ -0,0 +1,176 @@
+#include "vm/modules/translate.hpp"
+
+#include "bytecode/function.hpp"
+#include "bytecode/op.hpp"
+#include "bytecode/reader.hpp"
+#include "common/memory/binary.hpp"
+
+#include <cstring>
+#include <limits>
+#include <variant>
+
+namespace tiro::vm {
+namespace {
+
+class FunctionTranslator final {
+public:
+    explicit FunctionTranslator(const BytecodeFunction& func);
+
+    TranslatedFunction run();
+
+private:
+    // Computes the word offset of every instruction in the translated stream.
+    void compute_offsets();
+
+    // Emits the translated instructions.
+    void translate_code();
+
+    // Translates the exception handler table.
+    void translate_handlers();
+
+    // Translates the line table.
+    void translate_lines();
+
+    // Maps a byte offset in the original bytecode to a word offset in the translated stream.
+    // The offset must point to the start of an instruction or to the end of the code.
+    u32 map_offset(u32 byte_offset) const;
+
+    void emit_u32(u32 value) { result_.code.push_back(value); }
+    void emit_u64(u64 value);
+
+private:
+    static constexpr u32 invalid_offset = std::numeric_limits<u32>::max();
+
+    const BytecodeFunction& func_;
+
+    // Maps byte offsets to word offsets (or `invalid_offset` if the byte offset does not
+    // point to the start of an instruction). Contains one additional entry for the end of the code.
+    std::vector<u32> offsets_;
+
+    TranslatedFunction result_;
+};
+
+} // namespace
+
+FunctionTranslator::FunctionTranslator(const BytecodeFunction& func)
+    : func_(func) {}
+
+TranslatedFunction FunctionTranslator::run() {
+    compute_offsets();
+    translate_code();
+    translate_handlers();
+    translate_lines();
+    return std::move(result_);
+}
+
+void FunctionTranslator::compute_offsets() {
+    auto code = func_.code();
+    TIRO_CHECK(code.size() < invalid_offset, "bytecode too long");
+
+    offsets_.assign(code.size() + 1, invalid_offset);
+
+    size_t words = 0;
+    BytecodeReader reader(code);
+    while (reader.remaining() > 0) {
+        const size_t pos = reader.pos();
+        auto decoded = reader.read();
+        if (auto error = std::get_if<BytecodeReaderError>(&decoded))
+            TIRO_ERROR("invalid bytecode: {}", message(*error));
+
+        offsets_[pos] = static_cast<u32>(words);
+
+        words += 1;
+        for (auto operand : operands(std::get<BytecodeInstr>(decoded).type()))
+            words += operand_size(operand) / sizeof(CodeWord);
+        if (has_inline_cache(std::get<BytecodeInstr>(decoded).type()))
+            words += 1;
+        TIRO_CHECK(words < invalid_offset, "translated code too long");
+    }
+    offsets_[code.size()] = static_cast<u32>(words);
+    result_.code.reserve(words);
+}
+
+void FunctionTranslator::translate_code() {
+    CheckedBinaryReader reader(func_.code());
+    while (reader.remaining() > 0) {
+        const auto op = static_cast<BytecodeOp>(reader.read_u8());
+        TIRO_DEBUG_ASSERT(result_.code.size() == offsets_[reader.pos() - 1],
+            "instruction offset must match the precomputed value");
+
+        emit_u32(static_cast<u32>(op));
+        for (auto operand : operands(op)) {
+            switch (operand) {
+            case BytecodeOperand::Local:
+            case BytecodeOperand::Param:
+            case BytecodeOperand::Module:
+            case BytecodeOperand::U32:
+                emit_u32(reader.read_u32());
+                break;
+            case BytecodeOperand::Offset:
+                emit_u32(map_offset(reader.read_u32()));
+                break;
+            case BytecodeOperand::I64:
+            case BytecodeOperand::F64:
+                emit_u64(reader.read_u64());
+                break;
+            }
+        }
+
+        if (has_inline_cache(op)) {
+            TIRO_CHECK(result_.cache_sites < invalid_offset, "too many inline cache sites");
+            emit_u32(result_.cache_sites++);
+        }
+    }
+}
+
+void FunctionTranslator::translate_handlers() {
+    const auto& handlers = func_.handlers();
+    result_.handlers.reserve(handlers.size());
+    for (const auto& handler : handlers) {
+        result_.handlers.push_back({map_offset(handler.from.value()),
+            map_offset(handler.to.value()), map_offset(handler.target.value())});
+    }
+}
+
+void FunctionTranslator::translate_lines() {
+    const auto& lines = func_.lines();
+    result_.lines.reserve(lines.size());
+    for (const auto& entry : lines)
+        result_.lines.push_back({map_offset(entry.start.value()), entry.line});
+}
+
+u32 FunctionTranslator::map_offset(u32 byte_offset) const {
+    TIRO_CHECK(byte_offset < offsets_.size(), "offset out of bounds");
+
+    const u32 word_offset = offsets_[byte_offset];
+    TIRO_CHECK(word_offset != invalid_offset, "offset does not point to an instruction");
+    return word_offset;
+}
+
+void FunctionTranslator::emit_u64(u64 value) {
+    // 64 bit operands occupy two consecutive words in native byte order.
+    // The interpreter reassembles them with a single (possibly unaligned) 8 byte read.
+    static_assert(sizeof(u64) == 2 * sizeof(CodeWord));
+    CodeWord words[2];
+    std::memcpy(words, &value, sizeof(value));
+    emit_u32(words[0]);
+    emit_u32(words[1]);
+}
+
+TranslatedFunction translate_function(const BytecodeFunction& func) {
+    FunctionTranslator translator(func);
+    return translator.run();
+}
+
+bool has_inline_cache(BytecodeOp op) {
+    switch (op) {
+    case BytecodeOp::LoadMember:
+    case BytecodeOp::StoreMember:
+    case BytecodeOp::LoadMethod:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace tiro::vm
@@ -0,0 +1,50 @@
+#ifndef TIRO_VM_MODULES_TRANSLATE_HPP
+#define TIRO_VM_MODULES_TRANSLATE_HPP
+
+#include "bytecode/fwd.hpp"
+#include "vm/fwd.hpp"
+#include "vm/objects/function.hpp"
+
+#include <vector>
+
+namespace tiro::vm {
+
+/// The executable representation of a function's bytecode. See `translate_function()`.
+struct TranslatedFunction {
+    /// The translated instruction stream.
+    std::vector<CodeWord> code;
+
+    /// The function's exception handlers, with offsets relative to the translated instruction stream.
+    std::vector<HandlerTable::Entry> handlers;
+
+    /// The function's line table, with offsets relative to the translated instruction stream.
+    std::vector<LineTable::Entry> lines;
+
+    /// The number of instructions that use an inline cache.
+    u32 cache_sites = 0;
+};
+
+/// Translates the bytecode of the given function into the format executed by the interpreter.
+///
+/// Serialized bytecode is compact and portable: opcodes are single bytes and operands are stored as
+/// unaligned big endian integers. The interpreter instead executes a stream of aligned,
+/// native endian code words: every instruction starts with its opcode word, followed by one word
+/// for every 32 bit operand and two words for every 64 bit operand.
+/// Jump destinations, exception handler and line table offsets are rewritten to word offsets
+/// within the translated stream.
+///
+/// Instructions that use an inline cache (see `has_inline_cache()`) are followed by an additional
+/// word that contains the index of their cache site within the function.
+///
+/// The instruction set itself is unchanged, the decoding of operands (see `operands()`) is
+/// simply moved from execution time to load time.
+///
+/// \pre `func` must have passed verification (see `verify_module()`).
+TranslatedFunction translate_function(const BytecodeFunction& func);
+
+/// Returns true if the translated instruction carries an additional inline cache site operand.
+bool has_inline_cache(BytecodeOp op);
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_MODULES_TRANSLATE_HPP
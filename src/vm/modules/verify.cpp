@@ -143,6 +143,8 @@ private:
         void visit_call(const BytecodeInstr::Call& call);
         void visit_load_method(const BytecodeInstr::LoadMethod& load_method);
         void visit_call_method(const BytecodeInstr::CallMethod& call_method);
+        void visit_tail_call(const BytecodeInstr::TailCall& tail_call);
+        void visit_tail_call_method(const BytecodeInstr::TailCallMethod& tail_call_method);
         void visit_return(const BytecodeInstr::Return& ret);
         void visit_rethrow(const BytecodeInstr::Rethrow& rethrow);
         void visit_assert_fail(const BytecodeInstr::AssertFail& assert_fail);
@@ -387,6 +389,33 @@ void FunctionVerifier::verify() {
                 fail("invalid exception handler target instruction");
         }
     }
+
+    // Verify line table offsets
+    {
+        const auto& lines = function_.lines();
+        for (size_t i = 0, size = lines.size(); i < size; ++i) {
+            auto& current = lines[i];
+            if (!current.start || !is_instruction_start(current.start))
+                fail("invalid line table start instruction");
+            if (i > 0 && current.start.value() <= lines[i - 1].start.value())
+                fail("line table entries must be ordered");
+        }
+    }
+
+    // Tail calls discard the current frame, the frame's exception handlers would never run.
+    {
+        const auto& handlers = function_.handlers();
+        for (const auto& entry : insts) {
+            auto type = entry.ins.type();
+            if (type != BytecodeOp::TailCall && type != BytecodeOp::TailCallMethod)
+                continue;
+
+            for (const auto& handler : handlers) {
+                if (entry.offset >= handler.from.value() && entry.offset < handler.to.value())
+                    fail("tail calls must not be covered by an exception handler");
+            }
+        }
+    }
 }
 
 std::vector<FunctionVerifier::InsEntry> FunctionVerifier::read_instructions() {
@@ -817,6 +846,15 @@ void FunctionVerifier::InstructionVisitor::visit_call_method(
     self.check(call_method.method);
 }
 
+void FunctionVerifier::InstructionVisitor::visit_tail_call(const BytecodeInstr::TailCall& tail_call) {
+    self.check(tail_call.function);
+}
+
+void FunctionVerifier::InstructionVisitor::visit_tail_call_method(
+    const BytecodeInstr::TailCallMethod& tail_call_method) {
+    self.check(tail_call_method.method);
+}
+
 void FunctionVerifier::InstructionVisitor::visit_return(const BytecodeInstr::Return& ret) {
     self.check(ret.value);
 }
@@ -309,6 +309,13 @@ public:
 
     void clear_dynamic_slots() { count_ = 0; }
 
+    /// Updates the capacity after the object's storage has been resized by the heap
+    /// (see `Heap::resize_large_object()`).
+    void set_dynamic_slot_capacity(size_t capacity) {
+        TIRO_DEBUG_ASSERT(capacity >= count_, "Capacity must not be less than the slot count.");
+        capacity_ = capacity;
+    }
+
 private:
     size_t count_;
     size_t capacity_;
@@ -21,5 +21,6 @@
 #include "vm/objects/tuple.hpp"
 #include "vm/objects/types.hpp"
 #include "vm/objects/value.hpp"
+#include "vm/objects/weak_map.hpp"
 
 #endif // TIRO_VM_OBJECTS_ALL_HPP
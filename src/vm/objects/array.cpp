@@ -85,15 +85,25 @@ bool Array::try_append(Context& ctx, Handle<Value> value) {
     }
 
     // Slow path: must resize.
-    Scope sc(ctx);
-    Local storage = sc.local(get_storage());
-
     size_t new_capacity;
     if (TIRO_UNLIKELY(!checked_add(current_capacity, size_t(1), new_capacity))) {
         return false;
     }
     new_capacity = next_capacity(new_capacity);
 
+    // Large storage objects can be grown without copying if the heap supports it.
+    // The storage is only referenced by this array, so it may be moved.
+    if (auto storage = get_storage(); storage.has_value()) {
+        auto grown = ArrayStorage::try_grow(ctx, storage.value(), new_capacity);
+        if (grown.has_value()) {
+            grown.value().append(*value);
+            set_storage(grown);
+            return true;
+        }
+    }
+
+    Scope sc(ctx);
+    Local storage = sc.local(get_storage());
     Local new_storage = sc.local(ArrayStorage::make(ctx, new_capacity));
     if (storage->has_value()) {
         new_storage->append_all(storage->value().values());
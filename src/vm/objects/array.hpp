@@ -77,6 +77,7 @@ private:
     }
 
     void set_storage(Nullable<ArrayStorage> new_storage) {
+        write_barrier(new_storage);
         layout()->write_static_slot(StorageSlot, new_storage);
     }
 
@@ -22,6 +22,21 @@ Derived ArrayStorageBase<T, Derived>::make(Context& ctx, size_t capacity) {
     return Derived(from_heap(data));
 }
 
+template<typename T, typename Derived>
+Nullable<Derived>
+ArrayStorageBase<T, Derived>::try_grow(Context& ctx, Derived storage, size_t capacity) {
+    TIRO_DEBUG_ASSERT(capacity >= storage.capacity(), "try_grow(): capacity must not shrink.");
+
+    Header* object = ctx.heap().resize_large_object(
+        storage.heap_ptr(), LayoutTraits<Layout>::dynamic_alloc_size(capacity), true);
+    if (!object)
+        return {};
+
+    auto data = static_cast<Layout*>(object);
+    data->set_dynamic_slot_capacity(capacity);
+    return Derived(from_heap(data));
+}
+
 template class ArrayStorageBase<Value, ArrayStorage>;
 template class ArrayStorageBase<HashTableEntry, HashTableStorage>;
 
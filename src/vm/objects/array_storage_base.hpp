@@ -6,6 +6,7 @@
 #include "vm/handles/handle.hpp"
 #include "vm/handles/span.hpp"
 #include "vm/object_support/layout.hpp"
+#include "vm/objects/nullable.hpp"
 #include "vm/objects/value.hpp"
 
 namespace tiro::vm {
@@ -23,6 +24,12 @@ public:
 
     static Derived make(Context& ctx, size_t capacity);
 
+    /// Attempts to increase the capacity of a large storage object without copying its values
+    /// (see `Heap::resize_large_object()`). The storage may be moved to a new address, so it must not be
+    /// referenced by anything but its owner, which must be updated to point to the returned storage.
+    /// Returns null if the storage cannot be resized. Never triggers a garbage collection.
+    static Nullable<Derived> try_grow(Context& ctx, Derived storage, size_t capacity);
+
     explicit ArrayStorageBase(Value v);
 
     size_t size() { return layout()->dynamic_slot_count(); }
@@ -47,6 +54,7 @@ public:
 
     void set(size_t index, T value) {
         TIRO_DEBUG_ASSERT(index < size(), "ArrayStorageBase::set(): index out of bounds.");
+        barrier(value);
         *layout()->dynamic_slot(index) = value;
     }
 
@@ -54,6 +62,7 @@ public:
         TIRO_DEBUG_ASSERT(
             size() < capacity(), "ArrayStorageBase::append(): no free capacity remaining.");
 
+        barrier(value);
         Layout* data = layout();
         data->add_dynamic_slot(value);
     }
@@ -62,6 +71,8 @@ public:
         TIRO_DEBUG_ASSERT(values.size() <= capacity() - size(),
             "ArrayStorageBase::append_all(): not enough capacity remaining.");
 
+        if (!values.empty())
+            write_barrier();
         Layout* data = layout();
         data->add_dynamic_slots(values);
     }
@@ -81,6 +92,18 @@ public:
     }
 
     Layout* layout() const { return HeapValue::access_heap<Layout>(); }
+
+private:
+    void barrier(const T& value) {
+        if constexpr (std::is_same_v<T, Value>) {
+            write_barrier(value);
+        } else {
+            // Only the references of the stored entry must be recorded. Rescanning the whole storage
+            // would make every write into a marked storage as expensive as tracing it again.
+            write_barrier(value.key());
+            write_barrier(value.value());
+        }
+    }
 };
 
 extern template class ArrayStorageBase<Value, ArrayStorage>;
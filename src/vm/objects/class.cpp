@@ -27,6 +27,7 @@ InternalType InternalType::make_root(Context& ctx) {
         ctx.heap(), nullptr, StaticSlotsInit(), StaticPayloadInit());
     data->type(data);
     data->static_payload()->builtin_type = ValueType::InternalType;
+    data->static_payload()->heap = &ctx.heap();
     return InternalType(from_heap(data));
 }
 
@@ -36,6 +37,7 @@ InternalType InternalType::make(Context& ctx, ValueType builtin_type) {
 
     Layout* data = create_object<InternalType>(ctx, StaticSlotsInit(), StaticPayloadInit());
     data->static_payload()->builtin_type = builtin_type;
+    data->static_payload()->heap = &ctx.heap();
     return InternalType(from_heap(data));
 }
 
@@ -43,11 +45,16 @@ ValueType InternalType::builtin_type() {
     return layout()->static_payload()->builtin_type;
 }
 
+Heap& InternalType::heap() {
+    return *layout()->static_payload()->heap;
+}
+
 Nullable<Type> InternalType::public_type() {
     return layout()->read_static_slot<Nullable<Type>>(PublicTypeSlot);
 }
 
 void InternalType::public_type(MaybeHandle<Type> type) {
+    write_barrier(*type.to_nullable());
     layout()->write_static_slot(PublicTypeSlot, type.to_nullable());
 }
 
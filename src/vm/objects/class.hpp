@@ -49,6 +49,7 @@ private:
 
     struct Payload {
         ValueType builtin_type;
+        Heap* heap;
     };
 
 public:
@@ -67,6 +68,10 @@ public:
     /// Returns the kind of builtin object instances represented by this type instance.
     ValueType builtin_type();
 
+    /// Returns the heap that contains this type and all instances of it.
+    /// Used by the write barrier to find the heap of an object.
+    Heap& heap();
+
     /// The public type represents this type to calling code.
     Nullable<Type> public_type();
     void public_type(MaybeHandle<Type> type);
@@ -67,6 +67,7 @@ Nullable<CoroutineStack> Coroutine::stack() {
 }
 
 void Coroutine::stack(Nullable<CoroutineStack> stack) {
+    write_barrier(stack);
     layout()->write_static_slot(StackSlot, stack);
 }
 
@@ -75,6 +76,7 @@ Nullable<Result> Coroutine::result() {
 }
 
 void Coroutine::result(Nullable<Result> result) {
+    write_barrier(result);
     layout()->write_static_slot(ResultSlot, result);
 }
 
@@ -101,6 +103,7 @@ Nullable<NativeObject> Coroutine::native_callback() {
 }
 
 void Coroutine::native_callback(Nullable<NativeObject> callback) {
+    write_barrier(callback);
     layout()->write_static_slot(NativeCallbackSlot, callback);
 }
 
@@ -117,6 +120,7 @@ Nullable<Coroutine> Coroutine::next_ready() {
 }
 
 void Coroutine::next_ready(Nullable<Coroutine> next) {
+    write_barrier(next);
     layout()->write_static_slot(NextReadySlot, next);
 }
 
@@ -126,6 +130,7 @@ CoroutineToken Coroutine::create_token(Context& ctx, Handle<Coroutine> coroutine
 
     // Dangling, but following code does not allocate.
     CoroutineToken token = CoroutineToken::make(ctx, coroutine);
+    coroutine->write_barrier(token);
     coroutine->layout()->write_static_slot(CurrentTokenSlot, token);
     return token;
 }
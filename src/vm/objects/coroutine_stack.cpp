@@ -4,6 +4,8 @@
 #include "vm/modules/verify.hpp"
 #include "vm/object_support/factory.hpp"
 
+#include <algorithm>
+
 namespace tiro::vm {
 
 namespace {
@@ -97,6 +99,41 @@ bool CoroutineStack::push_user_frame(
     return push_frame<CodeFrame>(flags, params, locals, tmpl, closure);
 }
 
+bool CoroutineStack::replace_user_frame(
+    CodeFunctionTemplate tmpl, Nullable<Environment> closure, u8 flags) {
+    Layout* data = layout();
+    CoroutineFrame* old_frame = data->top_frame;
+    TIRO_DEBUG_ASSERT(old_frame && old_frame->type == FrameType::Code,
+        "the topmost frame must be a user frame");
+
+    auto pop_count = [](u32 argc, u8 frame_flags) {
+        return argc + ((frame_flags & FRAME_POP_ONE_MORE) ? 1 : 0);
+    };
+
+    const u32 params = tmpl.params();
+    const u32 locals = tmpl.locals();
+    const u32 argc = pop_count(params, flags);
+    TIRO_DEBUG_ASSERT(top_value_count() >= argc, "not enough arguments on the stack");
+    TIRO_DEBUG_ASSERT(locals < max_locals, "too many locals");
+
+    Value* source = values_end(old_frame, data->top) - argc;
+    Value* dest = args_begin(TIRO_NN(old_frame)) - pop_count(0, old_frame->flags);
+    byte* new_top = reinterpret_cast<byte*>(dest + argc);
+    if (sizeof(CodeFrame) + sizeof(Value) * locals > static_cast<size_t>(data->end - new_top))
+        return false;
+
+    // The destination never overlaps the end of the source range, because the old frame
+    // is located between the two.
+    TIRO_DEBUG_ASSERT(dest < source, "invalid argument locations");
+    std::copy(source, source + argc, dest);
+    data->top = new_top;
+    data->top_frame = old_frame->caller();
+
+    [[maybe_unused]] auto frame = push_frame<CodeFrame>(flags, params, locals, tmpl, closure);
+    TIRO_DEBUG_ASSERT(frame, "frame allocation must succeed");
+    return true;
+}
+
 bool CoroutineStack::push_resumable_frame(NativeFunction func, u32 argc, u8 flags) {
     TIRO_DEBUG_ASSERT(top_value_count() >= argc, "not enough arguments on the stack");
     TIRO_DEBUG_ASSERT(argc >= func.params(), "not enough arguments to the call the given function");
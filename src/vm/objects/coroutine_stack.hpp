@@ -112,7 +112,7 @@ struct alignas(Value) CodeFrame : CoroutineFrame {
     Nullable<Exception> current_exception;
 
     // Program counter, points into tmpl->code. FIXME moves
-    const byte* pc = nullptr;
+    const CodeWord* pc = nullptr;
 
     CodeFrame(CodeFunctionTemplate tmpl_, Nullable<Environment> closure_,
         const CoroutineFrameParams& params)
@@ -276,6 +276,14 @@ public:
     /// There must be enough arguments already on the stack to satisfy the function template.
     bool push_user_frame(CodeFunctionTemplate tmpl, Nullable<Environment> closure, u8 flags);
 
+    /// Replaces the topmost call frame (which must be a user frame) with a new call frame for
+    /// the given function template + closure (a tail call). The arguments for the new frame
+    /// (including the unused `this` value if FRAME_POP_ONE_MORE is set) must be on top of the
+    /// value stack. They are moved to the location of the old frame's arguments.
+    /// The new frame has the same caller as the old one.
+    /// Returns false (without modifying the stack) if the new frame does not fit.
+    bool replace_user_frame(CodeFunctionTemplate tmpl, Nullable<Environment> closure, u8 flags);
+
     /// Pushes a new call frame for the given resumable function on the stack.
     /// There must be enough arguments on the stack to satisfy the given resumable function.
     bool push_resumable_frame(NativeFunction func, u32 argc, u8 flags);
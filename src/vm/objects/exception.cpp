@@ -75,6 +75,7 @@ Exception Exception::make_impl(Context& ctx, Handle<String> message, MaybeHandle
 }
 
 void Exception::secondary(Nullable<Array> secondary) {
+    write_barrier(secondary);
     layout()->write_static_slot(SecondarySlot, secondary);
 }
 
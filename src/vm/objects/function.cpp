@@ -1,28 +1,30 @@
 #include "vm/objects/function.hpp"
 
 #include "vm/context.hpp"
+#include "vm/inline_cache.hpp"
 #include "vm/object_support/factory.hpp"
 #include "vm/objects/coroutine.hpp"
 #include "vm/objects/module.hpp"
 #include "vm/objects/native.hpp"
 
 #include <algorithm>
+#include <limits>
 
 // TODO Assertions vs checks
 
 namespace tiro::vm {
 
-Code Code::make(Context& ctx, Span<const byte> code) {
+Code Code::make(Context& ctx, Span<const CodeWord> code) {
     Layout* data = create_object<Code>(
-        ctx, code.size(), BufferInit(code.size(), [&](Span<byte> bytes) {
-            TIRO_DEBUG_ASSERT(bytes.size() == code.size(), "Unexpected allocation size.");
+        ctx, code.size(), BufferInit(code.size(), [&](Span<CodeWord> words) {
+            TIRO_DEBUG_ASSERT(words.size() == code.size(), "Unexpected allocation size.");
             if (code.size() > 0)
-                std::memcpy(bytes.data(), code.data(), code.size());
+                std::memcpy(words.data(), code.data(), code.size_bytes());
         }));
     return Code(from_heap(data));
 }
 
-const byte* Code::data() {
+const CodeWord* Code::data() {
     return layout()->buffer_begin();
 }
 
@@ -30,6 +32,11 @@ size_t Code::size() {
     return layout()->buffer_capacity();
 }
 
+void Code::rewrite(size_t offset, CodeWord word) {
+    TIRO_DEBUG_ASSERT(offset < size(), "code offset out of bounds");
+    layout()->buffer_begin()[offset] = word;
+}
+
 HandlerTable HandlerTable::make(Context& ctx, Span<const Entry> entries) {
     Layout* data = create_object<HandlerTable>(
         ctx, entries.size(), BufferInit(entries.size(), [&](Span<Entry> dest_entries) {
@@ -58,21 +65,60 @@ const HandlerTable::Entry* HandlerTable::find_entry(u32 pc) {
     return pos->from <= pc ? pos : nullptr;
 }
 
-CodeFunctionTemplate
-CodeFunctionTemplate::make(Context& ctx, Handle<String> name, Handle<Module> module, u32 params,
-    u32 locals, Span<const HandlerTable::Entry> handlers, Span<const byte> code) {
+LineTable LineTable::make(Context& ctx, Span<const Entry> entries) {
+    Layout* data = create_object<LineTable>(
+        ctx, entries.size(), BufferInit(entries.size(), [&](Span<Entry> dest_entries) {
+            TIRO_DEBUG_ASSERT(entries.size() == dest_entries.size(), "Unexpected allocation size.");
+            std::uninitialized_copy(entries.begin(), entries.end(), dest_entries.begin());
+        }));
+    return LineTable(from_heap(data));
+}
+
+const LineTable::Entry* LineTable::data() {
+    return layout()->buffer_begin();
+}
+
+size_t LineTable::size() {
+    return layout()->buffer_capacity();
+}
+
+u32 LineTable::find_line(u32 pc) {
+    auto entries = view();
+    auto pos = std::upper_bound(entries.begin(), entries.end(), pc,
+        [&](u32 lhs, const Entry& rhs) { return lhs < rhs.start; });
+    if (pos == entries.begin())
+        return 0;
+    return (pos - 1)->line;
+}
+
+CodeFunctionTemplate CodeFunctionTemplate::make(Context& ctx, Handle<String> name,
+    Handle<Module> module, u32 params, u32 locals, Span<const HandlerTable::Entry> handlers,
+    Span<const LineTable::Entry> lines, Span<const CodeWord> code, u32 cache_sites) {
 
     Scope sc(ctx);
     Local code_obj = sc.local(Code::make(ctx, code));
     Local handlers_obj = sc.local();
     if (!handlers.empty())
         handlers_obj = HandlerTable::make(ctx, handlers);
-
+    Local lines_obj = sc.local();
+    if (!lines.empty())
+        lines_obj = LineTable::make(ctx, lines);
+    Local cache_obj = sc.local();
+    if (cache_sites > 0)
+        cache_obj = InlineCache::make(ctx, cache_sites);
+
+#ifdef TIRO_JIT
+    Layout* data = create_object<CodeFunctionTemplate>(
+        ctx, StaticSlotsInit(), StaticPayloadInit(), FinalizerPiece());
+#else
     Layout* data = create_object<CodeFunctionTemplate>(ctx, StaticSlotsInit(), StaticPayloadInit());
+#endif
     data->write_static_slot(NameSlot, name);
     data->write_static_slot(ModuleSlot, module);
     data->write_static_slot(CodeSlot, code_obj);
     data->write_static_slot(HandlersSlot, handlers_obj);
+    data->write_static_slot(LinesSlot, lines_obj);
+    data->write_static_slot(InlineCacheSlot, cache_obj);
     data->static_payload()->params = params;
     data->static_payload()->locals = locals;
     return CodeFunctionTemplate(from_heap(data));
@@ -94,6 +140,14 @@ Nullable<HandlerTable> CodeFunctionTemplate::handlers() {
     return layout()->read_static_slot<Nullable<HandlerTable>>(HandlersSlot);
 }
 
+Nullable<LineTable> CodeFunctionTemplate::lines() {
+    return layout()->read_static_slot<Nullable<LineTable>>(LinesSlot);
+}
+
+Nullable<Tuple> CodeFunctionTemplate::inline_cache() {
+    return layout()->read_static_slot<Nullable<Tuple>>(InlineCacheSlot);
+}
+
 u32 CodeFunctionTemplate::params() {
     return layout()->static_payload()->params;
 }
@@ -102,6 +156,31 @@ u32 CodeFunctionTemplate::locals() {
     return layout()->static_payload()->locals;
 }
 
+#ifdef TIRO_JIT
+u32 CodeFunctionTemplate::add_hotness(u32 n) {
+    constexpr u32 max = std::numeric_limits<u32>::max();
+    u32& hotness = layout()->static_payload()->hotness;
+    hotness = n <= max - hotness ? hotness + n : max;
+    return hotness;
+}
+
+JitFunction* CodeFunctionTemplate::jit() {
+    return layout()->static_payload()->jit;
+}
+
+void CodeFunctionTemplate::jit(std::unique_ptr<JitFunction> func) {
+    JitFunction*& jit = layout()->static_payload()->jit;
+    TIRO_DEBUG_ASSERT(!jit, "function was already compiled");
+    jit = func.release();
+}
+
+void CodeFunctionTemplate::finalize() {
+    JitFunction*& jit = layout()->static_payload()->jit;
+    delete jit;
+    jit = nullptr;
+}
+#endif
+
 Environment Environment::make(Context& ctx, size_t size, MaybeHandle<Environment> parent) {
     TIRO_DEBUG_ASSERT(size > 0, "0 sized closure context is useless.");
 
@@ -135,6 +214,7 @@ Value Environment::get(size_t index) {
 
 void Environment::set(size_t index, Value value) {
     TIRO_DEBUG_ASSERT(index < size(), "Environment::set(): index out of bounds.");
+    write_barrier(value);
     *layout()->fixed_slot(index) = value;
 }
 
@@ -3,27 +3,41 @@
 
 #include "common/adt/span.hpp"
 #include "vm/handles/handle.hpp"
+#include "vm/jit/fwd.hpp"
 #include "vm/object_support/layout.hpp"
 #include "vm/objects/value.hpp"
 
+#include <memory>
+
 namespace tiro::vm {
 
-/// Represents executable byte code, typically used to
+/// The unit of the instruction stream executed by the interpreter.
+/// See `translate_function()` for the encoding of instructions.
+using CodeWord = u32;
+
+/// Represents executable code, typically used to
 /// represents the instructions within a function.
 ///
+/// Code objects contain translated (i.e. pre-decoded) instructions instead of serialized bytecode.
+/// All offsets (e.g. jump destinations or the program counter) are word offsets.
+///
 /// TODO: Code should not be movable on the heap.
 class Code final : public HeapValue {
 public:
-    using Layout = BufferLayout<byte, alignof(byte)>;
+    using Layout = BufferLayout<CodeWord, alignof(CodeWord)>;
 
-    static Code make(Context& ctx, Span<const byte> code);
+    static Code make(Context& ctx, Span<const CodeWord> code);
 
     explicit Code(Value v)
         : HeapValue(v, DebugCheck<Code>()) {}
 
-    const byte* data();
+    const CodeWord* data();
     size_t size();
-    Span<const byte> view() { return {data(), size()}; }
+    Span<const CodeWord> view() { return {data(), size()}; }
+
+    /// Replaces the code word at the given offset. Used by the interpreter to rewrite
+    /// instructions in place (see `QuickOp`).
+    void rewrite(size_t offset, CodeWord word);
 
     Layout* layout() const { return access_heap<Layout>(); }
 };
@@ -63,6 +77,40 @@ public:
     Layout* layout() const { return access_heap<Layout>(); }
 };
 
+/// Maps the program counters of a function to source lines.
+class LineTable final : public HeapValue {
+public:
+    struct Entry {
+        u32 start; // start pc of the instructions on this line
+        u32 line;  // source line (1 based)
+
+        bool operator==(const Entry& other) const {
+            return start == other.start && line == other.line;
+        }
+
+        bool operator!=(const Entry& other) const { return !(*this == other); }
+    };
+
+    using Layout = BufferLayout<Entry, alignof(Entry)>;
+
+    /// Creates a new table with the given set of entries.
+    /// \pre `entries` must be sorted by their start pc.
+    static LineTable make(Context& ctx, Span<const Entry> entries);
+
+    explicit LineTable(Value v)
+        : HeapValue(v, DebugCheck<LineTable>()) {}
+
+    const Entry* data();
+    size_t size();
+    Span<const Entry> view() { return {data(), size()}; }
+
+    /// Returns the source line of the instruction at the given program counter.
+    /// Returns 0 if the line is unknown.
+    u32 find_line(u32 pc);
+
+    Layout* layout() const { return access_heap<Layout>(); }
+};
+
 /// Represents a function prototype.
 ///
 /// Function prototypes contain the static properties of functions and are referenced
@@ -74,6 +122,10 @@ private:
     struct Payload {
         u32 params;
         u32 locals;
+#ifdef TIRO_JIT
+        u32 hotness = 0;
+        JitFunction* jit = nullptr;
+#endif
     };
 
     enum Slots {
@@ -81,14 +133,25 @@ private:
         ModuleSlot,
         CodeSlot,
         HandlersSlot,
+        LinesSlot,
+        InlineCacheSlot,
         SlotCount_,
     };
 
 public:
+#ifdef TIRO_JIT
+    // The finalizer releases the function's machine code.
+    using Layout =
+        StaticLayout<StaticSlotsPiece<SlotCount_>, StaticPayloadPiece<Payload>, FinalizerPiece>;
+#else
     using Layout = StaticLayout<StaticSlotsPiece<SlotCount_>, StaticPayloadPiece<Payload>>;
+#endif
 
+    /// Creates a new function template. `cache_sites` is the number of instructions
+    /// in `code` that use an inline cache (see `InlineCache`).
     static CodeFunctionTemplate make(Context& ctx, Handle<String> name, Handle<Module> module,
-        u32 params, u32 locals, Span<const HandlerTable::Entry> handlers, Span<const byte> code);
+        u32 params, u32 locals, Span<const HandlerTable::Entry> handlers,
+        Span<const LineTable::Entry> lines, Span<const CodeWord> code, u32 cache_sites);
 
     explicit CodeFunctionTemplate(Value v)
         : HeapValue(v, DebugCheck<CodeFunctionTemplate>()) {}
@@ -99,12 +162,19 @@ public:
     /// The module the function belongs to.
     Module module();
 
-    /// The executable byte code of this function.
+    /// The executable code of this function.
     Code code();
 
     /// Exception handler table for this function.
     Nullable<HandlerTable> handlers();
 
+    /// Line table for this function. Null if no line information is available.
+    Nullable<LineTable> lines();
+
+    /// Storage for the inline caches used by this function's instructions.
+    /// Null if the function does not contain any cached instructions.
+    Nullable<Tuple> inline_cache();
+
     /// The (minimum) number of required parameters.
     u32 params();
 
@@ -112,6 +182,20 @@ public:
     /// on the stack before the function may execute.
     u32 locals();
 
+#ifdef TIRO_JIT
+    /// Increments the number of calls and loop iterations observed for this function
+    /// and returns the new value. Used to detect functions worth compiling, see `Jit`.
+    u32 add_hotness(u32 n);
+
+    /// Machine code compiled for this function, or null.
+    /// The function template takes ownership of the machine code, which is released by `finalize()`.
+    JitFunction* jit();
+    void jit(std::unique_ptr<JitFunction> func);
+
+    /// Releases the machine code. Called by the garbage collector when the template is collected.
+    void finalize();
+#endif
+
     Layout* layout() const { return access_heap<Layout>(); }
 };
 
@@ -31,7 +31,6 @@ class CoroutineStack;
 class CoroutineToken;
 class Environment;
 class Exception;
-class Float;
 class HandlerTable;
 class HashTable;
 class HashTableIterator;
@@ -40,8 +39,10 @@ class HashTableKeyView;
 class HashTableStorage;
 class HashTableValueIterator;
 class HashTableValueView;
+class HeapFloat;
 class HeapInteger;
 class InternalType;
+class LineTable;
 class MagicFunction;
 class Method;
 class Module;
@@ -54,6 +55,7 @@ class RecordSchema;
 class Result;
 class Set;
 class SetIterator;
+class SmallFloat;
 class SmallInteger;
 class String;
 class StringBuilder;
@@ -65,8 +67,10 @@ class TupleIterator;
 class Type;
 class Undefined;
 class UnresolvedImport;
+class WeakMap;
 // [[[end]]]
 
+class Float;
 class Function;
 class Number;
 class Integer;
@@ -161,6 +161,15 @@ HashTable HashTable::make(Context& ctx) {
     return HashTable(from_heap(data));
 }
 
+HashTable HashTable::make_weak(Context& ctx) {
+    Layout* data = create_object<HashTable>(ctx, StaticSlotsInit(), StaticPayloadInit());
+    data->static_payload()->weak_keys = true;
+
+    HashTable table(from_heap(data));
+    ctx.heap().collector().register_weak_table(table.heap_ptr());
+    return table;
+}
+
 Fallible<HashTable> HashTable::make(Context& ctx, size_t initial_capacity) {
     Scope sc(ctx);
     Local table = sc.local(HashTable::make(ctx));
@@ -186,6 +195,10 @@ size_t HashTable::size() {
     return layout()->static_payload()->size;
 }
 
+bool HashTable::weak_keys() {
+    return layout()->static_payload()->weak_keys;
+}
+
 size_t HashTable::occupied_entries() {
     auto entries = get_entries(layout());
     if (!entries)
@@ -290,6 +303,39 @@ void HashTable::clear() {
         [&](auto traits) { this->template clear_impl<decltype(traits)>(data); });
 }
 
+size_t HashTable::remove_if(FunctionRef<bool(Value key, Value value)> pred) {
+    if (empty())
+        return 0;
+
+    static constexpr HashTableEntry sentinel = HashTableEntry::make_deleted();
+
+    Layout* data = layout();
+    auto entries = get_entries(data).value();
+    size_t removed = 0;
+    for (size_t i = 0, n = entries.size(); i < n; ++i) {
+        const HashTableEntry& entry = entries.get(i);
+        if (!entry.is_deleted() && pred(entry.key(), entry.value())) {
+            entries.set(i, sentinel);
+            ++removed;
+        }
+    }
+    if (removed == 0)
+        return 0;
+
+    TIRO_TABLE_TRACE("Removed {} entries", removed);
+
+    // Compaction rebuilds the index from the hashes stored in the remaining entries.
+    data->static_payload()->size -= removed;
+    dispatch_size_class(index_size_class(data), [&](auto traits) {
+        if (size() == 0) {
+            this->template clear_impl<decltype(traits)>(data);
+        } else {
+            this->template compact<decltype(traits)>(data);
+        }
+    });
+    return removed;
+}
+
 HashTableIterator HashTable::make_iterator(Context& ctx) {
     return HashTableIterator::make(ctx, Handle<HashTable>(this));
 }
@@ -554,9 +600,17 @@ void HashTable::init_first(Layout* data, Context& ctx) {
     using InitialSizeClass = SizeClassTraits<SizeClass::U8>;
 
     TIRO_TABLE_TRACE("Initializing hash table to initial capacity");
-    set_entries(data, HashTableStorage::make(ctx, initial_table_capacity));
-    set_index(data, InitialSizeClass::BufferAccess::make(
-                        ctx, initial_index_capacity, InitialSizeClass::empty_value));
+
+    // Both allocations happen before the table is modified. A collection triggered by
+    // an allocation may remove entries from weak tables, which requires a consistent table.
+    // The entries are allocated last: a marking slice must not trace them before they
+    // have been registered as the storage of a weak table (see set_entries()).
+    Scope sc(ctx);
+    Local index = sc.local(InitialSizeClass::BufferAccess::make(
+        ctx, initial_index_capacity, InitialSizeClass::empty_value));
+    Local entries = sc.local(HashTableStorage::make(ctx, initial_table_capacity));
+    set_entries(data, ctx, *entries);
+    set_index(data, *index);
     data->static_payload()->size = 0;
     data->static_payload()->mask = initial_index_capacity - 1;
 }
@@ -590,7 +644,13 @@ void HashTable::grow_to_capacity(
     TIRO_TABLE_TRACE("Growing table from {} entries to {} entries ({} index slots)",
         entry_capacity(), new_entry_capacity, new_index_capacity);
 
+    // Allocate everything up front (entries last), see init_first().
+    const SizeClass next_size_class = index_size_class(new_entry_capacity);
     Scope sc(ctx);
+    Local new_index = sc.local(dispatch_size_class(next_size_class, [&](auto traits) {
+        using Traits = decltype(traits);
+        return Traits::BufferAccess::make(ctx, new_index_capacity, Traits::empty_value);
+    }));
     Local new_entries = sc.local(HashTableStorage::make(ctx, new_entry_capacity));
     if (const auto sz = size(); sz == occupied_entries()) {
         if (sz > 0) {
@@ -602,12 +662,11 @@ void HashTable::grow_to_capacity(
                 new_entries->append(entry);
         }
     }
-    set_entries(data, *new_entries);
+    set_entries(data, ctx, *new_entries);
 
     // TODO: make rehashing cheaper by reusing the old index table...
-    const SizeClass next_size_class = index_size_class(new_entry_capacity);
     dispatch_size_class(next_size_class, [&](auto traits) {
-        this->template recreate_index<decltype(traits)>(data, ctx, new_index_capacity);
+        this->template recreate_index<decltype(traits)>(data, *new_index);
     });
 }
 
@@ -650,13 +709,14 @@ void HashTable::compact(Layout* data) {
 }
 
 template<typename ST>
-void HashTable::recreate_index(Layout* data, Context& ctx, size_t capacity) {
+void HashTable::recreate_index(Layout* data, Buffer index) {
+    const size_t capacity = ST::BufferAccess::size(index);
     TIRO_DEBUG_ASSERT(
         size() == occupied_entries(), "Entries array must not have any deleted elements.");
     TIRO_DEBUG_ASSERT(is_pow2(capacity), "New index capacity must be a power of two.");
 
     // TODO rehashing can be made faster, see rust index map at https://github.com/bluss/indexmap
-    set_index(data, ST::BufferAccess::make(ctx, capacity, ST::empty_value));
+    set_index(data, index);
     data->static_payload()->mask = capacity - 1;
     rehash_index<ST>(data);
 }
@@ -723,7 +783,17 @@ Nullable<HashTableStorage> HashTable::get_entries(Layout* data) {
     return data->read_static_slot<Nullable<HashTableStorage>>(EntriesSlot);
 }
 
-void HashTable::set_entries(Layout* data, Nullable<HashTableStorage> entries) {
+void HashTable::set_entries(Layout* data, Context& ctx, Nullable<HashTableStorage> entries) {
+    // The entries of weak tables must not be traced on their own (which would happen if they
+    // were shaded by the barrier or reached through a root). The table is visited again instead.
+    HashTable table(from_heap(data));
+    if (data->static_payload()->weak_keys) {
+        if (entries.has_value())
+            ctx.heap().collector().replace_weak_entries(table.heap_ptr(), entries.value().heap_ptr());
+        table.write_barrier();
+    } else {
+        table.write_barrier(entries);
+    }
     data->write_static_slot(EntriesSlot, entries);
 }
 
@@ -732,6 +802,7 @@ Nullable<Buffer> HashTable::get_index(Layout* data) {
 }
 
 void HashTable::set_index(Layout* data, Nullable<Buffer> index) {
+    HashTable(from_heap(data)).write_barrier(index);
     data->write_static_slot(IndexSlot, index);
 }
 
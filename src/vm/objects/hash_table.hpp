@@ -1,6 +1,7 @@
 #ifndef TIRO_VM_OBJECTS_HASH_TABLE_HPP
 #define TIRO_VM_OBJECTS_HASH_TABLE_HPP
 
+#include "common/adt/function_ref.hpp"
 #include "common/math.hpp"
 #include "vm/handles/handle.hpp"
 #include "vm/handles/scope.hpp"
@@ -138,6 +139,9 @@ private:
 
         // Mask for bucket index modulus computation. Derived from `indicies.size()`.
         size_t mask = 0;
+
+        // True if the keys are referenced weakly, see `make_weak()`.
+        bool weak_keys = false;
     };
 
 public:
@@ -149,6 +153,11 @@ public:
 
     static Fallible<HashTable> make(Context& ctx, size_t initial_capacity);
 
+    /// Creates a new, empty hash table that references its keys weakly.
+    /// The garbage collector removes an entry once its key is no longer reachable from anywhere else.
+    /// The value of an entry is kept alive for as long as its key is alive, see `Collector`.
+    static HashTable make_weak(Context& ctx);
+
     explicit HashTable(Value v)
         : HeapValue(v, DebugCheck<HashTable>()) {}
 
@@ -169,6 +178,9 @@ public:
     /// True iff the hash table is empty.
     bool empty() { return size() == 0; }
 
+    /// True iff the keys of this table are referenced weakly (see `make_weak()`).
+    bool weak_keys();
+
     /// Returns true iff key is in the table.
     bool contains(Value key);
 
@@ -193,6 +205,11 @@ public:
     /// Removes all elements from the hash table.
     void clear();
 
+    /// Removes all entries for which `pred(key, value)` returns true.
+    /// Returns the number of removed entries. Does not allocate and does not access the keys,
+    /// which makes it safe to use during garbage collection.
+    size_t remove_if(FunctionRef<bool(Value key, Value value)> pred);
+
     /// Returns a new iterator for this table.
     HashTableIterator make_iterator(Context& ctx);
 
@@ -251,6 +268,9 @@ private:
     using Hash = HashTableEntry::Hash;
 
 private:
+    // The collector treats the entries of weak tables as ephemerons.
+    friend Collector;
+
     // API used by the iterator classes
     template<typename Derived>
     friend class HashTableIteratorBase;
@@ -300,7 +320,7 @@ private:
     // Creates a new index table from an existing entries array.
     // This could be optimized further by using the old index table (?).
     template<typename ST>
-    void recreate_index(Layout* data, Context& ctx, size_t capacity);
+    void recreate_index(Layout* data, Buffer index);
 
     // Creates the index from scratch using the existing index array.
     // The index array should have been cleared (if reused) or initialized
@@ -323,7 +343,7 @@ private:
     SizeClass index_size_class(Layout* data);
 
     Nullable<HashTableStorage> get_entries(Layout* data);
-    void set_entries(Layout* data, Nullable<HashTableStorage> entries);
+    void set_entries(Layout* data, Context& ctx, Nullable<HashTableStorage> entries);
 
     Nullable<Buffer> get_index(Layout* data);
     void set_index(Layout* data, Nullable<Buffer> index);
@@ -39,6 +39,16 @@ HashTable Module::exported() {
 }
 
 std::optional<Value> Module::find_exported(Symbol name) {
+    auto index = find_exported_index(name);
+    if (!index)
+        return {};
+
+    auto members = this->members();
+    TIRO_DEBUG_ASSERT(*index < members.size(), "Index of exported module member is out of bounds.");
+    return members.unchecked_get(*index);
+}
+
+std::optional<size_t> Module::find_exported_index(Symbol name) {
     auto exported = this->exported();
     TIRO_DEBUG_ASSERT(exported, "Must have a table of exported members.");
 
@@ -47,12 +57,9 @@ std::optional<Value> Module::find_exported(Symbol name) {
         return {};
 
     auto index_value = Integer::try_extract(*index);
-    TIRO_DEBUG_ASSERT(index_value, "Members of the exported table must always be integers.");
-
-    auto members = this->members();
-    TIRO_DEBUG_ASSERT(*index_value >= 0 && static_cast<size_t>(*index_value) < members.size(),
-        "Index of exported module member is out of bounds.");
-    return members.unchecked_get(*index_value);
+    TIRO_DEBUG_ASSERT(index_value && *index_value >= 0,
+        "Members of the exported table must always be non-negative integers.");
+    return static_cast<size_t>(*index_value);
 }
 
 Value Module::initializer() {
@@ -60,6 +67,7 @@ Value Module::initializer() {
 }
 
 void Module::initializer(Value value) {
+    write_barrier(value);
     layout()->write_static_slot(InitializerSlot, value);
 }
 
@@ -78,6 +78,10 @@ public:
     // Returns an empty optional if no such member was found.
     std::optional<Value> find_exported(Symbol name);
 
+    // Returns the index (into the `members` tuple) of the exported member with that name.
+    // Returns an empty optional if no such member was found.
+    std::optional<size_t> find_exported_index(Symbol name);
+
     // A function that will be called at module load time. May be null.
     Value initializer();
     void initializer(Value value);
@@ -3,6 +3,8 @@
 #include "vm/context.hpp"
 #include "vm/object_support/factory.hpp"
 
+#include <cstring>
+
 namespace tiro::vm {
 
 Undefined Undefined::make(Context& ctx) {
@@ -84,16 +86,93 @@ std::optional<size_t> Integer::try_extract_size() {
     return static_cast<size_t>(u);
 }
 
-Float Float::make(Context& ctx, f64 value) {
-    Layout* data = create_object<Float>(ctx, StaticPayloadInit());
+HeapFloat HeapFloat::make(Context& ctx, f64 value) {
+    Layout* data = create_object<HeapFloat>(ctx, StaticPayloadInit());
     data->static_payload()->value = value;
-    return Float(from_heap(data));
+    return HeapFloat(from_heap(data));
 }
 
-f64 Float::value() {
+f64 HeapFloat::value() {
     return layout()->static_payload()->value;
 }
 
+// Small floats use the same bit representation as IEEE 754 doubles, but the
+// sign bit is rotated into the least significant bit and the biased exponent is reduced by
+// `small_float_exponent_offset`. This frees the two most significant bits, which are then
+// shifted out to make room for the tag bits. The rotated representation of zero (with either sign)
+// is reserved as a special case.
+//
+// See also: "64-bit immediate floats" in the Spur object representation (OpenSmalltalk VM).
+static constexpr u64 f64_exponent_shift = 52;
+static constexpr u64 f64_exponent_mask = 0x7ff;
+static constexpr u64 small_float_exponent_offset = 768;
+static constexpr u64 small_float_min_exponent = small_float_exponent_offset + 1;
+static constexpr u64 small_float_max_exponent = small_float_exponent_offset + 511;
+static constexpr u64 small_float_rotated_offset = small_float_exponent_offset
+                                                  << (f64_exponent_shift + 1);
+
+static u64 f64_bits(f64 value) {
+    u64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static f64 f64_from_bits(u64 bits) {
+    f64 value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool SmallFloat::fits(f64 value) {
+    if constexpr (!enabled) {
+        (void) value;
+        return false;
+    } else {
+        const u64 bits = f64_bits(value);
+        const u64 exponent = (bits >> f64_exponent_shift) & f64_exponent_mask;
+        return (exponent >= small_float_min_exponent && exponent <= small_float_max_exponent)
+               || (bits << 1) == 0;
+    }
+}
+
+SmallFloat SmallFloat::make(f64 value) {
+    TIRO_DEBUG_ASSERT(fits(value), "value cannot be represented as a small float");
+
+    const u64 bits = f64_bits(value);
+    const u64 rotated = (bits << 1) | (bits >> 63);
+    const u64 payload = rotated <= 1 ? rotated : rotated - small_float_rotated_offset;
+    const u64 raw = (payload << embedded_float_shift) | embedded_float_tag;
+    return SmallFloat(from_embedded_float(static_cast<uintptr_t>(raw)));
+}
+
+f64 SmallFloat::value() {
+    TIRO_DEBUG_ASSERT(is_embedded_float(), "value does not contain an embedded float");
+
+    const u64 payload = static_cast<u64>(raw()) >> embedded_float_shift;
+    const u64 rotated = payload <= 1 ? payload : payload + small_float_rotated_offset;
+    return f64_from_bits((rotated >> 1) | (rotated << 63));
+}
+
+template<typename Func>
+auto Float::dispatch(Func&& fn) {
+    TIRO_DEBUG_ASSERT(is<SmallFloat>() || is<HeapFloat>(), "unexpected type of object in float");
+    if (is<SmallFloat>())
+        return fn(SmallFloat(*this));
+    if (is<HeapFloat>())
+        return fn(HeapFloat(*this));
+    TIRO_UNREACHABLE("Invalid float type");
+}
+
+Float Float::make(Context& ctx, f64 value) {
+    if (SmallFloat::fits(value))
+        return SmallFloat::make(value);
+    return HeapFloat::make(ctx, value);
+}
+
+f64 Float::value() {
+    return dispatch([](auto&& v) { return v.value(); });
+}
+
 f64 Number::convert_float() {
     return visit([](auto&& v) { return static_cast<f64>(v.value()); });
 }
@@ -140,7 +140,8 @@ public:
 };
 
 /// Represents a heap-allocated 64-bit floating point value.
-class Float final : public HeapValue {
+/// Only used for values that cannot be represented as a small float.
+class HeapFloat final : public HeapValue {
 private:
     struct Payload {
         f64 value;
@@ -149,16 +150,71 @@ private:
 public:
     using Layout = StaticLayout<StaticPayloadPiece<Payload>>;
 
-    static Float make(Context& ctx, f64 value);
+    static HeapFloat make(Context& ctx, f64 value);
 
-    explicit Float(Value v)
-        : HeapValue(v, DebugCheck<Float>()) {}
+    explicit HeapFloat(Value v)
+        : HeapValue(v, DebugCheck<HeapFloat>()) {}
 
     f64 value();
 
     Layout* layout() { return access_heap<Layout>(); }
 };
 
+/// Small floats are floating point values that are stored directly in the
+/// raw pointer value instead of being allocated on the heap.
+///
+/// Small floats are only available on 64 bit platforms when the vm was built
+/// with `TIRO_EMBEDDED_FLOATS`. The encoding is lossless but reduces the range of
+/// representable exponents by two bits: zero and all finite values with
+/// a magnitude in [2^-254, 2^257) can be stored as small floats. All other values
+/// (e.g. very small or large numbers, infinity, nan) must be allocated on the heap.
+class SmallFloat final : public Value {
+public:
+    /// True if small floats are supported by this build.
+    static constexpr bool enabled =
+#if defined(TIRO_EMBEDDED_FLOATS)
+        sizeof(uintptr_t) == sizeof(u64);
+#else
+        false;
+#endif
+
+    /// Returns true if the given value can be represented as a small float.
+    static bool fits(f64 value);
+
+    /// Constructs a small float from the given value.
+    /// \pre `fits(value)`.
+    static SmallFloat make(f64 value);
+
+    explicit SmallFloat(Value v)
+        : Value(v, DebugCheck<SmallFloat>()) {}
+
+    f64 value();
+};
+
+/// Represents a floating point value with arbitrary storage mode (small float or heap float).
+class Float final : public Value {
+private:
+    template<typename Func>
+    auto dispatch(Func&&);
+
+public:
+    /// Returns a float that represents the given value. Values are stored as small floats
+    /// if possible. Otherwise, a new float is allocated on the heap.
+    static Float make(Context& ctx, f64 value);
+
+    explicit Float(Value v)
+        : Value(v, DebugCheck<Float>()) {}
+
+    Float(SmallFloat v)
+        : Float(static_cast<Value>(v)) {}
+
+    Float(HeapFloat v)
+        : Float(static_cast<Value>(v)) {}
+
+    /// Returns the value stored in this float.
+    f64 value();
+};
+
 /// Represents an arbitrary number.
 class Number final : public Value {
 public:
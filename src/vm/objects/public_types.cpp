@@ -47,6 +47,7 @@ std::string_view to_string(PublicType pt) {
         TIRO_CASE(Tuple)
         TIRO_CASE(TupleIterator)
         TIRO_CASE(Type)
+        TIRO_CASE(WeakMap)
         // [[[end]]]
     }
 
@@ -57,6 +57,7 @@ enum class PublicType : u8 {
     Tuple,
     TupleIterator,
     Type,
+    WeakMap,
     // [[[end]]]
 };
 
@@ -65,7 +66,7 @@ enum class PublicType : u8 {
     from codegen.objects import PUBLIC_TYPES
     outl(f"inline constexpr u8 max_public_type = static_cast<u8>({PUBLIC_TYPES[-1].type_tag});")
 ]]] */
-inline constexpr u8 max_public_type = static_cast<u8>(PublicType::Type);
+inline constexpr u8 max_public_type = static_cast<u8>(PublicType::WeakMap);
 // [[[end]]]
 
 std::string_view to_string(PublicType pt);
@@ -93,7 +94,7 @@ TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Buffer, ValueType::Buffer)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Coroutine, ValueType::Coroutine)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::CoroutineToken, ValueType::CoroutineToken)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Exception, ValueType::Exception)
-TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Float, ValueType::Float)
+TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Float, ValueType::HeapFloat, ValueType::SmallFloat)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Function, ValueType::BoundMethod,
     ValueType::CodeFunction, ValueType::MagicFunction, ValueType::NativeFunction)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(
@@ -121,6 +122,7 @@ TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Symbol, ValueType::Symbol)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Tuple, ValueType::Tuple)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::TupleIterator, ValueType::TupleIterator)
 TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::Type, ValueType::Type)
+TIRO_PUBLIC_TYPE_TO_VALUE_TYPES(PublicType::WeakMap, ValueType::WeakMap)
 // [[[end]]]
 
 #undef TIRO_PUBLIC_TYPE_TO_VALUE_TYPES
@@ -171,6 +173,7 @@ case pt:             \
         TIRO_MAP(PublicType::Tuple)
         TIRO_MAP(PublicType::TupleIterator)
         TIRO_MAP(PublicType::Type)
+        TIRO_MAP(PublicType::WeakMap)
         // [[[end]]]
 
 #undef TIRO_MAP
@@ -198,7 +201,8 @@ case ValueType::vt:      \
         TIRO_MAP(Coroutine, PublicType::Coroutine);
         TIRO_MAP(CoroutineToken, PublicType::CoroutineToken);
         TIRO_MAP(Exception, PublicType::Exception);
-        TIRO_MAP(Float, PublicType::Float);
+        TIRO_MAP(HeapFloat, PublicType::Float);
+        TIRO_MAP(SmallFloat, PublicType::Float);
         TIRO_MAP(BoundMethod, PublicType::Function);
         TIRO_MAP(CodeFunction, PublicType::Function);
         TIRO_MAP(MagicFunction, PublicType::Function);
@@ -228,6 +232,7 @@ case ValueType::vt:      \
         TIRO_MAP(Tuple, PublicType::Tuple);
         TIRO_MAP(TupleIterator, PublicType::TupleIterator);
         TIRO_MAP(Type, PublicType::Type);
+        TIRO_MAP(WeakMap, PublicType::WeakMap);
         // [[[end]]]
 
 #undef TIRO_MAP
@@ -96,6 +96,18 @@ bool Record::set(Symbol key, Value value) {
     return true;
 }
 
+Value Record::get_slot(size_t index) {
+    auto values = get_values();
+    TIRO_DEBUG_ASSERT(index < values.size(), "index too large");
+    return values.unchecked_get(index);
+}
+
+void Record::set_slot(size_t index, Value value) {
+    auto values = get_values();
+    TIRO_DEBUG_ASSERT(index < values.size(), "index too large");
+    values.unchecked_set(index, value);
+}
+
 RecordSchema Record::get_schema() {
     return layout()->read_static_slot<RecordSchema>(SchemaSlot);
 }
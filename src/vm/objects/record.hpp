@@ -108,6 +108,14 @@ public:
     /// Returns false (and does nothing) if the key is invalid for this record.
     bool set(Symbol key, Value value);
 
+    /// Returns the value at the given slot index. Slot indices are obtained from the record's schema.
+    /// \pre `index < schema().size()`.
+    Value get_slot(size_t index);
+
+    /// Sets the value at the given slot index. Slot indices are obtained from the record's schema.
+    /// \pre `index < schema().size()`.
+    void set_slot(size_t index, Value value);
+
     /// Quick-and-dirty iteration for record inspection without allocation.
     template<typename Function>
     void for_each_unsafe(Function&& fn) {
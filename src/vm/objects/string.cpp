@@ -394,6 +394,7 @@ Nullable<Buffer> StringBuilder::get_buffer(Layout* data) {
 }
 
 void StringBuilder::set_buffer(Layout* data, Nullable<Buffer> buffer) {
+    StringBuilder(from_heap(data)).write_barrier(buffer);
     data->write_static_slot(BufferSlot, buffer);
 }
 
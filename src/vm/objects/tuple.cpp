@@ -61,6 +61,7 @@ Value Tuple::unchecked_get(size_t index) {
 
 void Tuple::unchecked_set(size_t index, Value value) {
     TIRO_DEBUG_ASSERT(index < size(), "tuple index out of bounds");
+    write_barrier(value);
     *layout()->fixed_slot(index) = value;
 }
 
@@ -22,52 +22,55 @@ enum class ValueType : u8 {
     ]]] */
     Null = 1,
     Boolean = 2,
-    Float = 3,
-    HeapInteger = 4,
-    SmallInteger = 5,
-    Symbol = 6,
-    String = 7,
-    StringSlice = 8,
-    StringIterator = 9,
-    StringBuilder = 10,
-    BoundMethod = 11,
-    CodeFunction = 12,
-    MagicFunction = 13,
-    NativeFunction = 14,
-    Code = 15,
-    Environment = 16,
-    CodeFunctionTemplate = 17,
-    HandlerTable = 18,
-    Type = 19,
-    Method = 20,
-    InternalType = 21,
-    Array = 22,
-    ArrayIterator = 23,
-    ArrayStorage = 24,
-    Buffer = 25,
-    HashTable = 26,
-    HashTableIterator = 27,
-    HashTableKeyView = 28,
-    HashTableKeyIterator = 29,
-    HashTableValueView = 30,
-    HashTableValueIterator = 31,
-    HashTableStorage = 32,
-    Record = 33,
-    RecordSchema = 34,
-    Set = 35,
-    SetIterator = 36,
-    Tuple = 37,
-    TupleIterator = 38,
-    NativeObject = 39,
-    NativePointer = 40,
-    Exception = 41,
-    Result = 42,
-    Coroutine = 43,
-    CoroutineStack = 44,
-    CoroutineToken = 45,
-    Module = 46,
-    Undefined = 47,
-    UnresolvedImport = 48,
+    HeapFloat = 3,
+    SmallFloat = 4,
+    HeapInteger = 5,
+    SmallInteger = 6,
+    Symbol = 7,
+    String = 8,
+    StringSlice = 9,
+    StringIterator = 10,
+    StringBuilder = 11,
+    BoundMethod = 12,
+    CodeFunction = 13,
+    MagicFunction = 14,
+    NativeFunction = 15,
+    Code = 16,
+    Environment = 17,
+    CodeFunctionTemplate = 18,
+    HandlerTable = 19,
+    LineTable = 20,
+    Type = 21,
+    Method = 22,
+    InternalType = 23,
+    Array = 24,
+    ArrayIterator = 25,
+    ArrayStorage = 26,
+    Buffer = 27,
+    HashTable = 28,
+    HashTableIterator = 29,
+    HashTableKeyView = 30,
+    HashTableKeyIterator = 31,
+    HashTableValueView = 32,
+    HashTableValueIterator = 33,
+    HashTableStorage = 34,
+    Record = 35,
+    RecordSchema = 36,
+    Set = 37,
+    SetIterator = 38,
+    Tuple = 39,
+    TupleIterator = 40,
+    WeakMap = 41,
+    NativeObject = 42,
+    NativePointer = 43,
+    Exception = 44,
+    Result = 45,
+    Coroutine = 46,
+    CoroutineStack = 47,
+    CoroutineToken = 48,
+    Module = 49,
+    Undefined = 50,
+    UnresolvedImport = 51,
     // [[[end]]]
 };
 
@@ -136,7 +139,6 @@ TIRO_REGISTER_VM_TYPE(CoroutineStack, ValueType::CoroutineStack)
 TIRO_REGISTER_VM_TYPE(CoroutineToken, ValueType::CoroutineToken)
 TIRO_REGISTER_VM_TYPE(Environment, ValueType::Environment)
 TIRO_REGISTER_VM_TYPE(Exception, ValueType::Exception)
-TIRO_REGISTER_VM_TYPE(Float, ValueType::Float)
 TIRO_REGISTER_VM_TYPE(HandlerTable, ValueType::HandlerTable)
 TIRO_REGISTER_VM_TYPE(HashTable, ValueType::HashTable)
 TIRO_REGISTER_VM_TYPE(HashTableIterator, ValueType::HashTableIterator)
@@ -145,8 +147,10 @@ TIRO_REGISTER_VM_TYPE(HashTableKeyView, ValueType::HashTableKeyView)
 TIRO_REGISTER_VM_TYPE(HashTableStorage, ValueType::HashTableStorage)
 TIRO_REGISTER_VM_TYPE(HashTableValueIterator, ValueType::HashTableValueIterator)
 TIRO_REGISTER_VM_TYPE(HashTableValueView, ValueType::HashTableValueView)
+TIRO_REGISTER_VM_TYPE(HeapFloat, ValueType::HeapFloat)
 TIRO_REGISTER_VM_TYPE(HeapInteger, ValueType::HeapInteger)
 TIRO_REGISTER_VM_TYPE(InternalType, ValueType::InternalType)
+TIRO_REGISTER_VM_TYPE(LineTable, ValueType::LineTable)
 TIRO_REGISTER_VM_TYPE(MagicFunction, ValueType::MagicFunction)
 TIRO_REGISTER_VM_TYPE(Method, ValueType::Method)
 TIRO_REGISTER_VM_TYPE(Module, ValueType::Module)
@@ -159,6 +163,7 @@ TIRO_REGISTER_VM_TYPE(RecordSchema, ValueType::RecordSchema)
 TIRO_REGISTER_VM_TYPE(Result, ValueType::Result)
 TIRO_REGISTER_VM_TYPE(Set, ValueType::Set)
 TIRO_REGISTER_VM_TYPE(SetIterator, ValueType::SetIterator)
+TIRO_REGISTER_VM_TYPE(SmallFloat, ValueType::SmallFloat)
 TIRO_REGISTER_VM_TYPE(SmallInteger, ValueType::SmallInteger)
 TIRO_REGISTER_VM_TYPE(String, ValueType::String)
 TIRO_REGISTER_VM_TYPE(StringBuilder, ValueType::StringBuilder)
@@ -170,8 +175,10 @@ TIRO_REGISTER_VM_TYPE(TupleIterator, ValueType::TupleIterator)
 TIRO_REGISTER_VM_TYPE(Type, ValueType::Type)
 TIRO_REGISTER_VM_TYPE(Undefined, ValueType::Undefined)
 TIRO_REGISTER_VM_TYPE(UnresolvedImport, ValueType::UnresolvedImport)
-TIRO_REGISTER_VM_BASE_TYPE(Function, 11, 14)
-TIRO_REGISTER_VM_BASE_TYPE(Integer, 4, 5)
+TIRO_REGISTER_VM_TYPE(WeakMap, ValueType::WeakMap)
+TIRO_REGISTER_VM_BASE_TYPE(Float, 3, 4)
+TIRO_REGISTER_VM_BASE_TYPE(Function, 12, 15)
+TIRO_REGISTER_VM_BASE_TYPE(Integer, 5, 6)
 // [[[end]]]
 
 #undef TIRO_REGISTER_VM_TYPE
@@ -1,6 +1,7 @@
 #include "vm/objects/value.hpp"
 
 #include "vm/hash.hpp"
+#include "vm/heap/heap.hpp"
 #include "vm/objects/all.hpp"
 
 #include <type_traits>
@@ -27,6 +28,8 @@ ValueType Value::type() const {
         return ValueType::Null;
     case ValueCategory::EmbeddedInteger:
         return ValueType::SmallInteger;
+    case ValueCategory::EmbeddedFloat:
+        return ValueType::SmallFloat;
     case ValueCategory::Heap: {
         auto type = HeapValue(*this).type_instance();
         return type.builtin_type();
@@ -46,6 +49,24 @@ InternalType HeapValue::type_instance() {
                         : InternalType(Value::from_heap(type));
 }
 
+void HeapValue::write_barrier_slow(const Value* value) const {
+    Header* header = heap_ptr();
+    Heap& heap = HeapValue(header).type_instance().heap();
+
+    Collector& collector = heap.collector();
+    if (collector.marking()) {
+        if (value) {
+            collector.shade(*value);
+        } else {
+            collector.rescan(header);
+        }
+        return;
+    }
+
+    if (!header->remembered() && (!value || is_young(*value)))
+        heap.remember(header);
+}
+
 bool may_contain_references(ValueType type) {
     switch (type) {
 #define TIRO_CASE(Type)   \
@@ -72,7 +93,6 @@ bool may_contain_references(ValueType type) {
         TIRO_CASE(CoroutineToken)
         TIRO_CASE(Environment)
         TIRO_CASE(Exception)
-        TIRO_CASE(Float)
         TIRO_CASE(HandlerTable)
         TIRO_CASE(HashTable)
         TIRO_CASE(HashTableIterator)
@@ -81,8 +101,10 @@ bool may_contain_references(ValueType type) {
         TIRO_CASE(HashTableStorage)
         TIRO_CASE(HashTableValueIterator)
         TIRO_CASE(HashTableValueView)
+        TIRO_CASE(HeapFloat)
         TIRO_CASE(HeapInteger)
         TIRO_CASE(InternalType)
+        TIRO_CASE(LineTable)
         TIRO_CASE(MagicFunction)
         TIRO_CASE(Method)
         TIRO_CASE(Module)
@@ -95,6 +117,7 @@ bool may_contain_references(ValueType type) {
         TIRO_CASE(Result)
         TIRO_CASE(Set)
         TIRO_CASE(SetIterator)
+        TIRO_CASE(SmallFloat)
         TIRO_CASE(SmallInteger)
         TIRO_CASE(String)
         TIRO_CASE(StringBuilder)
@@ -106,6 +129,7 @@ bool may_contain_references(ValueType type) {
         TIRO_CASE(Type)
         TIRO_CASE(Undefined)
         TIRO_CASE(UnresolvedImport)
+        TIRO_CASE(WeakMap)
         // [[[end]]]
 
 #undef TIRO_CASE
@@ -119,6 +143,10 @@ size_t object_size(Value v) {
 }
 
 bool has_finalizer(Value v) {
+#ifdef TIRO_JIT
+    if (v.type() == ValueType::CodeFunctionTemplate)
+        return true;
+#endif
     return v.type() == ValueType::NativeObject;
 }
 
@@ -129,6 +157,11 @@ void finalize(Value v) {
     case ValueType::NativeObject:
         NativeObject(v).finalize();
         break;
+#ifdef TIRO_JIT
+    case ValueType::CodeFunctionTemplate:
+        CodeFunctionTemplate(v).finalize();
+        break;
+#endif
     default:
         TIRO_DEBUG_ASSERT(false, "invalid object type in finalize()");
     }
@@ -143,8 +176,10 @@ size_t hash(Value v) {
         return Boolean(v).value() ? 1 : 0;
     case ValueType::HeapInteger:
         return integer_hash(static_cast<u64>(HeapInteger(v).value()));
-    case ValueType::Float:
-        return float_hash(Float(v).value());
+    case ValueType::HeapFloat:
+        return float_hash(HeapFloat(v).value());
+    case ValueType::SmallFloat:
+        return float_hash(SmallFloat(v).value());
     case ValueType::SmallInteger:
         return integer_hash(static_cast<u64>(SmallInteger(v).value()));
     case ValueType::String:
@@ -167,6 +202,7 @@ size_t hash(Value v) {
     case ValueType::Environment:
     case ValueType::Exception:
     case ValueType::HandlerTable:
+    case ValueType::LineTable:
     case ValueType::HashTable:
     case ValueType::HashTableIterator:
     case ValueType::HashTableKeyIterator:
@@ -193,6 +229,7 @@ size_t hash(Value v) {
     case ValueType::TupleIterator:
     case ValueType::Type:
     case ValueType::UnresolvedImport:
+    case ValueType::WeakMap:
         // TODO: MUST update once we have moving gc, the heap addr will NOT
         // remain stable!
         // Stable hash codes: https://stackoverflow.com/a/3796963
@@ -238,7 +275,8 @@ bool equal(Value a, Value b) {
             return ai.value() == b.must_cast<SmallInteger>().value();
         case ValueType::HeapInteger:
             return ai.value() == b.must_cast<HeapInteger>().value();
-        case ValueType::Float:
+        case ValueType::HeapFloat:
+        case ValueType::SmallFloat:
             return int_float_equal(ai.value(), b.must_cast<Float>().value());
         default:
             return false;
@@ -251,20 +289,23 @@ bool equal(Value a, Value b) {
             return ai.value() == b.must_cast<SmallInteger>().value();
         case ValueType::HeapInteger:
             return ai.value() == b.must_cast<HeapInteger>().value();
-        case ValueType::Float:
+        case ValueType::HeapFloat:
+        case ValueType::SmallFloat:
             return int_float_equal(ai.value(), b.must_cast<Float>().value());
         default:
             return false;
         }
     }
-    case ValueType::Float: {
+    case ValueType::HeapFloat:
+    case ValueType::SmallFloat: {
         auto af = a.must_cast<Float>();
         switch (tb) {
         case ValueType::SmallInteger:
             return int_float_equal(b.must_cast<SmallInteger>().value(), af.value());
         case ValueType::HeapInteger:
             return int_float_equal(b.must_cast<HeapInteger>().value(), af.value());
-        case ValueType::Float:
+        case ValueType::HeapFloat:
+        case ValueType::SmallFloat:
             return af.value() == b.must_cast<Float>().value();
         default:
             return false;
@@ -293,8 +334,10 @@ std::string to_string(Value v) {
         return Boolean(v).value() ? "true" : "false";
     case ValueType::HeapInteger:
         return std::to_string(HeapInteger(v).value());
-    case ValueType::Float:
-        return std::to_string(Float(v).value());
+    case ValueType::HeapFloat:
+        return std::to_string(HeapFloat(v).value());
+    case ValueType::SmallFloat:
+        return std::to_string(SmallFloat(v).value());
     case ValueType::SmallInteger:
         return std::to_string(SmallInteger(v).value());
     case ValueType::String:
@@ -322,7 +365,8 @@ void to_string(Context& ctx, Handle<StringBuilder> builder, Handle<Value> v) {
         return builder->append(ctx, v.must_cast<Boolean>()->value() ? "true" : "false");
     case ValueType::HeapInteger:
         return builder->format(ctx, "{}", v.must_cast<HeapInteger>()->value());
-    case ValueType::Float:
+    case ValueType::HeapFloat:
+    case ValueType::SmallFloat:
         return builder->format(ctx, "{}", v.must_cast<Float>()->value());
     case ValueType::SmallInteger:
         return builder->format(ctx, "{}", v.must_cast<SmallInteger>()->value());
@@ -376,7 +420,6 @@ TIRO_CHECK_VM_TYPE(CoroutineStack)
 TIRO_CHECK_VM_TYPE(CoroutineToken)
 TIRO_CHECK_VM_TYPE(Environment)
 TIRO_CHECK_VM_TYPE(Exception)
-TIRO_CHECK_VM_TYPE(Float)
 TIRO_CHECK_VM_TYPE(HandlerTable)
 TIRO_CHECK_VM_TYPE(HashTable)
 TIRO_CHECK_VM_TYPE(HashTableIterator)
@@ -385,8 +428,10 @@ TIRO_CHECK_VM_TYPE(HashTableKeyView)
 TIRO_CHECK_VM_TYPE(HashTableStorage)
 TIRO_CHECK_VM_TYPE(HashTableValueIterator)
 TIRO_CHECK_VM_TYPE(HashTableValueView)
+TIRO_CHECK_VM_TYPE(HeapFloat)
 TIRO_CHECK_VM_TYPE(HeapInteger)
 TIRO_CHECK_VM_TYPE(InternalType)
+TIRO_CHECK_VM_TYPE(LineTable)
 TIRO_CHECK_VM_TYPE(MagicFunction)
 TIRO_CHECK_VM_TYPE(Method)
 TIRO_CHECK_VM_TYPE(Module)
@@ -399,6 +444,7 @@ TIRO_CHECK_VM_TYPE(RecordSchema)
 TIRO_CHECK_VM_TYPE(Result)
 TIRO_CHECK_VM_TYPE(Set)
 TIRO_CHECK_VM_TYPE(SetIterator)
+TIRO_CHECK_VM_TYPE(SmallFloat)
 TIRO_CHECK_VM_TYPE(SmallInteger)
 TIRO_CHECK_VM_TYPE(String)
 TIRO_CHECK_VM_TYPE(StringBuilder)
@@ -410,6 +456,7 @@ TIRO_CHECK_VM_TYPE(TupleIterator)
 TIRO_CHECK_VM_TYPE(Type)
 TIRO_CHECK_VM_TYPE(Undefined)
 TIRO_CHECK_VM_TYPE(UnresolvedImport)
+TIRO_CHECK_VM_TYPE(WeakMap)
 // [[[end]]]
 
 TIRO_CHECK_VM_TYPE(Nullable<Value>)
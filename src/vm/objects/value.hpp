@@ -6,6 +6,7 @@
 #include "common/type_traits.hpp"
 #include "vm/fwd.hpp"
 #include "vm/handles/fwd.hpp"
+#include "vm/heap/collector.hpp"
 #include "vm/heap/header.hpp"
 #include "vm/objects/types.hpp"
 
@@ -19,17 +20,33 @@ namespace tiro::vm {
 enum class ValueCategory {
     Null,            ///< The value is null
     EmbeddedInteger, ///< The value is an embedded integer
+    EmbeddedFloat,   ///< The value is an embedded floating point value
     Heap,            ///< The value lives on the heap
 };
 
 /// The uniform representation for all values managed by the VM.
 /// A value has pointer size and is either null, or a pointer to some object allocated
-/// on the heap, or a small integer (without any indirection).
+/// on the heap, or a small integer or small float (without any indirection).
+///
+/// The lowest two bits of the raw value determine its category:
+///
+///     ...x1: embedded integer
+///     ...10: embedded float (only if built with TIRO_EMBEDDED_FLOATS, see SmallFloat)
+///     ...00: heap pointer (or null)
 class Value {
 public:
     // This bit is set on the raw value if it contains an embedded integer.
     static constexpr uintptr_t embedded_integer_flag = 1;
 
+    // The lowest two bits of the raw value have this value if it contains an embedded float.
+    static constexpr uintptr_t embedded_float_tag = 2;
+
+    // Mask for the tag bits that distinguish embedded values from heap pointers.
+    static constexpr uintptr_t embedded_tag_mask = 3;
+
+    // Number of bits to shift floats by to encode/decode them into uintptr_t values.
+    static constexpr uintptr_t embedded_float_shift = 2;
+
     // Number of bits to shift integers by to encode/decode them into uintptr_t values.
     static constexpr uintptr_t embedded_integer_shift = 1;
 
@@ -74,16 +91,23 @@ public:
 
     /// Returns true if this value contains a pointer to the heap.
     /// Note: the pointer may still be NULL.
-    bool is_heap_ptr() const noexcept { return (raw_ & embedded_integer_flag) == 0; }
+    bool is_heap_ptr() const noexcept { return (raw_ & embedded_tag_mask) == 0; }
 
     /// Returns true if this value contains an embedded integer.
     bool is_embedded_integer() const noexcept { return (raw_ & embedded_integer_flag) != 0; }
 
+    /// Returns true if this value contains an embedded float.
+    bool is_embedded_float() const noexcept {
+        return (raw_ & embedded_tag_mask) == embedded_float_tag;
+    }
+
     ValueCategory category() const {
         if (is_null())
             return ValueCategory::Null;
         if (is_embedded_integer())
             return ValueCategory::EmbeddedInteger;
+        if (is_embedded_float())
+            return ValueCategory::EmbeddedFloat;
 
         TIRO_DEBUG_ASSERT(
             is_heap_ptr(), "the value must be on the heap if the other conditions are false");
@@ -104,6 +128,7 @@ public:
 protected:
     struct HeapPointerTag {};
     struct EmbeddedIntegerTag {};
+    struct EmbeddedFloatTag {};
 
     template<typename CheckedType>
     struct DebugCheck {};
@@ -114,10 +139,15 @@ protected:
             raw_ & embedded_integer_flag, "value does not represent an embedded integer");
     }
 
+    explicit Value(EmbeddedFloatTag, uintptr_t value)
+        : raw_(value) {
+        TIRO_DEBUG_ASSERT((raw_ & embedded_tag_mask) == embedded_float_tag,
+            "value does not represent an embedded float");
+    }
+
     explicit Value(HeapPointerTag, NotNull<Header*> ptr)
         : raw_(reinterpret_cast<uintptr_t>(ptr.get())) {
-        TIRO_DEBUG_ASSERT(
-            (raw_ & embedded_integer_flag) == 0, "heap pointer is not aligned correctly");
+        TIRO_DEBUG_ASSERT((raw_ & embedded_tag_mask) == 0, "heap pointer is not aligned correctly");
     }
 
     template<typename CheckedType>
@@ -130,6 +160,8 @@ protected:
 
     static Value from_embedded_integer(uintptr_t raw) { return Value(EmbeddedIntegerTag(), raw); }
 
+    static Value from_embedded_float(uintptr_t raw) { return Value(EmbeddedFloatTag(), raw); }
+
 private:
     uintptr_t raw_;
 };
@@ -175,6 +207,42 @@ protected:
         static_assert(std::is_base_of_v<Header, T>, "T must be a base class of Header");
         return static_cast<T*>(heap_ptr());
     }
+
+    // Write barrier for the garbage collector. Must be called when `value` is stored
+    // into this (already constructed) object. Stores into freshly allocated objects do not need a barrier.
+    // Old objects that receive a reference to a young object are recorded in the heap's remembered set.
+    // While the collector is marking incrementally, the value is marked instead. See `design/heap.md`.
+    void write_barrier(Value value) const {
+        Header* header = heap_ptr();
+        if (!header->old())
+            return;
+        if (TIRO_UNLIKELY(Collector::any_marking())) {
+            write_barrier_slow(&value);
+            return;
+        }
+        if (header->remembered() || !is_young(value))
+            return;
+        write_barrier_slow(&value);
+    }
+
+    // Write barrier for bulk writes or writes of unknown values.
+    // Always records old objects in the remembered set.
+    void write_barrier() const {
+        Header* header = heap_ptr();
+        if (!header->old())
+            return;
+        if (header->remembered() && TIRO_LIKELY(!Collector::any_marking()))
+            return;
+        write_barrier_slow(nullptr);
+    }
+
+private:
+    static bool is_young(Value value) {
+        return !value.is_null() && value.is_heap_ptr() && !HeapValue(value).heap_ptr()->old();
+    }
+
+    // `value` is null if the stored value is not known.
+    void write_barrier_slow(const Value* value) const;
 };
 
 namespace detail {
@@ -209,6 +277,11 @@ struct ValueTypeCheck<SmallInteger> {
     static bool test(Value v) { return v.is_embedded_integer(); }
 };
 
+template<>
+struct ValueTypeCheck<SmallFloat> {
+    static bool test(Value v) { return v.is_embedded_float(); }
+};
+
 // See definition of Number class.
 template<>
 struct ValueTypeCheck<Number> {
@@ -0,0 +1,78 @@
+#include "vm/objects/weak_map.hpp"
+
+#include "vm/error_utils.hpp"
+#include "vm/object_support/factory.hpp"
+#include "vm/object_support/type_desc.hpp"
+
+namespace tiro::vm {
+
+WeakMap WeakMap::make(Context& ctx) {
+    Scope sc(ctx);
+    Local table = sc.local(HashTable::make_weak(ctx));
+
+    Layout* data = create_object<WeakMap>(ctx, StaticSlotsInit());
+    data->write_static_slot(TableSlot, table);
+    return WeakMap(from_heap(data));
+}
+
+size_t WeakMap::size() {
+    return get_table().size();
+}
+
+bool WeakMap::contains(Value key) {
+    return get_table().contains(key);
+}
+
+std::optional<Value> WeakMap::get(Value key) {
+    return get_table().get(key);
+}
+
+Fallible<void> WeakMap::set(Context& ctx, Handle<Value> key, Handle<Value> value) {
+    TIRO_TRY_VOID(get_table().set(ctx, key, value));
+    return {};
+}
+
+void WeakMap::remove(Value key) {
+    get_table().remove(key);
+}
+
+void WeakMap::clear() {
+    get_table().clear();
+}
+
+HashTable WeakMap::get_table() {
+    return layout()->read_static_slot<HashTable>(TableSlot);
+}
+
+static void weak_map_size_impl(SyncFrameContext& frame) {
+    auto map = check_instance<WeakMap>(frame);
+    i64 size = static_cast<i64>(map->size());
+    frame.return_value(frame.ctx().get_integer(size));
+}
+
+static void weak_map_contains_impl(SyncFrameContext& frame) {
+    auto map = check_instance<WeakMap>(frame);
+    bool result = map->contains(*frame.arg(1));
+    frame.return_value(frame.ctx().get_boolean(result));
+}
+
+static void weak_map_clear_impl(SyncFrameContext& frame) {
+    auto map = check_instance<WeakMap>(frame);
+    map->clear();
+}
+
+static void weak_map_remove_impl(SyncFrameContext& frame) {
+    auto map = check_instance<WeakMap>(frame);
+    map->remove(*frame.arg(1));
+}
+
+static constexpr FunctionDesc weak_map_methods[] = {
+    FunctionDesc::method("size"sv, 1, weak_map_size_impl),
+    FunctionDesc::method("contains"sv, 2, weak_map_contains_impl),
+    FunctionDesc::method("clear"sv, 1, weak_map_clear_impl),
+    FunctionDesc::method("remove"sv, 2, weak_map_remove_impl),
+};
+
+constexpr TypeDesc weak_map_type_desc{"WeakMap"sv, weak_map_methods};
+
+} // namespace tiro::vm
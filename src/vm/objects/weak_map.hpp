@@ -0,0 +1,69 @@
+#ifndef TIRO_VM_OBJECTS_WEAK_MAP_HPP
+#define TIRO_VM_OBJECTS_WEAK_MAP_HPP
+
+#include "common/defs.hpp"
+#include "vm/handles/handle.hpp"
+#include "vm/object_support/fwd.hpp"
+#include "vm/object_support/layout.hpp"
+#include "vm/objects/fwd.hpp"
+#include "vm/objects/hash_table.hpp"
+#include "vm/objects/value.hpp"
+
+#include <optional>
+
+namespace tiro::vm {
+
+/// A map that does not keep its keys alive.
+/// An entry is removed by the garbage collector once its key is no longer reachable from
+/// anywhere else. Values are reachable for as long as their key is reachable, even if the value
+/// references the key (i.e. the entries are ephemerons).
+///
+/// Keys that are not heap objects (e.g. small integers) are never removed.
+/// Keys are compared like in a normal map, but only the key object that was used to insert
+/// an entry keeps the entry alive.
+class WeakMap final : public HeapValue {
+private:
+    enum Slots {
+        TableSlot,
+        SlotCount_,
+    };
+
+public:
+    using Layout = StaticLayout<StaticSlotsPiece<SlotCount_>>;
+
+    /// Creates a new, empty weak map.
+    static WeakMap make(Context& ctx);
+
+    explicit WeakMap(Value v)
+        : HeapValue(v, DebugCheck<WeakMap>()) {}
+
+    /// Returns the number of entries in this map. Entries with unreachable keys
+    /// are counted until they have been removed by the next garbage collection.
+    size_t size();
+
+    /// Returns true if the key is in the map.
+    bool contains(Value key);
+
+    /// Returns the value associated with the given key.
+    std::optional<Value> get(Value key);
+
+    /// Associates the given key with the given value.
+    Fallible<void> set(Context& ctx, Handle<Value> key, Handle<Value> value);
+
+    /// Removes the given key (and the value associated with it) from the map.
+    void remove(Value key);
+
+    /// Removes all entries from the map.
+    void clear();
+
+    Layout* layout() const { return access_heap<Layout>(); }
+
+private:
+    HashTable get_table();
+};
+
+extern const TypeDesc weak_map_type_desc;
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_OBJECTS_WEAK_MAP_HPP
@@ -0,0 +1,118 @@
+#include "vm/op_stats.hpp"
+
+#include "vm/objects/all.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+using nlohmann::ordered_json;
+
+namespace tiro::vm {
+
+static std::string_view op_name(CodeWord op) {
+    if (valid_quick_op(op))
+        return to_string(static_cast<QuickOp>(op));
+    return to_string(static_cast<BytecodeOp>(op));
+}
+
+OpStats::OpStats() {
+    if constexpr (enabled()) {
+        ops_.resize(code_op_limit);
+        pairs_.resize((code_op_limit + 1) * code_op_limit);
+    }
+}
+
+OpStats::~OpStats() {}
+
+void OpStats::enter_function(CodeFunctionTemplate tmpl) {
+    name_buffer_.clear();
+    name_buffer_ += tmpl.module().name().view();
+    name_buffer_ += '.';
+    name_buffer_ += tmpl.name().view();
+    function_counter_ = &functions_[name_buffer_];
+}
+
+void OpStats::reset() {
+    std::fill(ops_.begin(), ops_.end(), 0);
+    std::fill(pairs_.begin(), pairs_.end(), 0);
+    prev_op_ = code_op_limit;
+
+    // Keeps the entry of the current function alive (see function_counter_).
+    for (auto& [name, count] : functions_)
+        count = 0;
+    no_function_ = 0;
+}
+
+u64 OpStats::total() const {
+    return std::accumulate(ops_.begin(), ops_.end(), u64(0));
+}
+
+u64 OpStats::count(CodeWord op) const {
+    return op < ops_.size() ? ops_[op] : 0;
+}
+
+u64 OpStats::pair_count(CodeWord first, CodeWord second) const {
+    if (first >= code_op_limit || second >= code_op_limit || pairs_.empty())
+        return 0;
+    return pairs_[first * code_op_limit + second];
+}
+
+u64 OpStats::function_count(std::string_view name) const {
+    auto pos = functions_.find(std::string(name));
+    return pos != functions_.end() ? pos->second : 0;
+}
+
+std::string OpStats::to_json() const {
+    auto by_count = [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; };
+
+    std::vector<std::pair<CodeWord, u64>> ops;
+    for (CodeWord op = 0; op < ops_.size(); ++op) {
+        if (ops_[op] > 0)
+            ops.emplace_back(op, ops_[op]);
+    }
+    std::stable_sort(ops.begin(), ops.end(), by_count);
+
+    std::vector<std::pair<std::pair<CodeWord, CodeWord>, u64>> pairs;
+    if (!pairs_.empty()) {
+        for (CodeWord first = 0; first < code_op_limit; ++first) {
+            for (CodeWord second = 0; second < code_op_limit; ++second) {
+                if (u64 count = pair_count(first, second); count > 0)
+                    pairs.push_back({{first, second}, count});
+            }
+        }
+    }
+    std::stable_sort(pairs.begin(), pairs.end(), by_count);
+
+    std::vector<std::pair<std::string_view, u64>> functions;
+    for (const auto& [name, count] : functions_) {
+        if (count > 0)
+            functions.emplace_back(name, count);
+    }
+    std::sort(functions.begin(), functions.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+    });
+
+    ordered_json result = ordered_json::object();
+    result["enabled"] = enabled();
+    result["total"] = total();
+
+    auto& json_ops = result["ops"] = ordered_json::array();
+    for (const auto& [op, count] : ops)
+        json_ops.push_back({{"op", op_name(op)}, {"count", count}});
+
+    auto& json_pairs = result["pairs"] = ordered_json::array();
+    for (const auto& [ops_pair, count] : pairs) {
+        json_pairs.push_back({{"first", op_name(ops_pair.first)},
+            {"second", op_name(ops_pair.second)}, {"count", count}});
+    }
+
+    auto& json_functions = result["functions"] = ordered_json::array();
+    for (const auto& [name, count] : functions)
+        json_functions.push_back({{"function", name}, {"count", count}});
+
+    return result.dump(4);
+}
+
+} // namespace tiro::vm
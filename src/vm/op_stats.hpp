@@ -0,0 +1,90 @@
+#ifndef TIRO_VM_OP_STATS_HPP
+#define TIRO_VM_OP_STATS_HPP
+
+#include "bytecode/op.hpp"
+#include "common/defs.hpp"
+#include "vm/fwd.hpp"
+#include "vm/objects/function.hpp"
+#include "vm/quicken.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tiro::vm {
+
+/// Instruction statistics collected by the interpreter in instrumented builds (`TIRO_INSTRUMENT`).
+///
+/// For every executed instruction, the interpreter counts the opcode (quickened instructions are counted
+/// separately from their generic versions), the pair formed with the previously executed opcode
+/// and the function that contains the instruction.
+/// The statistics help to evaluate superinstructions, quickening and changes to the instruction encoding.
+///
+/// In normal builds the interpreter never calls into this class and no storage is allocated,
+/// `enabled()` returns false.
+class OpStats final {
+public:
+    /// Returns true if the interpreter was built with instrumentation.
+    static constexpr bool enabled() {
+#ifdef TIRO_INSTRUMENT
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    OpStats();
+    ~OpStats();
+
+    OpStats(const OpStats&) = delete;
+    OpStats& operator=(const OpStats&) = delete;
+
+    /// Called when the interpreter switches to a frame of the given function.
+    void enter_function(CodeFunctionTemplate tmpl);
+
+    /// Called for every instruction executed by the interpreter.
+    void record(CodeWord op) {
+        TIRO_DEBUG_ASSERT(op < code_op_limit, "invalid opcode");
+        ops_[op] += 1;
+        pairs_[prev_op_ * code_op_limit + op] += 1;
+        prev_op_ = op;
+        *function_counter_ += 1;
+    }
+
+    /// Discards all statistics collected so far.
+    void reset();
+
+    /// Total number of executed instructions.
+    u64 total() const;
+
+    /// Returns the number of executions of the given opcode (bytecode or quickened).
+    u64 count(CodeWord op) const;
+
+    /// Returns the number of executions of `second` immediately after `first`.
+    u64 pair_count(CodeWord first, CodeWord second) const;
+
+    /// Returns the number of instructions executed by the function with the given
+    /// qualified name (`module.function`).
+    u64 function_count(std::string_view name) const;
+
+    /// Returns the collected statistics as a json document. Opcodes, opcode pairs and
+    /// functions are sorted by their counts (in descending order).
+    std::string to_json() const;
+
+private:
+    std::vector<u64> ops_;
+    // Indexed by first * code_op_limit + second. The additional last row
+    // counts the first instruction after a reset.
+    std::vector<u64> pairs_;
+    CodeWord prev_op_ = code_op_limit;
+
+    // Node based map for stable value addresses.
+    std::unordered_map<std::string, u64> functions_;
+    u64 no_function_ = 0;                   // Counter before the first function was entered
+    u64* function_counter_ = &no_function_; // Counter of the current function
+    std::string name_buffer_;
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_OP_STATS_HPP
@@ -0,0 +1,173 @@
+#include "vm/profiler.hpp"
+
+#include "vm/context.hpp"
+#include "vm/objects/all.hpp"
+
+#include <algorithm>
+
+namespace tiro::vm {
+
+static void append_function_name(std::string& buffer, CoroutineFrame* frame) {
+    switch (frame->type) {
+    case FrameType::Code: {
+        auto tmpl = static_cast<CodeFrame*>(frame)->tmpl;
+        buffer += tmpl.module().name().view();
+        buffer += '.';
+        buffer += tmpl.name().view();
+        return;
+    }
+    case FrameType::Resumable:
+        buffer += static_cast<ResumableFrame*>(frame)->func.name().view();
+        return;
+    case FrameType::Catch:
+        buffer += "<catch panic>";
+        return;
+    }
+    TIRO_UNREACHABLE("invalid frame type");
+}
+
+// Appends the source line of the frame's current instruction, if known.
+static void append_line(std::string& buffer, CoroutineFrame* frame) {
+    if (frame->type != FrameType::Code)
+        return;
+
+    auto code_frame = static_cast<CodeFrame*>(frame);
+    auto lines = code_frame->tmpl.lines();
+    if (!lines)
+        return;
+
+    // The pc points past the opcode of the current instruction (or to the first instruction).
+    const auto offset = static_cast<u32>(code_frame->pc - code_frame->tmpl.code().data());
+    const u32 line = lines.value().find_line(offset > 0 ? offset - 1 : 0);
+    if (line > 0) {
+        buffer += ':';
+        buffer += std::to_string(line);
+    }
+}
+
+// Collects the frames of the given stack, from the outermost to the innermost frame.
+static void collect_frames(std::vector<CoroutineFrame*>& frames, CoroutineStack stack) {
+    frames.clear();
+    for (auto frame = stack.top_frame(); frame; frame = frame->caller())
+        frames.push_back(frame);
+    std::reverse(frames.begin(), frames.end());
+}
+
+static std::string format_folded_stacks(const absl::flat_hash_map<std::string, u64>& stacks) {
+    std::vector<std::pair<std::string_view, u64>> entries(stacks.begin(), stacks.end());
+    std::sort(entries.begin(), entries.end());
+
+    std::string result;
+    for (const auto& [stack, count] : entries) {
+        result += stack;
+        result += ' ';
+        result += std::to_string(count);
+        result += '\n';
+    }
+    return result;
+}
+
+Profiler::Profiler()
+    : interval_(default_interval) {}
+
+Profiler::~Profiler() {}
+
+void Profiler::start(std::chrono::microseconds interval) {
+    TIRO_CHECK(interval.count() > 0, "the sampling interval must be positive");
+    active_ = true;
+    interval_ = interval;
+    next_sample_ = Clock::now() + interval_;
+}
+
+void Profiler::stop() {
+    active_ = false;
+}
+
+void Profiler::reset() {
+    stacks_.clear();
+    sample_count_ = 0;
+}
+
+void Profiler::sample(Coroutine coro, CoroutineStack stack) {
+    TIRO_DEBUG_ASSERT(active_, "profiler must be active");
+    next_sample_ = Clock::now() + interval_;
+
+    collect_frames(frames_, stack);
+
+    buffer_.clear();
+    buffer_ += coro.name().view();
+    for (auto frame : frames_) {
+        buffer_ += ';';
+        append_function_name(buffer_, frame);
+        append_line(buffer_, frame);
+    }
+
+    stacks_[buffer_] += 1;
+    sample_count_ += 1;
+}
+
+std::string Profiler::folded_stacks() const {
+    return format_folded_stacks(stacks_);
+}
+
+AllocationProfiler::AllocationProfiler(Context& ctx)
+    : ctx_(ctx) {}
+
+AllocationProfiler::~AllocationProfiler() {
+    stop();
+}
+
+void AllocationProfiler::start(size_t interval) {
+    TIRO_CHECK(interval > 0, "the sampling interval must be positive");
+    active_ = true;
+    ctx_.heap().sample_allocations(this, interval);
+}
+
+void AllocationProfiler::stop() {
+    if (!active_)
+        return;
+
+    active_ = false;
+    ctx_.heap().sample_allocations(nullptr, 0);
+}
+
+void AllocationProfiler::reset() {
+    stacks_.clear();
+    sample_count_ = 0;
+    sampled_bytes_ = 0;
+}
+
+void AllocationProfiler::allocation_sampled(Header* object, size_t weight) {
+    TIRO_DEBUG_ASSERT(active_, "profiler must be active");
+
+    buffer_.clear();
+    auto coro = ctx_.interpreter().current_coroutine();
+    auto stack = coro ? coro.value().stack() : Nullable<CoroutineStack>();
+    if (stack) {
+        collect_frames(frames_, stack.value());
+        const size_t skip = frames_.size() > max_frames ? frames_.size() - max_frames : 0;
+
+        buffer_ += coro.value().name().view();
+        if (skip > 0)
+            buffer_ += ";...";
+        for (size_t i = skip; i < frames_.size(); ++i) {
+            buffer_ += ';';
+            append_function_name(buffer_, frames_[i]);
+            append_line(buffer_, frames_[i]);
+        }
+    } else {
+        buffer_ += "<native>";
+    }
+    buffer_ += ';';
+    buffer_ += to_string(HeapValue(object).type());
+
+    stacks_[buffer_] += weight;
+    sample_count_ += 1;
+    sampled_bytes_ += weight;
+}
+
+std::string AllocationProfiler::folded_stacks() const {
+    return format_folded_stacks(stacks_);
+}
+
+} // namespace tiro::vm
@@ -0,0 +1,152 @@
+#ifndef TIRO_VM_PROFILER_HPP
+#define TIRO_VM_PROFILER_HPP
+
+#include "common/defs.hpp"
+#include "vm/fwd.hpp"
+#include "vm/heap/heap.hpp"
+#include "vm/objects/coroutine.hpp"
+#include "vm/objects/coroutine_stack.hpp"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace tiro::vm {
+
+/// A sampling profiler for tiro code.
+///
+/// While the profiler is active, the interpreter checks at every safepoint (function calls and
+/// loop backedges) whether the sampling interval has elapsed. If it has, the call stack of the
+/// running coroutine is recorded. Code frames include the source line of the current instruction,
+/// if the function was compiled with line information. Samples are aggregated by their call stack
+/// and can be exported in the "folded stacks" format understood by flamegraph tools,
+/// i.e. one line per distinct stack:
+///
+///     <coroutine>;<module>.<outermost function>:<line>;...;<module>.<innermost function>:<line> <count>
+///
+/// Sampling at safepoints means that time spent in native functions (or in machine code generated by the jit)
+/// is attributed to the next safepoint reached by the interpreter. Samples are never taken from a signal handler,
+/// which keeps the profiler independent of the platform and allows it to inspect the heap without synchronization.
+///
+/// The cost of an inactive profiler is a single branch per safepoint.
+class Profiler final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// The default sampling interval.
+    static constexpr std::chrono::microseconds default_interval{1000};
+
+    Profiler();
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /// Returns true if the profiler is currently collecting samples.
+    bool active() const { return active_; }
+
+    /// Starts collecting samples with the given interval. Samples from earlier runs are retained.
+    void start(std::chrono::microseconds interval = default_interval);
+
+    /// Stops collecting samples.
+    void stop();
+
+    /// Discards all samples collected so far.
+    void reset();
+
+    /// Returns true if a sample should be taken at the current safepoint.
+    bool sample_due() const { return active_ && Clock::now() >= next_sample_; }
+
+    /// Records the call stack of the given coroutine. `stack` is the coroutine's current stack.
+    void sample(Coroutine coro, CoroutineStack stack);
+
+    /// The total number of samples collected since the last reset.
+    u64 sample_count() const { return sample_count_; }
+
+    /// Returns the collected samples in the folded stacks format (sorted by stack).
+    std::string folded_stacks() const;
+
+private:
+    bool active_ = false;
+    Clock::duration interval_;
+    Clock::time_point next_sample_;
+    u64 sample_count_ = 0;
+
+    // Sample counts, indexed by the folded call stack.
+    absl::flat_hash_map<std::string, u64> stacks_;
+
+    // Reused buffers to avoid allocations while sampling.
+    std::vector<CoroutineFrame*> frames_;
+    std::string buffer_;
+};
+
+/// A sampling allocation profiler for tiro code.
+///
+/// While the profiler is active, the heap reports a sample of the allocated objects (on average
+/// one object every `interval` bytes, see `Heap::sample_allocations()`). For every sample,
+/// the innermost frames of the running coroutine and the type of the allocated object are recorded.
+/// Code frames include the source line of the current instruction, if the function was compiled
+/// with line information. Samples are aggregated by stack and exported in the folded stacks format,
+/// weighted by the estimated number of allocated bytes:
+///
+///     <coroutine>;<module>.<function>:<line>;...;<type> <bytes>
+///
+/// Objects allocated while no coroutine is running (e.g. by native code) are attributed to `<native>`.
+///
+/// The cost of an inactive profiler is a single branch per allocation.
+class AllocationProfiler final : public AllocationObserver {
+public:
+    /// The default (average) sampling interval, in bytes.
+    static constexpr size_t default_interval = 512 * 1024;
+
+    /// The maximum number of recorded frames per sample. Outer frames are omitted from deeper stacks.
+    static constexpr size_t max_frames = 64;
+
+    explicit AllocationProfiler(Context& ctx);
+    ~AllocationProfiler();
+
+    AllocationProfiler(const AllocationProfiler&) = delete;
+    AllocationProfiler& operator=(const AllocationProfiler&) = delete;
+
+    /// Returns true if the profiler is currently collecting samples.
+    bool active() const { return active_; }
+
+    /// Starts collecting samples with the given interval. Samples from earlier runs are retained.
+    void start(size_t interval = default_interval);
+
+    /// Stops collecting samples.
+    void stop();
+
+    /// Discards all samples collected so far.
+    void reset();
+
+    /// The total number of samples collected since the last reset.
+    u64 sample_count() const { return sample_count_; }
+
+    /// The estimated number of bytes allocated while the profiler was active (since the last reset).
+    u64 sampled_bytes() const { return sampled_bytes_; }
+
+    /// Returns the collected samples in the folded stacks format (sorted by stack).
+    std::string folded_stacks() const;
+
+    void allocation_sampled(Header* object, size_t weight) override;
+
+private:
+    Context& ctx_;
+    bool active_ = false;
+    u64 sample_count_ = 0;
+    u64 sampled_bytes_ = 0;
+
+    // Estimated allocated bytes, indexed by the folded call stack.
+    absl::flat_hash_map<std::string, u64> stacks_;
+
+    // Reused buffers to avoid allocations while sampling.
+    std::vector<CoroutineFrame*> frames_;
+    std::string buffer_;
+};
+
+} // namespace tiro::vm
+
+#endif // TIRO_VM_PROFILER_HPP
@@ -0,0 +1,137 @@
+#include "vm/quicken.hpp"
+
+#include "vm/objects/primitives.hpp"
+
+namespace tiro::vm {
+
+static constexpr CodeWord first_quick_op = static_cast<CodeWord>(QuickOp::AddSmallInt);
+static constexpr CodeWord last_quick_op = static_cast<CodeWord>(QuickOp::LteFloat);
+
+bool valid_quick_op(CodeWord op) {
+    return op >= first_quick_op && op <= last_quick_op;
+}
+
+BytecodeOp generic_op(QuickOp op) {
+    switch (op) {
+    case QuickOp::AddSmallInt:
+    case QuickOp::AddFloat:
+        return BytecodeOp::Add;
+    case QuickOp::SubSmallInt:
+    case QuickOp::SubFloat:
+        return BytecodeOp::Sub;
+    case QuickOp::MulSmallInt:
+    case QuickOp::MulFloat:
+        return BytecodeOp::Mul;
+    case QuickOp::DivFloat:
+        return BytecodeOp::Div;
+    case QuickOp::ModSmallInt:
+        return BytecodeOp::Mod;
+    case QuickOp::GtSmallInt:
+    case QuickOp::GtFloat:
+        return BytecodeOp::Gt;
+    case QuickOp::GteSmallInt:
+    case QuickOp::GteFloat:
+        return BytecodeOp::Gte;
+    case QuickOp::LtSmallInt:
+    case QuickOp::LtFloat:
+        return BytecodeOp::Lt;
+    case QuickOp::LteSmallInt:
+    case QuickOp::LteFloat:
+        return BytecodeOp::Lte;
+    case QuickOp::EqSmallInt:
+        return BytecodeOp::Eq;
+    case QuickOp::NEqSmallInt:
+        return BytecodeOp::NEq;
+    }
+    TIRO_UNREACHABLE("invalid quickened opcode");
+}
+
+static std::optional<QuickOp> select_small_int_op(BytecodeOp op) {
+    switch (op) {
+    case BytecodeOp::Add:
+        return QuickOp::AddSmallInt;
+    case BytecodeOp::Sub:
+        return QuickOp::SubSmallInt;
+    case BytecodeOp::Mul:
+        return QuickOp::MulSmallInt;
+    case BytecodeOp::Mod:
+        return QuickOp::ModSmallInt;
+    case BytecodeOp::Gt:
+        return QuickOp::GtSmallInt;
+    case BytecodeOp::Gte:
+        return QuickOp::GteSmallInt;
+    case BytecodeOp::Lt:
+        return QuickOp::LtSmallInt;
+    case BytecodeOp::Lte:
+        return QuickOp::LteSmallInt;
+    case BytecodeOp::Eq:
+        return QuickOp::EqSmallInt;
+    case BytecodeOp::NEq:
+        return QuickOp::NEqSmallInt;
+    default:
+        return {};
+    }
+}
+
+static std::optional<QuickOp> select_float_op(BytecodeOp op) {
+    switch (op) {
+    case BytecodeOp::Add:
+        return QuickOp::AddFloat;
+    case BytecodeOp::Sub:
+        return QuickOp::SubFloat;
+    case BytecodeOp::Mul:
+        return QuickOp::MulFloat;
+    case BytecodeOp::Div:
+        return QuickOp::DivFloat;
+    case BytecodeOp::Gt:
+        return QuickOp::GtFloat;
+    case BytecodeOp::Gte:
+        return QuickOp::GteFloat;
+    case BytecodeOp::Lt:
+        return QuickOp::LtFloat;
+    case BytecodeOp::Lte:
+        return QuickOp::LteFloat;
+    default:
+        return {};
+    }
+}
+
+std::optional<QuickOp> select_quick_op(BytecodeOp op, Value lhs, Value rhs) {
+    if (lhs.is_embedded_integer() && rhs.is_embedded_integer())
+        return select_small_int_op(op);
+    if (lhs.is<Float>() && rhs.is<Float>())
+        return select_float_op(op);
+    return {};
+}
+
+std::string_view to_string(QuickOp op) {
+    switch (op) {
+#define TIRO_CASE(name) \
+    case QuickOp::name:  \
+        return #name;
+
+        TIRO_CASE(AddSmallInt)
+        TIRO_CASE(SubSmallInt)
+        TIRO_CASE(MulSmallInt)
+        TIRO_CASE(ModSmallInt)
+        TIRO_CASE(GtSmallInt)
+        TIRO_CASE(GteSmallInt)
+        TIRO_CASE(LtSmallInt)
+        TIRO_CASE(LteSmallInt)
+        TIRO_CASE(EqSmallInt)
+        TIRO_CASE(NEqSmallInt)
+        TIRO_CASE(AddFloat)
+        TIRO_CASE(SubFloat)
+        TIRO_CASE(MulFloat)
+        TIRO_CASE(DivFloat)
+        TIRO_CASE(GtFloat)
+        TIRO_CASE(GteFloat)
+        TIRO_CASE(LtFloat)
+        TIRO_CASE(LteFloat)
+
+#undef TIRO_CASE
+    }
+    TIRO_UNREACHABLE("invalid quickened opcode");
+}
+
+} // namespace tiro::vm
@@ -0,0 +1,68 @@
+#ifndef TIRO_VM_QUICKEN_HPP
+#define TIRO_VM_QUICKEN_HPP
+
+#include "bytecode/op.hpp"
+#include "vm/fwd.hpp"
+#include "vm/objects/function.hpp"
+#include "vm/objects/value.hpp"
+
+#include <optional>
+#include <string_view>
+
+namespace tiro::vm {
+
+/// Specialized ("quickened") instructions that only exist in translated code.
+///
+/// The interpreter rewrites generic arithmetic and comparison instructions into one of
+/// these after their first execution, based on the types of the observed operands (see `select_quick_op()`).
+/// A quickened instruction has exactly the same operands as the generic instruction it replaces.
+/// Its fast path works directly on the unboxed operand values. If the operands do not have the
+/// expected types (or the result cannot be produced cheaply, e.g. on overflow), the instruction rewrites
+/// itself back to its generic version (see `generic_op()`) and executes that instead.
+///
+/// Quickened opcodes are numbered after the last bytecode opcode, so both kinds of opcodes
+/// can share a single dispatch table.
+enum class QuickOp : CodeWord {
+    // Operands are small integers.
+    AddSmallInt = static_cast<CodeWord>(BytecodeOp::AssertFail) + 1,
+    SubSmallInt,
+    MulSmallInt,
+    ModSmallInt,
+    GtSmallInt,
+    GteSmallInt,
+    LtSmallInt,
+    LteSmallInt,
+    EqSmallInt,
+    NEqSmallInt,
+
+    // Operands are floats.
+    AddFloat,
+    SubFloat,
+    MulFloat,
+    DivFloat,
+    GtFloat,
+    GteFloat,
+    LtFloat,
+    LteFloat,
+};
+
+/// One past the largest opcode value (bytecode or quickened) that can appear in translated code.
+inline constexpr CodeWord code_op_limit = static_cast<CodeWord>(QuickOp::LteFloat) + 1;
+
+/// Returns true if `op` is the value of a quickened opcode.
+bool valid_quick_op(CodeWord op);
+
+/// Returns the generic instruction that was replaced by the given quickened instruction.
+BytecodeOp generic_op(QuickOp op);
+
+/// Returns the quickened version of the generic instruction `op` for the given operand types, or an
+/// empty optional if there is no specialized instruction for that combination.
+std::optional<QuickOp> select_quick_op(BytecodeOp op, Value lhs, Value rhs);
+
+std::string_view to_string(QuickOp op);
+
+} // namespace tiro::vm
+
+TIRO_ENABLE_FREE_TO_STRING(tiro::vm::QuickOp)
+
+#endif // TIRO_VM_QUICKEN_HPP
@@ -17,7 +17,7 @@ void RootSet::init(Context& ctx) {
     true_ = Boolean::make(ctx, true);
     false_ = Boolean::make(ctx, false);
     undefined_ = Undefined::make(ctx);
-    interned_strings_ = HashTable::make(ctx);
+    interned_strings_ = HashTable::make_weak(ctx);
 
     modules_.init(ctx);
     types_.init_public(ctx);
@@ -12,6 +12,8 @@
 #include "vm/objects/value.hpp"
 #include "vm/type_system.hpp"
 
+#include <string_view>
+
 namespace tiro::vm {
 
 /// Contains the gc roots.
@@ -46,12 +48,17 @@ public:
     template<typename Tracer>
     inline void trace(Tracer&& tracer);
 
+    /// Visits the same roots as `trace()`, but calls `label(std::string_view)` with a short description
+    /// before every group of roots (used by heap snapshots).
+    template<typename Labeler, typename Tracer>
+    inline void trace_labelled(Labeler&& label, Tracer&& tracer);
+
 private:
     Nullable<Boolean> true_;
     Nullable<Boolean> false_;
     Nullable<Undefined> undefined_;
     Nullable<Coroutine> first_ready_, last_ready_; // Linked list of runnable coroutines
-    Nullable<HashTable> interned_strings_;         // TODO this should eventually be a weak map
+    Nullable<HashTable> interned_strings_;         // Weak map from interned strings to their symbols
 
     // Stack of values used for Scope/Local instances.
     RootedStack stack_;
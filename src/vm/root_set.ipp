@@ -7,17 +7,36 @@ namespace tiro::vm {
 
 template<typename Tracer>
 void RootSet::trace(Tracer&& tracer) {
+    trace_labelled([](std::string_view) {}, tracer);
+}
+
+template<typename Labeler, typename Tracer>
+void RootSet::trace_labelled(Labeler&& label, Tracer&& tracer) {
+    label("constants");
     tracer(true_);
     tracer(false_);
     tracer(undefined_);
+
+    label("ready coroutines");
     tracer(first_ready_);
     tracer(last_ready_);
+
+    label("interned strings");
     tracer(interned_strings_);
 
+    label("scopes");
     stack_.trace(tracer);
+
+    label("externals");
     externals_.trace(tracer);
+
+    label("types");
     types_.trace(tracer);
+
+    label("modules");
     modules_.trace(tracer);
+
+    label("interpreter");
     interpreter_.trace(tracer);
 }
 
@@ -278,7 +278,6 @@ void TypeSystem::init_internal(Context& ctx) {
         TIRO_INIT(CoroutineToken);
         TIRO_INIT(Environment);
         TIRO_INIT(Exception);
-        TIRO_INIT(Float);
         TIRO_INIT(HandlerTable);
         TIRO_INIT(HashTable);
         TIRO_INIT(HashTableIterator);
@@ -287,7 +286,9 @@ void TypeSystem::init_internal(Context& ctx) {
         TIRO_INIT(HashTableStorage);
         TIRO_INIT(HashTableValueIterator);
         TIRO_INIT(HashTableValueView);
+        TIRO_INIT(HeapFloat);
         TIRO_INIT(HeapInteger);
+        TIRO_INIT(LineTable);
         TIRO_INIT(MagicFunction);
         TIRO_INIT(Method);
         TIRO_INIT(Module);
@@ -300,6 +301,7 @@ void TypeSystem::init_internal(Context& ctx) {
         TIRO_INIT(Result);
         TIRO_INIT(Set);
         TIRO_INIT(SetIterator);
+        TIRO_INIT(SmallFloat);
         TIRO_INIT(SmallInteger);
         TIRO_INIT(String);
         TIRO_INIT(StringBuilder);
@@ -311,6 +313,7 @@ void TypeSystem::init_internal(Context& ctx) {
         TIRO_INIT(Type);
         TIRO_INIT(Undefined);
         TIRO_INIT(UnresolvedImport);
+        TIRO_INIT(WeakMap);
         // [[[end]]]
 
 #undef TIRO_INIT
@@ -365,6 +368,7 @@ void TypeSystem::init_public(Context& ctx) {
     TIRO_INIT(Tuple, from_desc(ctx, tuple_type_desc));
     TIRO_INIT(TupleIterator, simple_type(ctx, "TupleIterator"));
     TIRO_INIT(Type, from_desc(ctx, type_type_desc));
+    TIRO_INIT(WeakMap, from_desc(ctx, weak_map_type_desc));
 
 #undef TIRO_INIT
 
@@ -397,6 +401,9 @@ Type TypeSystem::type_of(Handle<Value> object) {
     case ValueCategory::EmbeddedInteger:
         public_type = type_of(PublicType::Integer);
         break;
+    case ValueCategory::EmbeddedFloat:
+        public_type = type_of(PublicType::Float);
+        break;
     case ValueCategory::Heap:
         public_type = HeapValue(*object).type_instance().public_type();
         break;
@@ -454,6 +461,13 @@ Fallible<Value> TypeSystem::load_index(Context& ctx, Handle<Value> object, Handl
         }
         return Value::null();
     }
+    case ValueType::WeakMap: {
+        Handle map = object.must_cast<WeakMap>();
+        if (auto found = map->get(index.get())) {
+            return *found;
+        }
+        return Value::null();
+    }
     default:
         return get_index_not_supported_exception(ctx, object);
     }
@@ -502,6 +516,11 @@ Fallible<void> TypeSystem::store_index(
         TIRO_TRY_VOID(table->set(ctx, index, value));
         break;
     }
+    case ValueType::WeakMap: {
+        Handle map = object.must_cast<WeakMap>();
+        TIRO_TRY_VOID(map->set(ctx, index, value));
+        break;
+    }
     default:
         return set_index_not_supported_exception(ctx, object);
     }
@@ -86,6 +86,29 @@ class InstrParam:
     def raw_size(self):
         return TYPE_SIZES[self.raw_type]
 
+    @property
+    def operand(self):
+        class Visitor:
+            def visit_Local(self, local):
+                return "Local"
+
+            def visit_Param(self, param):
+                return "Param"
+
+            def visit_Module(self, module):
+                return "Module"
+
+            def visit_Offset(self, offset):
+                return "Offset"
+
+            def visit_Integer(self, i):
+                return i.int_type.upper()
+
+            def visit_Float(self, f):
+                return f.float_type.upper()
+
+        return visit_instr_param(self, Visitor())
+
     @property
     def description(self):
         class Visitor:
@@ -533,6 +556,29 @@ InstructionList = [
             After the call, a single return value will be left on the stack."""
         ),
     ),
+    Instr(
+        "TailCall",
+        [Local("function"), Integer("count", "u32")],
+        doc=dedent(
+            """\
+            Call the given function with the topmost count arguments on the stack
+            and return its result from the current function (a call in tail position).
+
+            The current function's frame may be replaced by the callee's frame, in which case
+            the instructions following this one are never executed. Otherwise, this instruction behaves
+            exactly like Call. It must therefore be followed by the same instructions as a Call in
+            tail position (i.e. PopTo and Return)."""
+        ),
+    ),
+    Instr(
+        "TailCallMethod",
+        [Local("method"), Integer("count", "u32")],
+        doc=dedent(
+            """\
+            Like CallMethod, but for calls in tail position. The current function's frame may
+            be replaced by the callee's frame (see TailCall)."""
+        ),
+    ),
     Instr("Return", [Local("value")], doc="Returns the value to the calling function."),
     Instr(
         "Rethrow",
@@ -171,7 +171,11 @@ def gather_public_types(root):
             # ----------
             Node("Null", public=True),
             Node("Boolean", public=True),
-            Node("Float", public=True),
+            Node(
+                "Float",
+                public=True,
+                children=[Node("HeapFloat"), Node("SmallFloat")],
+            ),
             Node(
                 "Integer",
                 public=True,
@@ -202,6 +206,7 @@ def gather_public_types(root):
             Node("Environment"),
             Node("CodeFunctionTemplate"),
             Node("HandlerTable"),
+            Node("LineTable"),
             #
             # Types
             # -----
@@ -228,6 +233,7 @@ def gather_public_types(root):
             Node("SetIterator", public=True),
             Node("Tuple", public=True),
             Node("TupleIterator", public=True),
+            Node("WeakMap", public=True),
             #
             # Native objects
             # --------------
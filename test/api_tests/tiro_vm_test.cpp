@@ -148,6 +148,42 @@ TEST_CASE("Virtual machine should support maximum heap size", "[api]") {
     }
 }
 
+TEST_CASE("Virtual machine should validate garbage collection settings", "[api]") {
+    tiro_vm_settings_t settings;
+    tiro_vm_settings_init(&settings);
+    REQUIRE(settings.gc_min_nursery_size == 0);
+    REQUIRE(settings.gc_heap_growth == 0.25);
+    REQUIRE(settings.gc_time_ratio == 0.05);
+    REQUIRE(settings.gc_heap_headroom == 0.1);
+
+    struct Holder {
+        tiro_vm_t vm = nullptr;
+        ~Holder() { tiro_vm_free(vm); }
+    };
+
+    SECTION("Custom values are accepted") {
+        Holder holder;
+        settings.gc_min_nursery_size = 4 << 20;
+        settings.gc_heap_growth = 2;
+        settings.gc_time_ratio = 0;
+        settings.gc_heap_headroom = 0;
+        tiro_vm_t& vm = holder.vm = tiro_vm_new(&settings, tiro::error_adapter());
+        REQUIRE(vm != nullptr);
+    }
+
+    SECTION("Invalid values are rejected") {
+        SECTION("Negative heap growth") { settings.gc_heap_growth = -1; }
+        SECTION("GC time ratio too large") { settings.gc_time_ratio = 1.5; }
+        SECTION("Heap headroom too large") { settings.gc_heap_headroom = 1; }
+
+        Holder holder;
+        tiro_errc_t errc = TIRO_OK;
+        holder.vm = tiro_vm_new(&settings, error_observer(errc));
+        REQUIRE(holder.vm == nullptr);
+        REQUIRE(errc == TIRO_ERROR_BAD_ARG);
+    }
+}
+
 TEST_CASE("Virtual machine supports userdata", "[api]") {
     tiro_vm_settings_t settings;
     tiro_vm_settings_init(&settings);
@@ -332,3 +368,31 @@ TEST_CASE("Global handle should return the address of their owning vm", "[api]")
     REQUIRE(global != nullptr);
     REQUIRE(tiro_global_get_vm(global) == h.vm);
 }
+
+TEST_CASE("Profiler functions should report invalid arguments", "[api]") {
+    tiro_errc_t errc = TIRO_OK;
+    tiro_vm_profiler_start(nullptr, 0, error_observer(errc));
+    REQUIRE(errc == TIRO_ERROR_BAD_ARG);
+
+    tiro::vm vm;
+    errc = TIRO_OK;
+    tiro_vm_profiler_folded_stacks(vm.raw_vm(), nullptr, error_observer(errc));
+    REQUIRE(errc == TIRO_ERROR_BAD_ARG);
+}
+
+TEST_CASE("Instruction statistics should only be available in instrumented builds", "[api]") {
+    tiro::vm vm;
+
+    // The api does not expose whether the library was built with instrumentation.
+    char* result = nullptr;
+    tiro_errc_t errc = TIRO_OK;
+    tiro_vm_op_stats(vm.raw_vm(), &result, error_observer(errc));
+    if (errc == TIRO_OK) {
+        REQUIRE(result != nullptr);
+        REQUIRE(std::string_view(result).find("\"total\"") != std::string_view::npos);
+        std::free(result);
+    } else {
+        REQUIRE(errc == TIRO_ERROR_BAD_STATE);
+        REQUIRE(result == nullptr);
+    }
+}
@@ -75,3 +75,206 @@ TEST_CASE("tiropp::vm should support stdout redirection", "[api]") {
     REQUIRE(messages[0] == "Hello\n");
     REQUIRE(messages[1] == "World\n");
 }
+
+TEST_CASE("tiropp::vm should support sampling profiles", "[api]") {
+    tiro::vm vm;
+    vm.load_std();
+    vm.load(test_compile("test", R"(
+        func fib(n) {
+            if (n <= 1) {
+                return n;
+            }
+            return fib(n - 1) + fib(n - 2);
+        }
+
+        export func main() {
+            return fib(20);
+        }
+    )"));
+
+    REQUIRE(vm.profiler_folded_stacks().empty());
+
+    vm.start_profiler(std::chrono::microseconds(1));
+    tiro::function main = tiro::get_export(vm, "test", "main").as<tiro::function>();
+    tiro::coroutine coro = tiro::make_coroutine(vm, main);
+    coro.start();
+    vm.run_ready();
+    vm.stop_profiler();
+
+    std::string folded = vm.profiler_folded_stacks();
+    REQUIRE(folded.find(";test.fib:6;test.fib:") != std::string::npos);
+
+    vm.reset_profiler();
+    REQUIRE(vm.profiler_folded_stacks().empty());
+}
+
+TEST_CASE("tiropp::vm should support the allocation profiler", "[api]") {
+    tiro::vm vm;
+    vm.load_std();
+    vm.load(test_compile("test", R"(
+        export func main() {
+            const values = [];
+            for var i = 0; i < 1000; i += 1 {
+                values.append((i, i));
+            }
+            return values;
+        }
+    )"));
+
+    REQUIRE(vm.alloc_profiler_folded_stacks().empty());
+
+    vm.start_alloc_profiler(256);
+    tiro::function main = tiro::get_export(vm, "test", "main").as<tiro::function>();
+    tiro::coroutine coro = tiro::make_coroutine(vm, main);
+    coro.start();
+    vm.run_ready();
+    vm.stop_alloc_profiler();
+
+    std::string folded = vm.alloc_profiler_folded_stacks();
+    REQUIRE(folded.find(";test.main:5;Tuple ") != std::string::npos);
+
+    vm.reset_alloc_profiler();
+    REQUIRE(vm.alloc_profiler_folded_stacks().empty());
+}
+
+TEST_CASE("tiropp::vm should export heap snapshots", "[api]") {
+    tiro::vm vm;
+    vm.load_std();
+    vm.load(test_compile("test", R"(
+        export const greeting = "hello snapshot";
+    )"));
+
+    std::string snapshot = vm.heap_snapshot();
+    REQUIRE(snapshot.rfind("{\"version\":1,", 0) == 0);
+    REQUIRE(snapshot.find("\"module test\"") != std::string::npos);
+    REQUIRE(snapshot.find("\"hello snapshot\"") != std::string::npos);
+}
+
+TEST_CASE("tiropp::vm should reject scheduling limits that do not fit into 32 bits", "[api]") {
+    using namespace std::chrono_literals;
+
+    {
+        tiro::vm_settings settings;
+        settings.coroutine_time_slice = 2h;
+        REQUIRE_THROWS_AS(tiro::vm(settings), tiro::error);
+    }
+
+    {
+        tiro::vm_settings settings;
+        settings.run_ready_budget = -1ms;
+        REQUIRE_THROWS_AS(tiro::vm(settings), tiro::error);
+    }
+
+    tiro::vm_settings settings;
+    settings.coroutine_time_slice = 1h;
+    settings.run_ready_budget = 1h;
+    REQUIRE_NOTHROW(tiro::vm(settings));
+}
+
+TEST_CASE("tiropp::vm should return from run_ready() when the budget is exhausted", "[api]") {
+    tiro::vm_settings settings;
+    settings.run_ready_budget = std::chrono::milliseconds(1);
+
+    tiro::vm vm(settings);
+    vm.load_std();
+    vm.load(test_compile("test", R"(
+        export func spin() {
+            while (true) {}
+        }
+    )"));
+
+    tiro::function spin = tiro::get_export(vm, "test", "spin").as<tiro::function>();
+    tiro::coroutine coro = tiro::make_coroutine(vm, spin);
+    coro.start();
+
+    for (int i = 0; i < 3; ++i) {
+        vm.run_ready();
+        REQUIRE(vm.has_ready());
+        REQUIRE_FALSE(coro.completed());
+    }
+}
+
+TEST_CASE("tiropp::vm should preempt coroutines after their time slice", "[api]") {
+    tiro::vm_settings settings;
+    settings.coroutine_time_slice = std::chrono::milliseconds(1);
+
+    tiro::vm vm(settings);
+    vm.load_std();
+    vm.load(test_compile("test", R"(
+        var started = false;
+        var done = false;
+
+        // Never completes without preemption, because `stop` cannot run while `spin` is running.
+        export func spin() {
+            started = true;
+            while (!done) {}
+        }
+
+        export func stop() {
+            done = started;
+        }
+    )"));
+
+    tiro::function spin = tiro::get_export(vm, "test", "spin").as<tiro::function>();
+    tiro::function stop = tiro::get_export(vm, "test", "stop").as<tiro::function>();
+    tiro::coroutine spin_coro = tiro::make_coroutine(vm, spin);
+    tiro::coroutine stop_coro = tiro::make_coroutine(vm, stop);
+    spin_coro.start();
+    stop_coro.start();
+
+    vm.run_ready();
+    REQUIRE_FALSE(vm.has_ready());
+    REQUIRE(spin_coro.completed());
+    REQUIRE(stop_coro.completed());
+}
+
+TEST_CASE("tiropp::vm should report garbage collection statistics", "[api]") {
+    std::vector<tiro::gc_event> events;
+
+    tiro::vm_settings settings;
+    settings.gc_min_nursery_size = 64 << 10;
+    settings.gc_time_ratio = 0;
+    settings.gc_callback = [&](const tiro::gc_event& event) { events.push_back(event); };
+
+    tiro::vm vm(settings);
+    vm.load_std();
+    vm.load(test_compile("test", R"(
+        export func main() {
+            const items = [];
+            var i = 0;
+            while (i < 20000) {
+                items.append("item ${i}");
+                i += 1;
+            }
+            return items.size();
+        }
+    )"));
+
+    tiro::function main = tiro::get_export(vm, "test", "main").as<tiro::function>();
+    tiro::coroutine coro = tiro::make_coroutine(vm, main);
+    coro.start();
+    vm.run_ready();
+    REQUIRE(coro.completed());
+
+    REQUIRE(events.size() > 0);
+    for (const auto& event : events) {
+        REQUIRE(event.reason == tiro::gc_reason::automatic);
+        REQUIRE(event.total_time >= event.mark_time);
+        REQUIRE(event.pages > 0);
+    }
+
+    tiro::heap_stats stats = vm.heap_stats();
+    REQUIRE(stats.collections_by(tiro::gc_reason::automatic) == events.size());
+    REQUIRE(stats.collections_by(tiro::gc_reason::forced) == 0);
+    REQUIRE(stats.pages == events.back().pages);
+    REQUIRE(stats.allocated_bytes > 0);
+    REQUIRE(stats.pauses >= events.size());
+
+    size_t histogram_total = 0;
+    for (size_t count : stats.pause_histogram)
+        histogram_total += count;
+    REQUIRE(histogram_total == stats.pauses);
+
+    std::string types = vm.heap_live_types();
+    REQUIRE(types.find("\"type\":\"String\"") != std::string::npos);
+}
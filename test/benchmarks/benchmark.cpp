@@ -0,0 +1,122 @@
+#include "benchmark.hpp"
+
+#include "bytecode/module.hpp"
+#include "common/format.hpp"
+#include "compiler/compiler.hpp"
+#include "vm/builtins/modules.hpp"
+#include "vm/heap/collector.hpp"
+#include "vm/heap/heap.hpp"
+#include "vm/modules/load.hpp"
+#include "vm/modules/registry.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace tiro::vm::bench {
+
+namespace {
+
+struct RegisteredBenchmark {
+    std::string_view name;
+    BenchmarkFunction fn;
+};
+
+} // namespace
+
+static std::vector<RegisteredBenchmark>& registry() {
+    static std::vector<RegisteredBenchmark> benchmarks;
+    return benchmarks;
+}
+
+static std::unique_ptr<BytecodeModule> compile(std::string_view source) {
+    Compiler compiler("bench", CompilerOptions());
+    compiler.add_file("bench", std::string(source));
+
+    auto result = compiler.run();
+    if (!result.success) {
+        for (const auto& msg : compiler.diag().messages()) {
+            CursorPosition pos = compiler.cursor_pos(msg.range);
+            fmt::print(stderr, "  [{}:{}]: {}\n", pos.line(), pos.column(), msg.text);
+        }
+        TIRO_ERROR("Failed to compile benchmark source.");
+    }
+
+    TIRO_CHECK(result.module, "Module must have been compiled.");
+    return std::move(result.module);
+}
+
+static External<Module> load(Context& ctx, std::string_view source) {
+    auto compiled = compile(source);
+
+    Scope sc(ctx);
+    Local std = sc.local(create_std_module(ctx));
+    if (!ctx.modules().add_module(ctx, std))
+        TIRO_ERROR("Failed to register std module.");
+
+    Local module = sc.local(load_module(ctx, *compiled));
+    ctx.modules().resolve_module(ctx, module);
+    return ctx.externals().allocate(module);
+}
+
+ScriptBenchmark::ScriptBenchmark(std::string_view source)
+    : ctx_(std::make_unique<Context>())
+    , module_(load(*ctx_, source)) {}
+
+ScriptBenchmark::~ScriptBenchmark() {
+    ctx_->externals().free(module_);
+}
+
+BenchmarkResult ScriptBenchmark::run(std::string_view function_name, i64 arg) {
+    Context& ctx = *ctx_;
+    Scope sc(ctx);
+
+    Local name = sc.local(ctx.get_symbol(function_name));
+    auto exported = module_->find_exported(*name);
+    if (!exported)
+        TIRO_ERROR("Failed to find function {} in module.", function_name);
+
+    Local func = sc.local(*exported);
+    Local args = sc.local(Tuple::make(ctx, 1));
+    args->checked_set(0, ctx.get_integer(arg));
+
+    auto& heap = ctx.heap();
+    const size_t allocations_before = heap.stats().total_allocated_objects;
+    const size_t collections_before = heap.collector().cycles();
+    const auto start = std::chrono::steady_clock::now();
+
+    Local result = sc.local(ctx.run_init(func, args));
+
+    const auto end = std::chrono::steady_clock::now();
+    if (!result->is_success())
+        TIRO_ERROR("Benchmark function {} failed.", function_name);
+
+    BenchmarkResult bench;
+    bench.duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    bench.allocations = heap.stats().total_allocated_objects - allocations_before;
+    bench.collections = heap.collector().cycles() - collections_before;
+    return bench;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(std::string_view name, BenchmarkFunction fn) {
+    registry().push_back({name, fn});
+}
+
+void report(std::string_view name, const BenchmarkResult& result) {
+    fmt::print("{:<40} {:>10.2f} ms {:>12} allocations {:>6} collections\n", name,
+        result.duration_ms, result.allocations, result.collections);
+}
+
+size_t run_benchmarks(std::string_view filter) {
+    size_t count = 0;
+    for (const auto& benchmark : registry()) {
+        if (benchmark.name.find(filter) == std::string_view::npos)
+            continue;
+
+        benchmark.fn();
+        ++count;
+    }
+    return count;
+}
+
+} // namespace tiro::vm::bench
@@ -0,0 +1,78 @@
+#ifndef TIRO_BENCHMARKS_BENCHMARK_HPP
+#define TIRO_BENCHMARKS_BENCHMARK_HPP
+
+#include "common/defs.hpp"
+#include "vm/context.hpp"
+#include "vm/handles/external.hpp"
+#include "vm/objects/all.hpp"
+
+#include <memory>
+#include <string_view>
+
+namespace tiro::vm::bench {
+
+/// Measurements collected while running a benchmark.
+struct BenchmarkResult {
+    /// Wall clock time, in milliseconds.
+    double duration_ms = 0;
+
+    /// Number of objects allocated on the heap.
+    size_t allocations = 0;
+
+    /// Number of garbage collection cycles.
+    size_t collections = 0;
+};
+
+/// Compiles a tiro module and runs its exported functions in a fresh context.
+class ScriptBenchmark final {
+public:
+    explicit ScriptBenchmark(std::string_view source);
+    ~ScriptBenchmark();
+
+    ScriptBenchmark(const ScriptBenchmark&) = delete;
+    ScriptBenchmark& operator=(const ScriptBenchmark&) = delete;
+
+    /// Calls the exported function with the given integer argument and measures the call.
+    BenchmarkResult run(std::string_view function_name, i64 arg);
+
+    Context& ctx() { return *ctx_; }
+
+private:
+    std::unique_ptr<Context> ctx_;
+    External<Module> module_;
+};
+
+using BenchmarkFunction = void (*)();
+
+/// Registers a benchmark function at static initialization time.
+/// Use `TIRO_BENCHMARK` instead of using this class directly.
+class BenchmarkRegistration final {
+public:
+    BenchmarkRegistration(std::string_view name, BenchmarkFunction fn);
+};
+
+/// Prints a single result line for the given benchmark.
+void report(std::string_view name, const BenchmarkResult& result);
+
+/// Runs all registered benchmarks whose name contains `filter`.
+/// Returns the number of executed benchmarks.
+size_t run_benchmarks(std::string_view filter);
+
+} // namespace tiro::vm::bench
+
+#define TIRO_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define TIRO_BENCHMARK_CONCAT(a, b) TIRO_BENCHMARK_CONCAT_IMPL(a, b)
+
+#define TIRO_BENCHMARK_IMPL(name, fn)                                                 \
+    static void fn();                                                                 \
+    static const ::tiro::vm::bench::BenchmarkRegistration TIRO_BENCHMARK_CONCAT(      \
+        fn, _registration)(name, &fn);                                                \
+    static void fn()
+
+/// Defines a benchmark function with the given name. Usage:
+///
+///     TIRO_BENCHMARK("my benchmark") { ... }
+#define TIRO_BENCHMARK(name) \
+    TIRO_BENCHMARK_IMPL(name, TIRO_BENCHMARK_CONCAT(tiro_benchmark_, __LINE__))
+
+#endif // TIRO_BENCHMARKS_BENCHMARK_HPP
@@ -0,0 +1,56 @@
+#include "benchmark.hpp"
+
+namespace tiro::vm::bench {
+
+static constexpr std::string_view float_source = R"(
+    export func float_sum(n) {
+        var sum = 0.0;
+        var x = 0.5;
+        var i = 0;
+        while (i < n) {
+            sum = sum + x * 1.5;
+            x = x + 0.25;
+            i = i + 1;
+        }
+        return sum;
+    }
+
+    export func mandelbrot(size) {
+        var inside = 0;
+        var py = 0;
+        while (py < size) {
+            const ci = py * 2.0 / size - 1.0;
+            var px = 0;
+            while (px < size) {
+                const cr = px * 2.0 / size - 1.5;
+                var zr = 0.0;
+                var zi = 0.0;
+                var iter = 0;
+                while (iter < 50 && zr * zr + zi * zi <= 4.0) {
+                    const t = zr * zr - zi * zi + cr;
+                    zi = 2.0 * zr * zi + ci;
+                    zr = t;
+                    iter = iter + 1;
+                }
+                if (iter == 50) {
+                    inside = inside + 1;
+                }
+                px = px + 1;
+            }
+            py = py + 1;
+        }
+        return inside;
+    }
+)";
+
+TIRO_BENCHMARK("float_sum") {
+    ScriptBenchmark bench(float_source);
+    report("float_sum(1000000)", bench.run("float_sum", 1000000));
+}
+
+TIRO_BENCHMARK("mandelbrot") {
+    ScriptBenchmark bench(float_source);
+    report("mandelbrot(100)", bench.run("mandelbrot", 100));
+}
+
+} // namespace tiro::vm::bench
@@ -0,0 +1,97 @@
+#include "benchmark.hpp"
+
+#include "vm/heap/collector.hpp"
+#include "vm/heap/heap.hpp"
+
+#include <chrono>
+
+namespace tiro::vm::bench {
+
+// Allocates `count` small objects of different sizes. The most recent `window` objects remain
+// reachable, which leaves holes of different sizes behind in the heap's pages.
+static BenchmarkResult allocation_churn(bool size_classes, i64 count, size_t window) {
+    ContextSettings settings;
+    settings.gc_size_classes = size_classes;
+    Context ctx(std::move(settings));
+
+    Scope sc(ctx);
+    Local live = sc.local(Tuple::make(ctx, window));
+    Local item = sc.local();
+
+    auto& heap = ctx.heap();
+    const size_t allocations_before = heap.stats().total_allocated_objects;
+    const size_t collections_before = heap.collector().cycles();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (i64 i = 0; i < count; ++i) {
+        switch (i % 4) {
+        case 0:
+            item = HeapInteger::make(ctx, i);
+            break;
+        case 1:
+            item = HeapFloat::make(ctx, static_cast<f64>(i));
+            break;
+        case 2:
+            item = Tuple::make(ctx, 3);
+            break;
+        case 3:
+            item = String::make(ctx, "some string value");
+            break;
+        }
+        live->unchecked_set(static_cast<size_t>(i) % window, *item);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    BenchmarkResult bench;
+    bench.duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    bench.allocations = heap.stats().total_allocated_objects - allocations_before;
+    bench.collections = heap.collector().cycles() - collections_before;
+    return bench;
+}
+
+TIRO_BENCHMARK("allocation_churn") {
+    report("allocation_churn(free space)", allocation_churn(false, 10000000, 100000));
+    report("allocation_churn(size classes)", allocation_churn(true, 10000000, 100000));
+}
+
+// Appends `count` integers to each of `arrays` arrays. Large array storage is resized without copying
+// when the heap maps its memory.
+static BenchmarkResult array_growth(bool mapped, i64 count, size_t arrays) {
+    ContextSettings settings;
+    settings.gc_mapped_memory = mapped;
+    settings.max_heap_size_bytes = size_t(1) << 30;
+    Context ctx(std::move(settings));
+
+    Scope sc(ctx);
+    Local array = sc.local<Array>(defer_init);
+    Local value = sc.local();
+
+    auto& heap = ctx.heap();
+    const size_t allocations_before = heap.stats().total_allocated_objects;
+    const size_t collections_before = heap.collector().cycles();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t n = 0; n < arrays; ++n) {
+        array = Array::make(ctx, 0);
+        for (i64 i = 0; i < count; ++i) {
+            value = ctx.get_integer(i);
+            array->append(ctx, value).must("append failed");
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    BenchmarkResult bench;
+    bench.duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    bench.allocations = heap.stats().total_allocated_objects - allocations_before;
+    bench.collections = heap.collector().cycles() - collections_before;
+    return bench;
+}
+
+TIRO_BENCHMARK("array_growth") {
+    report("array_growth(malloc)", array_growth(false, 2000000, 10));
+    report("array_growth(mapped)", array_growth(true, 2000000, 10));
+}
+
+} // namespace tiro::vm::bench
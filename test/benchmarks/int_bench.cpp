@@ -0,0 +1,64 @@
+#include "benchmark.hpp"
+
+namespace tiro::vm::bench {
+
+static constexpr std::string_view int_source = R"(
+    export func fibonacci(n) {
+        var a = 0;
+        var b = 1;
+        var i = 0;
+        while (i < n) {
+            const next = (a + b) % 1000000007;
+            a = b;
+            b = next;
+            i = i + 1;
+        }
+        return a;
+    }
+
+    func fib_recursive(n) {
+        if (n <= 1) {
+            return n;
+        }
+        return fib_recursive(n - 1) + fib_recursive(n - 2);
+    }
+
+    export func fibonacci_recursive(n) {
+        return fib_recursive(n);
+    }
+
+    export func fizzbuzz(n) {
+        var count = 0;
+        var i = 1;
+        while (i <= n) {
+            if (i % 15 == 0) {
+                count = count + 15;
+            } else if (i % 5 == 0) {
+                count = count + 5;
+            } else if (i % 3 == 0) {
+                count = count + 3;
+            } else {
+                count = count + 1;
+            }
+            i = i + 1;
+        }
+        return count;
+    }
+)";
+
+TIRO_BENCHMARK("fibonacci") {
+    ScriptBenchmark bench(int_source);
+    report("fibonacci(1000000)", bench.run("fibonacci", 1000000));
+}
+
+TIRO_BENCHMARK("fibonacci_recursive") {
+    ScriptBenchmark bench(int_source);
+    report("fibonacci_recursive(25)", bench.run("fibonacci_recursive", 25));
+}
+
+TIRO_BENCHMARK("fizzbuzz") {
+    ScriptBenchmark bench(int_source);
+    report("fizzbuzz(1000000)", bench.run("fizzbuzz", 1000000));
+}
+
+} // namespace tiro::vm::bench
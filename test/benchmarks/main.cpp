@@ -0,0 +1,17 @@
+#include "benchmark.hpp"
+
+#include "common/format.hpp"
+
+#include <string_view>
+
+// Usage: vm_benchmarks [FILTER]
+//
+// Runs all benchmarks whose name contains FILTER (or all benchmarks if no filter was given).
+int main(int argc, char** argv) {
+    std::string_view filter = argc > 1 ? argv[1] : "";
+    if (tiro::vm::bench::run_benchmarks(filter) == 0) {
+        fmt::print(stderr, "No benchmark matches the filter \"{}\".\n", filter);
+        return 1;
+    }
+    return 0;
+}
@@ -399,4 +399,36 @@ TEST_CASE("Set literals should support iteration in insertion order", "[containe
     test.call("test_entries").returns_string("foo,bar,baz,qux");
 }
 
+TEST_CASE("Weak maps should support insertion, lookup and removal", "[containers]") {
+    std::string_view source = R"(
+        import std;
+
+        export func test() {
+            const m = std.new_weak_map();
+            const a = [1];
+            const b = (1, 2);
+            m[a] = "a";
+            m[b] = "b";
+            m[#sym] = "sym";
+            assert(m.size() == 3);
+            assert(m.contains(a));
+            assert(!m.contains([1]));
+            assert(m[a] == "a");
+            assert(m[b] == "b");
+            assert(m[#sym] == "sym");
+            assert(m[[1]] == null);
+
+            m.remove(a);
+            assert(m.size() == 2);
+            assert(!m.contains(a));
+
+            m.clear();
+            assert(m.size() == 0);
+        }
+    )";
+
+    eval_test test(source);
+    test.call("test").returns_value();
+}
+
 } // namespace tiro::eval_tests
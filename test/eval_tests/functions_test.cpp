@@ -113,7 +113,6 @@ TEST_CASE("Interpreter should support closure variables in loops", "[functions]"
     test.call("outer").returns_int(3);
 }
 
-// TODO implement and test tail recursion
 TEST_CASE("Interpreter should support a large number of recursive calls", "[functions]") {
     std::string_view source = R"(
         func recursive_count(n) {
@@ -133,6 +132,133 @@ TEST_CASE("Interpreter should support a large number of recursive calls", "[func
     test.call("lots_of_calls").returns_int(10000);
 }
 
+TEST_CASE("Interpreter should run tail calls in constant stack space", "[functions]") {
+    std::string_view source = R"(
+        func count(n, acc) {
+            if (n <= 0) {
+                return acc;
+            }
+            return count(n - 1, acc + 1);
+        }
+
+        func is_even(n) {
+            if (n == 0) {
+                return true;
+            }
+            return is_odd(n - 1);
+        }
+
+        func is_odd(n) {
+            if (n == 0) {
+                return false;
+            }
+            return is_even(n - 1);
+        }
+
+        func count_fields(obj, n) {
+            if (n <= 0) {
+                return obj.size;
+            }
+            return obj.step(obj, n - 1);
+        }
+
+        export func tail_recursion() = count(1000000, 0);
+
+        export func mutual_recursion() = is_even(1000001);
+
+        export func method_recursion() {
+            const obj = (step: count_fields, size: 123);
+            return count_fields(obj, 1000000);
+        }
+    )";
+
+    eval_test test(source);
+    test.call("tail_recursion").returns_int(1000000);
+    test.call("mutual_recursion").returns_bool(false);
+    test.call("method_recursion").returns_int(123);
+}
+
+TEST_CASE("Tail calls should behave like normal calls", "[functions]") {
+    std::string_view source = R"(
+        import std;
+
+        func identity(x) = x;
+
+        func native_call(array) {
+            return array.size();
+        }
+
+        func call_with_defer(log) {
+            defer log.append("defer");
+            return append(log, "call");
+        }
+
+        func append(log, item) {
+            log.append(item);
+            return log.size();
+        }
+
+        func tail_call_catch() {
+            return std.catch_panic(func() = std.panic("oops"));
+        }
+
+        export func test_native() = native_call([1, 2, 3]);
+
+        export func test_defer() {
+            const log = [];
+            const size = call_with_defer(log);
+            return "${size} ${log[0]} ${log[1]}";
+        }
+
+        export func test_panic() = tail_call_catch().is_error();
+
+        export func test_closure() {
+            const f = func(n) = identity(n);
+            return f(7);
+        }
+    )";
+
+    eval_test test(source);
+    test.call("test_native").returns_int(3);
+    test.call("test_defer").returns_string("1 call defer");
+    test.call("test_panic").returns_bool(true);
+    test.call("test_closure").returns_int(7);
+}
+
+TEST_CASE("Interpreter should support calls between different kinds of frames", "[functions]") {
+    std::string_view source = R"(
+        import std;
+
+        func count_down(obj, n) {
+            if (n <= 0) {
+                return std.catch_panic(obj.fail).is_error();
+            }
+            return obj.step(obj, n);
+        }
+
+        export func test(n) {
+            var steps = 0;
+            const obj = (
+                step: func(obj, n) {
+                    steps = steps + 1;
+                    return count_down(obj, n - 1);
+                },
+                fail: func() {
+                    std.panic("fail");
+                },
+            );
+            const failed = count_down(obj, n);
+            return (failed, steps);
+        }
+    )";
+
+    eval_test test(source);
+    auto result = test.call("test", 1000).returns_value().as<tuple>();
+    REQUIRE(result.size() == 2);
+    REQUIRE(result.get(0).as<boolean>().value());
+    REQUIRE(result.get(1).as<integer>().value() == 1000);
+}
+
 TEST_CASE("The interpreter should bind method references to their instance", "[functions]") {
     std::string_view source = R"(
         import std;
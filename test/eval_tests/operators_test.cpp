@@ -2,6 +2,8 @@
 
 #include "eval_test.hpp"
 
+#include <limits>
+
 namespace tiro::eval_tests {
 
 TEST_CASE("Integers and floats should support equality tests", "[operators]") {
@@ -72,6 +74,62 @@ TEST_CASE("The language should support basic arithmetic operations", "[operators
     test.call("pow", 4, 0.5).returns_float(2);
 }
 
+TEST_CASE("Operators should handle changing operand types", "[operators]") {
+    std::string_view source = R"(
+        export func add(x, y) = {
+            x + y;
+        }
+
+        export func mul(x, y) = {
+            x * y;
+        }
+
+        export func mod(x, y) = {
+            x % y;
+        }
+
+        export func lte(x, y) = {
+            x <= y;
+        }
+
+        export func eq(x, y) = {
+            x == y;
+        }
+    )";
+
+    // Instructions are specialized for the operand types observed on first execution,
+    // subsequent calls with different types must still work.
+    const int64_t large = int64_t(1) << 62;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    eval_test test(source);
+    test.call("add", 1, 2).returns_int(3);
+    test.call("add", large - 1, 1).returns_int(large);
+    test.call("add", 1.5, 2.25).returns_float(3.75);
+    test.call("add", 1, 2).returns_int(3);
+    test.call("add", 1e300, 1e300).returns_float(2e300);
+    test.call("add", "foo", 1).panics();
+
+    test.call("mul", 3, 4).returns_int(12);
+    test.call("mul", large, 2).panics();
+    test.call("mul", large / 2, 2).returns_int(large);
+    test.call("mul", 1.5, 2.0).returns_float(3.0);
+
+    test.call("mod", 7, 3).returns_int(1);
+    test.call("mod", -7, 3).returns_int(-1);
+    test.call("mod", 7, 0).panics();
+    test.call("mod", 7.5, 2.0).returns_float(1.5);
+
+    test.call("lte", 1, 2).returns_bool(true);
+    test.call("lte", 2.5, 2.0).returns_bool(false);
+    test.call("lte", nan, 1.0).returns_bool(true);
+    test.call("lte", 3, 2).returns_bool(false);
+
+    test.call("eq", 4, 4).returns_bool(true);
+    test.call("eq", 4, 4.0).returns_bool(true);
+    test.call("eq", 4, 5).returns_bool(false);
+}
+
 TEST_CASE("The language should support basic logical operators", "[operators]") {
     std::string_view source = R"(
         export func not(x) = {
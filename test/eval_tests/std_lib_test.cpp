@@ -140,6 +140,7 @@ TEST_CASE("The type_of function should return the correct type.", "[std-lib]") {
             add("symbol", #foo, std.Symbol);
             add("tuple", (1, 2), std.Tuple);
             add("type", std.type_of(std.type_of(null)), std.Type);
+            add("weak map", std.new_weak_map(), std.WeakMap);
             return result;
         }
 
@@ -0,0 +1,63 @@
+#include <catch2/catch.hpp>
+
+#include "heap_report/graph.hpp"
+#include "vm/heap/snapshot.hpp"
+
+#include "vm/eval/test_context.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace tiro::heap_report::test {
+
+TEST_CASE("The heap report should read snapshots written by the vm", "[heap-report]") {
+    vm::test::TestContext test(R"(
+        var items = [];
+
+        export func test() {
+            for var i = 0; i < 10; i += 1 {
+                items.append((i, "report item"));
+            }
+        }
+    )");
+    test.call("test").returns_null();
+
+    std::istringstream input(vm::heap_snapshot(test.ctx()));
+    Graph graph = load_graph(input);
+    REQUIRE(graph.objects > 0);
+    REQUIRE(graph.size_nodes() == graph.objects + 1 + graph.labels.size());
+
+    auto label = std::find(graph.labels.begin(), graph.labels.end(), "module test");
+    REQUIRE(label != graph.labels.end());
+
+    size_t items = 0;
+    for (size_t i = 0; i < graph.objects; ++i) {
+        if (graph.types.at(graph.type[i]) == "String" && graph.name[i] == "report item")
+            ++items;
+    }
+    REQUIRE(items == 1);
+
+    // Snapshots only contain reachable objects, so the root retains the entire heap.
+    Dominators dom = compute_dominators(graph);
+    u64 total = 0;
+    for (size_t i = 0; i < graph.objects; ++i) {
+        REQUIRE(dom.idom[i] != invalid_node);
+        total += graph.size[i];
+    }
+    REQUIRE(dom.retained[graph.root] == total);
+
+    // The module retains its members, e.g. the array of items.
+    const auto& labelled = graph.edges[graph.label_node(label - graph.labels.begin())];
+    REQUIRE(labelled.size() == 1);
+    const u32 module = labelled[0];
+    REQUIRE(graph.types.at(graph.type[module]) == "Module");
+    REQUIRE(graph.name[module] == "test");
+    REQUIRE(dom.retained[module] > graph.size[module] + 10 * 32);
+}
+
+TEST_CASE("The heap report should reject unsupported snapshot versions", "[heap-report]") {
+    std::istringstream input(R"({"version": 2, "objects": [], "roots": [], "types": []})");
+    REQUIRE_THROWS(load_graph(input));
+}
+
+} // namespace tiro::heap_report::test
@@ -194,7 +194,7 @@ void require_int(Handle<Value> handle, i64 expected) {
 
 void require_float(Handle<Value> handle, f64 expected) {
     CAPTURE(to_string(handle->type()));
-    REQUIRE(handle->type() == ValueType::Float);
+    REQUIRE(handle->is<Float>());
     REQUIRE(handle.must_cast<Float>()->value() == expected);
 }
 
@@ -1,5 +1,7 @@
 #include <catch2/catch.hpp>
 
+#include <fmt/format.h>
+
 #include "vm/context.hpp"
 #include "vm/heap/collector.hpp"
 #include "vm/objects/all.hpp"
@@ -74,7 +76,6 @@ public:
             TIRO_CASE(CoroutineToken)
             TIRO_CASE(Environment)
             TIRO_CASE(Exception)
-            TIRO_CASE(Float)
             TIRO_CASE(HandlerTable)
             TIRO_CASE(HashTable)
             TIRO_CASE(HashTableIterator)
@@ -83,8 +84,10 @@ public:
             TIRO_CASE(HashTableStorage)
             TIRO_CASE(HashTableValueIterator)
             TIRO_CASE(HashTableValueView)
+            TIRO_CASE(HeapFloat)
             TIRO_CASE(HeapInteger)
             TIRO_CASE(InternalType)
+            TIRO_CASE(LineTable)
             TIRO_CASE(MagicFunction)
             TIRO_CASE(Method)
             TIRO_CASE(Module)
@@ -97,6 +100,7 @@ public:
             TIRO_CASE(Result)
             TIRO_CASE(Set)
             TIRO_CASE(SetIterator)
+            TIRO_CASE(SmallFloat)
             TIRO_CASE(SmallInteger)
             TIRO_CASE(String)
             TIRO_CASE(StringBuilder)
@@ -108,6 +112,7 @@ public:
             TIRO_CASE(Type)
             TIRO_CASE(Undefined)
             TIRO_CASE(UnresolvedImport)
+            TIRO_CASE(WeakMap)
             // [[[end]]]
         }
     }
@@ -204,6 +209,736 @@ TEST_CASE("Collector should collect unreferenced objects", "[collector]") {
     REQUIRE(allocated_bytes() == 0);
 }
 
+TEST_CASE("Minor collections should only collect young objects", "[collector]") {
+    Context ctx;
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 8));
+    gc.collect(GcReason::Forced);
+
+    const size_t allocated_objects_before = heap.stats().allocated_objects;
+    const size_t minor_cycles_before = gc.minor_cycles();
+    REQUIRE(heap.remembered_count() == 0);
+
+    {
+        Scope sc2(ctx);
+
+        // The string is only referenced from the (old) array storage, which must be remembered.
+        Local str = sc2.local(String::make(ctx, "young"));
+        array->append(ctx, str).must("append failed");
+        REQUIRE(heap.remembered_count() == 1);
+
+        // Unreachable young object.
+        HeapInteger::make(ctx, 123);
+        REQUIRE(heap.stats().allocated_objects == allocated_objects_before + 2);
+    }
+
+    gc.collect(GcReason::Automatic);
+    REQUIRE(gc.minor_cycles() == minor_cycles_before + 1);
+    REQUIRE(heap.stats().allocated_objects == allocated_objects_before + 1);
+    REQUIRE(heap.remembered_count() == 0);
+
+    auto str = array->unchecked_get(0);
+    REQUIRE(str.is<String>());
+    REQUIRE(str.must_cast<String>().view() == "young");
+
+    // The string has been promoted, the array does not need to be remembered anymore.
+    array->unchecked_set(0, SmallInteger::make(1));
+    REQUIRE(heap.remembered_count() == 0);
+}
+
+TEST_CASE("Incremental marking should preserve objects created during marking", "[collector]") {
+    ContextSettings settings;
+    settings.gc_slice_budget = std::chrono::microseconds(1);
+    settings.gc_slice_allocation_bytes = 4096;
+    settings.gc_policy.gc_time_ratio = 0; // Fixed collection thresholds
+    Context ctx(std::move(settings));
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+
+    // The array grows continuously, so some automatic collections will be (incremental) major collections.
+    // New items are stored into the array while marking is in progress.
+    constexpr i64 count = 200000;
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    Local item = sc.local();
+    for (i64 i = 0; i < count; ++i) {
+        item = HeapInteger::make(ctx, i);
+        array->append(ctx, item).must("append failed");
+        String::make(ctx, "garbage");
+    }
+    REQUIRE(gc.incremental_cycles() > 0);
+
+    i64 mismatches = 0;
+    for (i64 i = 0; i < count; ++i) {
+        auto value = array->unchecked_get(i);
+        if (!value.is<HeapInteger>() || value.must_cast<HeapInteger>().value() != i)
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+
+    // Forced collections do not wait for incremental marking.
+    gc.collect(GcReason::Forced);
+    REQUIRE(!gc.marking());
+    REQUIRE(array->size() == count);
+}
+
+TEST_CASE("Large arrays should be marked in chunks", "[collector]") {
+    Context ctx;
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+
+    // Every item would be on the mark stack at the same time without chunking.
+    gc.mark_stack_limit(MarkStack::reserved_segments);
+
+    constexpr i64 count = 100000;
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    Local item = sc.local();
+    for (i64 i = 0; i < count; ++i) {
+        item = HeapInteger::make(ctx, i);
+        array->append(ctx, item).must("append failed");
+    }
+    item = Value::null();
+
+    gc.collect(GcReason::Forced);
+    const size_t allocated_objects = heap.stats().allocated_objects;
+    REQUIRE(gc.mark_stack_overflows() == 0);
+
+    i64 mismatches = 0;
+    for (i64 i = 0; i < count; ++i) {
+        auto value = array->unchecked_get(i);
+        if (!value.is<HeapInteger>() || value.must_cast<HeapInteger>().value() != i)
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+
+    gc.collect(GcReason::Forced);
+    REQUIRE(heap.stats().allocated_objects == allocated_objects);
+}
+
+TEST_CASE("Marking should recover from a mark stack overflow", "[collector]") {
+    const bool major = GENERATE(true, false);
+    CAPTURE(major);
+
+    Context ctx;
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+    gc.mark_stack_limit(MarkStack::reserved_segments);
+    gc.collect(GcReason::Forced);
+
+    // Tracing a linked list leaves one item per node on the mark stack. The values are wrapped
+    // in tuples because objects without references are never pushed onto the mark stack.
+    constexpr i64 count = 3 * MarkStack::segment_size * MarkStack::reserved_segments;
+    Scope sc(ctx);
+    Local list = sc.local<Value>(Value::null());
+    Local item = sc.local();
+    for (i64 i = 0; i < count; ++i) {
+        item = HeapInteger::make(ctx, i);
+        item = Tuple::make(ctx, {item});
+        list = Tuple::make(ctx, {item, list});
+    }
+    item = Value::null();
+
+    // Unreachable objects must still be collected.
+    const size_t allocated_objects = heap.stats().allocated_objects;
+    for (int i = 0; i < 100; ++i)
+        String::make(ctx, "garbage");
+
+    gc.collect(major ? GcReason::Forced : GcReason::Automatic);
+    REQUIRE(gc.mark_stack_overflows() > 0);
+    REQUIRE(heap.stats().allocated_objects == allocated_objects);
+
+    i64 mismatches = 0;
+    i64 expected = count;
+    Value current = *list;
+    while (!current.is_null()) {
+        Tuple node = current.must_cast<Tuple>();
+        auto value = node.unchecked_get(0).must_cast<Tuple>().unchecked_get(0);
+        if (!value.is<HeapInteger>() || value.must_cast<HeapInteger>().value() != --expected)
+            ++mismatches;
+        current = node.unchecked_get(1);
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(expected == 0);
+}
+
+TEST_CASE("Weak tables should only retain entries with reachable keys", "[collector]") {
+    Context ctx;
+    Collector& gc = ctx.heap().collector();
+
+    Scope sc(ctx);
+    Local table = sc.local(HashTable::make_weak(ctx));
+    Local live_key = sc.local<Value>(Array::make(ctx, 0));
+    Local chained_key = sc.local<Value>(Value::null());
+    {
+        Scope sc2(ctx);
+        Local key = sc2.local();
+        Local value = sc2.local();
+
+        // The value is only reachable through the live key.
+        chained_key = Array::make(ctx, 0);
+        value = String::make(ctx, "live");
+        table->set(ctx, live_key, chained_key).must("insert failed");
+
+        // Reachable because the chained key is the value of a live entry.
+        value = String::make(ctx, "chained");
+        table->set(ctx, chained_key, value).must("insert failed");
+        chained_key = Value::null();
+
+        // Unreachable key.
+        key = Array::make(ctx, 0);
+        value = String::make(ctx, "dead");
+        table->set(ctx, key, value).must("insert failed");
+
+        // The value references its key, which must not keep the entry alive.
+        key = Array::make(ctx, 0);
+        value = Tuple::make(ctx, {key});
+        table->set(ctx, key, value).must("insert failed");
+
+        // Keys that are not heap objects are never removed.
+        key = SmallInteger::make(1);
+        value = String::make(ctx, "integer");
+        table->set(ctx, key, value).must("insert failed");
+    }
+    REQUIRE(table->size() == 5);
+
+    gc.collect(GcReason::Forced);
+    REQUIRE(table->size() == 3);
+    REQUIRE(gc.cleared_weak_entries() == 2);
+
+    auto chained = table->get(*live_key);
+    REQUIRE(chained);
+    REQUIRE(chained->is<Array>());
+    auto chained_value = table->get(*chained);
+    REQUIRE(chained_value);
+    REQUIRE(chained_value->must_cast<String>().view() == "chained");
+    REQUIRE(table->get(SmallInteger::make(1))->must_cast<String>().view() == "integer");
+
+    // The table remains usable after entries have been removed.
+    live_key = Value::null();
+    gc.collect(GcReason::Forced);
+    REQUIRE(table->size() == 1);
+    REQUIRE(table->contains(SmallInteger::make(1)));
+}
+
+TEST_CASE("Minor collections should clear young entries of old weak tables", "[collector]") {
+    Context ctx;
+    Collector& gc = ctx.heap().collector();
+
+    Scope sc(ctx);
+    Local table = sc.local(HashTable::make_weak(ctx));
+    gc.collect(GcReason::Forced);
+
+    const size_t minor_cycles_before = gc.minor_cycles();
+    Local live_key = sc.local(Array::make(ctx, 0));
+    {
+        Scope sc2(ctx);
+        Local value = sc2.local(String::make(ctx, "young"));
+        table->set(ctx, live_key, value).must("insert failed");
+
+        Local dead_key = sc2.local(Array::make(ctx, 0));
+        table->set(ctx, dead_key, value).must("insert failed");
+    }
+    REQUIRE(table->size() == 2);
+
+    gc.collect(GcReason::Automatic);
+    REQUIRE(gc.minor_cycles() == minor_cycles_before + 1);
+    REQUIRE(table->size() == 1);
+
+    auto value = table->get(*live_key);
+    REQUIRE(value);
+    REQUIRE(value->must_cast<String>().view() == "young");
+}
+
+TEST_CASE("Incremental marking should clear weak tables", "[collector]") {
+    ContextSettings settings;
+    settings.gc_slice_budget = std::chrono::microseconds(1);
+    settings.gc_slice_allocation_bytes = 4096;
+    settings.gc_policy.gc_time_ratio = 0; // Fixed collection thresholds
+    settings.gc_policy.min_nursery_bytes = 64 * 1024;
+    Context ctx(std::move(settings));
+
+    Collector& gc = ctx.heap().collector();
+
+    // Every 16th key remains reachable. The table grows while marking is in progress.
+    // Growing the old generation (the ballast) triggers major collections.
+    constexpr i64 count = 10000;
+    Scope sc(ctx);
+    Local table = sc.local(HashTable::make_weak(ctx));
+    Local keys = sc.local(Array::make(ctx, 0));
+    Local ballast = sc.local(Array::make(ctx, 0));
+    Local key = sc.local();
+    Local value = sc.local();
+    i64 marking_inserts = 0;
+    for (i64 i = 0; i < count; ++i) {
+        key = Array::make(ctx, 0);
+        value = HeapInteger::make(ctx, i);
+        table->set(ctx, key, value).must("insert failed");
+        if (i % 16 == 0)
+            keys->append(ctx, key).must("append failed");
+        if (gc.marking())
+            ++marking_inserts;
+
+        value = Tuple::make(ctx, 16);
+        ballast->append(ctx, value).must("append failed");
+    }
+    REQUIRE(marking_inserts > 0);
+    key = Value::null();
+    value = Value::null();
+
+    // Keys inserted while marking is in progress are shaded by the barrier and survive that cycle.
+    // The next complete incremental cycle must remove all unreachable keys.
+    const size_t cycles = gc.incremental_cycles() + (gc.marking() ? 2 : 1);
+    while (gc.incremental_cycles() < cycles) {
+        value = Tuple::make(ctx, 16);
+        ballast->append(ctx, value).must("append failed");
+    }
+    REQUIRE(gc.cycles() == gc.minor_cycles() + gc.incremental_cycles()); // No stop-the-world major collection
+    REQUIRE(table->size() == keys->size());
+
+    i64 mismatches = 0;
+    for (size_t i = 0; i < keys->size(); ++i) {
+        auto found = table->get(keys->unchecked_get(i));
+        if (!found || !found->is<HeapInteger>()
+            || found->must_cast<HeapInteger>().value() != static_cast<i64>(i * 16))
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Unreachable interned strings should be collected", "[collector]") {
+    Context ctx;
+    Collector& gc = ctx.heap().collector();
+    gc.collect(GcReason::Forced);
+
+    Scope sc(ctx);
+    Local str = sc.local(ctx.get_interned_string("kept string"));
+    Local symbol = sc.local(ctx.get_symbol("kept symbol"));
+    {
+        Scope sc2(ctx);
+        for (int i = 0; i < 100; ++i) {
+            Local dynamic = sc2.local(String::make(ctx, fmt::format("dynamic key {}", i)));
+            ctx.get_symbol(dynamic);
+        }
+    }
+
+    gc.collect(GcReason::Forced);
+    REQUIRE(gc.cleared_weak_entries() == 100);
+
+    // Reachable strings and symbols keep their identity.
+    REQUIRE(ctx.get_interned_string("kept string").same(*str));
+    REQUIRE(ctx.get_symbol("kept symbol").same(*symbol));
+    REQUIRE(ctx.get_symbol("dynamic key 1").name().view() == "dynamic key 1");
+}
+
+TEST_CASE("Pages should be swept lazily after a collection", "[collector]") {
+    const u32 threads = GENERATE(0u, 2u);
+
+    ContextSettings settings;
+    settings.page_size_bytes = Page::min_size_bytes;
+    settings.gc_sweep_threads = threads;
+    Context ctx(std::move(settings));
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+    REQUIRE(heap.sweep_threads() == threads);
+
+    // Live and dead objects are interleaved on many pages.
+    constexpr i64 count = 20000;
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    Local item = sc.local();
+    for (i64 i = 0; i < count; ++i) {
+        item = HeapInteger::make(ctx, i);
+        array->append(ctx, item).must("append failed");
+        String::make(ctx, "garbage");
+    }
+
+    // No page has been swept yet.
+    gc.collect(GcReason::Forced);
+    REQUIRE(heap.sweeping());
+    REQUIRE(heap.stats().free_bytes == 0);
+
+    // New objects are allocated from the free space of swept pages (the holes left behind by
+    // the dead strings), the heap does not grow.
+    const size_t total_bytes = heap.stats().total_bytes;
+    for (i64 i = 0; i < 1000; ++i)
+        String::make(ctx, "garbage");
+    REQUIRE(heap.stats().total_bytes == total_bytes);
+
+    heap.finish_sweep();
+    REQUIRE(!heap.sweeping());
+    REQUIRE(heap.stats().free_bytes > 0);
+
+    gc.collect(GcReason::Forced);
+    REQUIRE(array->size() == count);
+
+    i64 mismatches = 0;
+    for (i64 i = 0; i < count; ++i) {
+        auto value = array->unchecked_get(i);
+        if (!value.is<HeapInteger>() || value.must_cast<HeapInteger>().value() != i)
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Objects without references should be allocated in the data region", "[collector]") {
+    ContextSettings settings;
+    settings.page_size_bytes = Page::min_size_bytes;
+    Context ctx(std::move(settings));
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+
+    const auto region = [&](Value value) {
+        return Page::from_address(HeapValue(value).heap_ptr(), heap)->region();
+    };
+
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    Local string = sc.local(String::make(ctx, "hello"));
+    Local buffer = sc.local(Buffer::make(ctx, 16, 0));
+    Local large_buffer = sc.local(Buffer::make(ctx, Page::min_size_bytes, 0));
+    Local number = sc.local(HeapFloat::make(ctx, 1.5));
+    Local tuple = sc.local(Tuple::make(ctx, {string, buffer, number}));
+    REQUIRE(region(*array) == Region::Generic);
+    REQUIRE(region(*tuple) == Region::Generic);
+    REQUIRE(region(*string) == Region::Data);
+    REQUIRE(region(*buffer) == Region::Data);
+    REQUIRE(LargeObject::from_address(large_buffer->heap_ptr())->region() == Region::Data);
+    REQUIRE(region(*number) == Region::Data);
+    REQUIRE(heap.page_count(Region::Generic) > 0);
+    REQUIRE(heap.page_count(Region::Data) > 0);
+
+    // Data objects are marked (but not traced) when they are reachable.
+    Local item = sc.local();
+    for (i64 i = 0; i < 10000; ++i) {
+        item = String::make(ctx, fmt::format("string {}", i));
+        array->append(ctx, item).must("append failed");
+    }
+    gc.collect(GcReason::Forced);
+    REQUIRE(array->size() == 10000);
+    REQUIRE(array->unchecked_get(9999).must_cast<String>().view() == "string 9999");
+    REQUIRE(tuple->unchecked_get(0).must_cast<String>().view() == "hello");
+    REQUIRE(large_buffer->size() == Page::min_size_bytes);
+
+    // Empty pages are reused by any region: the tuples fit into the pages left behind by the strings.
+    heap.finish_sweep();
+    array->clear();
+    gc.collect(GcReason::Forced);
+    heap.finish_sweep();
+    const size_t total_bytes = heap.stats().total_bytes;
+    for (i64 i = 0; i < 1000; ++i)
+        item = Tuple::make(ctx, 3);
+    REQUIRE(heap.stats().total_bytes == total_bytes);
+}
+
+TEST_CASE("Small objects should be allocated from size class pages", "[collector]") {
+    const u32 threads = GENERATE(0u, 2u);
+
+    ContextSettings settings;
+    settings.page_size_bytes = Page::min_size_bytes;
+    settings.gc_sweep_threads = threads;
+    settings.gc_size_classes = true;
+    Context ctx(std::move(settings));
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+    REQUIRE(heap.size_classes());
+
+    constexpr i64 count = 20000;
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    Local string = sc.local(String::make(ctx, "some string"));
+    Local item = sc.local();
+    for (i64 i = 0; i < count; ++i) {
+        item = HeapInteger::make(ctx, i);
+        array->append(ctx, item).must("append failed");
+        String::make(ctx, "garbage");
+    }
+
+    // Objects of different sizes never share a page.
+    const auto page_of = [&](Value value) {
+        return Page::from_address(HeapValue(value).heap_ptr(), heap);
+    };
+    auto first = page_of(array->unchecked_get(0));
+    REQUIRE(first->slot_cells() == ceil_div(sizeof(HeapInteger::Layout), cell_size));
+    REQUIRE(page_of(array->unchecked_get(1)) == first);
+    REQUIRE(page_of(*string) != first);
+    REQUIRE(page_of(*string)->slot_cells() > 0);
+
+    // Dead strings leave free slots behind, new strings reuse them.
+    gc.collect(GcReason::Forced);
+    heap.finish_sweep();
+    const size_t total_bytes = heap.stats().total_bytes;
+    for (i64 i = 0; i < 1000; ++i)
+        String::make(ctx, "garbage");
+    REQUIRE(heap.stats().total_bytes == total_bytes);
+
+    gc.collect(GcReason::Forced);
+    REQUIRE(array->size() == count);
+    REQUIRE(string->view() == "some string");
+
+    i64 mismatches = 0;
+    for (i64 i = 0; i < count; ++i) {
+        auto value = array->unchecked_get(i);
+        if (!value.is<HeapInteger>() || value.must_cast<HeapInteger>().value() != i)
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Empty pages should be released after a spike in memory usage", "[collector]") {
+    ContextSettings settings;
+    settings.page_size_bytes = Page::min_size_bytes;
+    settings.gc_spare_pages = 2;
+    settings.gc_page_release_cycles = 1;
+    Context ctx(std::move(settings));
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+    gc.collect(GcReason::Forced);
+    const size_t total_bytes_before = heap.stats().total_bytes;
+
+    {
+        Scope sc(ctx);
+        Local array = sc.local(Array::make(ctx, 0));
+        Local item = sc.local();
+        for (i64 i = 0; i < 100000; ++i) {
+            item = String::make(ctx, "some string value");
+            array->append(ctx, item).must("append failed");
+        }
+    }
+    const size_t total_bytes_peak = heap.stats().total_bytes;
+    REQUIRE(total_bytes_peak >= total_bytes_before + 20 * Page::min_size_bytes);
+
+    // The first collection frees the objects, the next ones find the pages empty and idle.
+    for (int i = 0; i < 3; ++i)
+        gc.collect(GcReason::Forced);
+    heap.finish_sweep();
+
+    REQUIRE(heap.stats().released_pages >= 20);
+    REQUIRE(heap.stats().total_bytes <= total_bytes_before + 2 * Page::min_size_bytes);
+
+    // The heap grows again on demand.
+    {
+        Scope sc(ctx);
+        Local array = sc.local(Array::make(ctx, 0));
+        Local item = sc.local();
+        for (i64 i = 0; i < 10000; ++i) {
+            item = String::make(ctx, "some string value");
+            array->append(ctx, item).must("append failed");
+        }
+        gc.collect(GcReason::Forced);
+        REQUIRE(array->size() == 10000);
+        REQUIRE(array->unchecked_get(9999).must_cast<String>().view() == "some string value");
+    }
+}
+
+TEST_CASE("Compaction should evacuate sparsely populated pages", "[collector]") {
+    const bool size_classes = GENERATE(false, true);
+    CAPTURE(size_classes);
+
+    ContextSettings settings;
+    settings.page_size_bytes = Page::min_size_bytes;
+    settings.gc_evacuation_threshold = 0.5;
+    settings.gc_size_classes = size_classes;
+    Context ctx(std::move(settings));
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+
+    // Only every 16th string survives, the other ones leave holes in the pages.
+    constexpr i64 count = 2000;
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    Local table = sc.local(HashTable::make(ctx));
+    Local item = sc.local();
+    for (i64 i = 0; i < count * 16; ++i) {
+        item = String::make(ctx, fmt::format("string {}", i));
+        if (i % 16 == 0) {
+            array->append(ctx, item).must("append failed");
+            table->set(ctx, item, item).must("set failed");
+        }
+    }
+
+    // Objects referenced from external handles must not move.
+    External pinned = ctx.externals().allocate(array->unchecked_get(0));
+    Header* pinned_address = HeapValue(*pinned).heap_ptr();
+
+    gc.collect(GcReason::Forced);
+    REQUIRE(gc.compaction_due());
+    heap.finish_sweep();
+    const size_t total_bytes_before = heap.stats().total_bytes;
+
+    gc.collect(GcReason::Compaction);
+    heap.finish_sweep();
+    REQUIRE(gc.evacuated_objects() > 0);
+    REQUIRE(!gc.compaction_due());
+    REQUIRE(heap.stats().total_bytes < total_bytes_before);
+    REQUIRE(HeapValue(*pinned).heap_ptr() == pinned_address);
+    REQUIRE(pinned->same(array->unchecked_get(0)));
+
+    i64 mismatches = 0;
+    for (i64 i = 0; i < count; ++i) {
+        item = String::make(ctx, fmt::format("string {}", i * 16));
+        auto value = array->unchecked_get(i);
+        if (!value.is<String>() || !value.must_cast<String>().equal(*item))
+            ++mismatches;
+
+        // String keys are hashed by their content.
+        auto found = table->get(*item);
+        if (!found || !found->same(value))
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+    ctx.externals().free(pinned);
+}
+
+TEST_CASE("The collection threshold should follow the gc policy", "[collector]") {
+    ContextSettings settings;
+    settings.max_heap_size_bytes = 64 << 20;
+    settings.gc_policy.gc_time_ratio = 0;
+    settings.gc_policy.heap_headroom = 0;
+
+    SECTION("Heap growth") {
+        settings.gc_policy.heap_growth = 3;
+        Context ctx(settings);
+        Heap& heap = ctx.heap();
+        Collector& gc = heap.collector();
+
+        Scope sc(ctx);
+        Local array = sc.local(Array::make(ctx, 0));
+        Local item = sc.local();
+        for (int i = 0; i < 20000; ++i) {
+            item = String::make(ctx, fmt::format("string {}", i));
+            array->append(ctx, item).must("append failed");
+        }
+
+        gc.collect(GcReason::Forced);
+        const size_t live = heap.stats().allocated_bytes;
+        REQUIRE(live * 3 > settings.gc_policy.min_nursery_bytes);
+        REQUIRE(gc.next_threshold() == live * 4);
+    }
+
+    SECTION("Minimum nursery size") {
+        settings.gc_policy.min_nursery_bytes = 8 << 20;
+        Context ctx(settings);
+        Heap& heap = ctx.heap();
+        Collector& gc = heap.collector();
+
+        gc.collect(GcReason::Forced);
+        REQUIRE(gc.next_threshold() == heap.stats().allocated_bytes + (8 << 20));
+    }
+
+    SECTION("Heap headroom") {
+        settings.gc_policy.min_nursery_bytes = 128 << 20;
+        settings.gc_policy.heap_headroom = 0.25;
+        Context ctx(settings);
+        Collector& gc = ctx.heap().collector();
+
+        gc.collect(GcReason::Forced);
+        REQUIRE(gc.next_threshold() == 48 << 20);
+    }
+
+    SECTION("GC time ratio") {
+        settings.gc_policy.gc_time_ratio = 0.0001;
+        Context ctx(settings);
+        Heap& heap = ctx.heap();
+        Collector& gc = heap.collector();
+
+        Scope sc(ctx);
+        Local array = sc.local(Array::make(ctx, 0));
+        Local item = sc.local();
+        for (int i = 0; i < 20000; ++i) {
+            item = String::make(ctx, fmt::format("string {}", i));
+            array->append(ctx, item).must("append failed");
+        }
+        for (int i = 0; i < 20000; ++i)
+            item = String::make(ctx, fmt::format("garbage {}", i));
+
+        gc.collect(GcReason::Forced);
+        REQUIRE(gc.last_duration() > 0);
+        REQUIRE(gc.allocation_rate() > 0);
+
+        // The collection must be amortized over a very long time, which requires a much larger nursery.
+        const size_t live = heap.stats().allocated_bytes;
+        REQUIRE(gc.next_threshold() > live + settings.gc_policy.min_nursery_bytes);
+    }
+}
+
+TEST_CASE("Collector should record statistics about collections", "[collector]") {
+    std::vector<GcEvent> events;
+
+    ContextSettings settings;
+    settings.gc_callback = [&](const GcEvent& event) { events.push_back(event); };
+    Context ctx(std::move(settings));
+
+    Heap& heap = ctx.heap();
+    Collector& gc = heap.collector();
+
+    constexpr int count = 1000;
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    Local item = sc.local();
+    for (int i = 0; i < count; ++i) {
+        item = String::make(ctx, fmt::format("string {}", i));
+        array->append(ctx, item).must("append failed");
+        String::make(ctx, fmt::format("garbage {}", i));
+    }
+
+    const size_t cycles_before = gc.cycles();
+    gc.collect(GcReason::Forced);
+    REQUIRE(gc.cycles() == cycles_before + 1);
+    REQUIRE(events.size() == gc.cycles());
+
+    const GcEvent& event = events.back();
+    REQUIRE(event.reason == GcReason::Forced);
+    REQUIRE(event.major);
+    REQUIRE(!event.incremental);
+    REQUIRE(event.freed_bytes() > 0);
+    REQUIRE(event.objects_before >= event.objects_after + count);
+    REQUIRE(event.bytes_after == heap.stats().allocated_bytes);
+    REQUIRE(event.pages == heap.page_count());
+    REQUIRE(event.duration >= event.mark_duration);
+    REQUIRE(gc.last_event().duration == event.duration);
+
+    const GcStats& stats = gc.stats();
+    REQUIRE(stats.collections[static_cast<size_t>(GcReason::Forced)] == 1);
+    REQUIRE(stats.pauses.count() == gc.cycles());
+    REQUIRE(stats.pauses.max() <= stats.pauses.total());
+
+    const auto& strings = stats.live_types[static_cast<size_t>(ValueType::String)];
+    REQUIRE(strings.objects >= count);
+    REQUIRE(strings.objects < 2 * count);
+    REQUIRE(strings.bytes >= count * sizeof(Header));
+    REQUIRE(stats.live_types[static_cast<size_t>(ValueType::Array)].objects >= 1);
+    REQUIRE(stats.live_types_json().find("\"type\":\"String\"") != std::string::npos);
+}
+
+TEST_CASE("Pause histogram should sort pauses into exponential buckets", "[collector]") {
+    PauseHistogram histogram;
+    histogram.record(0.01);
+    histogram.record(0.1);
+    histogram.record(1);
+    histogram.record(1e9);
+
+    REQUIRE(histogram.count() == 4);
+    REQUIRE(histogram.max() == 1e9);
+    REQUIRE(histogram.bucket(0) == 1);                               // < 0.064 ms
+    REQUIRE(histogram.bucket(1) == 1);                               // < 0.128 ms
+    REQUIRE(histogram.bucket(4) == 1);                               // < 1.024 ms
+    REQUIRE(histogram.bucket(PauseHistogram::bucket_count - 1) == 1); // unbounded
+    REQUIRE(PauseHistogram::upper_bound(4) == 1.024);
+}
+
 TEST_CASE("Collector should find rooted local objects", "[collector]") {
     Context ctx;
 
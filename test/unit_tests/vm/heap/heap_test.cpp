@@ -297,6 +297,93 @@ TEST_CASE("allocate_large should favor large chunks", "[heap]") {
     }
 }
 
+TEST_CASE("allocation buffer should allocate sequential cells", "[heap]") {
+    DefaultHeapAllocator alloc;
+    Heap heap(Page::default_size_bytes, alloc);
+
+    NotNull<Page*> page = Page::allocate(heap);
+    ScopeExit cleanup = [&] { Page::destroy(page); };
+
+    Cell* cells = page->cells().data();
+    FreeSpace space(heap.layout());
+    space.insert_free_with_metadata(Span(cells, 64));
+
+    auto chunk = space.allocate_chunk(1);
+    REQUIRE(chunk.data() == cells);
+    REQUIRE(chunk.size() == 64);
+
+    AllocationBuffer buffer;
+    REQUIRE(buffer.remaining() == 0);
+    REQUIRE(buffer.allocate(1) == nullptr);
+
+    buffer.reset(page, chunk);
+    REQUIRE(buffer.remaining() == 64);
+
+    Cell* a = buffer.allocate(2);
+    Cell* b = buffer.allocate(30);
+    Cell* c = buffer.allocate(30);
+    REQUIRE(a == cells);
+    REQUIRE(b == cells + 2);
+    REQUIRE(c == cells + 32);
+    REQUIRE(buffer.remaining() == 2);
+    REQUIRE(buffer.allocate(3) == nullptr);
+
+    REQUIRE(page->is_allocated_block_start(0));
+    REQUIRE(page->is_allocated_block_start(2));
+    REQUIRE(page->is_allocated_block_start(32));
+    REQUIRE(page->is_cell_block_extent(1));
+    REQUIRE(page->is_cell_block_extent(62));
+
+    auto unused = buffer.take_remaining();
+    REQUIRE(unused.data() == cells + 62);
+    REQUIRE(unused.size() == 2);
+    REQUIRE(buffer.remaining() == 0);
+
+    space.insert_free_with_metadata(unused);
+    REQUIRE(page->is_free_block_start(62));
+    REQUIRE(space.allocate_exact(2) == cells + 62);
+}
+
+TEST_CASE("size class pages should allocate fixed size slots", "[heap]") {
+    DefaultHeapAllocator alloc;
+    Heap heap(Page::min_size_bytes, alloc);
+
+    NotNull<Page*> page = Page::allocate(heap, Region::Generic, 3);
+    ScopeExit cleanup = [&] { Page::destroy(page); };
+    REQUIRE(page->slot_cells() == 3);
+    REQUIRE(page->usable_cells() == (page->cells_count() / 3) * 3);
+
+    const u32 slots = page->usable_cells() / 3;
+    Cell* cells = page->cells().data();
+    for (u32 i = 0; i < slots; ++i) {
+        Cell* slot = page->allocate_slot();
+        REQUIRE(slot == cells + i * 3);
+    }
+    REQUIRE(page->allocate_slot() == nullptr);
+    REQUIRE(page->is_allocated_block_start(0));
+    REQUIRE(page->is_cell_block_extent(1));
+    REQUIRE(page->is_allocated_block_start(3));
+
+    // Only marked slots survive the sweep, the other slots are reused in address order.
+    page->set_cell_marked(3, true);
+    page->set_cell_marked(9, true);
+    std::vector<Span<Cell>> free_blocks;
+    REQUIRE(page->sweep(free_blocks) == page->usable_cells() - 6);
+    REQUIRE(free_blocks.empty());
+    REQUIRE(page->allocate_slot() == cells);
+    REQUIRE(page->allocate_slot() == cells + 6);
+    REQUIRE(page->allocate_slot() == cells + 12);
+
+    // Empty pages can be divided into slots of a different size.
+    page->clear_marks();
+    REQUIRE(page->sweep(free_blocks) == page->usable_cells());
+    page->reassign(Region::Data, 1);
+    REQUIRE(page->region() == Region::Data);
+    REQUIRE(page->usable_cells() == page->cells_count());
+    REQUIRE(page->allocate_slot() == cells);
+    REQUIRE(page->allocate_slot() == cells + 1);
+}
+
 TEST_CASE("heap should track of total allocated memory", "[heap]") {
     const size_t page_size = 1 << 16;
     DefaultHeapAllocator alloc;
@@ -0,0 +1,64 @@
+#include <catch2/catch.hpp>
+
+#include "vm/heap/mark_stack.hpp"
+
+namespace tiro::vm::test {
+
+static Header* fake_object(size_t index) {
+    return reinterpret_cast<Header*>((index + 1) * 16);
+}
+
+TEST_CASE("Mark stack should return items in reverse order", "[mark-stack]") {
+    constexpr size_t count = MarkStack::segment_size * 10 + 3;
+
+    MarkStack stack;
+    REQUIRE(stack.empty());
+    for (size_t i = 0; i < count; ++i)
+        REQUIRE(stack.push(MarkItem{fake_object(i), i}));
+    REQUIRE(stack.size() == count);
+    REQUIRE(stack.segments() == 11);
+
+    size_t mismatches = 0;
+    MarkItem item;
+    for (size_t i = count; i-- > 0;) {
+        REQUIRE(stack.pop(item));
+        if (item.object != fake_object(i) || item.offset != i)
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(stack.empty());
+    REQUIRE(!stack.pop(item));
+    REQUIRE(!stack.overflowed());
+
+    // Segments are cached until the stack is trimmed.
+    REQUIRE(stack.segments() == 11);
+    stack.trim();
+    REQUIRE(stack.segments() == MarkStack::reserved_segments);
+}
+
+TEST_CASE("Mark stack should drop items when it reaches its limit", "[mark-stack]") {
+    constexpr size_t capacity = MarkStack::segment_size * MarkStack::reserved_segments;
+
+    MarkStack stack;
+    stack.max_segments(MarkStack::reserved_segments);
+    for (size_t i = 0; i < capacity; ++i)
+        REQUIRE(stack.push(MarkItem{fake_object(i), 0}));
+    REQUIRE(!stack.overflowed());
+
+    REQUIRE(!stack.push(MarkItem{fake_object(capacity), 0}));
+    REQUIRE(stack.overflowed());
+    REQUIRE(stack.size() == capacity);
+
+    MarkItem item;
+    REQUIRE(stack.pop(item));
+    REQUIRE(item.object == fake_object(capacity - 1));
+
+    stack.reset_overflow();
+    REQUIRE(!stack.overflowed());
+
+    stack.clear();
+    REQUIRE(stack.empty());
+    REQUIRE(stack.size() == 0);
+}
+
+} // namespace tiro::vm::test
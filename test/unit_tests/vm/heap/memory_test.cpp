@@ -46,4 +46,47 @@ TEST_CASE("Aligned allocation should succeed for large blocks", "[memory]") {
     }
 }
 
+TEST_CASE("Mapped blocks should be aligned and resizable", "[memory]") {
+    if (!memory_mapping_supported())
+        return;
+
+    const size_t sizes[] = {
+        1 << 12,
+        1 << 20,
+        1 << 22,
+    };
+
+    for (size_t size : sizes) {
+        CAPTURE(size);
+
+        byte* block = static_cast<byte*>(map_aligned(size, size));
+        REQUIRE(block != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(block) % size == 0);
+        ScopeExit guard = [&] { unmap_aligned(block, size, size); };
+
+        block[0] = 1;
+        block[size - 1] = 2;
+    }
+
+    // Small alignment: the block may be moved.
+    const size_t old_size = 3 << 12;
+    const size_t new_size = 5 << 20;
+    byte* block = static_cast<byte*>(map_aligned(old_size, 16));
+    REQUIRE(block != nullptr);
+    for (size_t i = 0; i < old_size; ++i)
+        block[i] = static_cast<byte>(i);
+
+    byte* resized = static_cast<byte*>(remap_aligned(block, old_size, new_size, 16, true));
+    REQUIRE(resized != nullptr);
+    ScopeExit guard = [&] { unmap_aligned(resized, new_size, 16); };
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < old_size; ++i) {
+        if (resized[i] != static_cast<byte>(i))
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+    resized[new_size - 1] = 1;
+}
+
 } // namespace tiro::vm::test
@@ -0,0 +1,63 @@
+#include <catch2/catch.hpp>
+
+#include "vm/heap/snapshot.hpp"
+
+#include "../eval/test_context.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <optional>
+
+namespace tiro::vm::test {
+
+TEST_CASE("Heap snapshots should contain reachable objects and their roots", "[heap]") {
+    TestContext test(R"(
+        var items = [];
+
+        export func test() {
+            for var i = 0; i < 10; i += 1 {
+                items.append((i, "snapshot item"));
+            }
+        }
+    )");
+    test.call("test").returns_null();
+
+    auto snapshot = nlohmann::json::parse(heap_snapshot(test.ctx()));
+    REQUIRE(snapshot["version"] == 1);
+
+    const auto& objects = snapshot["objects"];
+    const auto& types = snapshot["types"];
+    const auto type_name = [&](const nlohmann::json& object) {
+        return types.at(object.at(0).get<size_t>()).get<std::string>();
+    };
+
+    // The module is labelled as a root and references the array (through its members).
+    std::optional<size_t> module;
+    for (const auto& root : snapshot["roots"]) {
+        if (root[0] == "module test")
+            module = root[1].get<size_t>();
+    }
+    REQUIRE(module);
+    REQUIRE(type_name(objects.at(*module)) == "Module");
+    REQUIRE(objects.at(*module).at(3) == "test");
+
+    // Every item references the shared string.
+    size_t tuples = 0;
+    for (const auto& object : objects) {
+        REQUIRE(object.at(1).get<size_t>() > 0);
+        for (const auto& ref : object.at(2))
+            REQUIRE(ref.get<size_t>() < objects.size());
+
+        if (type_name(object) != "Tuple")
+            continue;
+
+        for (const auto& ref : object.at(2)) {
+            const auto& target = objects.at(ref.get<size_t>());
+            if (type_name(target) == "String" && target.at(3) == "snapshot item")
+                ++tuples;
+        }
+    }
+    REQUIRE(tuples >= 10); // The module constants may reference the string as well
+}
+
+} // namespace tiro::vm::test
@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+
+#include "vm/context.hpp"
+#include "vm/inline_cache.hpp"
+#include "vm/objects/all.hpp"
+
+namespace tiro::vm::test {
+
+static Record make_record(Context& ctx, std::initializer_list<std::string_view> names) {
+    Scope sc(ctx);
+    Local keys = sc.local(Array::make(ctx, 0));
+    Local key = sc.local<Symbol>(defer_init);
+    for (auto name : names) {
+        key = ctx.get_symbol(name);
+        keys->append(ctx, key).must("append failed");
+    }
+    return Record::make(ctx, keys);
+}
+
+TEST_CASE("Inline caches should remember record property slots", "[inline-cache]") {
+    Context ctx;
+    Scope sc(ctx);
+
+    Local cache = sc.local(InlineCache::make(ctx, 2));
+    Local record = sc.local(make_record(ctx, {"foo", "bar"}));
+    Local bar = sc.local(ctx.get_symbol("bar"));
+    Local value = sc.local(ctx.get_integer(123));
+
+    REQUIRE_FALSE(InlineCache::load(*cache, 0, *record));
+    REQUIRE_FALSE(InlineCache::store(*cache, 0, *record, *value));
+
+    InlineCache::update_member(*cache, 0, *record, *bar, Value::null());
+    REQUIRE(InlineCache::store(*cache, 0, *record, *value));
+    REQUIRE(record->get(*bar)->same(*value));
+
+    auto loaded = InlineCache::load(*cache, 0, *record);
+    REQUIRE(loaded);
+    REQUIRE(loaded->same(*value));
+
+    // Other sites are not affected.
+    REQUIRE_FALSE(InlineCache::load(*cache, 1, *record));
+
+    // Records with the same schema share the cache entry.
+    Local schema = sc.local(record->schema());
+    Local other = sc.local(Record::make(ctx, schema));
+    loaded = InlineCache::load(*cache, 0, *other);
+    REQUIRE(loaded);
+    REQUIRE(loaded->is_null());
+}
+
+TEST_CASE("Inline caches should evict the oldest entry when full", "[inline-cache]") {
+    Context ctx;
+    Scope sc(ctx);
+
+    Local cache = sc.local(InlineCache::make(ctx, 1));
+    Local symbol = sc.local(ctx.get_symbol("foo"));
+    Local records = sc.local(Array::make(ctx, 0));
+    Local record = sc.local<Record>(defer_init);
+    for (u32 i = 0; i < InlineCache::ways + 1; ++i) {
+        record = make_record(ctx, {"foo"});
+        records->append(ctx, record).must("append failed");
+        InlineCache::update_member(*cache, 0, *record, *symbol, Value::null());
+    }
+
+    REQUIRE_FALSE(InlineCache::load(*cache, 0, records->checked_get(0)));
+    for (u32 i = 1; i < InlineCache::ways + 1; ++i) {
+        CAPTURE(i);
+        REQUIRE(InlineCache::load(*cache, 0, records->checked_get(i)));
+    }
+}
+
+TEST_CASE("Inline caches should remember methods of builtin types", "[inline-cache]") {
+    Context ctx;
+    Scope sc(ctx);
+
+    Local cache = sc.local(InlineCache::make(ctx, 1));
+    Local array = sc.local(Array::make(ctx, 0));
+    Local append = sc.local(ctx.get_symbol("append"));
+    Local method = sc.local(ctx.types().load_method(ctx, array, append).must("lookup failed"));
+
+    // Members of builtin instances are bound to the object and are not cached.
+    InlineCache::update_member(*cache, 0, *array, *append, *method);
+    REQUIRE_FALSE(InlineCache::load(*cache, 0, *array));
+
+    InlineCache::update_method(*cache, 0, *array, *append, *method);
+    Local other = sc.local(Array::make(ctx, 0));
+    auto loaded = InlineCache::load(*cache, 0, *other);
+    REQUIRE(loaded);
+    REQUIRE(loaded->same(*method));
+
+    // Values of a different builtin type must miss.
+    Local tuple = sc.local(Tuple::make(ctx, 0));
+    REQUIRE_FALSE(InlineCache::load(*cache, 0, *tuple));
+}
+
+} // namespace tiro::vm::test
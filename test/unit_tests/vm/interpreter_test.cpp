@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+
+#include "bytecode/function.hpp"
+#include "bytecode/writer.hpp"
+#include "vm/context.hpp"
+#include "vm/handles/scope.hpp"
+#include "vm/modules/translate.hpp"
+#include "vm/objects/all.hpp"
+
+namespace tiro::vm::test {
+
+// Returns a function that never returns. Its loop is closed by a conditional jump to itself.
+static CodeFunction make_spin_function(Context& ctx, BytecodeOp jump_op) {
+    BytecodeFunction func;
+    func.locals(1);
+
+    BytecodeWriter writer(func);
+    BytecodeLabel loop(1);
+    const BytecodeRegister value(0);
+    switch (jump_op) {
+    case BytecodeOp::JmpTrue:
+        writer.load_true(value);
+        writer.define_label(loop);
+        writer.jmp_true(value, loop);
+        break;
+    case BytecodeOp::JmpFalse:
+        writer.load_false(value);
+        writer.define_label(loop);
+        writer.jmp_false(value, loop);
+        break;
+    case BytecodeOp::JmpNull:
+        writer.load_null(value);
+        writer.define_label(loop);
+        writer.jmp_null(value, loop);
+        break;
+    case BytecodeOp::JmpNotNull:
+        writer.load_true(value);
+        writer.define_label(loop);
+        writer.jmp_not_null(value, loop);
+        break;
+    default:
+        TIRO_UNREACHABLE("unexpected jump instruction");
+    }
+    writer.ret(value);
+    writer.finish();
+
+    auto translated = translate_function(func);
+
+    Scope sc(ctx);
+    Local name = sc.local(String::make(ctx, "spin"));
+    Local members = sc.local(Tuple::make(ctx, 0));
+    Local exported = sc.local(HashTable::make(ctx));
+    Local module = sc.local(Module::make(ctx, name, members, exported));
+    Local tmpl = sc.local(CodeFunctionTemplate::make(ctx, name, module, 0, func.locals(),
+        translated.handlers, translated.lines, translated.code, translated.cache_sites));
+    return CodeFunction::make(ctx, tmpl, {});
+}
+
+TEST_CASE("Backward conditional jumps should be safepoints", "[interpreter]") {
+    const BytecodeOp jump_op = GENERATE(
+        BytecodeOp::JmpTrue, BytecodeOp::JmpFalse, BytecodeOp::JmpNull, BytecodeOp::JmpNotNull);
+    CAPTURE(to_string(jump_op));
+
+    ContextSettings settings;
+    settings.run_ready_budget = std::chrono::milliseconds(1);
+    Context ctx(settings);
+
+    Scope sc(ctx);
+    Local func = sc.local(make_spin_function(ctx, jump_op));
+    Local coro = sc.local(ctx.make_coroutine(func, {}));
+    ctx.start(coro);
+
+    // Never returns if the loop does not pass through a safepoint.
+    for (int i = 0; i < 3; ++i) {
+        ctx.run_ready();
+        REQUIRE(ctx.has_ready());
+        REQUIRE(coro->state() == CoroutineState::Ready);
+    }
+}
+
+} // namespace tiro::vm::test
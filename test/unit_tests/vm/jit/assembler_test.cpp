@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include "vm/jit/assembler.hpp"
+#include "vm/jit/code_memory.hpp"
+
+#include <vector>
+
+namespace tiro::vm::test {
+
+static std::vector<byte> bytes(const X64Assembler& as) {
+    auto code = as.code();
+    return std::vector<byte>(code.begin(), code.end());
+}
+
+TEST_CASE("The assembler should encode register operands", "[jit]") {
+    X64Assembler as;
+    as.mov(X64Reg::RAX, X64Reg::RDI);
+    as.add(X64Reg::R8, X64Reg::RSI);
+    as.ret();
+    REQUIRE(bytes(as) == std::vector<byte>{0x48, 0x89, 0xF8, 0x49, 0x01, 0xF0, 0xC3});
+}
+
+TEST_CASE("The assembler should encode memory operands", "[jit]") {
+    X64Assembler as;
+    as.mov(X64Reg::RAX, X64Mem{X64Reg::RDI, 8});
+    as.mov(X64Mem{X64Reg::RSP, 0}, X64Reg::RCX);
+    as.mov(X64Reg::RDX, X64Mem{X64Reg::RBP, 0});
+    as.mov(X64Reg::RAX, X64Mem{X64Reg::RSI, 1024});
+    as.sub(X64Mem{X64Reg::RDX, 16}, 1);
+    REQUIRE(bytes(as) == std::vector<byte>{
+                             0x48, 0x8B, 0x47, 0x08,                   // mov rax, [rdi + 8]
+                             0x48, 0x89, 0x0C, 0x24,                   // mov [rsp], rcx
+                             0x48, 0x8B, 0x55, 0x00,                   // mov rdx, [rbp + 0]
+                             0x48, 0x8B, 0x86, 0x00, 0x04, 0x00, 0x00, // mov rax, [rsi + 1024]
+                             0x48, 0x83, 0x6A, 0x10, 0x01,             // sub qword [rdx + 16], 1
+                         });
+}
+
+TEST_CASE("The assembler should patch forward and backward jumps", "[jit]") {
+    X64Assembler as;
+    X64Label back, forward;
+    as.bind(back);
+    as.jcc(X64Cond::Equal, forward);
+    as.jmp(back);
+    as.bind(forward);
+    as.ret();
+    REQUIRE(bytes(as) == std::vector<byte>{
+                             0x0F, 0x84, 0x05, 0x00, 0x00, 0x00, // je forward
+                             0xE9, 0xF5, 0xFF, 0xFF, 0xFF,       // jmp back
+                             0xC3,                               // ret
+                         });
+}
+
+TEST_CASE("Generated code should be executable", "[jit]") {
+    // u64 f(u64 a, u64 b) { return a > b ? a - b : 0; }
+    X64Assembler as;
+    X64Label done;
+    as.mov(X64Reg::RAX, u64(0));
+    as.cmp(X64Reg::RDI, X64Reg::RSI);
+    as.jcc(X64Cond::BelowEqual, done);
+    as.mov(X64Reg::RAX, X64Reg::RDI);
+    as.sub(X64Reg::RAX, X64Reg::RSI);
+    as.bind(done);
+    as.ret();
+
+    auto memory = CodeMemory::make(as.code());
+    REQUIRE(memory.size() == as.code().size());
+
+    using Func = u64 (*)(u64, u64);
+    auto func = reinterpret_cast<Func>(reinterpret_cast<uintptr_t>(memory.data()));
+    REQUIRE(func(10, 3) == 7);
+    REQUIRE(func(3, 10) == 0);
+    REQUIRE(func(5, 5) == 0);
+}
+
+} // namespace tiro::vm::test
@@ -0,0 +1,135 @@
+#include <catch2/catch.hpp>
+
+#include "vm/jit/jit.hpp"
+#include "vm/objects/function.hpp"
+
+#include "../eval/test_context.hpp"
+
+namespace tiro::vm::test {
+
+static JitFunction* compiled_function(TestContext& test, std::string_view name) {
+    auto func = test.get_export(name);
+    return func->must_cast<CodeFunction>().tmpl().jit();
+}
+
+TEST_CASE("The jit should compile hot loops", "[jit]") {
+    std::string_view source = R"(
+        export func sum(n) {
+            var result = 0;
+            for var i = 0; i < n; i += 1 {
+                result += i;
+            }
+            return result;
+        }
+    )";
+
+    TestContext test(source);
+    test.call("sum", 10).returns_int(45);
+    REQUIRE(compiled_function(test, "sum") == nullptr);
+
+    test.call("sum", 10000).returns_int(49995000);
+    REQUIRE(compiled_function(test, "sum") != nullptr);
+
+    // Compiled code is reused on the next call.
+    test.call("sum", 100).returns_int(4950);
+}
+
+TEST_CASE("The jit should compile hot functions", "[jit]") {
+    std::string_view source = R"(
+        func max(a, b) {
+            if (a >= b) {
+                return a;
+            }
+            return b;
+        }
+
+        export func test(n) {
+            var result = 0;
+            var i = 0;
+            while (i < n) {
+                result = max(result, i * 3 - 100);
+                i = i + 1;
+            }
+            return result;
+        }
+
+        export func get_max() = max;
+    )";
+
+    TestContext test(source);
+    test.call("test", 5000).returns_int(14897);
+
+    auto max = test.call("get_max").returns_value();
+    REQUIRE(max->must_cast<CodeFunction>().tmpl().jit() != nullptr);
+}
+
+TEST_CASE("The jit should fall back to the interpreter on integer overflow", "[jit]") {
+    std::string_view source = R"(
+        func pow2(n) {
+            var result = 1;
+            for var i = 0; i < n; i += 1 {
+                result = result * 2;
+            }
+            return result;
+        }
+
+        export func test() {
+            var result = 0;
+            for var i = 0; i < 2000; i += 1 {
+                result = pow2(62);
+            }
+            return result;
+        }
+    )";
+
+    TestContext test(source);
+    test.call("test").returns_int(i64(1) << 62);
+}
+
+TEST_CASE("The jit should fall back to the interpreter for unsupported operand types", "[jit]") {
+    std::string_view source = R"(
+        export func test(start, step) {
+            var result = start;
+            var i = 0;
+            while (i < 5000) {
+                result = result + step;
+                i = i + 1;
+            }
+            return result == start + step * 5000;
+        }
+    )";
+
+    TestContext test(source);
+    test.call("test", 0, 1).returns_bool(true);
+    test.call("test", 0.5, 0.25).returns_bool(true);
+    test.call("test", 1, 0.5).returns_bool(true);
+}
+
+TEST_CASE("Compiled code should support boolean and null values", "[jit]") {
+    std::string_view source = R"(
+        export func test(n) {
+            var count = 0;
+            var flag = false;
+            var value = null;
+            for var i = 0; i < n; i += 1 {
+                flag = !flag;
+                if (flag && i != 8) {
+                    count += 1;
+                }
+                if (value == null) {
+                    value = i;
+                }
+            }
+            return (count, value);
+        }
+    )";
+
+    TestContext test(source);
+    auto result = test.call("test", 5000).returns_value();
+    auto tuple = result->must_cast<Tuple>();
+    REQUIRE(tuple.size() == 2);
+    REQUIRE(tuple.checked_get(0).must_cast<SmallInteger>().value() == 2499);
+    REQUIRE(tuple.checked_get(1).must_cast<SmallInteger>().value() == 0);
+}
+
+} // namespace tiro::vm::test
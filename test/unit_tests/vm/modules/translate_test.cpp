@@ -0,0 +1,157 @@
+#include <catch2/catch.hpp>
+
+#include "bytecode/function.hpp"
+#include "bytecode/writer.hpp"
+#include "vm/modules/translate.hpp"
+
+#include <cstring>
+
+namespace tiro::vm::test {
+
+static u64 read_u64(const std::vector<CodeWord>& code, size_t index) {
+    u64 value;
+    std::memcpy(&value, code.data() + index, sizeof(value));
+    return value;
+}
+
+TEST_CASE("translation produces native code words", "[module-translate]") {
+    BytecodeFunction func;
+    func.locals(2);
+
+    BytecodeWriter writer(func);
+    writer.load_int(-123456789012, BytecodeRegister(0));
+    writer.load_float(1.5, BytecodeRegister(1));
+    writer.add(BytecodeRegister(0), BytecodeRegister(1), BytecodeRegister(0));
+    writer.ret(BytecodeRegister(0));
+    writer.finish();
+
+    auto result = translate_function(func);
+    const auto& code = result.code;
+    REQUIRE(code.size() == 14);
+
+    REQUIRE(code[0] == static_cast<u32>(BytecodeOp::LoadInt));
+    REQUIRE(static_cast<i64>(read_u64(code, 1)) == -123456789012);
+    REQUIRE(code[3] == 0);
+
+    REQUIRE(code[4] == static_cast<u32>(BytecodeOp::LoadFloat));
+    f64 constant;
+    std::memcpy(&constant, code.data() + 5, sizeof(constant));
+    REQUIRE(constant == 1.5);
+    REQUIRE(code[7] == 1);
+
+    REQUIRE(code[8] == static_cast<u32>(BytecodeOp::Add));
+    REQUIRE(code[9] == 0);
+    REQUIRE(code[10] == 1);
+    REQUIRE(code[11] == 0);
+
+    REQUIRE(code[12] == static_cast<u32>(BytecodeOp::Return));
+    REQUIRE(code[13] == 0);
+    REQUIRE(result.handlers.empty());
+}
+
+TEST_CASE("translation rewrites jump destinations to word offsets", "[module-translate]") {
+    BytecodeFunction func;
+    func.locals(1);
+
+    BytecodeWriter writer(func);
+    BytecodeLabel loop(1), exit(2);
+    writer.define_label(loop);
+    writer.load_true(BytecodeRegister(0));       // words 0 - 1
+    writer.jmp_false(BytecodeRegister(0), exit); // words 2 - 4
+    writer.jmp(loop);                            // words 5 - 6
+    writer.define_label(exit);
+    writer.ret(BytecodeRegister(0)); // words 7 - 8
+    writer.finish();
+
+    auto result = translate_function(func);
+    const auto& code = result.code;
+    REQUIRE(code.size() == 9);
+    REQUIRE(code[2] == static_cast<u32>(BytecodeOp::JmpFalse));
+    REQUIRE(code[4] == 7);
+    REQUIRE(code[5] == static_cast<u32>(BytecodeOp::Jmp));
+    REQUIRE(code[6] == 0);
+}
+
+TEST_CASE("translation rewrites exception handler offsets", "[module-translate]") {
+    BytecodeFunction func;
+    func.locals(1);
+
+    BytecodeWriter writer(func);
+    BytecodeLabel handler(1);
+    writer.load_null(BytecodeRegister(0)); // words 0 - 1
+    writer.start_handler(handler);
+    writer.load_int(1, BytecodeRegister(0)); // words 2 - 5
+    writer.load_int(2, BytecodeRegister(0)); // words 6 - 9
+    writer.start_handler(BytecodeLabel());
+    writer.ret(BytecodeRegister(0)); // words 10 - 11
+    writer.define_label(handler);
+    writer.ret(BytecodeRegister(0)); // words 12 - 13
+    writer.finish();
+
+    auto result = translate_function(func);
+    REQUIRE(result.code.size() == 14);
+    REQUIRE(result.handlers.size() == 1);
+
+    const auto& entry = result.handlers[0];
+    REQUIRE(entry.from == 2);
+    REQUIRE(entry.to == 10);
+    REQUIRE(entry.target == 12);
+}
+
+TEST_CASE("translation rewrites line table offsets", "[module-translate]") {
+    BytecodeFunction func;
+    func.locals(1);
+
+    BytecodeWriter writer(func);
+    writer.line(3);
+    writer.load_null(BytecodeRegister(0)); // words 0 - 1
+    writer.line(3);
+    writer.load_int(1, BytecodeRegister(0)); // words 2 - 5
+    writer.line(0);
+    writer.load_int(2, BytecodeRegister(0)); // words 6 - 9
+    writer.line(4);
+    writer.line(5);
+    writer.ret(BytecodeRegister(0)); // words 10 - 11
+    writer.finish();
+
+    // Unknown lines and lines without instructions do not produce entries.
+    REQUIRE(func.lines().size() == 2);
+    REQUIRE(func.lines()[0].start.value() == 0);
+    REQUIRE(func.lines()[0].line == 3);
+    REQUIRE(func.lines()[1].start.value() == 31);
+    REQUIRE(func.lines()[1].line == 5);
+
+    auto result = translate_function(func);
+    REQUIRE(result.lines.size() == 2);
+    REQUIRE(result.lines[0] == LineTable::Entry{0, 3});
+    REQUIRE(result.lines[1] == LineTable::Entry{10, 5});
+}
+
+TEST_CASE("translation assigns inline cache sites to member access instructions",
+    "[module-translate]") {
+    BytecodeFunction func;
+    func.locals(3);
+
+    BytecodeWriter writer(func);
+    writer.load_member(BytecodeRegister(0), BytecodeMemberId(5), BytecodeRegister(1)); // words 0 - 4
+    writer.store_member(BytecodeRegister(1), BytecodeRegister(0), BytecodeMemberId(6)); // words 5 - 9
+    writer.load_method(BytecodeRegister(0), BytecodeMemberId(7), BytecodeRegister(1),
+        BytecodeRegister(2));           // words 10 - 15
+    writer.ret(BytecodeRegister(0)); // words 16 - 17
+    writer.finish();
+
+    auto result = translate_function(func);
+    const auto& code = result.code;
+    REQUIRE(code.size() == 18);
+    REQUIRE(result.cache_sites == 3);
+
+    REQUIRE(code[0] == static_cast<u32>(BytecodeOp::LoadMember));
+    REQUIRE(code[4] == 0);
+    REQUIRE(code[5] == static_cast<u32>(BytecodeOp::StoreMember));
+    REQUIRE(code[9] == 1);
+    REQUIRE(code[10] == static_cast<u32>(BytecodeOp::LoadMethod));
+    REQUIRE(code[15] == 2);
+    REQUIRE(code[16] == static_cast<u32>(BytecodeOp::Return));
+}
+
+} // namespace tiro::vm::test
@@ -267,6 +267,28 @@ TEST_CASE("verifier rejects exception handlers", "[module-verify]") {
     }
 }
 
+TEST_CASE("verifier rejects tail calls within exception handler regions", "[module-verify]") {
+    BytecodeModule mod = empty_module();
+
+    BytecodeOffset call_pos;
+    BytecodeOffset end_pos;
+    BytecodeFunctionId func_id = mod.functions().push_back(
+        simple_function(0, 1, [&](BytecodeWriter& writer) {
+            writer.load_null(BytecodeRegister(0));
+            call_pos = BytecodeOffset(writer.pos());
+            writer.tail_call(BytecodeRegister(0), 0);
+            writer.pop_to(BytecodeRegister(0));
+            end_pos = BytecodeOffset(writer.pos());
+            writer.ret(BytecodeRegister(0));
+        }));
+    mod.members().push_back(BytecodeMember::make_function(func_id));
+
+    auto& handlers = mod[func_id].handlers();
+    handlers.emplace_back(call_pos, end_pos, end_pos);
+    REQUIRE_THROWS_MATCHES(verify_module(mod), Error,
+        exception_contains_string("tail calls must not be covered by an exception handler"));
+}
+
 TEST_CASE("verifier rejects functions that reference undeclared locals", "[module-verify]") {
     BytecodeModule mod = empty_module();
     add_simple_function(mod, 0, 0, [&](BytecodeWriter& writer) {
@@ -1,11 +1,14 @@
 #include <catch2/catch.hpp>
 
 #include "vm/context.hpp"
+#include "vm/heap/memory.hpp"
 #include "vm/math.hpp"
 #include "vm/objects/array.hpp"
 
 #include "support/vm_matchers.hpp"
 
+#include <algorithm>
+
 namespace tiro::vm::test {
 
 using test_support::is_integer_value;
@@ -67,4 +70,41 @@ TEST_CASE("Arrays should support clearing", "[arrays]") {
     REQUIRE_THAT(array->checked_get(0), is_integer_value(123));
 }
 
+TEST_CASE("Large arrays should grow without copying when memory is mapped", "[arrays]") {
+    ContextSettings settings;
+    settings.gc_mapped_memory = true;
+    settings.gc_policy.min_nursery_bytes = 64 << 20;
+    Context ctx(std::move(settings));
+
+    // Applies the nursery size, no automatic collection is due while the array grows.
+    ctx.heap().collector().collect(GcReason::Forced);
+
+    const i64 count = 1 << 19;
+    size_t max_large_objects = 0;
+
+    Scope sc(ctx);
+    Local array = sc.local(Array::make(ctx, 0));
+    {
+        Local value = sc.local();
+        for (i64 i = 0; i < count; ++i) {
+            value = ctx.get_integer(i);
+            array->append(ctx, value).must("append failed");
+            max_large_objects = std::max(max_large_objects, ctx.heap().large_object_count());
+        }
+    }
+    REQUIRE(array->size() == size_t(count));
+
+    size_t mismatches = 0;
+    for (i64 i = 0; i < count; ++i) {
+        Value value = array->checked_get(i);
+        if (!value.is<SmallInteger>() || value.must_cast<SmallInteger>().value() != i)
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+
+    // Otherwise every resize allocates a new storage object, the old one remains until the next collection.
+    if (memory_mapping_supported())
+        REQUIRE(max_large_objects == 1);
+}
+
 } // namespace tiro::vm::test
@@ -56,4 +56,29 @@ TEST_CASE("Handler tables should return the correct entry", "[function]") {
     lookup_fail(9999);
 }
 
+TEST_CASE("Line tables should return the line of the given pc", "[function]") {
+    std::vector<LineTable::Entry> entries{
+        {2, 3},
+        {4, 5},
+        {10, 7},
+    };
+
+    Context ctx;
+    Scope sc(ctx);
+    Local lines = sc.local(LineTable::make(ctx, entries));
+    {
+        auto raw_entries = lines->view();
+        REQUIRE(std::equal(entries.begin(), entries.end(), raw_entries.begin(), raw_entries.end()));
+    }
+
+    REQUIRE(lines->find_line(0) == 0);
+    REQUIRE(lines->find_line(1) == 0);
+    REQUIRE(lines->find_line(2) == 3);
+    REQUIRE(lines->find_line(3) == 3);
+    REQUIRE(lines->find_line(4) == 5);
+    REQUIRE(lines->find_line(9) == 5);
+    REQUIRE(lines->find_line(10) == 7);
+    REQUIRE(lines->find_line(9999) == 7);
+}
+
 } // namespace tiro::vm::test
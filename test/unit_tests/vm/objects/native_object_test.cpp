@@ -81,4 +81,22 @@ TEST_CASE("Native object finalizer should be invoked when the object is collecte
     REQUIRE(i == 0); // And not again from the heap's destructor
 }
 
+TEST_CASE("Native object finalizer should be invoked for surviving objects when the heap is destroyed") {
+    int i = 1;
+
+    {
+        Context ctx;
+        function_t func = [&]() { i -= 1; };
+
+        Scope sc(ctx);
+        Local obj = sc.local(NativeObject::make(ctx, &native_type, sizeof(function_t)));
+        new (obj->data()) function_t(std::move(func));
+
+        // The object survives and is promoted to the old generation.
+        ctx.heap().collector().collect(GcReason::Forced);
+        REQUIRE(i == 1);
+    }
+    REQUIRE(i == 0);
+}
+
 } // namespace tiro::vm::test
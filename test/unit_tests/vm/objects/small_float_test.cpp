@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+
+#include "vm/context.hpp"
+#include "vm/objects/primitives.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace tiro::vm::test {
+
+TEST_CASE("Small floats should only represent values in their exponent range", "[small-float]") {
+    if constexpr (!SmallFloat::enabled) {
+        REQUIRE_FALSE(SmallFloat::fits(0.0));
+        REQUIRE_FALSE(SmallFloat::fits(1.5));
+        return;
+    }
+
+    REQUIRE(SmallFloat::fits(0.0));
+    REQUIRE(SmallFloat::fits(-0.0));
+    REQUIRE(SmallFloat::fits(1.5));
+    REQUIRE(SmallFloat::fits(-123.25));
+    REQUIRE(SmallFloat::fits(1e70));
+    REQUIRE(SmallFloat::fits(1e-70));
+
+    REQUIRE_FALSE(SmallFloat::fits(1e300));
+    REQUIRE_FALSE(SmallFloat::fits(-1e300));
+    REQUIRE_FALSE(SmallFloat::fits(1e-300));
+    REQUIRE_FALSE(SmallFloat::fits(std::numeric_limits<f64>::infinity()));
+    REQUIRE_FALSE(SmallFloat::fits(-std::numeric_limits<f64>::infinity()));
+    REQUIRE_FALSE(SmallFloat::fits(std::numeric_limits<f64>::quiet_NaN()));
+    REQUIRE_FALSE(SmallFloat::fits(std::numeric_limits<f64>::denorm_min()));
+}
+
+TEST_CASE("Small floats should preserve their value", "[small-float]") {
+    if constexpr (!SmallFloat::enabled)
+        return;
+
+    auto value = GENERATE(0.0, 1.5, -123.25, 0.1, 1e70, -1e70, 1e-70, 123456789.123456789);
+    CAPTURE(value);
+
+    SmallFloat f = SmallFloat::make(value);
+    REQUIRE(f.is_embedded_float());
+    REQUIRE_FALSE(f.is_heap_ptr());
+    REQUIRE_FALSE(f.is_embedded_integer());
+    REQUIRE(f.type() == ValueType::SmallFloat);
+    REQUIRE(f.value() == value);
+
+    SmallFloat negative_zero = SmallFloat::make(-0.0);
+    REQUIRE(negative_zero.value() == 0.0);
+    REQUIRE(std::signbit(negative_zero.value()));
+    REQUIRE_FALSE(std::signbit(SmallFloat::make(0.0).value()));
+}
+
+TEST_CASE("Floats should use the small representation if possible", "[small-float]") {
+    Context ctx;
+    Scope sc(ctx);
+
+    Local small = sc.local(Float::make(ctx, 2.5));
+    Local large = sc.local(Float::make(ctx, 1e300));
+    REQUIRE(small->value() == 2.5);
+    REQUIRE(large->value() == 1e300);
+    REQUIRE(large->is<HeapFloat>());
+
+    if constexpr (SmallFloat::enabled) {
+        REQUIRE(small->is<SmallFloat>());
+    } else {
+        REQUIRE(small->is<HeapFloat>());
+    }
+}
+
+TEST_CASE("Small floats and heap floats should be equal if their values are equal", "[small-float]") {
+    if constexpr (!SmallFloat::enabled)
+        return;
+
+    Context ctx;
+    Scope sc(ctx);
+
+    SmallFloat small = SmallFloat::make(-123.25);
+    Local heap = sc.local(HeapFloat::make(ctx, -123.25));
+    REQUIRE(equal(small, *heap));
+    REQUIRE(hash(small) == hash(*heap));
+    REQUIRE(small.same(SmallFloat::make(-123.25)));
+    REQUIRE_FALSE(equal(small, SmallFloat::make(123.25)));
+
+    // Floats with integral values compare equal to integers.
+    REQUIRE(equal(SmallFloat::make(4.0), SmallInteger::make(4)));
+}
+
+} // namespace tiro::vm::test
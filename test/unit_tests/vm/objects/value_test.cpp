@@ -22,12 +22,13 @@ TEST_CASE("Only expected types should be able to contain references", "[value]")
         {ValueType::Boolean, false},
         {ValueType::Buffer, false},
         {ValueType::Code, false},
-        {ValueType::Float, false},
+        {ValueType::HeapFloat, false},
         {ValueType::HeapInteger, false},
         {ValueType::MagicFunction, false},
         {ValueType::NativeObject, false},
         {ValueType::NativePointer, false},
         {ValueType::Null, false},
+        {ValueType::SmallFloat, false},
         {ValueType::SmallInteger, false},
         {ValueType::String, false},
         {ValueType::Undefined, false},
@@ -64,6 +65,7 @@ TEST_CASE("Only expected types should be able to contain references", "[value]")
         {ValueType::Tuple, true},
         {ValueType::Type, true},
         {ValueType::UnresolvedImport, true},
+        {ValueType::WeakMap, true},
     };
 
     for (const auto& test : tests) {
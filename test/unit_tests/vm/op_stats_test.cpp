@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+
+#include "vm/context.hpp"
+#include "vm/op_stats.hpp"
+
+#include "./eval/test_context.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace tiro::vm::test {
+
+TEST_CASE("Instruction statistics should be empty initially", "[op-stats]") {
+    Context ctx;
+    auto& stats = ctx.op_stats();
+    REQUIRE(stats.total() == 0);
+    REQUIRE(stats.count(static_cast<CodeWord>(BytecodeOp::Add)) == 0);
+    REQUIRE(stats.function_count("test.foo") == 0);
+
+    auto json = nlohmann::json::parse(stats.to_json());
+    REQUIRE(json["enabled"] == OpStats::enabled());
+    REQUIRE(json["total"] == 0);
+    REQUIRE(json["ops"].empty());
+}
+
+#ifdef TIRO_INSTRUMENT
+TEST_CASE("Instruction statistics should count executed instructions", "[op-stats]") {
+    std::string_view source = R"(
+        func add(a, b) {
+            return a + b;
+        }
+
+        export func test(n) {
+            var result = 0;
+            for var i = 0; i < n; i += 1 {
+                result = add(result, i);
+            }
+            return result;
+        }
+    )";
+
+    TestContext test(source);
+    auto& stats = test.ctx().op_stats();
+    stats.reset();
+    test.call("test", 100).returns_int(4950);
+
+    const auto ret = static_cast<CodeWord>(BytecodeOp::Return);
+    const auto add_small_int = static_cast<CodeWord>(QuickOp::AddSmallInt);
+    const auto add = static_cast<CodeWord>(BytecodeOp::Add);
+
+    // Every call of `add` returns once, `test` returns once.
+    REQUIRE(stats.count(ret) == 101);
+
+    // The first execution of each addition is generic, later executions are quickened.
+    REQUIRE(stats.count(add) > 0);
+    REQUIRE(stats.count(add_small_int) > stats.count(add));
+    REQUIRE(stats.pair_count(add_small_int, ret) > 0);
+
+    REQUIRE(stats.function_count("test.add") > 0);
+    REQUIRE(stats.function_count("test.test") > stats.function_count("test.add"));
+    REQUIRE(stats.function_count("test.add") + stats.function_count("test.test") == stats.total());
+
+    auto json = nlohmann::json::parse(stats.to_json());
+    REQUIRE(json["enabled"] == true);
+    REQUIRE(json["total"] == stats.total());
+    REQUIRE(json["functions"][0]["function"] == "test.test");
+
+    stats.reset();
+    REQUIRE(stats.total() == 0);
+    REQUIRE(stats.function_count("test.add") == 0);
+}
+#endif
+
+} // namespace tiro::vm::test
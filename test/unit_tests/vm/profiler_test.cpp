@@ -0,0 +1,137 @@
+#include <catch2/catch.hpp>
+
+#include "vm/context.hpp"
+#include "vm/profiler.hpp"
+
+#include "./eval/test_context.hpp"
+
+namespace tiro::vm::test {
+
+static constexpr std::string_view fib_source = R"(
+    func fib(n) {
+        if (n <= 1) {
+            return n;
+        }
+        return fib(n - 1) + fib(n - 2);
+    }
+
+    export func test(n) {
+        return fib(n);
+    }
+)";
+
+TEST_CASE("The profiler should not collect samples when inactive", "[profiler]") {
+    TestContext test(fib_source);
+    test.call("test", 20).returns_int(6765);
+
+    auto& profiler = test.ctx().profiler();
+    REQUIRE_FALSE(profiler.active());
+    REQUIRE(profiler.sample_count() == 0);
+    REQUIRE(profiler.folded_stacks().empty());
+}
+
+TEST_CASE("The profiler should record folded call stacks", "[profiler]") {
+    TestContext test(fib_source);
+
+    auto& profiler = test.ctx().profiler();
+    profiler.start(std::chrono::microseconds(1));
+    REQUIRE(profiler.active());
+    test.call("test", 20).returns_int(6765);
+    profiler.stop();
+    REQUIRE_FALSE(profiler.active());
+
+    const u64 samples = profiler.sample_count();
+    REQUIRE(samples > 0);
+
+    u64 total = 0;
+    std::string folded = profiler.folded_stacks();
+    std::string_view rest = folded;
+    while (!rest.empty()) {
+        auto line_end = rest.find('\n');
+        REQUIRE(line_end != std::string_view::npos);
+        auto line = rest.substr(0, line_end);
+        rest.remove_prefix(line_end + 1);
+
+        // <coroutine>;test.test:<line> <count> or <coroutine>;test.fib:<line>;... <count>
+        // (the frame of `test` is replaced by the tail call to `fib`)
+        auto count_start = line.rfind(' ');
+        REQUIRE(count_start != std::string_view::npos);
+        auto stack = line.substr(0, count_start);
+        REQUIRE(stack.find(";test.") != std::string_view::npos);
+        total += std::stoull(std::string(line.substr(count_start + 1)));
+    }
+    REQUIRE(total == samples);
+
+    // Callers of `fib` are always suspended in the recursive calls on line 6.
+    REQUIRE(folded.find(";test.fib:6;test.fib:6;test.fib:") != std::string::npos);
+
+    // Inactive profilers retain their samples.
+    test.call("test", 10).returns_int(55);
+    REQUIRE(profiler.sample_count() == samples);
+
+    profiler.reset();
+    REQUIRE(profiler.sample_count() == 0);
+    REQUIRE(profiler.folded_stacks().empty());
+}
+
+static constexpr std::string_view alloc_source = R"(
+    export func test(n) {
+        const result = [];
+        for var i = 0; i < n; i += 1 {
+            result.append((i, i));
+        }
+        return result;
+    }
+)";
+
+TEST_CASE("The allocation profiler should not collect samples when inactive", "[profiler]") {
+    TestContext test(alloc_source);
+    test.call("test", 100).returns_value();
+
+    auto& profiler = test.ctx().allocation_profiler();
+    REQUIRE_FALSE(profiler.active());
+    REQUIRE(profiler.sample_count() == 0);
+    REQUIRE(profiler.folded_stacks().empty());
+}
+
+TEST_CASE("The allocation profiler should attribute allocations to source lines", "[profiler]") {
+    TestContext test(alloc_source);
+
+    auto& profiler = test.ctx().allocation_profiler();
+    profiler.start(1);
+    REQUIRE(profiler.active());
+    test.call("test", 100).returns_value();
+    profiler.stop();
+    REQUIRE_FALSE(profiler.active());
+
+    // Every allocation is sampled with an interval of 1 byte.
+    const u64 samples = profiler.sample_count();
+    REQUIRE(samples >= 100);
+
+    u64 total = 0;
+    std::string folded = profiler.folded_stacks();
+    std::string_view rest = folded;
+    while (!rest.empty()) {
+        auto line_end = rest.find('\n');
+        REQUIRE(line_end != std::string_view::npos);
+        auto line = rest.substr(0, line_end);
+        rest.remove_prefix(line_end + 1);
+
+        auto bytes_start = line.rfind(' ');
+        REQUIRE(bytes_start != std::string_view::npos);
+        total += std::stoull(std::string(line.substr(bytes_start + 1)));
+    }
+    REQUIRE(total == profiler.sampled_bytes());
+    REQUIRE(folded.find(";test.test:3;Array ") != std::string::npos);
+    REQUIRE(folded.find(";test.test:5;Tuple ") != std::string::npos);
+
+    // Inactive profilers retain their samples.
+    test.call("test", 10).returns_value();
+    REQUIRE(profiler.sample_count() == samples);
+
+    profiler.reset();
+    REQUIRE(profiler.sample_count() == 0);
+    REQUIRE(profiler.folded_stacks().empty());
+}
+
+} // namespace tiro::vm::test
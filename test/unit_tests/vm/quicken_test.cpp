@@ -0,0 +1,61 @@
+#include <catch2/catch.hpp>
+
+#include "vm/context.hpp"
+#include "vm/objects/all.hpp"
+#include "vm/quicken.hpp"
+
+namespace tiro::vm::test {
+
+TEST_CASE("Quickened opcodes should not overlap with bytecode opcodes", "[quicken]") {
+    const CodeWord first = static_cast<CodeWord>(QuickOp::AddSmallInt);
+    REQUIRE(first <= 0xFF);
+    REQUIRE_FALSE(valid_opcode(static_cast<u8>(first)));
+    REQUIRE(valid_opcode(static_cast<u8>(first - 1)));
+
+    REQUIRE(valid_quick_op(first));
+    REQUIRE(valid_quick_op(static_cast<CodeWord>(QuickOp::LteFloat)));
+    REQUIRE_FALSE(valid_quick_op(static_cast<CodeWord>(BytecodeOp::Add)));
+    REQUIRE_FALSE(valid_quick_op(static_cast<CodeWord>(QuickOp::LteFloat) + 1));
+}
+
+TEST_CASE("Quickened instructions should be selected based on operand types", "[quicken]") {
+    Context ctx;
+    Scope sc(ctx);
+
+    Local small_int = sc.local<Value>(SmallInteger::make(1));
+    Local float_value = sc.local<Value>(Float::make(ctx, 1.5));
+    Local heap_float = sc.local<Value>(HeapFloat::make(ctx, 2.5));
+    Local string = sc.local<Value>(String::make(ctx, "foo"));
+
+    REQUIRE(select_quick_op(BytecodeOp::Add, *small_int, *small_int) == QuickOp::AddSmallInt);
+    REQUIRE(select_quick_op(BytecodeOp::Mod, *small_int, *small_int) == QuickOp::ModSmallInt);
+    REQUIRE(select_quick_op(BytecodeOp::Lt, *small_int, *small_int) == QuickOp::LtSmallInt);
+    REQUIRE(select_quick_op(BytecodeOp::NEq, *small_int, *small_int) == QuickOp::NEqSmallInt);
+    REQUIRE(select_quick_op(BytecodeOp::Mul, *float_value, *heap_float) == QuickOp::MulFloat);
+    REQUIRE(select_quick_op(BytecodeOp::Div, *float_value, *float_value) == QuickOp::DivFloat);
+    REQUIRE(select_quick_op(BytecodeOp::Gte, *heap_float, *float_value) == QuickOp::GteFloat);
+
+    // No specialization for mixed operand types, non-numeric operands or other instructions.
+    REQUIRE_FALSE(select_quick_op(BytecodeOp::Add, *small_int, *float_value));
+    REQUIRE_FALSE(select_quick_op(BytecodeOp::Add, *string, *string));
+    REQUIRE_FALSE(select_quick_op(BytecodeOp::Pow, *small_int, *small_int));
+    REQUIRE_FALSE(select_quick_op(BytecodeOp::Div, *small_int, *small_int));
+    REQUIRE_FALSE(select_quick_op(BytecodeOp::Eq, *float_value, *float_value));
+}
+
+TEST_CASE("Quickened instructions should map back to their generic instruction", "[quicken]") {
+    const CodeWord first = static_cast<CodeWord>(QuickOp::AddSmallInt);
+    const CodeWord last = static_cast<CodeWord>(QuickOp::LteFloat);
+    for (CodeWord raw = first; raw <= last; ++raw) {
+        const auto op = static_cast<QuickOp>(raw);
+        CAPTURE(to_string(op));
+
+        const BytecodeOp generic = generic_op(op);
+        const bool is_float = to_string(op).find("Float") != std::string_view::npos;
+        const bool is_int = to_string(op).find("SmallInt") != std::string_view::npos;
+        REQUIRE(is_float != is_int);
+        REQUIRE(to_string(op).substr(0, to_string(generic).size()) == to_string(generic));
+    }
+}
+
+} // namespace tiro::vm::test